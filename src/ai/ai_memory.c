@@ -33,6 +33,70 @@ typedef struct memory_block {
 #define MEMORY_MAGIC 0xABCDEF01
 #define MEMORY_ALIGN 8  // 8-byte alignment
 
+// Default input tensor metadata per model type (matches the exported PP-OCR models;
+// the Neural-ART runtime overrides these from the network info when available)
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint8_t channels;
+    uint8_t layout;
+    float scale;
+    int32_t zero_point;
+    float mean[3];
+    float std[3];
+    uint8_t batch;                  // Batch dimension (0 = 1)
+    uint8_t recognizer;             // CTC recognition model (input width is its bucket)
+} ai_model_input_info_t;
+
+static const ai_model_input_info_t ai_model_input_defaults[AI_MODEL_COUNT] = {
+    [AI_MODEL_TEXT_DETECTION]   = { OCR_INPUT_WIDTH, OCR_INPUT_HEIGHT, 3, OCR_TENSOR_LAYOUT_NHWC,
+                                    0.0186584f, -14, {0.485f, 0.456f, 0.406f}, {0.229f, 0.224f, 0.225f} },
+    // Compiled with a batch dimension: several crops per inference
+    [AI_MODEL_TEXT_RECOGNITION] = { 320, 48, 3, OCR_TENSOR_LAYOUT_NHWC,
+                                    0.0078431f, 0, {0.5f, 0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}, 8, 1 },
+    [AI_MODEL_PREPROCESSING]    = { OCR_INPUT_WIDTH, OCR_INPUT_HEIGHT, 3, OCR_TENSOR_LAYOUT_NHWC,
+                                    0.0078431f, 0, {0.5f, 0.5f, 0.5f}, {0.5f, 0.5f, 0.5f} },
+    // Fed the 2x2-averaged detection tensor, so it shares the detection quantization
+    [AI_MODEL_TEXT_DETECTION_COARSE] = { OCR_COARSE_INPUT_WIDTH, OCR_COARSE_INPUT_HEIGHT, 3, OCR_TENSOR_LAYOUT_NHWC,
+                                    0.0186584f, -14, {0.485f, 0.456f, 0.406f}, {0.229f, 0.224f, 0.225f} },
+    // Same network compiled at other widths; the widest one holds fewer crops per batch
+    [AI_MODEL_TEXT_RECOGNITION_W80]  = { 80, 48, 3, OCR_TENSOR_LAYOUT_NHWC,
+                                    0.0078431f, 0, {0.5f, 0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}, 8, 1 },
+    [AI_MODEL_TEXT_RECOGNITION_W160] = { 160, 48, 3, OCR_TENSOR_LAYOUT_NHWC,
+                                    0.0078431f, 0, {0.5f, 0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}, 8, 1 },
+    [AI_MODEL_TEXT_RECOGNITION_W640] = { 640, 48, 3, OCR_TENSOR_LAYOUT_NHWC,
+                                    0.0078431f, 0, {0.5f, 0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}, 4, 1 },
+};
+
+// Default output tensor metadata per model type (first output; an EAST head
+// packs the score plane and the 5 geometry channels into 6 channels per pixel)
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint16_t channels;
+    uint8_t head;
+    float scale;
+    int32_t zero_point;
+    float geo_scale;
+    int32_t geo_zero_point;
+    float angle_scale;
+    int32_t angle_zero_point;
+} ai_model_output_info_t;
+
+static const ai_model_output_info_t ai_model_output_defaults[AI_MODEL_COUNT] = {
+    [AI_MODEL_TEXT_DETECTION]   = { OCR_INPUT_WIDTH, OCR_INPUT_HEIGHT, 1, OCR_DET_HEAD_DBNET,
+                                    0.0039216f, -128, 0.0f, 0, 0.0f, 0 },
+    [AI_MODEL_TEXT_RECOGNITION] = { 80, 1, OCR_REC_CLASSES, 0, 0.0039216f, -128, 0.0f, 0, 0.0f, 0 },
+    [AI_MODEL_PREPROCESSING]    = { OCR_INPUT_WIDTH, OCR_INPUT_HEIGHT, 3, 0,
+                                    0.0078431f, 0, 0.0f, 0, 0.0f, 0 },
+    [AI_MODEL_TEXT_DETECTION_COARSE] = { OCR_COARSE_INPUT_WIDTH, OCR_COARSE_INPUT_HEIGHT, 1, OCR_DET_HEAD_DBNET,
+                                    0.0039216f, -128, 0.0f, 0, 0.0f, 0 },
+    // One timestep per 4 input columns
+    [AI_MODEL_TEXT_RECOGNITION_W80]  = { 20, 1, OCR_REC_CLASSES, 0, 0.0039216f, -128, 0.0f, 0, 0.0f, 0 },
+    [AI_MODEL_TEXT_RECOGNITION_W160] = { 40, 1, OCR_REC_CLASSES, 0, 0.0039216f, -128, 0.0f, 0, 0.0f, 0 },
+    [AI_MODEL_TEXT_RECOGNITION_W640] = { 160, 1, OCR_REC_CLASSES, 0, 0.0039216f, -128, 0.0f, 0, 0.0f, 0 },
+};
+
 // Static memory pool (allocated from PSRAM)
 static uint8_t ai_memory_pool_buffer[AI_MEMORY_POOL_SIZE] __attribute__((aligned(8)));
 static ai_memory_pool_t ai_pool;
@@ -342,6 +406,34 @@ int neural_art_load_model(ai_model_type_t model_type, const void *model_data, ui
     model->precision = AI_PRECISION_INT8;
     model->loaded = 1;
     
+    // Input tensor metadata used by the fused preprocessing stage
+    const ai_model_input_info_t *info = &ai_model_input_defaults[model_type];
+    model->input_width = info->width;
+    model->input_height = info->height;
+    model->input_channels = info->channels;
+    model->input_layout = info->layout;
+    model->input_scale = info->scale;
+    model->input_zero_point = info->zero_point;
+    memcpy(model->input_mean, info->mean, sizeof(model->input_mean));
+    memcpy(model->input_std, info->std, sizeof(model->input_std));
+    model->input_size = (uint32_t)info->width * info->height * info->channels;
+    model->max_batch = info->batch ? info->batch : 1;
+    model->recognizer = info->recognizer;
+    
+    // Output tensor metadata used by the detection postprocessors and the CTC decoder
+    const ai_model_output_info_t *out = &ai_model_output_defaults[model_type];
+    model->output_width = out->width;
+    model->output_height = out->height;
+    model->output_channels = out->channels;
+    model->output_head = out->head;
+    model->output_scale = out->scale;
+    model->output_zero_point = out->zero_point;
+    model->output_geo_scale = out->geo_scale;
+    model->output_geo_zero_point = out->geo_zero_point;
+    model->output_angle_scale = out->angle_scale;
+    model->output_angle_zero_point = out->angle_zero_point;
+    model->output_size = (uint32_t)out->width * out->height * out->channels;
+    
     // Configure NPU for this model
     // This would involve setting up the Neural-ART runtime
     // For now, we simulate successful loading
@@ -371,6 +463,29 @@ int neural_art_inference(ai_model_type_t model_type, const void *input, void *ou
     return 0;
 }
 
+int neural_art_inference_batch(ai_model_type_t model_type, const void *input, void *output, uint32_t batch)
+{
+    if (model_type >= AI_MODEL_COUNT || !ai_context.models[model_type].loaded) {
+        return AI_ERROR_MODEL_LOAD_FAILED;
+    }
+    if (!input || !output || batch == 0 || batch > ai_context.models[model_type].max_batch) {
+        return AI_ERROR_INPUT_INVALID;
+    }
+    
+    uint32_t start_time = hal_get_time_us();
+    
+    // Simulate NPU inference: one call (setup, weight fetch) for the whole batch
+    hal_delay_us(5000);
+    
+    uint32_t end_time = hal_get_time_us();
+    uint32_t inference_time = end_time - start_time;
+    
+    hal_debug_printf("[NEURAL_ART] Model %d inference (batch %d) completed in %dμs\n", 
+                   model_type, batch, inference_time);
+    
+    return 0;
+}
+
 uint32_t neural_art_get_utilization(void *npu_handle)
 {
     // Simulate NPU utilization based on recent inference activity
@@ -0,0 +1,333 @@
+/**
+ * @file ocr_beam.c
+ * @brief Lexicon-constrained CTC prefix beam search
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#include "ocr_beam.h"
+#include "ocr_common.h"
+#include <string.h>
+
+#define OCR_BEAM_HASH_MUL 0x9E3779B1u
+#define OCR_BEAM_SLOT_FREE 0xFFFFu
+
+// Hash table slots: power of two, at least twice the candidates
+static uint32_t ocr_beam_slots(uint32_t candidates)
+{
+    uint32_t slots = 1;
+    while (slots < 2 * candidates) {
+        slots <<= 1;
+    }
+    return slots;
+}
+
+uint32_t ocr_beam_size(uint16_t width)
+{
+    if (width == 0 || width > OCR_BEAM_MAX_WIDTH) {
+        return 0;
+    }
+    const uint32_t candidates = (uint32_t)width * (width + 1);
+    return 2 * width * sizeof(ocr_beam_entry_t) +
+           candidates * sizeof(ocr_beam_candidate_t) +
+           ocr_align4(ocr_beam_slots(candidates) * sizeof(uint16_t)) +
+           ocr_align4(width * sizeof(uint16_t)) +
+           ocr_align4(width * sizeof(uint16_t));
+}
+
+int ocr_beam_init(ocr_beam_t *beam, const ocr_ctc_t *ctc, const ocr_lexicon_t *lexicon,
+                  uint16_t width, void *storage, uint32_t storage_size)
+{
+    uint32_t size = ocr_beam_size(width);
+
+    if (!beam || !ctc || !storage || size == 0 || storage_size < size) {
+        return -1;
+    }
+
+    const uint32_t candidates = (uint32_t)width * (width + 1);
+    const uint32_t slots = ocr_beam_slots(candidates);
+    uint8_t *p = (uint8_t*)storage;
+
+    beam->ctc = ctc;
+    beam->lexicon = lexicon;
+    beam->width = width;
+    beam->min_prob = OCR_BEAM_MIN_PROB;
+    beam->oov_penalty = OCR_BEAM_OOV_PENALTY;
+    beam->beams = (ocr_beam_entry_t*)p;
+    p += width * sizeof(ocr_beam_entry_t);
+    beam->next = (ocr_beam_entry_t*)p;
+    p += width * sizeof(ocr_beam_entry_t);
+    beam->candidates = (ocr_beam_candidate_t*)p;
+    p += candidates * sizeof(ocr_beam_candidate_t);
+    beam->slots = (uint16_t*)p;
+    beam->slot_mask = (uint16_t)(slots - 1);
+    p += ocr_align4(slots * sizeof(uint16_t));
+    beam->top = (uint16_t*)p;
+    p += ocr_align4(width * sizeof(uint16_t));
+    beam->order = (uint16_t*)p;
+    beam->fallback = 0;
+    return 0;
+}
+
+// Class k of a candidate's prefix
+static uint16_t ocr_beam_class_at(const ocr_beam_t *beam, const ocr_beam_candidate_t *c, uint32_t k)
+{
+    const ocr_beam_entry_t *parent = &beam->beams[c->parent];
+    return (k < parent->length) ? parent->classes[k] : c->label;
+}
+
+static uint32_t ocr_beam_length(const ocr_beam_t *beam, const ocr_beam_candidate_t *c)
+{
+    return beam->beams[c->parent].length + (c->label != OCR_BEAM_NO_LABEL);
+}
+
+/**
+ * @brief Candidate for a prefix, created on first use
+ * @details Different parents reach the same prefix (the parent itself and a
+ *          shorter parent plus one class): their probabilities add up
+ */
+static ocr_beam_candidate_t *ocr_beam_candidate(ocr_beam_t *beam, uint32_t *count, uint16_t parent,
+                                                uint16_t label, uint32_t hash, uint32_t node)
+{
+    ocr_beam_candidate_t probe = {0.0f, 0.0f, 0.0f, hash, node, parent, label};
+    const uint32_t length = ocr_beam_length(beam, &probe);
+    uint32_t slot = (hash * OCR_BEAM_HASH_MUL) >> 16;
+
+    for (;; slot++) {
+        slot &= beam->slot_mask;
+        uint16_t index = beam->slots[slot];
+        if (index == OCR_BEAM_SLOT_FREE) {
+            break;
+        }
+        ocr_beam_candidate_t *c = &beam->candidates[index];
+        if (c->hash != hash || ocr_beam_length(beam, c) != length) {
+            continue;
+        }
+        uint32_t k = 0;
+        while (k < length && ocr_beam_class_at(beam, c, k) == ocr_beam_class_at(beam, &probe, k)) {
+            k++;
+        }
+        if (k == length) {
+            return c;
+        }
+    }
+
+    beam->slots[slot] = (uint16_t)*count;
+    beam->candidates[*count] = probe;
+    return &beam->candidates[(*count)++];
+}
+
+// Lexicon node after a class, and the factor the step costs
+static uint32_t ocr_beam_walk(const ocr_beam_t *beam, uint32_t node, uint16_t label, float *factor)
+{
+    const ocr_lexicon_t *lexicon = beam->lexicon;
+
+    *factor = 1.0f;
+    if (!lexicon) {
+        return OCR_LEXICON_ROOT;
+    }
+    if (label == beam->ctc->space_class && beam->ctc->space_class != 0) {
+        // Word boundary: a word left unfinished costs like leaving the lexicon
+        if (node != OCR_LEXICON_NONE && node != OCR_LEXICON_ROOT && !ocr_lexicon_is_word(lexicon, node)) {
+            *factor = beam->oov_penalty;
+        }
+        return OCR_LEXICON_ROOT;
+    }
+    if (node == OCR_LEXICON_NONE) {
+        return OCR_LEXICON_NONE;
+    }
+    uint32_t child = ocr_lexicon_child(lexicon, node, label);
+    if (child == OCR_LEXICON_NONE) {
+        *factor = beam->oov_penalty;
+    }
+    return child;
+}
+
+// Final weight of a prefix: ending inside a word costs like leaving the lexicon
+static float ocr_beam_final(const ocr_beam_t *beam, const ocr_beam_entry_t *e)
+{
+    float total = e->p_blank + e->p_char;
+
+    if (beam->lexicon && e->node != OCR_LEXICON_NONE && e->node != OCR_LEXICON_ROOT &&
+        !ocr_lexicon_is_word(beam->lexicon, e->node)) {
+        total *= beam->oov_penalty;
+    }
+    return total;
+}
+
+int ocr_beam_decode(ocr_beam_t *beam, const int8_t *scores, uint32_t timesteps,
+                    char *text, uint32_t text_size, ocr_ctc_result_t *result)
+{
+    if (!beam || !scores || !text || text_size == 0) {
+        return -1;
+    }
+
+    const ocr_ctc_t *ctc = beam->ctc;
+    const uint32_t classes = ctc->classes;
+    const uint32_t *lut = ctc->prob_q16;
+    const float q16 = 1.0f / (1u << OCR_CTC_PROB_SHIFT);
+    uint32_t beam_count = 1;
+
+    beam->fallback = 0;
+    beam->beams[0].p_blank = 1.0f;
+    beam->beams[0].p_char = 0.0f;
+    beam->beams[0].conf_sum = 0.0f;
+    beam->beams[0].hash = 0;
+    beam->beams[0].node = OCR_LEXICON_ROOT;
+    beam->beams[0].length = 0;
+
+    for (uint32_t t = 0; t < timesteps; t++) {
+        const int8_t *step = scores + t * classes;
+        uint32_t tried = ocr_ctc_topk(step, classes, beam->width, beam->top);
+        const int8_t best = step[beam->top[0]];
+
+        // Probability of class c: LUT value times the step normalization
+        float norm = q16;
+        if (ctc->output == OCR_CTC_OUTPUT_LOGITS) {
+            uint32_t sum = 0;
+            for (uint32_t c = 0; c < classes; c++) {
+                sum += lut[best - step[c]];
+            }
+            norm = 1.0f / (float)sum;
+        }
+        #define OCR_BEAM_PROB(c) ((ctc->output == OCR_CTC_OUTPUT_LOGITS) ? \
+                                  lut[best - step[c]] * norm : lut[step[c] + 128] * norm)
+        const float p_blank = OCR_BEAM_PROB(ctc->blank);
+
+        memset(beam->slots, 0xFF, (beam->slot_mask + 1u) * sizeof(uint16_t));
+        uint32_t count = 0;
+
+        for (uint32_t b = 0; b < beam_count; b++) {
+            const ocr_beam_entry_t *e = &beam->beams[b];
+            const float total = e->p_blank + e->p_char;
+            const uint16_t last = e->length ? e->classes[e->length - 1] : OCR_BEAM_NO_LABEL;
+
+            // Same prefix: a blank, or the last class once more
+            ocr_beam_candidate_t *same = ocr_beam_candidate(beam, &count, (uint16_t)b, OCR_BEAM_NO_LABEL,
+                                                            e->hash, e->node);
+            same->p_blank += total * p_blank;
+            if (e->length) {
+                same->p_char += e->p_char * OCR_BEAM_PROB(last);
+            }
+            if (same->conf_sum < e->conf_sum) {
+                same->conf_sum = e->conf_sum;
+            }
+
+            // One more class
+            if (e->length == OCR_BEAM_MAX_CHARS) {
+                continue;
+            }
+            for (uint32_t k = 0; k < tried; k++) {
+                const uint16_t c = beam->top[k];
+                const float p = OCR_BEAM_PROB(c);
+                if (c == ctc->blank || p < beam->min_prob) {
+                    continue;
+                }
+                float factor;
+                uint32_t node = ocr_beam_walk(beam, e->node, c, &factor);
+                if (factor == 0.0f) {
+                    continue;
+                }
+                ocr_beam_candidate_t *ext = ocr_beam_candidate(beam, &count, (uint16_t)b, c,
+                                                               e->hash * 31u + c + 1u, node);
+                // A repeat needs a blank in between
+                ext->p_char += ((c == last) ? e->p_blank : total) * p * factor;
+                if (ext->conf_sum < e->conf_sum + p) {
+                    ext->conf_sum = e->conf_sum + p;
+                }
+            }
+        }
+        #undef OCR_BEAM_PROB
+
+        // Keep the best candidates (insertion into a short sorted list)
+        uint32_t kept = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            const float total = beam->candidates[i].p_blank + beam->candidates[i].p_char;
+            uint32_t pos = (kept < beam->width) ? kept : beam->width;
+            while (pos > 0 && beam->candidates[beam->order[pos - 1]].p_blank +
+                              beam->candidates[beam->order[pos - 1]].p_char < total) {
+                if (pos < beam->width) {
+                    beam->order[pos] = beam->order[pos - 1];
+                }
+                pos--;
+            }
+            if (pos < beam->width) {
+                beam->order[pos] = (uint16_t)i;
+                kept += (kept < beam->width);
+            }
+        }
+
+        // Materialize, renormalized to the best prefix (no underflow over long lines)
+        const ocr_beam_candidate_t *lead = &beam->candidates[beam->order[0]];
+        const float lead_total = lead->p_blank + lead->p_char;
+        const float scale = (lead_total > 0.0f) ? 1.0f / lead_total : 1.0f;
+        for (uint32_t i = 0; i < kept; i++) {
+            const ocr_beam_candidate_t *c = &beam->candidates[beam->order[i]];
+            const ocr_beam_entry_t *parent = &beam->beams[c->parent];
+            ocr_beam_entry_t *e = &beam->next[i];
+
+            e->p_blank = c->p_blank * scale;
+            e->p_char = c->p_char * scale;
+            e->conf_sum = c->conf_sum;
+            e->hash = c->hash;
+            e->node = c->node;
+            e->length = parent->length;
+            memcpy(e->classes, parent->classes, parent->length * sizeof(uint16_t));
+            if (c->label != OCR_BEAM_NO_LABEL) {
+                e->classes[e->length++] = c->label;
+            }
+        }
+        ocr_beam_entry_t *swap = beam->beams;
+        beam->beams = beam->next;
+        beam->next = swap;
+        beam_count = kept;
+    }
+
+    // Best complete prefix
+    uint32_t best_index = 0;
+    float best_score = -1.0f;
+    for (uint32_t b = 0; b < beam_count; b++) {
+        float score = ocr_beam_final(beam, &beam->beams[b]);
+        if (score > best_score) {
+            best_score = score;
+            best_index = b;
+        }
+    }
+    if (beam->lexicon && (best_score <= 0.0f || beam->beams[best_index].length == 0)) {
+        // No listed word fits the line (hard constraint: only the empty prefix is left)
+        int bytes = ocr_ctc_greedy(ctc, scores, timesteps, text, text_size, result);
+        beam->fallback = (bytes > 0);
+        return bytes;
+    }
+
+    // Prefix -> UTF-8, whole characters only
+    const ocr_beam_entry_t *e = &beam->beams[best_index];
+    uint32_t bytes = 0, chars = 0;
+    uint8_t truncated = 0;
+    for (uint32_t k = 0; k < e->length; k++) {
+        const uint8_t *utf8 = (const uint8_t*)" ";
+        uint32_t length = 1;
+        if (ctc->space_class == 0 || e->classes[k] != ctc->space_class) {
+            length = ocr_charset_lookup(ctc->charset, e->classes[k] - 1u, &utf8);
+            if (length == 0) {
+                continue;
+            }
+        }
+        if (bytes + length >= text_size) {
+            truncated = 1;
+            break;
+        }
+        memcpy(text + bytes, utf8, length);
+        bytes += length;
+        chars++;
+    }
+    text[bytes] = '\0';
+
+    if (result) {
+        result->chars = (uint16_t)chars;
+        result->bytes = (uint16_t)bytes;
+        result->truncated = truncated;
+        result->confidence = e->length ? e->conf_sum / e->length : 0.0f;
+    }
+    return (int)bytes;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file ocr_beam.h
+ * @brief Lexicon-constrained CTC prefix beam search
+ * @details Keeps the most probable label prefixes (paths ending in a blank
+ *          and in a character tracked apart, so repeats collapse correctly)
+ *          and tries the top classes of every timestep on each. With a
+ *          lexicon, every prefix walks the trie; leaving it, or ending the
+ *          line inside a word, costs a fixed factor, so look-alike kana and
+ *          kanji resolve to the listed word while clear out-of-lexicon text
+ *          still reads. ' ' starts a new word. All state lives in one arena
+ *          sized by the beam width. Platform independent (no HAL dependency)
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#ifndef OCR_BEAM_H
+#define OCR_BEAM_H
+
+#include <stdint.h>
+#include "ocr_ctc.h"
+#include "ocr_lexicon.h"
+
+// Defaults
+#define OCR_BEAM_WIDTH        8       // Prefixes kept (and classes tried) per timestep
+#define OCR_BEAM_MAX_WIDTH    16
+#define OCR_BEAM_MAX_CHARS    63      // Longest prefix (a 64-byte region of 1-byte characters)
+#define OCR_BEAM_MIN_PROB     0.002f  // Classes below this are not tried
+#define OCR_BEAM_OOV_PENALTY  0.05f   // Leaving the lexicon / ending inside a word (0 = hard constraint)
+
+// One prefix
+typedef struct {
+    float p_blank;                  // Paths ending in a blank
+    float p_char;                   // Paths ending in the last class
+    float conf_sum;                 // Probabilities the characters were emitted with
+    uint32_t hash;
+    uint32_t node;                  // Lexicon node, OCR_LEXICON_NONE outside the lexicon
+    uint16_t length;
+    uint16_t classes[OCR_BEAM_MAX_CHARS];
+} ocr_beam_entry_t;
+
+// Prefix candidate of the next timestep: parent prefix plus at most one class
+typedef struct {
+    float p_blank;
+    float p_char;
+    float conf_sum;
+    uint32_t hash;
+    uint32_t node;
+    uint16_t parent;
+    uint16_t label;                 // Appended class, OCR_BEAM_NO_LABEL for the parent itself
+} ocr_beam_candidate_t;
+
+#define OCR_BEAM_NO_LABEL 0xFFFFu
+
+// Beam search state (arena)
+typedef struct {
+    const ocr_ctc_t *ctc;           // Charset, classes and probability LUT
+    const ocr_lexicon_t *lexicon;   // NULL: unconstrained
+    uint16_t width;
+    float min_prob;
+    float oov_penalty;
+
+    ocr_beam_entry_t *beams;        // width entries
+    ocr_beam_entry_t *next;         // width entries
+    ocr_beam_candidate_t *candidates; // width * (width + 1)
+    uint16_t *slots;                // Candidate hash table (power of two)
+    uint16_t slot_mask;
+    uint16_t *top;                  // Classes tried this timestep
+    uint16_t *order;                // Best candidates (selection)
+
+    // Last decode
+    uint8_t fallback;               // No listed word fit the line: greedy result
+} ocr_beam_t;
+
+/**
+ * @brief Get arena size for a beam width
+ * @param width Beam width (1..OCR_BEAM_MAX_WIDTH)
+ * @return Required storage in bytes (worst case of any line), 0 if invalid
+ */
+uint32_t ocr_beam_size(uint16_t width);
+
+/**
+ * @brief Initialize a beam search over a greedy decoder's charset
+ * @param beam Beam search
+ * @param ctc Initialized greedy decoder (classes, charset, probability LUT)
+ * @param lexicon Mapped lexicon, NULL for an unconstrained search
+ * @param width Beam width
+ * @param storage Storage (4-byte aligned, ocr_beam_size() bytes)
+ * @param storage_size Size of storage in bytes
+ * @return 0 on success, negative on error
+ */
+int ocr_beam_init(ocr_beam_t *beam, const ocr_ctc_t *ctc, const ocr_lexicon_t *lexicon,
+                  uint16_t width, void *storage, uint32_t storage_size);
+
+/**
+ * @brief Decode one line
+ * @param beam Beam search
+ * @param scores Output, timestep-major (classes contiguous)
+ * @param timesteps Timesteps
+ * @param text Output string (always terminated)
+ * @param text_size Size of text in bytes (characters are never split)
+ * @param result Decoded line (optional)
+ * @return Bytes written, negative on error
+ */
+int ocr_beam_decode(ocr_beam_t *beam, const int8_t *scores, uint32_t timesteps,
+                    char *text, uint32_t text_size, ocr_ctc_result_t *result);
+
+#endif // OCR_BEAM_H
@@ -0,0 +1,383 @@
+/**
+ * @file ocr_binarize.c
+ * @brief Integral-image adaptive thresholding and contrast normalization
+ * @details Prefix-sum kernels are selected at compile time:
+ *          Helium/MVE (Cortex-M55), NEON and SSE2 (host builds), scalar fallback
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#include "ocr_binarize.h"
+#include "ocr_common.h"
+#include "ocr_simd.h"
+#include <math.h>
+#include <string.h>
+
+// Largest supported window half size
+#define OCR_ADAPTIVE_MAX_RADIUS 63
+
+static inline uint8_t ocr_clamp_u8(float v)
+{
+    if (v <= 0.0f) {
+        return 0;
+    }
+    if (v >= 255.0f) {
+        return 255;
+    }
+    return (uint8_t)(v + 0.5f);
+}
+
+// ========================================================================
+// Integral Image
+// ========================================================================
+
+#if defined(OCR_SIMD_MVE) || defined(OCR_SIMD_NEON)
+
+// Inclusive prefix sum of 4 lanes: two shift-add steps, lanes moving up by
+// one and then two (the _mm_slli_si128 steps of the SSE2 scan)
+static inline uint32x4_t ocr_scan4_u32(uint32x4_t v)
+{
+#if defined(OCR_SIMD_MVE)
+    // Whole-vector shifts by 32 bits, zeros shifted in
+    uint32_t carry = 0;
+    v = vaddq_u32(v, vshlcq_u32(v, &carry, 32));
+    carry = 0;
+    uint32x4_t t = vshlcq_u32(v, &carry, 32);
+    carry = 0;
+    t = vshlcq_u32(t, &carry, 32);
+    return vaddq_u32(v, t);
+#else
+    const uint32x4_t zero = vdupq_n_u32(0);
+    v = vaddq_u32(v, vextq_u32(zero, v, 3));
+    return vaddq_u32(v, vextq_u32(zero, v, 2));
+#endif
+}
+
+#endif
+
+// One integral row: row[x + 1] = prev[x + 1] + sum(src[0..x]), scanned in
+// registers with the previous row added in the same pass
+static void ocr_integral_row(const uint8_t *src, uint32_t width,
+                             const uint32_t *prev, const uint32_t *prev_sq,
+                             uint32_t *row, uint32_t *row_sq)
+{
+    uint32_t x = 0;
+    uint32_t sum = 0, sum_sq = 0;
+
+    row[0] = 0;
+    row_sq[0] = 0;
+
+#if defined(OCR_SIMD_SSE2)
+    // Two shift-add steps turn 4 lanes into prefix sums, the running total
+    // is carried as a broadcast vector
+    const __m128i zero = _mm_setzero_si128();
+    __m128i carry = zero, carry_sq = zero;
+
+    for (; x + 8 <= width; x += 8) {
+        __m128i v16 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src + x)), zero);
+        __m128i sq16 = _mm_mullo_epi16(v16, v16);   // 255^2 fits unsigned 16-bit
+        __m128i v[4] = {
+            _mm_unpacklo_epi16(v16, zero), _mm_unpackhi_epi16(v16, zero),
+            _mm_unpacklo_epi16(sq16, zero), _mm_unpackhi_epi16(sq16, zero)
+        };
+
+        for (int i = 0; i < 4; i++) {
+            v[i] = _mm_add_epi32(v[i], _mm_slli_si128(v[i], 4));
+            v[i] = _mm_add_epi32(v[i], _mm_slli_si128(v[i], 8));
+        }
+        v[0] = _mm_add_epi32(v[0], carry);
+        v[1] = _mm_add_epi32(v[1], _mm_shuffle_epi32(v[0], 0xFF));
+        carry = _mm_shuffle_epi32(v[1], 0xFF);
+        v[2] = _mm_add_epi32(v[2], carry_sq);
+        v[3] = _mm_add_epi32(v[3], _mm_shuffle_epi32(v[2], 0xFF));
+        carry_sq = _mm_shuffle_epi32(v[3], 0xFF);
+
+        _mm_storeu_si128((__m128i*)(row + x + 1),
+                         _mm_add_epi32(v[0], _mm_loadu_si128((const __m128i*)(prev + x + 1))));
+        _mm_storeu_si128((__m128i*)(row + x + 5),
+                         _mm_add_epi32(v[1], _mm_loadu_si128((const __m128i*)(prev + x + 5))));
+        _mm_storeu_si128((__m128i*)(row_sq + x + 1),
+                         _mm_add_epi32(v[2], _mm_loadu_si128((const __m128i*)(prev_sq + x + 1))));
+        _mm_storeu_si128((__m128i*)(row_sq + x + 5),
+                         _mm_add_epi32(v[3], _mm_loadu_si128((const __m128i*)(prev_sq + x + 5))));
+    }
+    sum = (uint32_t)_mm_cvtsi128_si32(carry);
+    sum_sq = (uint32_t)_mm_cvtsi128_si32(carry_sq);
+#elif defined(OCR_SIMD_MVE) || defined(OCR_SIMD_NEON)
+    // Helium and NEON share the ACLE names; the running total is a scalar
+    // added to each scanned vector
+    for (; x + 8 <= width; x += 8) {
+#if defined(OCR_SIMD_MVE)
+        uint32x4_t v[2] = { vldrbq_u32(src + x), vldrbq_u32(src + x + 4) };
+#else
+        uint16x8_t v16 = vmovl_u8(vld1_u8(src + x));
+        uint32x4_t v[2] = { vmovl_u16(vget_low_u16(v16)), vmovl_u16(vget_high_u16(v16)) };
+#endif
+        for (int i = 0; i < 2; i++) {
+            const uint32_t o = x + 4 * i + 1;
+            uint32x4_t sq = ocr_scan4_u32(vmulq_u32(v[i], v[i]));
+            uint32x4_t s = ocr_scan4_u32(v[i]);
+
+            s = vaddq_u32(s, vdupq_n_u32(sum));
+            sq = vaddq_u32(sq, vdupq_n_u32(sum_sq));
+            sum = vgetq_lane_u32(s, 3);
+            sum_sq = vgetq_lane_u32(sq, 3);
+            vst1q_u32(row + o, vaddq_u32(s, vld1q_u32(prev + o)));
+            vst1q_u32(row_sq + o, vaddq_u32(sq, vld1q_u32(prev_sq + o)));
+        }
+    }
+#endif
+
+    // Tail (or the whole row on scalar builds), same single pass
+    for (; x < width; x++) {
+        sum += src[x];
+        sum_sq += (uint32_t)src[x] * src[x];
+        row[x + 1] = prev[x + 1] + sum;
+        row_sq[x + 1] = prev_sq[x + 1] + sum_sq;
+    }
+}
+
+void ocr_integral_image(const uint8_t *src, uint32_t src_stride, uint16_t width, uint16_t height,
+                        uint32_t *integral, uint32_t *integral_sq)
+{
+    const uint32_t stride = (uint32_t)width + 1;
+
+    memset(integral, 0, stride * sizeof(uint32_t));
+    memset(integral_sq, 0, stride * sizeof(uint32_t));
+
+    for (uint32_t y = 0; y < height; y++) {
+        ocr_integral_row(src + y * src_stride, width,
+                         integral + y * stride, integral_sq + y * stride,
+                         integral + (y + 1) * stride, integral_sq + (y + 1) * stride);
+    }
+}
+
+// ========================================================================
+// Adaptive Stage
+// ========================================================================
+
+uint32_t ocr_adaptive_size(uint16_t width, uint8_t radius)
+{
+    uint32_t rows = 2 * (uint32_t)radius + 2;
+    uint32_t luma = ((uint32_t)width * rows + 3) & ~3u;
+    uint32_t integral = ((uint32_t)width + 1) * rows * sizeof(uint32_t);
+
+    return luma + 2 * integral;
+}
+
+int ocr_adaptive_init(ocr_adaptive_t *adaptive, uint16_t width, uint16_t height,
+                      uint8_t mode, uint8_t radius, void *storage, uint32_t storage_size)
+{
+    uint8_t *p = (uint8_t*)storage;
+
+    if (!adaptive || !storage || width == 0 || height == 0 ||
+        mode > OCR_ADAPTIVE_BRADLEY || radius == 0 || radius > OCR_ADAPTIVE_MAX_RADIUS ||
+        storage_size < ocr_adaptive_size(width, radius)) {
+        return -1;
+    }
+
+    memset(adaptive, 0, sizeof(*adaptive));
+    adaptive->width = width;
+    adaptive->height = height;
+    adaptive->mode = mode;
+    adaptive->radius = radius;
+    adaptive->k = (mode == OCR_ADAPTIVE_BRADLEY) ? OCR_ADAPTIVE_BRADLEY_T : OCR_ADAPTIVE_SAUVOLA_K;
+    adaptive->target_std = OCR_ADAPTIVE_TARGET_STD;
+    adaptive->min_std = OCR_ADAPTIVE_MIN_STD;
+    adaptive->ring_rows = (uint16_t)(2 * radius + 2);
+
+    adaptive->luma = p;
+    p += ((uint32_t)width * adaptive->ring_rows + 3) & ~3u;
+    adaptive->integral = (uint32_t*)p;
+    adaptive->integral_sq = adaptive->integral + ((uint32_t)width + 1) * adaptive->ring_rows;
+
+    return 0;
+}
+
+// Integral row y lives in ring slot y % ring_rows. The window of output row y
+// spans integral rows y - r .. y + r + 1, so 2r + 2 slots never overwrite a
+// row that is still needed
+static inline uint32_t ocr_ring_offset(const ocr_adaptive_t *adaptive, uint32_t y)
+{
+    return (y % adaptive->ring_rows) * ((uint32_t)adaptive->width + 1);
+}
+
+// Extend the ring with integral row y + 1 from source row y
+static void ocr_ring_push(ocr_adaptive_t *adaptive, uint32_t y, const uint8_t *src)
+{
+    uint32_t prev = ocr_ring_offset(adaptive, y);
+    uint32_t next = ocr_ring_offset(adaptive, y + 1);
+
+    ocr_integral_row(src, adaptive->width,
+                     adaptive->integral + prev, adaptive->integral_sq + prev,
+                     adaptive->integral + next, adaptive->integral_sq + next);
+}
+
+// Zero integral row 0 before the first push
+static void ocr_ring_reset(ocr_adaptive_t *adaptive)
+{
+    memset(adaptive->integral, 0, ((uint32_t)adaptive->width + 1) * sizeof(uint32_t));
+    memset(adaptive->integral_sq, 0, ((uint32_t)adaptive->width + 1) * sizeof(uint32_t));
+}
+
+// Source rows the ring must hold before output row y can be processed
+static inline uint32_t ocr_window_end(const ocr_adaptive_t *adaptive, uint32_t y)
+{
+    uint32_t y1 = y + adaptive->radius + 1;
+    return (y1 < adaptive->height) ? y1 : adaptive->height;
+}
+
+// Per-row window geometry; reciprocal areas avoid a divide per pixel
+typedef struct {
+    const uint32_t *top;
+    const uint32_t *bottom;
+    const uint32_t *top_sq;
+    const uint32_t *bottom_sq;
+    float inv_area[2 * OCR_ADAPTIVE_MAX_RADIUS + 2]; // Indexed by window width
+} ocr_window_row_t;
+
+static void ocr_window_row(const ocr_adaptive_t *adaptive, uint32_t y, ocr_window_row_t *row)
+{
+    const uint32_t r = adaptive->radius;
+    uint32_t y0 = (y > r) ? y - r : 0;
+    uint32_t y1 = ocr_window_end(adaptive, y);
+
+    row->top = adaptive->integral + ocr_ring_offset(adaptive, y0);
+    row->bottom = adaptive->integral + ocr_ring_offset(adaptive, y1);
+    row->top_sq = adaptive->integral_sq + ocr_ring_offset(adaptive, y0);
+    row->bottom_sq = adaptive->integral_sq + ocr_ring_offset(adaptive, y1);
+
+    for (uint32_t w = 1; w <= 2 * r + 1; w++) {
+        row->inv_area[w] = 1.0f / (float)(w * (y1 - y0));
+    }
+}
+
+// Window mean and standard deviation around (x, row)
+static inline void ocr_window_stats(const ocr_adaptive_t *adaptive, const ocr_window_row_t *row,
+                                    uint32_t x, float *mean, float *std)
+{
+    const uint32_t r = adaptive->radius;
+    uint32_t x0 = (x > r) ? x - r : 0;
+    uint32_t x1 = (x + r + 1 < adaptive->width) ? x + r + 1 : adaptive->width;
+
+    // Modulo 2^32 differences are exact for in-range window sums
+    uint32_t sum = row->bottom[x1] - row->bottom[x0] - row->top[x1] + row->top[x0];
+    uint32_t sum_sq = row->bottom_sq[x1] - row->bottom_sq[x0] - row->top_sq[x1] + row->top_sq[x0];
+    float inv = row->inv_area[x1 - x0];
+    float m = (float)sum * inv;
+    float var = (float)sum_sq * inv - m * m;
+
+    *mean = m;
+    *std = (var > 0.0f) ? sqrtf(var) : 0.0f;
+}
+
+// Binarization decision, or the contrast gain in OCR_ADAPTIVE_CONTRAST mode
+static inline uint8_t ocr_adaptive_threshold(const ocr_adaptive_t *adaptive, uint8_t v,
+                                             float mean, float std)
+{
+    if (adaptive->mode == OCR_ADAPTIVE_SAUVOLA) {
+        float t = mean * (1.0f + adaptive->k * (std / OCR_ADAPTIVE_SAUVOLA_R - 1.0f));
+        return ((float)v > t) ? 255 : 0;
+    }
+    return ((float)v < mean * (1.0f - adaptive->k)) ? 0 : 255;
+}
+
+static inline float ocr_adaptive_gain(const ocr_adaptive_t *adaptive, float std)
+{
+    return adaptive->target_std / ((std > adaptive->min_std) ? std : adaptive->min_std);
+}
+
+void ocr_adaptive_gray(ocr_adaptive_t *adaptive, const uint8_t *src, uint32_t src_stride,
+                       uint8_t *dst, uint32_t dst_stride)
+{
+    ocr_window_row_t row;
+    uint32_t pushed = 0;
+
+    ocr_ring_reset(adaptive);
+
+    for (uint32_t y = 0; y < adaptive->height; y++) {
+        const uint8_t *in = src + y * src_stride;
+        uint8_t *out = dst + y * dst_stride;
+
+        // Integral rows are produced just ahead of the window
+        for (uint32_t end = ocr_window_end(adaptive, y); pushed < end; pushed++) {
+            ocr_ring_push(adaptive, pushed, src + pushed * src_stride);
+        }
+        ocr_window_row(adaptive, y, &row);
+
+        for (uint32_t x = 0; x < adaptive->width; x++) {
+            float mean, std;
+            ocr_window_stats(adaptive, &row, x, &mean, &std);
+
+            if (adaptive->mode == OCR_ADAPTIVE_CONTRAST) {
+                out[x] = ocr_clamp_u8(128.0f + ((float)in[x] - mean) * ocr_adaptive_gain(adaptive, std));
+            } else {
+                out[x] = ocr_adaptive_threshold(adaptive, in[x], mean, std);
+            }
+        }
+    }
+}
+
+void ocr_adaptive_rgb565_to_tensor(ocr_adaptive_t *adaptive, const ocr_tensor_quantizer_t *quantizer,
+                                   const uint16_t *src, uint32_t src_stride, int8_t *tensor)
+{
+    const uint32_t width = adaptive->width;
+    const uint32_t height = adaptive->height;
+    const uint32_t channels = quantizer->channels;
+    const uint32_t px_stride = (quantizer->layout == OCR_TENSOR_LAYOUT_NHWC) ? channels : 1;
+    const uint32_t ch_stride = (quantizer->layout == OCR_TENSOR_LAYOUT_NHWC) ? 1 : width * height;
+    ocr_window_row_t row;
+
+    uint32_t pushed = 0;
+
+    ocr_ring_reset(adaptive);
+
+    for (uint32_t y = 0; y < height; y++) {
+        const uint16_t *in = src + y * src_stride;
+        int8_t *out = tensor + y * width * px_stride;
+
+        // Luma rows are converted once into the ring, just ahead of the
+        // window, and stay there until output row y reads them
+        for (uint32_t end = ocr_window_end(adaptive, y); pushed < end; pushed++) {
+            const uint16_t *row_in = src + pushed * src_stride;
+            uint8_t *row_luma = adaptive->luma + (pushed % adaptive->ring_rows) * width;
+
+            for (uint32_t x = 0; x < width; x++) {
+                row_luma[x] = (uint8_t)ocr_rgb565_luma(row_in[x]);
+            }
+            ocr_ring_push(adaptive, pushed, row_luma);
+        }
+
+        const uint8_t *l = adaptive->luma + (y % adaptive->ring_rows) * width;
+        ocr_window_row(adaptive, y, &row);
+
+        for (uint32_t x = 0; x < width; x++, out += px_stride) {
+            float mean, std;
+            ocr_window_stats(adaptive, &row, x, &mean, &std);
+
+            if (adaptive->mode != OCR_ADAPTIVE_CONTRAST) {
+                uint8_t b = ocr_adaptive_threshold(adaptive, l[x], mean, std);
+                out[0] = quantizer->lut[0][b];
+                if (channels == 3) {
+                    out[ch_stride] = quantizer->lut[1][b];
+                    out[2 * ch_stride] = quantizer->lut[2][b];
+                }
+                continue;
+            }
+
+            // Stretch luma only and keep each channel's chroma offset, so
+            // color is not amplified along with contrast
+            float luma = 128.0f + ((float)l[x] - mean) * ocr_adaptive_gain(adaptive, std);
+
+            if (channels == 1) {
+                out[0] = quantizer->lut[0][ocr_clamp_u8(luma)];
+            } else {
+                uint16_t p = in[x];
+                float chroma = luma - (float)l[x];
+                out[0] = quantizer->lut[0][ocr_clamp_u8(chroma + (float)ocr_expand5(p >> 11))];
+                out[ch_stride] = quantizer->lut[1][ocr_clamp_u8(chroma + (float)ocr_expand6((p >> 5) & 0x3F))];
+                out[2 * ch_stride] = quantizer->lut[2][ocr_clamp_u8(chroma + (float)ocr_expand5(p & 0x1F))];
+            }
+        }
+    }
+}
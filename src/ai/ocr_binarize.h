@@ -0,0 +1,110 @@
+/**
+ * @file ocr_binarize.h
+ * @brief Integral-image adaptive thresholding and contrast normalization
+ * @details Sauvola / Bradley binarization and local contrast stretching with
+ *          O(1) window statistics. Platform independent (no HAL dependency)
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#ifndef OCR_BINARIZE_H
+#define OCR_BINARIZE_H
+
+#include <stdint.h>
+#include "ocr_preprocess.h"
+
+// Adaptive stage modes
+typedef enum {
+    OCR_ADAPTIVE_CONTRAST = 0,      // Local mean/std luma stretch (keeps chroma)
+    OCR_ADAPTIVE_SAUVOLA,           // T = m * (1 + k * (s / R - 1))
+    OCR_ADAPTIVE_BRADLEY            // Dark if v < m * (1 - t)
+} ocr_adaptive_mode_t;
+
+// Default window and mode parameters
+#define OCR_ADAPTIVE_RADIUS       7     // 15x15 window at detection resolution
+#define OCR_ADAPTIVE_SAUVOLA_K    0.2f
+#define OCR_ADAPTIVE_SAUVOLA_R    128.0f
+#define OCR_ADAPTIVE_BRADLEY_T    0.15f
+#define OCR_ADAPTIVE_TARGET_STD   48.0f // Contrast stretch output std
+#define OCR_ADAPTIVE_MIN_STD      8.0f  // Gain limit on flat regions (noise)
+
+// Adaptive stage state and working buffers
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint8_t mode;                   // ocr_adaptive_mode_t
+    uint8_t radius;                 // Window half size
+    float k;                        // Sauvola k / Bradley t
+    float target_std;               // Contrast stretch output std
+    float min_std;                  // Contrast stretch std floor
+    uint16_t ring_rows;             // 2 * radius + 2 rows held at a time
+    uint8_t *luma;                  // ring_rows * width luma rows
+    uint32_t *integral;             // ring_rows * (width + 1), modulo 2^32
+    uint32_t *integral_sq;          // Squared integral ring, modulo 2^32
+} ocr_adaptive_t;
+
+/**
+ * @brief Get storage required for the adaptive stage
+ * @param width Image width
+ * @param radius Window half size
+ * @return Required storage in bytes
+ * @details Integral rows are kept in a ring of 2 * radius + 2 rows, so the
+ *          cost does not depend on the image height (about 46 KB at 320 wide
+ *          with the default radius)
+ */
+uint32_t ocr_adaptive_size(uint16_t width, uint8_t radius);
+
+/**
+ * @brief Initialize the adaptive stage with default parameters for a mode
+ * @param adaptive Stage to initialize
+ * @param width Image width
+ * @param height Image height
+ * @param mode Stage mode (ocr_adaptive_mode_t)
+ * @param radius Window half size (window is 2 * radius + 1 square)
+ * @param storage Storage (4-byte aligned, ocr_adaptive_size(width, radius) bytes)
+ * @param storage_size Size of storage in bytes
+ * @return 0 on success, negative on error
+ */
+int ocr_adaptive_init(ocr_adaptive_t *adaptive, uint16_t width, uint16_t height,
+                      uint8_t mode, uint8_t radius, void *storage, uint32_t storage_size);
+
+/**
+ * @brief Compute integral and squared-integral images of an 8-bit plane
+ * @param src Source plane
+ * @param src_stride Source row stride in bytes
+ * @param width Plane width
+ * @param height Plane height
+ * @param integral Output (width + 1) * (height + 1) sums, first row/column zero
+ * @param integral_sq Output squared sums (same layout)
+ * @details Row prefix sums are scanned in SIMD registers and added to the
+ *          previous row in the same pass. Values wrap modulo 2^32; window
+ *          differences stay exact while the true window sum fits 32 bits
+ */
+void ocr_integral_image(const uint8_t *src, uint32_t src_stride, uint16_t width, uint16_t height,
+                        uint32_t *integral, uint32_t *integral_sq);
+
+/**
+ * @brief Apply the adaptive stage to an 8-bit plane
+ * @param adaptive Adaptive stage
+ * @param src Source plane (width x height)
+ * @param src_stride Source row stride in bytes
+ * @param dst Output plane (binary 0/255 or stretched)
+ * @param dst_stride Output row stride in bytes
+ */
+void ocr_adaptive_gray(ocr_adaptive_t *adaptive, const uint8_t *src, uint32_t src_stride,
+                       uint8_t *dst, uint32_t dst_stride);
+
+/**
+ * @brief Apply the adaptive stage to an RGB565 image and quantize into a tensor
+ * @param adaptive Adaptive stage (geometry must match the quantizer)
+ * @param quantizer Tensor quantizer
+ * @param src Source image (RGB565, tensor resolution)
+ * @param src_stride Source row stride in pixels
+ * @param tensor Output int8 tensor
+ * @details Statistics come from the luma plane; contrast mode stretches luma
+ *          and keeps per-channel chroma offsets, binarization modes replicate 0/255
+ */
+void ocr_adaptive_rgb565_to_tensor(ocr_adaptive_t *adaptive, const ocr_tensor_quantizer_t *quantizer,
+                                   const uint16_t *src, uint32_t src_stride, int8_t *tensor);
+
+#endif // OCR_BINARIZE_H
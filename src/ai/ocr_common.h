@@ -0,0 +1,38 @@
+/**
+ * @file ocr_common.h
+ * @brief Small helpers shared by the OCR modules
+ * @details Internal header: scratch size alignment and the RGB565 / BT.601
+ *          luma conversion every kernel must agree on. Platform independent
+ *          (no HAL dependency)
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#ifndef OCR_COMMON_H
+#define OCR_COMMON_H
+
+#include <stdint.h>
+
+// BT.601 luma weights (sum = 256)
+#define LUMA_R 77
+#define LUMA_G 150
+#define LUMA_B 29
+
+// Round a scratch or storage size up to 4-byte alignment
+static inline uint32_t ocr_align4(uint32_t size)
+{
+    return (size + 3) & ~3u;
+}
+
+// Expand RGB565 fields to 8-bit by bit replication
+static inline uint8_t ocr_expand5(uint32_t v) { return (uint8_t)((v << 3) | (v >> 2)); }
+static inline uint8_t ocr_expand6(uint32_t v) { return (uint8_t)((v << 2) | (v >> 4)); }
+
+// 8-bit luma of an RGB565 pixel
+static inline uint32_t ocr_rgb565_luma(uint16_t p)
+{
+    return (LUMA_R * ocr_expand5(p >> 11) + LUMA_G * ocr_expand6((p >> 5) & 0x3F) +
+            LUMA_B * ocr_expand5(p & 0x1F)) >> 8;
+}
+
+#endif // OCR_COMMON_H
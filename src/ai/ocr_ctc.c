@@ -0,0 +1,318 @@
+/**
+ * @file ocr_ctc.c
+ * @brief CTC decoding of the int8 recognition output and the UTF-8 charset
+ * @details The argmax block test is selected at compile time:
+ *          Helium/MVE (Cortex-M55), NEON (AArch64) and SSE2 (host builds),
+ *          scalar fallback
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#include "ocr_ctc.h"
+#include "ocr_common.h"
+#include "ocr_simd.h"
+#include <string.h>
+#include <math.h>
+
+// Classes tested per SIMD block
+#define OCR_CTC_LANES 16
+
+// ========================================================================
+// Charset
+// ========================================================================
+
+static uint32_t ocr_charset_count(const uint8_t *data, uint32_t data_size)
+{
+    uint32_t lines = 0;
+
+    for (uint32_t i = 0; i < data_size; i++) {
+        lines += (data[i] == '\n');
+    }
+    // Last line without a line feed
+    return lines + (data_size > 0 && data[data_size - 1] != '\n');
+}
+
+// Length of the line at offset, without its line end
+static uint32_t ocr_charset_line(const uint8_t *data, uint32_t data_size, uint32_t offset)
+{
+    const uint8_t *end = memchr(data + offset, '\n', data_size - offset);
+    uint32_t length = end ? (uint32_t)(end - data) - offset : data_size - offset;
+
+    if (length > 0 && data[offset + length - 1] == '\r') {
+        length--;
+    }
+    return length;
+}
+
+uint32_t ocr_charset_size(const uint8_t *data, uint32_t data_size)
+{
+    if (!data) {
+        return 0;
+    }
+    uint32_t count = ocr_charset_count(data, data_size);
+    return ocr_align4(((count + OCR_CHARSET_BLOCK - 1) / OCR_CHARSET_BLOCK) * sizeof(uint32_t));
+}
+
+int ocr_charset_init(ocr_charset_t *charset, const uint8_t *data, uint32_t data_size,
+                     void *storage, uint32_t storage_size)
+{
+    if (!charset || !data || !storage) {
+        return -1;
+    }
+    uint32_t count = ocr_charset_count(data, data_size);
+    if (count == 0 || count > UINT16_MAX || storage_size < ocr_charset_size(data, data_size)) {
+        return -1;
+    }
+
+    charset->data = data;
+    charset->data_size = data_size;
+    charset->count = (uint16_t)count;
+    charset->blocks = (uint32_t*)storage;
+
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t length = ocr_charset_line(data, data_size, offset);
+        if (length == 0) {
+            return -1;
+        }
+        if (i % OCR_CHARSET_BLOCK == 0) {
+            charset->blocks[i / OCR_CHARSET_BLOCK] = offset;
+        }
+        const uint8_t *end = memchr(data + offset, '\n', data_size - offset);
+        offset = end ? (uint32_t)(end - data) + 1 : data_size;
+    }
+    return 0;
+}
+
+uint32_t ocr_charset_lookup(const ocr_charset_t *charset, uint32_t index, const uint8_t **utf8)
+{
+    if (index >= charset->count) {
+        return 0;
+    }
+
+    uint32_t offset = charset->blocks[index / OCR_CHARSET_BLOCK];
+    for (uint32_t skip = index % OCR_CHARSET_BLOCK; skip > 0; skip--) {
+        const uint8_t *end = memchr(charset->data + offset, '\n', charset->data_size - offset);
+        offset = (uint32_t)(end - charset->data) + 1;
+    }
+    *utf8 = charset->data + offset;
+    return ocr_charset_line(charset->data, charset->data_size, offset);
+}
+
+int32_t ocr_charset_find(const ocr_charset_t *charset, const uint8_t *utf8, uint32_t length)
+{
+    uint32_t offset = 0;
+
+    for (uint32_t i = 0; i < charset->count; i++) {
+        uint32_t entry = ocr_charset_line(charset->data, charset->data_size, offset);
+        if (entry == length && memcmp(charset->data + offset, utf8, length) == 0) {
+            return (int32_t)i;
+        }
+        const uint8_t *end = memchr(charset->data + offset, '\n', charset->data_size - offset);
+        offset = (uint32_t)(end - charset->data) + 1;
+    }
+    return -1;
+}
+
+// ========================================================================
+// Greedy Decoder
+// ========================================================================
+
+int ocr_ctc_init(ocr_ctc_t *ctc, const ocr_charset_t *charset, uint16_t classes,
+                 uint8_t output, float scale, int32_t zero_point)
+{
+    if (!ctc || !charset || charset->count == 0 || scale <= 0.0f ||
+        classes < charset->count + 1u || classes > charset->count + 2u) {
+        return -1;
+    }
+
+    ctc->charset = charset;
+    ctc->classes = classes;
+    ctc->blank = OCR_CTC_BLANK;
+    ctc->space_class = (classes == charset->count + 2u) ? (uint16_t)(charset->count + 1u) : 0;
+    ctc->output = output;
+
+    // All exponentials happen here, decoding is table lookups only
+    for (uint32_t i = 0; i < 256; i++) {
+        float p;
+        if (output == OCR_CTC_OUTPUT_PROBS) {
+            p = ((int32_t)i - 128 - zero_point) * scale;
+            p = (p < 0.0f) ? 0.0f : ((p > 1.0f) ? 1.0f : p);
+        } else {
+            p = expf(-(float)i * scale);
+        }
+        ctc->prob_q16[i] = (uint32_t)(p * (1u << OCR_CTC_PROB_SHIFT) + 0.5f);
+    }
+    return 0;
+}
+
+#if defined(OCR_SIMD_MVE)
+
+static inline uint32_t ocr_ctc_block_exceeds(const int8_t *p, int8_t best)
+{
+    return vmaxvq_s8(best, vld1q_s8(p)) > best;
+}
+
+#elif defined(OCR_SIMD_NEON_A64)
+
+static inline uint32_t ocr_ctc_block_exceeds(const int8_t *p, int8_t best)
+{
+    return vmaxvq_s8(vld1q_s8(p)) > best;
+}
+
+#elif defined(OCR_SIMD_SSE2)
+
+static inline uint32_t ocr_ctc_block_exceeds(const int8_t *p, int8_t best)
+{
+    __m128i v = _mm_loadu_si128((const __m128i*)p);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpgt_epi8(v, _mm_set1_epi8(best)));
+}
+
+#else
+
+static inline uint32_t ocr_ctc_block_exceeds(const int8_t *p, int8_t best)
+{
+    for (uint32_t i = 0; i < OCR_CTC_LANES; i++) {
+        if (p[i] > best) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#endif
+
+uint32_t ocr_ctc_argmax(const int8_t *scores, uint32_t classes)
+{
+    const uint32_t blocks_end = classes - classes % OCR_CTC_LANES;
+    int8_t best = scores[0];
+    uint32_t index = 0;
+
+    // Most blocks hold nothing above the running maximum and cost one compare
+    for (uint32_t block = 0; block < blocks_end; block += OCR_CTC_LANES) {
+        if (!ocr_ctc_block_exceeds(scores + block, best)) {
+            continue;
+        }
+        for (uint32_t c = block; c < block + OCR_CTC_LANES; c++) {
+            if (scores[c] > best) {
+                best = scores[c];
+                index = c;
+            }
+        }
+    }
+    for (uint32_t c = blocks_end; c < classes; c++) {
+        if (scores[c] > best) {
+            best = scores[c];
+            index = c;
+        }
+    }
+    return index;
+}
+
+// Insert a class into the sorted top list (full list: replaces the smallest)
+static uint32_t ocr_ctc_topk_insert(const int8_t *scores, uint16_t *top, uint32_t count,
+                                    uint32_t k, uint32_t c)
+{
+    uint32_t pos = (count < k) ? count : k - 1;
+
+    while (pos > 0 && scores[top[pos - 1]] < scores[c]) {
+        if (pos < k) {
+            top[pos] = top[pos - 1];
+        }
+        pos--;
+    }
+    top[pos] = (uint16_t)c;
+    return (count < k) ? count + 1 : count;
+}
+
+uint32_t ocr_ctc_topk(const int8_t *scores, uint32_t classes, uint32_t k, uint16_t *top)
+{
+    const uint32_t blocks_end = classes - classes % OCR_CTC_LANES;
+    uint32_t count = 0;
+
+    if (k == 0) {
+        return 0;
+    }
+    for (uint32_t block = 0; block < classes; block += OCR_CTC_LANES) {
+        uint32_t end = (block < blocks_end) ? block + OCR_CTC_LANES : classes;
+
+        // Full list: only values above its smallest can enter
+        if (count == k && block < blocks_end && !ocr_ctc_block_exceeds(scores + block, scores[top[k - 1]])) {
+            continue;
+        }
+        for (uint32_t c = block; c < end; c++) {
+            if (count < k || scores[c] > scores[top[k - 1]]) {
+                count = ocr_ctc_topk_insert(scores, top, count, k, c);
+            }
+        }
+    }
+    return count;
+}
+
+// Probability of the winning class (Q16)
+static uint32_t ocr_ctc_prob(const ocr_ctc_t *ctc, const int8_t *scores, int8_t best)
+{
+    if (ctc->output == OCR_CTC_OUTPUT_PROBS) {
+        return ctc->prob_q16[best + 128];
+    }
+
+    // softmax(max) = 1 / sum(exp(logit - max)); the maximum itself adds 1.0
+    uint32_t sum = 0;
+    for (uint32_t c = 0; c < ctc->classes; c++) {
+        sum += ctc->prob_q16[best - scores[c]];
+    }
+    return (uint32_t)(((uint64_t)1 << (2 * OCR_CTC_PROB_SHIFT)) / sum);
+}
+
+int ocr_ctc_greedy(const ocr_ctc_t *ctc, const int8_t *scores, uint32_t timesteps,
+                   char *text, uint32_t text_size, ocr_ctc_result_t *result)
+{
+    if (!ctc || !scores || !text || text_size == 0) {
+        return -1;
+    }
+
+    const uint32_t classes = ctc->classes;
+    uint32_t prev = ctc->blank;
+    uint32_t bytes = 0, chars = 0;
+    uint64_t prob_sum = 0;
+    uint8_t truncated = 0;
+
+    for (uint32_t t = 0; t < timesteps; t++) {
+        const int8_t *step = scores + t * classes;
+        uint32_t c = ocr_ctc_argmax(step, classes);
+
+        // Blanks separate repeats; a repeated class is one character
+        if (c == ctc->blank || c == prev) {
+            prev = c;
+            continue;
+        }
+        prev = c;
+
+        const uint8_t *utf8 = (const uint8_t*)" ";
+        uint32_t length = 1;
+        if (ctc->space_class == 0 || c != ctc->space_class) {
+            length = ocr_charset_lookup(ctc->charset, c - 1, &utf8);
+            if (length == 0) {
+                continue;
+            }
+        }
+        // Whole characters only, terminator always fits
+        if (bytes + length >= text_size) {
+            truncated = 1;
+            break;
+        }
+        memcpy(text + bytes, utf8, length);
+        bytes += length;
+        chars++;
+        prob_sum += ocr_ctc_prob(ctc, step, step[c]);
+    }
+    text[bytes] = '\0';
+
+    if (result) {
+        result->chars = (uint16_t)chars;
+        result->bytes = (uint16_t)bytes;
+        result->truncated = truncated;
+        result->confidence = chars ? (float)prob_sum / (float)chars / (1u << OCR_CTC_PROB_SHIFT) : 0.0f;
+    }
+    return (int)bytes;
+}
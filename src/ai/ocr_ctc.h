@@ -0,0 +1,144 @@
+/**
+ * @file ocr_ctc.h
+ * @brief CTC decoding of the int8 recognition output and the UTF-8 charset
+ * @details The charset is the PP-OCR dictionary file as stored in flash (one
+ *          UTF-8 character per line), read in place through a small block
+ *          index. Greedy decoding takes the per-timestep argmax straight on
+ *          the int8 output, collapses blanks and repeats and scores the line
+ *          through a 256-entry probability LUT. No heap allocation.
+ *          Platform independent (no HAL dependency)
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#ifndef OCR_CTC_H
+#define OCR_CTC_H
+
+#include <stdint.h>
+
+// Defaults
+#define OCR_CHARSET_BLOCK     16    // Entries per index block (a lookup skips at most 15 lines)
+#define OCR_CTC_BLANK         0     // PP-OCR: class 0 is the CTC blank, class i is entry i - 1
+#define OCR_CTC_PROB_SHIFT    16    // Probabilities in Q16
+
+// Recognition output kind (PP-OCR exports end in a softmax)
+typedef enum {
+    OCR_CTC_OUTPUT_LOGITS = 0,      // Raw scores: softmax of the maximum through an exp LUT
+    OCR_CTC_OUTPUT_PROBS            // Softmax already applied: the maximum is the probability
+} ocr_ctc_output_t;
+
+// Dictionary read in place (flash-mapped)
+typedef struct {
+    const uint8_t *data;            // One UTF-8 entry per line ('\n', optional '\r')
+    uint32_t data_size;
+    uint16_t count;                 // Entries
+    uint32_t *blocks;               // Byte offset of every OCR_CHARSET_BLOCK-th entry
+} ocr_charset_t;
+
+// Greedy CTC decoder
+typedef struct {
+    const ocr_charset_t *charset;
+    uint16_t classes;               // Output classes per timestep
+    uint16_t blank;
+    uint16_t space_class;           // ' ' after the dictionary (use_space_char), 0 = none
+    uint8_t output;                 // ocr_ctc_output_t
+    uint32_t prob_q16[256];         // LOGITS: exp(-d * scale) for d = max - logit
+                                    // PROBS: dequantized probability of q + 128
+} ocr_ctc_t;
+
+// Decoded line
+typedef struct {
+    uint16_t chars;                 // Characters written
+    uint16_t bytes;                 // UTF-8 bytes written (excluding the terminator)
+    uint8_t truncated;              // Text buffer full: remaining characters dropped
+    float confidence;               // Mean probability of the written characters
+} ocr_ctc_result_t;
+
+/**
+ * @brief Get storage required for a charset index
+ * @param data Dictionary file
+ * @param data_size Size of the dictionary in bytes
+ * @return Required storage in bytes, 0 for an empty dictionary
+ */
+uint32_t ocr_charset_size(const uint8_t *data, uint32_t data_size);
+
+/**
+ * @brief Index a dictionary in place
+ * @param charset Charset
+ * @param data Dictionary file (must outlive the charset)
+ * @param data_size Size of the dictionary in bytes
+ * @param storage Storage (4-byte aligned, ocr_charset_size() bytes)
+ * @param storage_size Size of storage in bytes
+ * @return 0 on success, negative on error (empty entry or more than 65535)
+ */
+int ocr_charset_init(ocr_charset_t *charset, const uint8_t *data, uint32_t data_size,
+                     void *storage, uint32_t storage_size);
+
+/**
+ * @brief Look up one entry
+ * @param charset Charset
+ * @param index Entry index (0-based, line number in the dictionary)
+ * @param utf8 Entry bytes (not terminated)
+ * @return Entry length in bytes, 0 if out of range
+ */
+uint32_t ocr_charset_lookup(const ocr_charset_t *charset, uint32_t index, const uint8_t **utf8);
+
+/**
+ * @brief Find the entry of one character
+ * @param charset Charset
+ * @param utf8 Character bytes
+ * @param length Character length in bytes
+ * @return Entry index, negative if the dictionary does not hold it
+ * @details Linear scan of the dictionary: for word lists at startup or on the host
+ */
+int32_t ocr_charset_find(const ocr_charset_t *charset, const uint8_t *utf8, uint32_t length);
+
+/**
+ * @brief Initialize a greedy decoder
+ * @param ctc Decoder
+ * @param charset Charset (classes: blank, the entries, optionally ' ')
+ * @param classes Output classes per timestep
+ * @param output ocr_ctc_output_t
+ * @param scale Output quantization scale
+ * @param zero_point Output quantization zero point (PROBS only, softmax is shift invariant)
+ * @return 0 on success, negative if the class count does not fit the charset
+ */
+int ocr_ctc_init(ocr_ctc_t *ctc, const ocr_charset_t *charset, uint16_t classes,
+                 uint8_t output, float scale, int32_t zero_point);
+
+/**
+ * @brief Class with the largest output of one timestep
+ * @param scores Class outputs
+ * @param classes Number of classes
+ * @return Index of the first maximum
+ * @details 16-lane compare against the running maximum; only blocks that
+ *          raise it are rescanned
+ */
+uint32_t ocr_ctc_argmax(const int8_t *scores, uint32_t classes);
+
+/**
+ * @brief Classes with the largest outputs of one timestep
+ * @param scores Class outputs
+ * @param classes Number of classes
+ * @param k Classes wanted
+ * @param top Output classes, largest first (ties: lower class first)
+ * @return Classes written (min(k, classes))
+ * @details Blocks with nothing above the k-th largest so far are skipped
+ *          with the argmax block test
+ */
+uint32_t ocr_ctc_topk(const int8_t *scores, uint32_t classes, uint32_t k, uint16_t *top);
+
+/**
+ * @brief Greedy CTC decoding into a UTF-8 string
+ * @param ctc Decoder
+ * @param scores Output, timestep-major (classes contiguous)
+ * @param timesteps Timesteps
+ * @param text Output string (always terminated)
+ * @param text_size Size of text in bytes (characters are never split)
+ * @param result Decoded line (optional)
+ * @return Bytes written, negative on error
+ */
+int ocr_ctc_greedy(const ocr_ctc_t *ctc, const int8_t *scores, uint32_t timesteps,
+                   char *text, uint32_t text_size, ocr_ctc_result_t *result);
+
+#endif // OCR_CTC_H
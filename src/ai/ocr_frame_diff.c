@@ -0,0 +1,212 @@
+/**
+ * @file ocr_frame_diff.c
+ * @brief Frame change detection for the OCR pipeline
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#include "ocr_frame_diff.h"
+#include "ocr_common.h"
+#include <string.h>
+
+void ocr_frame_signature_compute(const uint16_t *src, uint32_t src_stride,
+                                 uint16_t width, uint16_t height,
+                                 ocr_frame_signature_t *signature)
+{
+    const uint32_t step = OCR_SIGNATURE_SAMPLE_STEP;
+    uint32_t frame_sum = 0;
+
+    for (uint32_t by = 0; by < OCR_SIGNATURE_GRID_H; by++) {
+        uint32_t y0 = by * height / OCR_SIGNATURE_GRID_H;
+        uint32_t y1 = (by + 1) * height / OCR_SIGNATURE_GRID_H;
+
+        for (uint32_t bx = 0; bx < OCR_SIGNATURE_GRID_W; bx++) {
+            uint32_t x0 = bx * width / OCR_SIGNATURE_GRID_W;
+            uint32_t x1 = (bx + 1) * width / OCR_SIGNATURE_GRID_W;
+            uint32_t sum = 0;
+            uint32_t count = 0;
+
+            // Sample the middle of each STEP x STEP cell
+            for (uint32_t y = y0 + step / 2; y < y1; y += step) {
+                const uint16_t *row = src + y * src_stride;
+                for (uint32_t x = x0 + step / 2; x < x1; x += step) {
+                    sum += ocr_rgb565_luma(row[x]);
+                    count++;
+                }
+            }
+
+            // Blocks narrower than the step fall back to their top-left pixel
+            if (count == 0) {
+                sum = ocr_rgb565_luma(src[y0 * src_stride + x0]);
+                count = 1;
+            }
+
+            uint8_t mean = (uint8_t)((sum + count / 2) / count);
+            signature->luma[by * OCR_SIGNATURE_GRID_W + bx] = mean;
+            frame_sum += mean;
+        }
+    }
+
+    signature->mean_luma = (uint8_t)((frame_sum + OCR_SIGNATURE_BLOCKS / 2) / OCR_SIGNATURE_BLOCKS);
+    signature->valid = 1;
+}
+
+void ocr_frame_signature_compare(const ocr_frame_signature_t *reference,
+                                 const ocr_frame_signature_t *current,
+                                 uint8_t block_threshold, ocr_signature_delta_t *delta)
+{
+    int32_t shift = (int32_t)current->mean_luma - (int32_t)reference->mean_luma;
+
+    memset(delta, 0, sizeof(*delta));
+    delta->brightness_shift = (int8_t)(shift < -128 ? -128 : (shift > 127 ? 127 : shift));
+
+    for (uint32_t i = 0; i < OCR_SIGNATURE_BLOCKS; i++) {
+        int32_t d = (int32_t)current->luma[i] - (int32_t)reference->luma[i] - shift;
+        uint32_t ad = (uint32_t)(d < 0 ? -d : d);
+
+        if (ad > 255) {
+            ad = 255;
+        }
+        delta->sum_abs_diff += ad;
+        if (ad > delta->max_diff) {
+            delta->max_diff = (uint8_t)ad;
+        }
+        if (ad > block_threshold) {
+            delta->changed_blocks++;
+        }
+    }
+}
+
+// ========================================================================
+// Dirty Tiles
+// ========================================================================
+
+uint32_t ocr_tile_map_size(uint16_t tiles_x, uint16_t tiles_y)
+{
+    uint32_t tiles = (uint32_t)tiles_x * tiles_y;
+
+    return ocr_align4(2 * (tiles_x + tiles_y) * sizeof(uint16_t)) +
+           ocr_align4(tiles * OCR_TILE_GRID * OCR_TILE_GRID) +
+           ((tiles + 31) / 32) * sizeof(uint32_t);
+}
+
+int ocr_tile_map_init(ocr_tile_map_t *map, uint16_t tile_size, uint16_t tiles_x, uint16_t tiles_y,
+                      uint8_t threshold, void *storage, uint32_t storage_size)
+{
+    uint32_t tiles = (uint32_t)tiles_x * tiles_y;
+    uint8_t *p = (uint8_t*)storage;
+
+    if (!map || !storage || tile_size == 0 || tiles == 0 ||
+        storage_size < ocr_tile_map_size(tiles_x, tiles_y)) {
+        return -1;
+    }
+
+    memset(map, 0, sizeof(*map));
+    memset(storage, 0, ocr_tile_map_size(tiles_x, tiles_y));
+    map->tile_size = tile_size;
+    map->tiles_x = tiles_x;
+    map->tiles_y = tiles_y;
+    map->threshold = threshold;
+    map->refresh_interval = OCR_TILE_REFRESH_INTERVAL;
+
+    map->src_x0 = (uint16_t*)p;
+    map->src_x1 = map->src_x0 + tiles_x;
+    map->src_y0 = map->src_x1 + tiles_x;
+    map->src_y1 = map->src_y0 + tiles_y;
+    p += ocr_align4(2 * (tiles_x + tiles_y) * sizeof(uint16_t));
+    map->cells = p;
+    p += ocr_align4(tiles * OCR_TILE_GRID * OCR_TILE_GRID);
+    map->dirty = (uint32_t*)p;
+
+    return 0;
+}
+
+void ocr_tile_map_invalidate(ocr_tile_map_t *map)
+{
+    map->valid = 0;
+}
+
+uint8_t ocr_tile_map_is_dirty(const ocr_tile_map_t *map, uint32_t tile_x, uint32_t tile_y)
+{
+    uint32_t i = tile_y * map->tiles_x + tile_x;
+    return (uint8_t)((map->dirty[i >> 5] >> (i & 31)) & 1);
+}
+
+uint32_t ocr_tile_map_update(ocr_tile_map_t *map, const uint16_t *src, uint32_t src_stride)
+{
+    const uint32_t step = OCR_TILE_SAMPLE_STEP;
+    const uint32_t grid = OCR_TILE_GRID;
+    uint8_t cells[OCR_TILE_GRID * OCR_TILE_GRID];
+    uint32_t dirty_count = 0;
+    uint32_t samples = 0;
+
+    memset(map->dirty, 0, (((uint32_t)map->tiles_x * map->tiles_y + 31) / 32) * sizeof(uint32_t));
+
+    // Backstop for changes finer than a cell: rebuild every tile now and then
+    if (map->refresh_interval && ++map->frames_since_refresh >= map->refresh_interval) {
+        map->valid = 0;
+    }
+    if (!map->valid) {
+        map->frames_since_refresh = 0;
+    }
+
+    for (uint32_t ty = 0; ty < map->tiles_y; ty++) {
+        const uint32_t y0 = map->src_y0[ty];
+        const uint32_t y1 = map->src_y1[ty];
+        const uint32_t rows = (y1 > y0) ? (y1 - y0 + step - 1) / step : 0;
+
+        for (uint32_t tx = 0; tx < map->tiles_x; tx++) {
+            const uint32_t x0 = map->src_x0[tx];
+            const uint32_t x1 = map->src_x1[tx];
+            const uint32_t cols = (x1 > x0) ? (x1 - x0 + step - 1) / step : 0;
+            const uint32_t i = ty * map->tiles_x + tx;
+            uint8_t *stored = map->cells + i * grid * grid;
+            uint32_t max_delta = 0;
+
+            // Padding-only tiles never change
+            if (cols == 0 || rows == 0) {
+                continue;
+            }
+
+            // Cell means over the sampled footprint (cells are empty when
+            // the footprint has fewer samples than cells)
+            for (uint32_t cy = 0; cy < grid; cy++) {
+                const uint32_t r0 = cy * rows / grid;
+                const uint32_t r1 = (cy + 1) * rows / grid;
+
+                for (uint32_t cx = 0; cx < grid; cx++) {
+                    const uint32_t c0 = cx * cols / grid;
+                    const uint32_t c1 = (cx + 1) * cols / grid;
+                    const uint32_t count = (r1 - r0) * (c1 - c0);
+                    uint32_t sum = 0;
+
+                    for (uint32_t r = r0; r < r1; r++) {
+                        const uint16_t *row = src + (y0 + r * step) * src_stride + x0;
+                        for (uint32_t c = c0; c < c1; c++) {
+                            sum += ocr_rgb565_luma(row[c * step]);
+                        }
+                    }
+
+                    uint8_t mean = count ? (uint8_t)((sum + count / 2) / count) : 0;
+                    int32_t d = (int32_t)mean - stored[cy * grid + cx];
+                    cells[cy * grid + cx] = mean;
+                    d = (d < 0) ? -d : d;
+                    max_delta = ((uint32_t)d > max_delta) ? (uint32_t)d : max_delta;
+                    samples += count;
+                }
+            }
+
+            if (!map->valid || max_delta > map->threshold) {
+                map->dirty[i >> 5] |= 1u << (i & 31);
+                memcpy(stored, cells, sizeof(cells));
+                dirty_count++;
+            }
+        }
+    }
+
+    map->full_refresh = !map->valid;
+    map->valid = 1;
+    map->dirty_count = (uint16_t)dirty_count;
+    map->bytes_scanned = samples * sizeof(uint16_t);
+    return dirty_count;
+}
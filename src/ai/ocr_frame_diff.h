@@ -0,0 +1,158 @@
+/**
+ * @file ocr_frame_diff.h
+ * @brief Frame change detection for the OCR pipeline
+ * @details Cheap block-mean luma signatures used to skip OCR on static scenes,
+ *          and per-tile signatures for dirty-tile preprocessing.
+ *          Platform independent (no HAL dependency)
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#ifndef OCR_FRAME_DIFF_H
+#define OCR_FRAME_DIFF_H
+
+#include <stdint.h>
+
+// Signature grid (blocks across the whole frame)
+#define OCR_SIGNATURE_GRID_W   16
+#define OCR_SIGNATURE_GRID_H   12
+#define OCR_SIGNATURE_BLOCKS   (OCR_SIGNATURE_GRID_W * OCR_SIGNATURE_GRID_H)
+
+// Pixel sampling step inside a block (1 of every STEP x STEP pixels)
+#define OCR_SIGNATURE_SAMPLE_STEP 4
+
+// Per-frame signature
+typedef struct {
+    uint8_t luma[OCR_SIGNATURE_BLOCKS]; // Block-mean luma (0..255)
+    uint8_t mean_luma;              // Frame-mean luma
+    uint8_t valid;                  // Signature computed
+} ocr_frame_signature_t;
+
+// Difference between two signatures
+typedef struct {
+    uint32_t sum_abs_diff;          // Sum of per-block deltas (global shift removed)
+    uint16_t changed_blocks;        // Blocks whose delta exceeds the threshold
+    uint8_t max_diff;               // Largest per-block delta
+    int8_t brightness_shift;        // Frame-mean delta (auto exposure drift)
+} ocr_signature_delta_t;
+
+// Default dirty-tile edge in tensor pixels
+#define OCR_TILE_SIZE 16
+
+// Pixel sampling step inside a tile footprint
+#define OCR_TILE_SAMPLE_STEP 2
+
+// Signature cells per tile edge (cell-mean luma of the sampled footprint;
+// 4x4 samples per cell at 16-pixel tiles of a 2x plan, so noise averages out)
+#define OCR_TILE_GRID 4
+
+// Frames between forced full refreshes (backstop for sub-cell changes)
+#define OCR_TILE_REFRESH_INTERVAL 30
+
+// Dirty-tile map over a preprocessed tensor
+// Per-tile signatures cover the source footprint of each tensor tile
+typedef struct {
+    uint16_t tile_size;             // Tile edge in tensor pixels
+    uint16_t tiles_x;
+    uint16_t tiles_y;
+    uint16_t *src_x0;               // Source footprint per tile column [x0, x1)
+    uint16_t *src_x1;
+    uint16_t *src_y0;               // Source footprint per tile row [y0, y1)
+    uint16_t *src_y1;
+    uint8_t *cells;                 // Per-tile cell means, OCR_TILE_GRID^2 per tile
+    uint32_t *dirty;                // Dirty bitmap, 1 bit per tile, row-major
+    uint16_t dirty_count;           // Dirty tiles after the last update
+    uint8_t threshold;              // Cell-mean luma delta counted as dirty
+    uint8_t valid;                  // Signatures hold a previous frame
+    uint16_t refresh_interval;      // Frames between forced full refreshes (0: never)
+    uint16_t frames_since_refresh;
+    uint8_t full_refresh;           // Last update had no previous signatures
+    uint32_t bytes_scanned;         // Source bytes read by the last update
+} ocr_tile_map_t;
+
+/**
+ * @brief Compute block-mean luma signature of an RGB565 frame
+ * @param src Source frame (RGB565)
+ * @param src_stride Source row stride in pixels
+ * @param width Frame width (at least OCR_SIGNATURE_GRID_W)
+ * @param height Frame height (at least OCR_SIGNATURE_GRID_H)
+ * @param signature Output signature
+ * @details Reads 1/(STEP*STEP) of the frame, about 19k pixels at VGA
+ */
+void ocr_frame_signature_compute(const uint16_t *src, uint32_t src_stride,
+                                 uint16_t width, uint16_t height,
+                                 ocr_frame_signature_t *signature);
+
+/**
+ * @brief Compare two signatures
+ * @param reference Reference signature (last processed frame)
+ * @param current Current frame signature
+ * @param block_threshold Per-block luma delta counted as a change
+ * @param delta Output difference
+ * @details The frame-mean shift is subtracted before comparing blocks so
+ *          auto exposure and flicker do not register as scene changes
+ */
+void ocr_frame_signature_compare(const ocr_frame_signature_t *reference,
+                                 const ocr_frame_signature_t *current,
+                                 uint8_t block_threshold, ocr_signature_delta_t *delta);
+
+// ========================================================================
+// Dirty Tiles
+// ========================================================================
+
+/**
+ * @brief Get storage required for a tile map
+ * @param tiles_x Tile columns
+ * @param tiles_y Tile rows
+ * @return Required storage in bytes
+ */
+uint32_t ocr_tile_map_size(uint16_t tiles_x, uint16_t tiles_y);
+
+/**
+ * @brief Initialize a tile map
+ * @param map Tile map
+ * @param tile_size Tile edge in tensor pixels
+ * @param tiles_x Tile columns
+ * @param tiles_y Tile rows
+ * @param threshold Cell-mean luma delta counted as dirty
+ * @param storage Storage (4-byte aligned, ocr_tile_map_size() bytes)
+ * @param storage_size Size of storage in bytes
+ * @return 0 on success, negative on error
+ * @details Footprints start empty; bind them with ocr_resize_plan_bind_tiles().
+ *          A full refresh is forced every OCR_TILE_REFRESH_INTERVAL updates
+ *          (change map->refresh_interval after init to adjust)
+ */
+int ocr_tile_map_init(ocr_tile_map_t *map, uint16_t tile_size, uint16_t tiles_x, uint16_t tiles_y,
+                      uint8_t threshold, void *storage, uint32_t storage_size);
+
+/**
+ * @brief Drop previous signatures so the next update marks every tile dirty
+ * @param map Tile map
+ */
+void ocr_tile_map_invalidate(ocr_tile_map_t *map);
+
+/**
+ * @brief Compare a new frame against the stored tile signatures
+ * @param map Tile map
+ * @param src Source frame (RGB565)
+ * @param src_stride Source row stride in pixels
+ * @return Number of dirty tiles
+ * @details Each tile's sampled footprint is reduced to OCR_TILE_GRID x
+ *          OCR_TILE_GRID cell means and compared cell by cell against the
+ *          stored ones, so a glyph moved or swapped inside a tile is dirty
+ *          even when the tile's ink density is unchanged. Signatures of dirty
+ *          tiles are replaced; clean tiles keep theirs so slow drift still
+ *          accumulates to a change
+ */
+uint32_t ocr_tile_map_update(ocr_tile_map_t *map, const uint16_t *src, uint32_t src_stride);
+
+/**
+ * @brief Check whether a tile is dirty
+ * @param map Tile map
+ * @param tile_x Tile column
+ * @param tile_y Tile row
+ * @return 1 if dirty, 0 otherwise
+ */
+uint8_t ocr_tile_map_is_dirty(const ocr_tile_map_t *map, uint32_t tile_x, uint32_t tile_y);
+
+#endif // OCR_FRAME_DIFF_H
@@ -0,0 +1,821 @@
+/**
+ * @file ocr_geometry.c
+ * @brief Geometric normalization of text regions for recognition
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#include "ocr_geometry.h"
+#include "ocr_common.h"
+#include <math.h>
+#include <string.h>
+
+// RGB565 channels spread with gaps for packed blending (G:21-26, R:11-15, B:0-4)
+#define RGB565_SPREAD_MASK 0x07E0F81Fu
+#define RGB565_SPREAD_HALF 0x02008010u  // 16 in each field after a 5-bit weight multiply
+
+#define OCR_PI 3.14159265f
+
+// Coarse pass point budget and fine search around its peak (+-3 quarter degrees)
+#define OCR_SKEW_COARSE_POINTS 1024
+#define OCR_SKEW_FINE_STEPS 3
+
+// ========================================================================
+// Skew Estimation
+// ========================================================================
+
+typedef struct {
+    const uint32_t *points;         // (y << 16) | x on the sampling grid
+    uint32_t count;
+    uint32_t *bins;
+    uint32_t bin_count;
+    int32_t offset_q16;             // Keeps sheared positions non-negative
+    uint32_t bin_shift;             // Extra shift when the profile is longer than MAX_BINS
+    uint32_t stride;                // Point subsampling (coarse pass)
+} ocr_skew_profile_t;
+
+/**
+ * @brief Projection profile sharpness for lines y = b + x * tan
+ * @return Sum of squared bin counts (peaks when lines align with bins)
+ */
+static uint32_t ocr_skew_score(const ocr_skew_profile_t *p, int32_t tan_q16)
+{
+    const uint32_t shift = 16 + p->bin_shift;
+    uint32_t score = 0;
+
+    memset(p->bins, 0, p->bin_count * sizeof(uint32_t));
+    for (uint32_t i = 0; i < p->count; i += p->stride) {
+        // Columns are two rows wide
+        int32_t x = (int32_t)(p->points[i] & 0xFFFF) * 2;
+        int32_t y = (int32_t)(p->points[i] >> 16);
+        uint32_t b = (uint32_t)((y << 16) - x * tan_q16 + p->offset_q16) >> shift;
+        p->bins[b]++;
+    }
+    for (uint32_t b = 0; b < p->bin_count; b++) {
+        score += p->bins[b] * p->bins[b];
+    }
+    return score;
+}
+
+static int32_t ocr_tan_q16(float degrees)
+{
+    return (int32_t)lrintf(tanf(degrees * OCR_PI / 180.0f) * 65536.0f);
+}
+
+int ocr_skew_estimate(const uint16_t *src, uint32_t src_stride, uint16_t width, uint16_t height,
+                      uint16_t step, void *scratch, ocr_skew_t *skew)
+{
+    uint32_t *points = (uint32_t*)scratch;
+    ocr_skew_profile_t profile;
+    uint32_t scores[OCR_SKEW_ANGLES];
+    uint32_t count = 0;
+    uint32_t seen = 0;
+    uint32_t keep_shift = 0;
+
+    memset(skew, 0, sizeof(*skew));
+    if (!src || !scratch || step == 0 || width < 2 * step || height < 2 * step) {
+        return -1;
+    }
+
+    // Edge map on the sampling grid: vertical luma steps mark line tops,
+    // bottoms and horizontal strokes, which all run along the text.
+    // Lines run horizontally, so columns are sampled at twice the row step.
+    // Luma rows are converted once and reused as the next row's reference
+    const uint32_t col_step = 2 * step;
+    const uint32_t grid_w = (width / col_step < OCR_SKEW_MAX_BINS * 2) ? width / col_step : OCR_SKEW_MAX_BINS * 2;
+    const uint32_t grid_h = height / step;
+    uint8_t *luma_prev = (uint8_t*)(points + OCR_SKEW_MAX_POINTS);
+    uint8_t *luma_cur = luma_prev + grid_w;
+
+    for (uint32_t gx = 0; gx < grid_w; gx++) {
+        luma_prev[gx] = (uint8_t)ocr_rgb565_luma(src[gx * col_step]);
+    }
+    for (uint32_t gy = 1; gy < grid_h; gy++) {
+        const uint16_t *row = src + gy * step * src_stride;
+
+        for (uint32_t gx = 0; gx < grid_w; gx++) {
+            luma_cur[gx] = (uint8_t)ocr_rgb565_luma(row[gx * col_step]);
+        }
+        for (uint32_t gx = 0; gx < grid_w; gx++) {
+            int32_t d = (int32_t)luma_cur[gx] - (int32_t)luma_prev[gx];
+            if (d <= OCR_SKEW_EDGE_THRESHOLD && d >= -OCR_SKEW_EDGE_THRESHOLD) {
+                continue;
+            }
+
+            // Uniform decimation: keep every 2^keep_shift-th edge, halve when full
+            if ((seen++ & ((1u << keep_shift) - 1)) != 0) {
+                continue;
+            }
+            if (count == OCR_SKEW_MAX_POINTS) {
+                for (uint32_t i = 0; i < OCR_SKEW_MAX_POINTS / 2; i++) {
+                    points[i] = points[2 * i];
+                }
+                count = OCR_SKEW_MAX_POINTS / 2;
+                keep_shift++;
+                if (((seen - 1) & ((1u << keep_shift) - 1)) != 0) {
+                    continue;
+                }
+            }
+            points[count++] = (gy << 16) | gx;
+        }
+
+        uint8_t *t = luma_prev;
+        luma_prev = luma_cur;
+        luma_cur = t;
+    }
+
+    skew->edge_points = (uint16_t)count;
+    if (count < OCR_SKEW_MIN_POINTS) {
+        return -1;
+    }
+
+    // Sheared position range: [-2 * grid_w * tan(max), grid_h + 2 * grid_w * tan(max)]
+    const int32_t tan_max = ocr_tan_q16((float)OCR_SKEW_MAX_ANGLE_DEG + 1.0f);
+    profile.points = points;
+    profile.count = count;
+    profile.bins = points + OCR_SKEW_MAX_POINTS;
+    profile.offset_q16 = (int32_t)(2 * grid_w) * tan_max + (1 << 16);
+    profile.bin_shift = 0;
+    profile.bin_count = (uint32_t)(((int32_t)(grid_h << 16) + 2 * profile.offset_q16) >> 16) + 1;
+    while (profile.bin_count > OCR_SKEW_MAX_BINS) {
+        profile.bin_shift++;
+        profile.bin_count = (profile.bin_count + 1) / 2;
+    }
+
+    // Coarse search on a subset of the points, fine search on all of them
+    profile.stride = (count + OCR_SKEW_COARSE_POINTS - 1) / OCR_SKEW_COARSE_POINTS;
+    uint32_t best = 0;
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < OCR_SKEW_ANGLES; i++) {
+        float deg = (float)((int32_t)i * OCR_SKEW_STEP_DEG - OCR_SKEW_MAX_ANGLE_DEG);
+        scores[i] = ocr_skew_score(&profile, ocr_tan_q16(deg));
+        total += scores[i];
+        if (scores[i] > scores[best]) {
+            best = i;
+        }
+    }
+    const float coarse = (float)((int32_t)best * OCR_SKEW_STEP_DEG - OCR_SKEW_MAX_ANGLE_DEG);
+    profile.stride = 1;
+
+    // Fine search in quarter steps around the peak, then parabolic refinement
+    const float fine_step = (float)OCR_SKEW_STEP_DEG / 4.0f;
+    uint32_t fine[2 * OCR_SKEW_FINE_STEPS + 1];
+    int32_t fine_best = 0;
+    for (int32_t k = -OCR_SKEW_FINE_STEPS; k <= OCR_SKEW_FINE_STEPS; k++) {
+        fine[k + OCR_SKEW_FINE_STEPS] = ocr_skew_score(&profile, ocr_tan_q16(coarse + k * fine_step));
+        if (fine[k + OCR_SKEW_FINE_STEPS] > fine[fine_best + OCR_SKEW_FINE_STEPS]) {
+            fine_best = k;
+        }
+    }
+
+    float offset = 0.0f;
+    if (fine_best > -OCR_SKEW_FINE_STEPS && fine_best < OCR_SKEW_FINE_STEPS) {
+        float s0 = (float)fine[fine_best + OCR_SKEW_FINE_STEPS - 1];
+        float s1 = (float)fine[fine_best + OCR_SKEW_FINE_STEPS];
+        float s2 = (float)fine[fine_best + OCR_SKEW_FINE_STEPS + 1];
+        float denom = s0 - 2.0f * s1 + s2;
+        if (denom < 0.0f) {
+            offset = 0.5f * (s0 - s2) / denom;
+        }
+    }
+
+    float angle = coarse + ((float)fine_best + offset) * fine_step;
+    skew->angle_cdeg = (int16_t)lrintf(angle * 100.0f);
+
+    // Peak prominence over the mean coarse score
+    uint32_t peak = scores[best];
+    uint32_t mean = (uint32_t)(total / OCR_SKEW_ANGLES);
+    skew->confidence = (uint8_t)(peak > mean ? (uint64_t)(peak - mean) * 100 / peak : 0);
+    return 0;
+}
+
+// ========================================================================
+// Affine Warp
+// ========================================================================
+
+void ocr_affine_rotate_crop(ocr_affine_q16_t *affine, float center_x, float center_y,
+                            int16_t angle_cdeg, float scale, uint16_t dst_width, uint16_t dst_height)
+{
+    const float rad = (float)angle_cdeg * OCR_PI / 18000.0f;
+    const float c = cosf(rad) * scale;
+    const float s = sinf(rad) * scale;
+    const float hw = 0.5f * (float)(dst_width - 1);
+    const float hh = 0.5f * (float)(dst_height - 1);
+
+    // Columns follow the text direction, rows run across it
+    affine->du_x = (int32_t)lrintf(c * 65536.0f);
+    affine->du_y = (int32_t)lrintf(s * 65536.0f);
+    affine->dv_x = (int32_t)lrintf(-s * 65536.0f);
+    affine->dv_y = (int32_t)lrintf(c * 65536.0f);
+    affine->origin_x = (int32_t)lrintf((center_x - hw * c + hh * s) * 65536.0f);
+    affine->origin_y = (int32_t)lrintf((center_y - hw * s - hh * c) * 65536.0f);
+}
+
+void ocr_affine_crop_resize(ocr_affine_q16_t *affine, uint16_t crop_x, uint16_t crop_y,
+                            uint16_t crop_width, uint16_t crop_height,
+                            uint16_t dst_width, uint16_t dst_height)
+{
+    const uint32_t step_x = ((uint32_t)crop_width << 16) / dst_width;
+    const uint32_t step_y = ((uint32_t)crop_height << 16) / dst_height;
+
+    affine->origin_x = ((int32_t)crop_x << 16) + (int32_t)(step_x >> 1) - 32768;
+    affine->origin_y = ((int32_t)crop_y << 16) + (int32_t)(step_y >> 1) - 32768;
+    affine->du_x = (int32_t)step_x;
+    affine->du_y = 0;
+    affine->dv_x = 0;
+    affine->dv_y = (int32_t)step_y;
+}
+
+void ocr_affine_crop_rotate90(ocr_affine_q16_t *affine, uint16_t crop_x, uint16_t crop_y,
+                              uint16_t crop_width, uint16_t crop_height,
+                              uint16_t dst_width, uint16_t dst_height)
+{
+    // Columns run down the box, rows run leftwards from its right edge
+    const uint32_t step_u = ((uint32_t)crop_height << 16) / dst_width;
+    const uint32_t step_v = ((uint32_t)crop_width << 16) / dst_height;
+
+    affine->origin_x = (((int32_t)crop_x + crop_width) << 16) - (int32_t)(step_v >> 1) - 32768;
+    affine->origin_y = ((int32_t)crop_y << 16) + (int32_t)(step_u >> 1) - 32768;
+    affine->du_x = 0;
+    affine->du_y = (int32_t)step_u;
+    affine->dv_x = -(int32_t)step_v;
+    affine->dv_y = 0;
+}
+
+static inline uint32_t ocr_rgb565_spread(uint16_t p)
+{
+    return ((uint32_t)p | ((uint32_t)p << 16)) & RGB565_SPREAD_MASK;
+}
+
+static inline uint16_t ocr_rgb565_pack(uint32_t v)
+{
+    v &= RGB565_SPREAD_MASK;
+    return (uint16_t)(v | (v >> 16));
+}
+
+// Packed lerp with a 5-bit weight (0..32), rounded; every field has 5 spare bits
+static inline uint32_t ocr_lerp_spread(uint32_t a, uint32_t b, uint32_t w)
+{
+    return ((a * (32 - w) + b * w + RGB565_SPREAD_HALF) >> 5) & RGB565_SPREAD_MASK;
+}
+
+// Bilinear sample at a Q16 position; clamps so crops at the border repeat edge pixels
+static inline uint16_t ocr_sample_rgb565(const uint16_t *src, uint32_t src_stride,
+                                         uint32_t src_width, uint32_t src_height,
+                                         int32_t max_x, int32_t max_y, int32_t sx, int32_t sy)
+{
+    // Positions round to the nearest 1/32 pixel (the weight resolution)
+    int32_t cx = (sx < 0 ? 0 : (sx > max_x ? max_x : sx)) + (1 << 10);
+    int32_t cy = (sy < 0 ? 0 : (sy > max_y ? max_y : sy)) + (1 << 10);
+    uint32_t x0 = (uint32_t)cx >> 16;
+    uint32_t y0 = (uint32_t)cy >> 16;
+    uint32_t wx = ((uint32_t)cx >> 11) & 31;
+    uint32_t wy = ((uint32_t)cy >> 11) & 31;
+    uint32_t x1 = (x0 + 1 < src_width) ? x0 + 1 : x0;
+    const uint16_t *r0 = src + y0 * src_stride;
+    const uint16_t *r1 = (y0 + 1 < src_height) ? r0 + src_stride : r0;
+
+    uint32_t top = ocr_lerp_spread(ocr_rgb565_spread(r0[x0]), ocr_rgb565_spread(r0[x1]), wx);
+    uint32_t bottom = ocr_lerp_spread(ocr_rgb565_spread(r1[x0]), ocr_rgb565_spread(r1[x1]), wx);
+    return ocr_rgb565_pack(ocr_lerp_spread(top, bottom, wy));
+}
+
+// Same sample for a position whose 2x2 neighbourhood is inside the image (no clamping)
+static inline uint16_t ocr_sample_rgb565_inner(const uint16_t *src, uint32_t src_stride, int32_t sx, int32_t sy)
+{
+    uint32_t cx = (uint32_t)sx + (1 << 10);
+    uint32_t cy = (uint32_t)sy + (1 << 10);
+    uint32_t x0 = cx >> 16;
+    uint32_t wx = (cx >> 11) & 31;
+    uint32_t wy = (cy >> 11) & 31;
+    const uint16_t *r0 = src + (cy >> 16) * src_stride;
+    const uint16_t *r1 = r0 + src_stride;
+
+    uint32_t top = ocr_lerp_spread(ocr_rgb565_spread(r0[x0]), ocr_rgb565_spread(r0[x0 + 1]), wx);
+    uint32_t bottom = ocr_lerp_spread(ocr_rgb565_spread(r1[x0]), ocr_rgb565_spread(r1[x0 + 1]), wx);
+    return ocr_rgb565_pack(ocr_lerp_spread(top, bottom, wy));
+}
+
+void ocr_warp_affine_rgb565(const uint16_t *src, uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                            const ocr_affine_q16_t *affine,
+                            uint16_t *dst, uint32_t dst_stride, uint16_t dst_width, uint16_t dst_height)
+{
+    const int32_t max_x = (int32_t)(src_width - 1) << 16;
+    const int32_t max_y = (int32_t)(src_height - 1) << 16;
+
+    for (uint32_t v = 0; v < dst_height; v++) {
+        int32_t sx = affine->origin_x + (int32_t)v * affine->dv_x;
+        int32_t sy = affine->origin_y + (int32_t)v * affine->dv_y;
+        uint16_t *out = dst + v * dst_stride;
+
+        for (uint32_t u = 0; u < dst_width; u++, sx += affine->du_x, sy += affine->du_y) {
+            out[u] = ocr_sample_rgb565(src, src_stride, src_width, src_height, max_x, max_y, sx, sy);
+        }
+    }
+}
+
+// Mean of a source rectangle, per 565 field, rounded
+static inline uint16_t ocr_box_average_rgb565(const uint16_t *src, uint32_t src_stride,
+                                              uint32_t x0, uint32_t x1, uint32_t y0, uint32_t y1)
+{
+    const uint32_t n = (x1 - x0) * (y1 - y0);
+    uint32_t r = 0, g = 0, b = 0;
+
+    if (n == 1) {
+        return src[y0 * src_stride + x0];
+    }
+    for (uint32_t y = y0; y < y1; y++) {
+        const uint16_t *row = src + y * src_stride;
+        for (uint32_t x = x0; x < x1; x++) {
+            const uint16_t p = row[x];
+            r += p >> 11;
+            g += (p >> 5) & 0x3F;
+            b += p & 0x1F;
+        }
+    }
+    const uint32_t half = n >> 1;
+    return (uint16_t)((((r + half) / n) << 11) | (((g + half) / n) << 5) | ((b + half) / n));
+}
+
+void ocr_crop_resize_rgb565(const uint16_t *src, uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                            uint16_t crop_x, uint16_t crop_y, uint16_t crop_width, uint16_t crop_height,
+                            uint16_t *dst, uint32_t dst_stride, uint16_t dst_width, uint16_t dst_height)
+{
+    const uint32_t step_x = ((uint32_t)crop_width << 16) / dst_width;
+    const uint32_t step_y = ((uint32_t)crop_height << 16) / dst_height;
+
+    // Enlarging (small glyphs): bilinear along an axis-aligned grid, centers matched
+    if (step_y < 65536u) {
+        ocr_affine_q16_t affine;
+        ocr_affine_crop_resize(&affine, crop_x, crop_y, crop_width, crop_height, dst_width, dst_height);
+        ocr_warp_affine_rgb565(src, src_stride, src_width, src_height, &affine,
+                               dst, dst_stride, dst_width, dst_height);
+        return;
+    }
+
+    // Reducing: box average over the covered pixels, at least one per output
+    for (uint32_t v = 0; v < dst_height; v++) {
+        const uint32_t y0 = crop_y + ((v * step_y) >> 16);
+        uint32_t y1 = crop_y + (((v + 1) * step_y) >> 16);
+        y1 = (y1 > y0) ? y1 : y0 + 1;
+        y1 = (y1 < src_height) ? y1 : src_height;
+        uint16_t *out = dst + v * dst_stride;
+
+        for (uint32_t u = 0; u < dst_width; u++) {
+            const uint32_t x0 = crop_x + ((u * step_x) >> 16);
+            uint32_t x1 = crop_x + (((u + 1) * step_x) >> 16);
+            x1 = (x1 > x0) ? x1 : x0 + 1;
+            x1 = (x1 < src_width) ? x1 : src_width;
+            out[u] = ocr_box_average_rgb565(src, src_stride, x0, x1, y0, y1);
+        }
+    }
+}
+
+void ocr_crop_rotate90_rgb565(const uint16_t *src, uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                              uint16_t crop_x, uint16_t crop_y, uint16_t crop_width, uint16_t crop_height,
+                              uint16_t *dst, uint32_t dst_stride, uint16_t dst_width, uint16_t dst_height)
+{
+    // Output columns run down the box, output rows run leftwards from its right edge
+    const uint32_t step_u = ((uint32_t)crop_height << 16) / dst_width;
+    const uint32_t step_v = ((uint32_t)crop_width << 16) / dst_height;
+    const uint32_t right = (uint32_t)crop_x + crop_width;
+    const int32_t max_x = (int32_t)(src_width - 1) << 16;
+    const int32_t max_y = (int32_t)(src_height - 1) << 16;
+    const uint8_t enlarge = (step_v < 65536u);
+
+    // Blocks of output columns: the few source rows of a block stay cached
+    // while all its output rows are written, instead of striding the whole
+    // box height of the frame for every output row
+    for (uint32_t u0 = 0; u0 < dst_width; u0 += OCR_ROTATE_BLOCK) {
+        const uint32_t u_count = (u0 + OCR_ROTATE_BLOCK < dst_width) ? OCR_ROTATE_BLOCK : dst_width - u0;
+        uint16_t row_start[OCR_ROTATE_BLOCK];
+        uint16_t row_end[OCR_ROTATE_BLOCK];
+        uint8_t single_rows = 1;
+
+        // Source rows of each output column in the block, computed once
+        for (uint32_t k = 0; k < u_count; k++) {
+            const uint32_t u = u0 + k;
+            const uint32_t y0 = crop_y + ((u * step_u) >> 16);
+            uint32_t y1 = crop_y + (((u + 1) * step_u) >> 16);
+            y1 = (y1 > y0) ? y1 : y0 + 1;
+            y1 = (y1 < src_height) ? y1 : src_height;
+            row_start[k] = (uint16_t)y0;
+            row_end[k] = (uint16_t)y1;
+            single_rows &= (y1 - y0 == 1);
+        }
+
+        for (uint32_t v = 0; v < dst_height; v++) {
+            uint16_t *out = dst + v * dst_stride + u0;
+
+            if (enlarge) {
+                // Bilinear, centers matched: x falls leftwards with v, y grows with u
+                const int32_t sx = ((int32_t)right << 16) - (int32_t)(step_v >> 1) - 32768 -
+                                   (int32_t)(v * step_v);
+                int32_t sy = ((int32_t)crop_y << 16) + (int32_t)(step_u >> 1) - 32768 +
+                             (int32_t)(u0 * step_u);
+                for (uint32_t k = 0; k < u_count; k++, sy += (int32_t)step_u) {
+                    out[k] = ocr_sample_rgb565(src, src_stride, src_width, src_height,
+                                               max_x, max_y, sx, sy);
+                }
+                continue;
+            }
+
+            uint32_t x0 = right - (((v + 1) * step_v) >> 16);
+            const uint32_t x1 = right - ((v * step_v) >> 16);
+            x0 = (x0 < x1) ? x0 : x1 - 1;
+            if (single_rows && x1 - x0 == 1) {
+                // One source pixel per output: plain transpose of the block
+                const uint16_t *column = src + x0;
+                for (uint32_t k = 0; k < u_count; k++) {
+                    out[k] = column[row_start[k] * src_stride];
+                }
+                continue;
+            }
+            for (uint32_t k = 0; k < u_count; k++) {
+                out[k] = ocr_box_average_rgb565(src, src_stride, x0, x1, row_start[k], row_end[k]);
+            }
+        }
+    }
+}
+
+void ocr_deskew_extent(uint16_t box_width, uint16_t box_height, int16_t angle_cdeg,
+                       uint16_t *line_width, uint16_t *line_height)
+{
+    const float rad = (float)angle_cdeg * OCR_PI / 18000.0f;
+    const float c = cosf(rad);
+    const float s = fabsf(sinf(rad));
+    const float det = c * c - s * s;
+    float w = (float)box_width;
+    float h = (float)box_height;
+
+    if (det > 0.1f) {
+        float lw = (w * c - h * s) / det;
+        float lh = (h * c - w * s) / det;
+
+        // Boxes much shorter than the slope implies: angle does not fit, keep the box
+        if (lw >= 1.0f && lh >= 2.0f) {
+            w = lw;
+            h = lh;
+        }
+    }
+
+    *line_width = (uint16_t)lrintf(w);
+    *line_height = (uint16_t)lrintf(h);
+}
+
+// ========================================================================
+// Perspective Warp
+// ========================================================================
+
+int ocr_perspective_from_quad(ocr_perspective_t *persp, const float quad_x[4], const float quad_y[4],
+                              uint16_t dst_width, uint16_t dst_height)
+{
+    const float sx = quad_x[0] - quad_x[1] + quad_x[2] - quad_x[3];
+    const float sy = quad_y[0] - quad_y[1] + quad_y[2] - quad_y[3];
+    float a, b, d, e, g, h;
+
+    if (dst_width == 0 || dst_height == 0) {
+        return -1;
+    }
+
+    // Unit square -> quad (Heckbert), corners TL, TR, BR, BL
+    if (sx == 0.0f && sy == 0.0f) {
+        // Parallelogram: affine
+        a = quad_x[1] - quad_x[0];
+        b = quad_x[2] - quad_x[1];
+        d = quad_y[1] - quad_y[0];
+        e = quad_y[2] - quad_y[1];
+        g = 0.0f;
+        h = 0.0f;
+    } else {
+        const float dx1 = quad_x[1] - quad_x[2];
+        const float dx2 = quad_x[3] - quad_x[2];
+        const float dy1 = quad_y[1] - quad_y[2];
+        const float dy2 = quad_y[3] - quad_y[2];
+        const float den = dx1 * dy2 - dx2 * dy1;
+
+        if (fabsf(den) < 1e-6f) {
+            return -1;
+        }
+        g = (sx * dy2 - dx2 * sy) / den;
+        h = (dx1 * sy - sx * dy1) / den;
+        a = quad_x[1] - quad_x[0] + g * quad_x[1];
+        b = quad_x[3] - quad_x[0] + h * quad_x[3];
+        d = quad_y[1] - quad_y[0] + g * quad_y[1];
+        e = quad_y[3] - quad_y[0] + h * quad_y[3];
+    }
+
+    // Destination pixels -> unit square
+    const float iw = 1.0f / (float)dst_width;
+    const float ih = 1.0f / (float)dst_height;
+    persp->a = a * iw;
+    persp->b = b * ih;
+    persp->c = quad_x[0];
+    persp->d = d * iw;
+    persp->e = e * ih;
+    persp->f = quad_y[0];
+    persp->g = g * iw;
+    persp->h = h * ih;
+    return 0;
+}
+
+uint16_t ocr_quad_strip_width(const float quad_x[4], const float quad_y[4],
+                              uint16_t strip_height, uint16_t max_width)
+{
+    const float top = hypotf(quad_x[1] - quad_x[0], quad_y[1] - quad_y[0]);
+    const float bottom = hypotf(quad_x[2] - quad_x[3], quad_y[2] - quad_y[3]);
+    const float left = hypotf(quad_x[3] - quad_x[0], quad_y[3] - quad_y[0]);
+    const float right = hypotf(quad_x[2] - quad_x[1], quad_y[2] - quad_y[1]);
+    float width;
+
+    if (left + right < 1.0f) {
+        return 0;
+    }
+    width = (float)strip_height * (top + bottom) / (left + right);
+    if (width < 1.0f) {
+        return 1;
+    }
+    return (width > (float)max_width) ? max_width : (uint16_t)lrintf(width);
+}
+
+void ocr_warp_perspective_rgb565(const uint16_t *src, uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                                 const ocr_perspective_t *persp,
+                                 uint16_t *dst, uint32_t dst_stride, uint16_t dst_width, uint16_t dst_height)
+{
+    const int32_t max_x = (int32_t)(src_width - 1) << 16;
+    const int32_t max_y = (int32_t)(src_height - 1) << 16;
+
+    for (uint32_t v = 0; v < dst_height; v++) {
+        const float vc = (float)v + 0.5f;
+        uint16_t *out = dst + v * dst_stride;
+
+        // Homogeneous numerators at the first pixel center; per-pixel increments are a, d, g
+        float xn = persp->a * 0.5f + persp->b * vc + persp->c;
+        float yn = persp->d * 0.5f + persp->e * vc + persp->f;
+        float wn = persp->g * 0.5f + persp->h * vc + 1.0f;
+        float inv = 1.0f / wn;
+
+        // Quad edges are pixel edges; the sampler works on pixel centers
+        int32_t sx = (int32_t)lrintf((xn * inv - 0.5f) * 65536.0f);
+        int32_t sy = (int32_t)lrintf((yn * inv - 0.5f) * 65536.0f);
+
+        for (uint32_t u0 = 0; u0 < dst_width; u0 += OCR_PERSPECTIVE_SPAN) {
+            const uint32_t n = (dst_width - u0 < OCR_PERSPECTIVE_SPAN) ? dst_width - u0 : OCR_PERSPECTIVE_SPAN;
+
+            // One exact divide per span end, linear steps in between
+            xn += persp->a * (float)n;
+            yn += persp->d * (float)n;
+            wn += persp->g * (float)n;
+            inv = 1.0f / wn;
+            const int32_t ex = (int32_t)lrintf((xn * inv - 0.5f) * 65536.0f);
+            const int32_t ey = (int32_t)lrintf((yn * inv - 0.5f) * 65536.0f);
+            const int32_t dx = (ex - sx) / (int32_t)n;
+            const int32_t dy = (ey - sy) / (int32_t)n;
+
+            for (uint32_t k = 0; k < n; k++, sx += dx, sy += dy) {
+                out[u0 + k] = ocr_sample_rgb565(src, src_stride, src_width, src_height, max_x, max_y, sx, sy);
+            }
+            sx = ex;
+            sy = ey;
+        }
+    }
+}
+
+// ========================================================================
+// Fused Warp to Model Input
+// ========================================================================
+
+// Input tensor geometry shared by the fused warps
+typedef struct {
+    const ocr_tensor_quantizer_t *quantizer;
+    uint32_t px_stride;             // Elements between neighbouring pixels
+    uint32_t ch_stride;             // Elements between channels of a pixel
+    uint32_t row_stride;            // Elements between rows
+    uint32_t width;                 // Strip clipped to the input
+    uint32_t height;
+    int32_t inner_x;                // Samples below these need no clamping
+    int32_t inner_y;
+} ocr_tensor_writer_t;
+
+// Pads the input with the quantized zero and clips the strip to it
+static void ocr_tensor_writer_begin(ocr_tensor_writer_t *writer, const ocr_tensor_quantizer_t *quantizer,
+                                    uint16_t src_width, uint16_t src_height,
+                                    uint16_t dst_width, uint16_t dst_height, int8_t *tensor)
+{
+    const uint32_t nhwc = (quantizer->layout == OCR_TENSOR_LAYOUT_NHWC);
+
+    writer->quantizer = quantizer;
+    writer->px_stride = nhwc ? quantizer->channels : 1;
+    writer->ch_stride = nhwc ? 1 : (uint32_t)quantizer->width * quantizer->height;
+    writer->row_stride = (uint32_t)quantizer->width * writer->px_stride;
+    writer->width = (dst_width < quantizer->width) ? dst_width : quantizer->width;
+    writer->height = (dst_height < quantizer->height) ? dst_height : quantizer->height;
+
+    // Rounded position left of the last column/row: x0 + 1 and y0 + 1 exist
+    writer->inner_x = ((int32_t)(src_width - 1) << 16) - (1 << 10);
+    writer->inner_y = ((int32_t)(src_height - 1) << 16) - (1 << 10);
+
+    memset(tensor, quantizer->zero_point,
+           (uint32_t)quantizer->width * quantizer->height * quantizer->channels);
+}
+
+static inline uint8_t ocr_writer_inside(const ocr_tensor_writer_t *writer, int32_t sx, int32_t sy)
+{
+    return sx >= 0 && sy >= 0 && sx < writer->inner_x && sy < writer->inner_y;
+}
+
+// RGB565 sample -> quantized channels of one input pixel
+static inline void ocr_quantize_rgb565(const ocr_tensor_writer_t *writer, uint16_t p, int8_t *out)
+{
+    const ocr_tensor_quantizer_t *quantizer = writer->quantizer;
+
+    if (quantizer->channels == 1) {
+        out[0] = quantizer->lut[0][ocr_rgb565_luma(p)];
+    } else {
+        out[0] = quantizer->lut[0][ocr_expand5(p >> 11)];
+        out[writer->ch_stride] = quantizer->lut[1][ocr_expand6((p >> 5) & 0x3F)];
+        out[2 * writer->ch_stride] = quantizer->lut[2][ocr_expand5(p & 0x1F)];
+    }
+}
+
+// n samples from (sx, sy) in steps of (dx, dy); clamping only if an end is outside
+static inline void ocr_warp_span_to_tensor(const ocr_tensor_writer_t *writer, const uint16_t *src,
+                                           uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                                           int32_t sx, int32_t sy, int32_t dx, int32_t dy,
+                                           uint32_t n, int8_t *out)
+{
+    const int32_t last_x = sx + (int32_t)(n - 1) * dx;
+    const int32_t last_y = sy + (int32_t)(n - 1) * dy;
+    const uint32_t step = writer->px_stride;
+
+    // Samples are linear along the span: both ends inside, all inside
+    if (ocr_writer_inside(writer, sx, sy) && ocr_writer_inside(writer, last_x, last_y)) {
+        for (uint32_t k = 0; k < n; k++, sx += dx, sy += dy, out += step) {
+            ocr_quantize_rgb565(writer, ocr_sample_rgb565_inner(src, src_stride, sx, sy), out);
+        }
+        return;
+    }
+
+    const int32_t max_x = (int32_t)(src_width - 1) << 16;
+    const int32_t max_y = (int32_t)(src_height - 1) << 16;
+    for (uint32_t k = 0; k < n; k++, sx += dx, sy += dy, out += step) {
+        ocr_quantize_rgb565(writer, ocr_sample_rgb565(src, src_stride, src_width, src_height,
+                                                      max_x, max_y, sx, sy), out);
+    }
+}
+
+void ocr_warp_affine_to_tensor(const ocr_tensor_quantizer_t *quantizer,
+                               const uint16_t *src, uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                               const ocr_affine_q16_t *affine, uint16_t dst_width, uint16_t dst_height,
+                               int8_t *tensor)
+{
+    ocr_tensor_writer_t writer;
+
+    ocr_tensor_writer_begin(&writer, quantizer, src_width, src_height, dst_width, dst_height, tensor);
+    if (writer.width == 0) {
+        return;
+    }
+    for (uint32_t v = 0; v < writer.height; v++) {
+        ocr_warp_span_to_tensor(&writer, src, src_stride, src_width, src_height,
+                                affine->origin_x + (int32_t)v * affine->dv_x,
+                                affine->origin_y + (int32_t)v * affine->dv_y,
+                                affine->du_x, affine->du_y, writer.width, tensor + v * writer.row_stride);
+    }
+}
+
+void ocr_warp_perspective_to_tensor(const ocr_tensor_quantizer_t *quantizer,
+                                    const uint16_t *src, uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                                    const ocr_perspective_t *persp, uint16_t dst_width, uint16_t dst_height,
+                                    int8_t *tensor)
+{
+    ocr_tensor_writer_t writer;
+
+    ocr_tensor_writer_begin(&writer, quantizer, src_width, src_height, dst_width, dst_height, tensor);
+    for (uint32_t v = 0; v < writer.height; v++) {
+        const float vc = (float)v + 0.5f;
+        int8_t *out = tensor + v * writer.row_stride;
+
+        // Span stepping as ocr_warp_perspective_rgb565(), so samples match it
+        float xn = persp->a * 0.5f + persp->b * vc + persp->c;
+        float yn = persp->d * 0.5f + persp->e * vc + persp->f;
+        float wn = persp->g * 0.5f + persp->h * vc + 1.0f;
+        float inv = 1.0f / wn;
+        int32_t sx = (int32_t)lrintf((xn * inv - 0.5f) * 65536.0f);
+        int32_t sy = (int32_t)lrintf((yn * inv - 0.5f) * 65536.0f);
+
+        for (uint32_t u0 = 0; u0 < writer.width; u0 += OCR_PERSPECTIVE_SPAN) {
+            const uint32_t n = (dst_width - u0 < OCR_PERSPECTIVE_SPAN) ? dst_width - u0 : OCR_PERSPECTIVE_SPAN;
+            const uint32_t kept = (writer.width - u0 < n) ? writer.width - u0 : n;
+
+            xn += persp->a * (float)n;
+            yn += persp->d * (float)n;
+            wn += persp->g * (float)n;
+            inv = 1.0f / wn;
+            const int32_t ex = (int32_t)lrintf((xn * inv - 0.5f) * 65536.0f);
+            const int32_t ey = (int32_t)lrintf((yn * inv - 0.5f) * 65536.0f);
+            const int32_t dx = (ex - sx) / (int32_t)n;
+            const int32_t dy = (ey - sy) / (int32_t)n;
+
+            ocr_warp_span_to_tensor(&writer, src, src_stride, src_width, src_height,
+                                    sx, sy, dx, dy, kept, out + u0 * writer.px_stride);
+            sx = ex;
+            sy = ey;
+        }
+    }
+}
+
+void ocr_crop_resize_to_tensor(const ocr_tensor_quantizer_t *quantizer,
+                               const uint16_t *src, uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                               uint16_t crop_x, uint16_t crop_y, uint16_t crop_width, uint16_t crop_height,
+                               uint16_t dst_width, uint16_t dst_height, int8_t *tensor)
+{
+    const uint32_t step_x = ((uint32_t)crop_width << 16) / dst_width;
+    const uint32_t step_y = ((uint32_t)crop_height << 16) / dst_height;
+    ocr_tensor_writer_t writer;
+
+    // Enlarging or mild reduction: one bilinear grid (a 2x grid averages 2x2 pixels)
+    if (step_y <= ((uint32_t)OCR_AREA_REDUCE_STEP << 16)) {
+        ocr_affine_q16_t affine;
+        ocr_affine_crop_resize(&affine, crop_x, crop_y, crop_width, crop_height, dst_width, dst_height);
+        ocr_warp_affine_to_tensor(quantizer, src, src_stride, src_width, src_height, &affine,
+                                  dst_width, dst_height, tensor);
+        return;
+    }
+
+    // Strong reduction: box average over the covered pixels, quantized in place
+    ocr_tensor_writer_begin(&writer, quantizer, src_width, src_height, dst_width, dst_height, tensor);
+    for (uint32_t v = 0; v < writer.height; v++) {
+        const uint32_t y0 = crop_y + ((v * step_y) >> 16);
+        uint32_t y1 = crop_y + (((v + 1) * step_y) >> 16);
+        y1 = (y1 > y0) ? y1 : y0 + 1;
+        y1 = (y1 < src_height) ? y1 : src_height;
+        int8_t *out = tensor + v * writer.row_stride;
+
+        for (uint32_t u = 0; u < writer.width; u++, out += writer.px_stride) {
+            const uint32_t x0 = crop_x + ((u * step_x) >> 16);
+            uint32_t x1 = crop_x + (((u + 1) * step_x) >> 16);
+            x1 = (x1 > x0) ? x1 : x0 + 1;
+            x1 = (x1 < src_width) ? x1 : src_width;
+            ocr_quantize_rgb565(&writer, ocr_box_average_rgb565(src, src_stride, x0, x1, y0, y1), out);
+        }
+    }
+}
+
+void ocr_crop_rotate90_to_tensor(const ocr_tensor_quantizer_t *quantizer,
+                                 const uint16_t *src, uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                                 uint16_t crop_x, uint16_t crop_y, uint16_t crop_width, uint16_t crop_height,
+                                 uint16_t dst_width, uint16_t dst_height, int8_t *tensor)
+{
+    // Output columns run down the box, output rows run leftwards from its right edge
+    const uint32_t step_u = ((uint32_t)crop_height << 16) / dst_width;
+    const uint32_t step_v = ((uint32_t)crop_width << 16) / dst_height;
+    const uint32_t right = (uint32_t)crop_x + crop_width;
+    const uint8_t area = (step_v > ((uint32_t)OCR_AREA_REDUCE_STEP << 16));
+    ocr_tensor_writer_t writer;
+    ocr_affine_q16_t affine;
+
+    ocr_tensor_writer_begin(&writer, quantizer, src_width, src_height, dst_width, dst_height, tensor);
+    ocr_affine_crop_rotate90(&affine, crop_x, crop_y, crop_width, crop_height, dst_width, dst_height);
+
+    // Blocks of output columns, as ocr_crop_rotate90_rgb565()
+    for (uint32_t u0 = 0; u0 < writer.width; u0 += OCR_ROTATE_BLOCK) {
+        const uint32_t u_count = (u0 + OCR_ROTATE_BLOCK < writer.width) ? OCR_ROTATE_BLOCK : writer.width - u0;
+        uint16_t row_start[OCR_ROTATE_BLOCK];
+        uint16_t row_end[OCR_ROTATE_BLOCK];
+        int8_t *block = tensor + u0 * writer.px_stride;
+
+        if (!area) {
+            // Grid samples: x falls leftwards with v, y grows along the block
+            for (uint32_t v = 0; v < writer.height; v++) {
+                ocr_warp_span_to_tensor(&writer, src, src_stride, src_width, src_height,
+                                        affine.origin_x + (int32_t)v * affine.dv_x,
+                                        affine.origin_y + (int32_t)u0 * affine.du_y,
+                                        0, affine.du_y, u_count, block + v * writer.row_stride);
+            }
+            continue;
+        }
+
+        // Source rows of each output column in the block, computed once
+        for (uint32_t k = 0; k < u_count; k++) {
+            const uint32_t u = u0 + k;
+            const uint32_t y0 = crop_y + ((u * step_u) >> 16);
+            uint32_t y1 = crop_y + (((u + 1) * step_u) >> 16);
+            y1 = (y1 > y0) ? y1 : y0 + 1;
+            y1 = (y1 < src_height) ? y1 : src_height;
+            row_start[k] = (uint16_t)y0;
+            row_end[k] = (uint16_t)y1;
+        }
+
+        for (uint32_t v = 0; v < writer.height; v++) {
+            int8_t *out = block + v * writer.row_stride;
+            uint32_t x0 = right - (((v + 1) * step_v) >> 16);
+            const uint32_t x1 = right - ((v * step_v) >> 16);
+            x0 = (x0 < x1) ? x0 : x1 - 1;
+
+            for (uint32_t k = 0; k < u_count; k++, out += writer.px_stride) {
+                ocr_quantize_rgb565(&writer, ocr_box_average_rgb565(src, src_stride, x0, x1,
+                                                                    row_start[k], row_end[k]), out);
+            }
+        }
+    }
+}
@@ -0,0 +1,344 @@
+/**
+ * @file ocr_geometry.h
+ * @brief Geometric normalization of text regions for recognition
+ * @details Skew estimation and fixed-point warps of RGB565 images, either
+ *          into an RGB565 image or fused with quantization straight into a
+ *          model input. The pipeline uses the fused warps; the RGB565 warps
+ *          are kept as their reference implementations (host tests check the
+ *          fused output against them). Platform independent (no HAL dependency)
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#ifndef OCR_GEOMETRY_H
+#define OCR_GEOMETRY_H
+
+#include <stdint.h>
+#include "ocr_preprocess.h"
+
+// Skew search range and resolution
+#define OCR_SKEW_MAX_ANGLE_DEG   15     // Search -15..+15 degrees
+#define OCR_SKEW_STEP_DEG        1      // Coarse step, refined by interpolation
+#define OCR_SKEW_ANGLES          (2 * OCR_SKEW_MAX_ANGLE_DEG / OCR_SKEW_STEP_DEG + 1)
+
+// Work bounds (fixed cost regardless of scene content)
+#define OCR_SKEW_MAX_POINTS      4096   // Edge points kept for projection
+#define OCR_SKEW_MAX_BINS        1024   // Projection profile length
+#define OCR_SKEW_MIN_POINTS      64     // Fewer edges: no estimate
+#define OCR_SKEW_EDGE_THRESHOLD  24     // Vertical luma step counted as edge
+
+// Scratch required by ocr_skew_estimate()
+#define OCR_SKEW_SCRATCH_SIZE    ((OCR_SKEW_MAX_POINTS + OCR_SKEW_MAX_BINS) * sizeof(uint32_t))
+
+// Skew estimate
+typedef struct {
+    int16_t angle_cdeg;             // Text line angle in 1/100 degree (+ = falling to the right)
+    uint8_t confidence;             // 0..100, peak sharpness of the best projection
+    uint16_t edge_points;           // Edge points used
+} ocr_skew_t;
+
+// Perspective warp
+#define OCR_STRIP_HEIGHT         48     // Height-normalized recognition strip
+#define OCR_STRIP_MAX_WIDTH      640
+#define OCR_PERSPECTIVE_SPAN     16     // Pixels between exact perspective divides
+#define OCR_ROTATE_BLOCK         16     // Output columns (source rows) per rotate-crop block
+#define OCR_AREA_REDUCE_STEP     2      // Fused crops average areas beyond this reduction
+
+// Fixed-point affine sampling grid (destination -> source)
+// src(u, v) = origin + u * du + v * dv, all Q16
+typedef struct {
+    int32_t origin_x;               // Source position of destination pixel (0, 0) center
+    int32_t origin_y;
+    int32_t du_x;                   // Source step per destination column
+    int32_t du_y;
+    int32_t dv_x;                   // Source step per destination row
+    int32_t dv_y;
+} ocr_affine_q16_t;
+
+// Destination -> source homography (quad edges are pixel edges)
+// src = (a u + b v + c, d u + e v + f) / (g u + h v + 1), u, v at pixel centers
+typedef struct {
+    float a, b, c;
+    float d, e, f;
+    float g, h;
+} ocr_perspective_t;
+
+/**
+ * @brief Estimate dominant text line angle with projection profiles
+ * @param src Source frame (RGB565)
+ * @param src_stride Source row stride in pixels
+ * @param width Frame width
+ * @param height Frame height
+ * @param step Row sampling step (downsampled edge map, e.g. 2 for VGA -> QVGA);
+ *             columns are sampled at twice the step
+ * @param scratch Work memory (OCR_SKEW_SCRATCH_SIZE bytes, 4-byte aligned)
+ * @param skew Output estimate
+ * @return 0 on success, negative if there are too few edges
+ * @details Edge points are decimated to OCR_SKEW_MAX_POINTS; a coarse pass over
+ *          a subset scores OCR_SKEW_ANGLES shear angles and a quarter-step pass
+ *          refines the peak, so time is bounded regardless of scene content
+ */
+int ocr_skew_estimate(const uint16_t *src, uint32_t src_stride, uint16_t width, uint16_t height,
+                      uint16_t step, void *scratch, ocr_skew_t *skew);
+
+/**
+ * @brief Build the sampling grid for a rotated, scaled crop
+ * @param affine Output grid
+ * @param center_x Crop center in source pixels
+ * @param center_y Crop center in source pixels
+ * @param angle_cdeg Text angle in 1/100 degree (crop axis follows the text)
+ * @param scale Source pixels per destination pixel
+ * @param dst_width Destination width
+ * @param dst_height Destination height
+ */
+void ocr_affine_rotate_crop(ocr_affine_q16_t *affine, float center_x, float center_y,
+                            int16_t angle_cdeg, float scale, uint16_t dst_width, uint16_t dst_height);
+
+/**
+ * @brief Build the sampling grid for an axis-aligned crop resized to a destination
+ * @param affine Output grid
+ * @param crop_x Box left in source pixels
+ * @param crop_y Box top in source pixels
+ * @param crop_width Box width
+ * @param crop_height Box height
+ * @param dst_width Destination width
+ * @param dst_height Destination height
+ * @details Pixel centers matched (a 2x reduction samples between source pixels)
+ */
+void ocr_affine_crop_resize(ocr_affine_q16_t *affine, uint16_t crop_x, uint16_t crop_y,
+                            uint16_t crop_width, uint16_t crop_height,
+                            uint16_t dst_width, uint16_t dst_height);
+
+/**
+ * @brief Build the sampling grid for a vertical box turned into a strip
+ * @param affine Output grid
+ * @param crop_x Box left in source pixels
+ * @param crop_y Box top in source pixels
+ * @param crop_width Box width
+ * @param crop_height Box height
+ * @param dst_width Strip width (along the column, top to bottom)
+ * @param dst_height Strip height (across the column, right edge first)
+ * @details Same strip as ocr_crop_rotate90_rgb565() when it enlarges
+ */
+void ocr_affine_crop_rotate90(ocr_affine_q16_t *affine, uint16_t crop_x, uint16_t crop_y,
+                              uint16_t crop_width, uint16_t crop_height,
+                              uint16_t dst_width, uint16_t dst_height);
+
+/**
+ * @brief Resample an RGB565 image along an affine grid (bilinear, Q16)
+ * @param src Source image (RGB565)
+ * @param src_stride Source row stride in pixels
+ * @param src_width Source width (samples are clamped to the image)
+ * @param src_height Source height
+ * @param affine Sampling grid
+ * @param dst Output image (RGB565)
+ * @param dst_stride Output row stride in pixels
+ * @param dst_width Output width
+ * @param dst_height Output height
+ * @details Integer-only inner loop; coordinates advance by constant steps.
+ *          Reference for ocr_warp_affine_to_tensor() (not used by the pipeline)
+ */
+void ocr_warp_affine_rgb565(const uint16_t *src, uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                            const ocr_affine_q16_t *affine,
+                            uint16_t *dst, uint32_t dst_stride, uint16_t dst_width, uint16_t dst_height);
+
+/**
+ * @brief Crop an axis-aligned box and resize it in one pass (RGB565)
+ * @param src Source image (RGB565)
+ * @param src_stride Source row stride in pixels
+ * @param src_width Source width (samples are clamped to the image)
+ * @param src_height Source height
+ * @param crop_x Box left in source pixels
+ * @param crop_y Box top in source pixels
+ * @param crop_width Box width (box inside the source)
+ * @param crop_height Box height
+ * @param dst Output image (RGB565)
+ * @param dst_stride Output row stride in pixels
+ * @param dst_width Output width
+ * @param dst_height Output height
+ * @details Reducing, each output pixel averages the source pixels it covers,
+ *          so every source pixel is read once and thin strokes are not
+ *          skipped; enlarging, the box is sampled bilinearly. Reference
+ *          for ocr_crop_resize_to_tensor() (not used by the pipeline)
+ */
+void ocr_crop_resize_rgb565(const uint16_t *src, uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                            uint16_t crop_x, uint16_t crop_y, uint16_t crop_width, uint16_t crop_height,
+                            uint16_t *dst, uint32_t dst_stride, uint16_t dst_width, uint16_t dst_height);
+
+/**
+ * @brief Crop a vertical text box, rotate it 90 degrees and resize it in one pass
+ * @param src Source image (RGB565)
+ * @param src_stride Source row stride in pixels
+ * @param src_width Source width (samples are clamped to the image)
+ * @param src_height Source height
+ * @param crop_x Box left in source pixels
+ * @param crop_y Box top in source pixels
+ * @param crop_width Box width (box inside the source)
+ * @param crop_height Box height
+ * @param dst Output strip (RGB565)
+ * @param dst_stride Output row stride in pixels
+ * @param dst_width Output width (along the column, top to bottom)
+ * @param dst_height Output height (across the column, right edge first)
+ * @details Same strip orientation as a vertical quad rectified by
+ *          ocr_warp_perspective_rgb565(). Resampling as in
+ *          ocr_crop_resize_rgb565(); processed in blocks of OCR_ROTATE_BLOCK
+ *          output columns so their source rows are reused while cached.
+ *          Reference for ocr_crop_rotate90_to_tensor() (not used by the pipeline)
+ */
+void ocr_crop_rotate90_rgb565(const uint16_t *src, uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                              uint16_t crop_x, uint16_t crop_y, uint16_t crop_width, uint16_t crop_height,
+                              uint16_t *dst, uint32_t dst_stride, uint16_t dst_width, uint16_t dst_height);
+
+/**
+ * @brief Size of the deskewed text line inside an axis-aligned box
+ * @param box_width Box width
+ * @param box_height Box height
+ * @param angle_cdeg Text angle in 1/100 degree
+ * @param line_width Output length along the text
+ * @param line_height Output thickness across the text
+ * @details Inverts w = L cos + H sin, h = L sin + H cos; falls back to the box
+ *          size when the box is too flat for the angle
+ */
+void ocr_deskew_extent(uint16_t box_width, uint16_t box_height, int16_t angle_cdeg,
+                       uint16_t *line_width, uint16_t *line_height);
+
+/**
+ * @brief Build the homography mapping a destination strip onto a source quad
+ * @param persp Output homography
+ * @param quad_x Corner x in source pixels: TL, TR, BR, BL
+ * @param quad_y Corner y in source pixels: TL, TR, BR, BL
+ * @param dst_width Strip width
+ * @param dst_height Strip height
+ * @return 0 on success, negative for a degenerate quad
+ */
+int ocr_perspective_from_quad(ocr_perspective_t *persp, const float quad_x[4], const float quad_y[4],
+                              uint16_t dst_width, uint16_t dst_height);
+
+/**
+ * @brief Strip width that keeps the quad's aspect ratio at a given height
+ * @param quad_x Corner x: TL, TR, BR, BL
+ * @param quad_y Corner y: TL, TR, BR, BL
+ * @param strip_height Strip height (e.g. OCR_STRIP_HEIGHT)
+ * @param max_width Width limit
+ * @return Strip width, 0 for a degenerate quad
+ */
+uint16_t ocr_quad_strip_width(const float quad_x[4], const float quad_y[4],
+                              uint16_t strip_height, uint16_t max_width);
+
+/**
+ * @brief Resample a source quad into a rectangular strip (bilinear, Q16)
+ * @param src Source image (RGB565)
+ * @param src_stride Source row stride in pixels
+ * @param src_width Source width (samples are clamped to the image)
+ * @param src_height Source height
+ * @param persp Strip -> source homography
+ * @param dst Output strip (RGB565)
+ * @param dst_stride Output row stride in pixels
+ * @param dst_width Output width
+ * @param dst_height Output height
+ * @details Exact positions every OCR_PERSPECTIVE_SPAN pixels, Q16 increments
+ *          in between, so the inner loop is add-only. Reference for
+ *          ocr_warp_perspective_to_tensor(), which samples the same points
+ */
+void ocr_warp_perspective_rgb565(const uint16_t *src, uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                                 const ocr_perspective_t *persp,
+                                 uint16_t *dst, uint32_t dst_stride, uint16_t dst_width, uint16_t dst_height);
+
+// ========================================================================
+// Fused Warp to Model Input
+// ========================================================================
+
+/**
+ * @brief Resample along an affine grid straight into a model input
+ * @param quantizer Tensor quantizer (geometry = model input, layout, LUT)
+ * @param src Source image (RGB565)
+ * @param src_stride Source row stride in pixels
+ * @param src_width Source width (samples are clamped to the image)
+ * @param src_height Source height
+ * @param affine Sampling grid
+ * @param dst_width Strip width
+ * @param dst_height Strip height
+ * @param tensor Output int8 tensor (width * height * channels bytes)
+ * @details Crop, bilinear resize, grayscale conversion (1-channel input) and
+ *          quantization in one pass, without an intermediate strip. The strip
+ *          is placed at the top left and the rest is padded with the
+ *          quantized zero, as ocr_strip_to_tensor(). Rows whose samples all
+ *          lie inside the image skip clamping; the result is bit-exact with
+ *          ocr_warp_affine_rgb565() followed by ocr_strip_to_tensor()
+ */
+void ocr_warp_affine_to_tensor(const ocr_tensor_quantizer_t *quantizer,
+                               const uint16_t *src, uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                               const ocr_affine_q16_t *affine, uint16_t dst_width, uint16_t dst_height,
+                               int8_t *tensor);
+
+/**
+ * @brief Rectify a source quad straight into a model input
+ * @param quantizer Tensor quantizer (geometry = model input, layout, LUT)
+ * @param src Source image (RGB565)
+ * @param src_stride Source row stride in pixels
+ * @param src_width Source width (samples are clamped to the image)
+ * @param src_height Source height
+ * @param persp Strip -> source homography
+ * @param dst_width Strip width
+ * @param dst_height Strip height
+ * @param tensor Output int8 tensor (width * height * channels bytes)
+ * @details As ocr_warp_affine_to_tensor(), sampled as
+ *          ocr_warp_perspective_rgb565(); clamping is decided per span
+ */
+void ocr_warp_perspective_to_tensor(const ocr_tensor_quantizer_t *quantizer,
+                                    const uint16_t *src, uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                                    const ocr_perspective_t *persp, uint16_t dst_width, uint16_t dst_height,
+                                    int8_t *tensor);
+
+/**
+ * @brief Crop an axis-aligned box and resize it straight into a model input
+ * @param quantizer Tensor quantizer (geometry = model input, layout, LUT)
+ * @param src Source image (RGB565)
+ * @param src_stride Source row stride in pixels
+ * @param src_width Source width (samples are clamped to the image)
+ * @param src_height Source height
+ * @param crop_x Box left in source pixels
+ * @param crop_y Box top in source pixels
+ * @param crop_width Box width (box inside the source)
+ * @param crop_height Box height
+ * @param dst_width Strip width
+ * @param dst_height Strip height
+ * @param tensor Output int8 tensor (width * height * channels bytes)
+ * @details Up to an OCR_AREA_REDUCE_STEP vertical reduction the strip is the
+ *          bilinear ocr_affine_crop_resize() grid of ocr_warp_affine_to_tensor().
+ *          Beyond it a single sample per output would skip 1 px strokes, so
+ *          each output averages the pixels it covers as ocr_crop_resize_rgb565()
+ *          and is quantized in place (bit-exact with it and ocr_strip_to_tensor())
+ */
+void ocr_crop_resize_to_tensor(const ocr_tensor_quantizer_t *quantizer,
+                               const uint16_t *src, uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                               uint16_t crop_x, uint16_t crop_y, uint16_t crop_width, uint16_t crop_height,
+                               uint16_t dst_width, uint16_t dst_height, int8_t *tensor);
+
+/**
+ * @brief Turn a vertical text box into a strip straight into a model input
+ * @param quantizer Tensor quantizer (geometry = model input, layout, LUT)
+ * @param src Source image (RGB565)
+ * @param src_stride Source row stride in pixels
+ * @param src_width Source width (samples are clamped to the image)
+ * @param src_height Source height
+ * @param crop_x Box left in source pixels
+ * @param crop_y Box top in source pixels
+ * @param crop_width Box width (box inside the source)
+ * @param crop_height Box height
+ * @param dst_width Strip width (along the column, top to bottom)
+ * @param dst_height Strip height (across the column, right edge first)
+ * @param tensor Output int8 tensor (width * height * channels bytes)
+ * @details Processed in blocks of OCR_ROTATE_BLOCK output columns, each
+ *          quantized as it is written, so a block's few source rows stay
+ *          cached instead of striding the box height for every output row.
+ *          Up to an OCR_AREA_REDUCE_STEP reduction across the column the
+ *          samples are the ocr_affine_crop_rotate90() grid; beyond it each
+ *          output averages its source pixels as ocr_crop_rotate90_rgb565()
+ */
+void ocr_crop_rotate90_to_tensor(const ocr_tensor_quantizer_t *quantizer,
+                                 const uint16_t *src, uint32_t src_stride, uint16_t src_width, uint16_t src_height,
+                                 uint16_t crop_x, uint16_t crop_y, uint16_t crop_width, uint16_t crop_height,
+                                 uint16_t dst_width, uint16_t dst_height, int8_t *tensor);
+
+#endif // OCR_GEOMETRY_H
@@ -0,0 +1,537 @@
+/**
+ * @file ocr_layout.c
+ * @brief Reading-order reconstruction for detected text boxes
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#include "ocr_layout.h"
+#include "ocr_common.h"
+#include <string.h>
+
+#define OCR_LAYOUT_NONE     0xFFFFu
+#define OCR_LAYOUT_C_FLIP   (OCR_LAYOUT_MAX_COORD + 1)
+
+// Box or line extent along the reading axis (a) and across it (c)
+typedef struct {
+    int32_t a0, a1;
+    int32_t c0, c1;
+} ocr_layout_span_t;
+
+static inline int32_t ocr_layout_min(int32_t a, int32_t b)
+{
+    return a < b ? a : b;
+}
+
+static inline int32_t ocr_layout_max(int32_t a, int32_t b)
+{
+    return a > b ? a : b;
+}
+
+// Horizontal text reads along x and stacks down y. Vertical text reads along y and
+// stacks right to left, so c is mirrored to keep "next line" at increasing c
+static void ocr_layout_span(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint8_t direction,
+                            ocr_layout_span_t *s)
+{
+    const int32_t x0 = ocr_layout_min((int32_t)x, OCR_LAYOUT_MAX_COORD);
+    const int32_t y0 = ocr_layout_min((int32_t)y, OCR_LAYOUT_MAX_COORD);
+    const int32_t x1 = ocr_layout_min((int32_t)(x + w), OCR_LAYOUT_MAX_COORD);
+    const int32_t y1 = ocr_layout_min((int32_t)(y + h), OCR_LAYOUT_MAX_COORD);
+
+    if (direction) {
+        s->a0 = y0;
+        s->a1 = y1;
+        s->c0 = OCR_LAYOUT_C_FLIP - x1;
+        s->c1 = OCR_LAYOUT_C_FLIP - x0;
+    } else {
+        s->a0 = x0;
+        s->a1 = x1;
+        s->c0 = y0;
+        s->c1 = y1;
+    }
+}
+
+static void ocr_layout_line_span(const ocr_layout_line_t *line, ocr_layout_span_t *s)
+{
+    ocr_layout_span(line->x, line->y, line->width, line->height, line->direction, s);
+}
+
+// Grow image-space bounds by another rectangle
+static void ocr_layout_bounds_add(uint16_t *x, uint16_t *y, uint16_t *w, uint16_t *h,
+                                  uint32_t bx, uint32_t by, uint32_t bw, uint32_t bh)
+{
+    const uint32_t x1 = ocr_layout_max(*x + *w, bx + bw);
+    const uint32_t y1 = ocr_layout_max(*y + *h, by + bh);
+
+    *x = (uint16_t)ocr_layout_min(*x, bx);
+    *y = (uint16_t)ocr_layout_min(*y, by);
+    *w = (uint16_t)(x1 - *x);
+    *h = (uint16_t)(y1 - *y);
+}
+
+// In-place ascending heap sort of packed keys
+static void ocr_layout_sift(uint32_t *keys, uint32_t root, uint32_t n)
+{
+    for (;;) {
+        uint32_t child = 2 * root + 1;
+        if (child >= n) {
+            break;
+        }
+        if (child + 1 < n && keys[child + 1] > keys[child]) {
+            child++;
+        }
+        if (keys[child] <= keys[root]) {
+            break;
+        }
+        uint32_t t = keys[root];
+        keys[root] = keys[child];
+        keys[child] = t;
+        root = child;
+    }
+}
+
+static void ocr_layout_sort(uint32_t *keys, uint32_t n)
+{
+    for (uint32_t i = n / 2; i-- > 0;) {
+        ocr_layout_sift(keys, i, n);
+    }
+    for (uint32_t end = n; end > 1; end--) {
+        uint32_t t = keys[0];
+        keys[0] = keys[end - 1];
+        keys[end - 1] = t;
+        ocr_layout_sift(keys, 0, end - 1);
+    }
+}
+
+uint32_t ocr_layout_size(uint32_t capacity)
+{
+    const uint32_t index = ocr_align4(capacity * sizeof(uint16_t));
+
+    return 6u * index + ocr_align4(3u * capacity * sizeof(uint16_t)) +
+           capacity * sizeof(uint32_t) +
+           2u * capacity * sizeof(ocr_layout_line_t) +
+           2u * capacity * sizeof(ocr_layout_block_t);
+}
+
+int ocr_layout_init(ocr_layout_t *layout, uint32_t capacity, void *storage, uint32_t storage_size)
+{
+    uint8_t *p = (uint8_t*)storage;
+    const uint32_t index = ocr_align4(capacity * sizeof(uint16_t));
+
+    if (!layout || !storage || capacity == 0 || capacity > 0xFFFFu ||
+        storage_size < ocr_layout_size(capacity)) {
+        return -1;
+    }
+
+    memset(layout, 0, sizeof(*layout));
+    layout->capacity = (uint16_t)capacity;
+    layout->line_overlap_q8 = OCR_LAYOUT_LINE_OVERLAP_Q8;
+    layout->word_gap_q8 = OCR_LAYOUT_WORD_GAP_Q8;
+    layout->block_gap_q8 = OCR_LAYOUT_BLOCK_GAP_Q8;
+
+    // 4-byte members first, then the index arrays
+    layout->keys = (uint32_t*)p;
+    p += capacity * sizeof(uint32_t);
+    layout->lines = (ocr_layout_line_t*)p;
+    p += capacity * sizeof(ocr_layout_line_t);
+    layout->line_work = (ocr_layout_line_t*)p;
+    p += capacity * sizeof(ocr_layout_line_t);
+    layout->blocks = (ocr_layout_block_t*)p;
+    p += capacity * sizeof(ocr_layout_block_t);
+    layout->block_work = (ocr_layout_block_t*)p;
+    p += capacity * sizeof(ocr_layout_block_t);
+    layout->box_order = (uint16_t*)p;
+    p += index;
+    layout->sorted = (uint16_t*)p;
+    p += index;
+    layout->line_next = (uint16_t*)p;
+    p += index;
+    layout->block_tail = (uint16_t*)p;
+    p += index;
+    layout->open_blocks = (uint16_t*)p;
+    p += index;
+    layout->block_order = (uint16_t*)p;
+    p += index;
+    layout->stack = (uint16_t*)p;
+
+    return 0;
+}
+
+// ========================================================================
+// Lines
+// ========================================================================
+
+// Split one band of boxes (same direction, overlapping across the reading axis)
+// into lines wherever the gap along the reading axis is too wide
+static uint32_t ocr_layout_split_band(ocr_layout_t *layout, const ocr_det_boxes_t *boxes,
+                                      uint32_t begin, uint32_t end, uint32_t line_count)
+{
+    uint16_t *sorted = layout->sorted;
+    uint32_t *keys = layout->keys + begin;
+    const uint32_t n = end - begin;
+    const uint8_t direction = boxes->direction[sorted[begin]];
+    ocr_layout_line_t *line = NULL;
+    int32_t line_a1 = 0;
+    int32_t line_thick = 0;
+
+    for (uint32_t k = 0; k < n; k++) {
+        const uint16_t i = sorted[begin + k];
+        ocr_layout_span_t s;
+        ocr_layout_span(boxes->x[i], boxes->y[i], boxes->width[i], boxes->height[i], direction, &s);
+        keys[k] = ((uint32_t)s.a0 << 16) | i;
+    }
+    ocr_layout_sort(keys, n);
+
+    for (uint32_t k = 0; k < n; k++) {
+        const uint16_t i = (uint16_t)(keys[k] & 0xFFFFu);
+        ocr_layout_span_t s;
+        ocr_layout_span(boxes->x[i], boxes->y[i], boxes->width[i], boxes->height[i], direction, &s);
+        sorted[begin + k] = i;
+
+        const int32_t thick = ocr_layout_max(line_thick, s.c1 - s.c0);
+        if (line && s.a0 - line_a1 <= (thick * layout->word_gap_q8) >> 8) {
+            ocr_layout_bounds_add(&line->x, &line->y, &line->width, &line->height,
+                                  boxes->x[i], boxes->y[i], boxes->width[i], boxes->height[i]);
+            line->box_count++;
+            line_a1 = ocr_layout_max(line_a1, s.a1);
+            line_thick = thick;
+            continue;
+        }
+
+        line = &layout->line_work[line_count];
+        line->x = boxes->x[i];
+        line->y = boxes->y[i];
+        line->width = boxes->width[i];
+        line->height = boxes->height[i];
+        line->first_box = (uint16_t)(begin + k);
+        line->box_count = 1;
+        line->block = OCR_LAYOUT_NONE;
+        line->direction = direction;
+        line_a1 = s.a1;
+        line_thick = s.c1 - s.c0;
+        line_count++;
+    }
+
+    return line_count;
+}
+
+// Sort boxes by direction and centre across the reading axis, then sweep them
+// into bands and split each band into lines
+static uint32_t ocr_layout_lines(ocr_layout_t *layout, const ocr_det_boxes_t *boxes)
+{
+    const uint32_t n = boxes->count;
+    uint32_t *keys = layout->keys;
+    uint16_t *sorted = layout->sorted;
+    uint32_t line_count = 0;
+    uint32_t band_begin = 0;
+    int32_t band_c0 = 0, band_c1 = 0, band_thick = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        ocr_layout_span_t s;
+        const uint8_t d = boxes->direction[i] ? 1 : 0;
+        ocr_layout_span(boxes->x[i], boxes->y[i], boxes->width[i], boxes->height[i], d, &s);
+        keys[i] = ((uint32_t)d << 31) | ((uint32_t)((s.c0 + s.c1) >> 1) << 16) | i;
+    }
+    ocr_layout_sort(keys, n);
+    for (uint32_t k = 0; k < n; k++) {
+        sorted[k] = (uint16_t)(keys[k] & 0xFFFFu);
+    }
+
+    // Keys are reused per band, so collect band bounds first in sorted order
+    for (uint32_t k = 0; k < n; k++) {
+        const uint16_t i = sorted[k];
+        const uint8_t d = boxes->direction[i] ? 1 : 0;
+        ocr_layout_span_t s;
+        ocr_layout_span(boxes->x[i], boxes->y[i], boxes->width[i], boxes->height[i], d, &s);
+
+        const int32_t thick = s.c1 - s.c0;
+        if (k > band_begin && d == (boxes->direction[sorted[band_begin]] ? 1 : 0)) {
+            const int32_t overlap = ocr_layout_min(s.c1, band_c1) - ocr_layout_max(s.c0, band_c0);
+            const int32_t thinner = ocr_layout_min(thick, band_thick);
+            if (overlap * 256 >= thinner * layout->line_overlap_q8) {
+                band_c0 = ocr_layout_min(band_c0, s.c0);
+                band_c1 = ocr_layout_max(band_c1, s.c1);
+                band_thick = ocr_layout_max(band_thick, thick);
+                continue;
+            }
+        }
+        if (k > band_begin) {
+            line_count = ocr_layout_split_band(layout, boxes, band_begin, k, line_count);
+        }
+        band_begin = k;
+        band_c0 = s.c0;
+        band_c1 = s.c1;
+        band_thick = thick;
+    }
+    if (n > band_begin) {
+        line_count = ocr_layout_split_band(layout, boxes, band_begin, n, line_count);
+    }
+
+    return line_count;
+}
+
+// ========================================================================
+// Blocks
+// ========================================================================
+
+// Chain lines into blocks: the next line of a block follows the previous one
+// across the reading axis, overlaps it along the axis and has a similar size
+static uint32_t ocr_layout_blocks(ocr_layout_t *layout, uint32_t line_count)
+{
+    ocr_layout_line_t *lines = layout->line_work;
+    uint16_t *open = layout->open_blocks;
+    uint32_t open_count = 0;
+    uint32_t block_count = 0;
+
+    for (uint32_t l = 0; l < line_count; l++) {
+        ocr_layout_line_t *line = &lines[l];
+        ocr_layout_span_t s;
+        const int32_t thick = line->direction ? line->width : line->height;
+        int32_t best_gap = INT32_MAX;
+        uint32_t best = OCR_LAYOUT_NONE;
+        uint32_t kept = 0;
+
+        ocr_layout_line_span(line, &s);
+        layout->line_next[l] = OCR_LAYOUT_NONE;
+
+        for (uint32_t k = 0; k < open_count; k++) {
+            const uint16_t b = open[k];
+            const ocr_layout_line_t *tail = &lines[layout->block_tail[b]];
+            const int32_t tail_thick = tail->direction ? tail->width : tail->height;
+            ocr_layout_span_t t;
+            ocr_layout_line_span(tail, &t);
+
+            // Lines arrive in increasing c; no later line can reach this block
+            const int32_t gap = s.c0 - t.c1;
+            if (gap > ((2 * tail_thick * layout->block_gap_q8) >> 8)) {
+                continue;
+            }
+            open[kept++] = b;
+
+            if (tail->direction != line->direction || 2 * s.c0 < t.c0 + t.c1) {
+                continue;   // Other orientation, or still the same band
+            }
+            if (thick > 2 * tail_thick || tail_thick > 2 * thick) {
+                continue;
+            }
+            const int32_t thicker = ocr_layout_max(thick, tail_thick);
+            if (gap > ((thicker * layout->block_gap_q8) >> 8)) {
+                continue;
+            }
+            const int32_t overlap = ocr_layout_min(s.a1, t.a1) - ocr_layout_max(s.a0, t.a0);
+            const int32_t shorter = ocr_layout_min(s.a1 - s.a0, t.a1 - t.a0);
+            if (2 * overlap < shorter) {
+                continue;
+            }
+            if (gap < best_gap) {
+                best_gap = gap;
+                best = b;
+            }
+        }
+        open_count = kept;
+
+        if (best != OCR_LAYOUT_NONE) {
+            ocr_layout_block_t *block = &layout->block_work[best];
+            layout->line_next[layout->block_tail[best]] = (uint16_t)l;
+            layout->block_tail[best] = (uint16_t)l;
+            ocr_layout_bounds_add(&block->x, &block->y, &block->width, &block->height,
+                                  line->x, line->y, line->width, line->height);
+            block->line_count++;
+            line->block = (uint16_t)best;
+            continue;
+        }
+
+        ocr_layout_block_t *block = &layout->block_work[block_count];
+        block->x = line->x;
+        block->y = line->y;
+        block->width = line->width;
+        block->height = line->height;
+        block->first_line = (uint16_t)l;
+        block->line_count = 1;
+        block->column = 0;
+        block->direction = line->direction;
+        layout->block_tail[block_count] = (uint16_t)l;
+        line->block = (uint16_t)block_count;
+        open[open_count++] = (uint16_t)block_count;
+        block_count++;
+    }
+
+    return block_count;
+}
+
+// ========================================================================
+// Reading order (XY cut)
+// ========================================================================
+
+// Sort a segment of block_order by one edge, then cut it wherever no block spans
+// the gap. Parts are pushed in ascending order; returns the number pushed
+static uint32_t ocr_layout_cut(ocr_layout_t *layout, uint32_t begin, uint32_t end,
+                               int vertical, uint32_t *sp)
+{
+    uint16_t *order = layout->block_order;
+    uint32_t *keys = layout->keys + begin;
+    const uint32_t n = end - begin;
+    uint32_t parts = 0;
+    uint32_t part_begin = begin;
+    int32_t reach = 0;
+
+    for (uint32_t k = 0; k < n; k++) {
+        const ocr_layout_block_t *b = &layout->block_work[order[begin + k]];
+        keys[k] = ((uint32_t)(vertical ? b->x : b->y) << 16) | order[begin + k];
+    }
+    ocr_layout_sort(keys, n);
+
+    for (uint32_t k = 0; k < n; k++) {
+        const uint16_t bi = (uint16_t)(keys[k] & 0xFFFFu);
+        const ocr_layout_block_t *b = &layout->block_work[bi];
+        const int32_t lo = vertical ? b->x : b->y;
+        const int32_t hi = lo + (vertical ? b->width : b->height);
+
+        order[begin + k] = bi;
+        if (k > 0 && lo >= reach) {
+            layout->stack[3 * *sp] = (uint16_t)part_begin;
+            layout->stack[3 * *sp + 1] = (uint16_t)(begin + k);
+            (*sp)++;
+            parts++;
+            part_begin = begin + k;
+        }
+        reach = (k == 0) ? hi : ocr_layout_max(reach, hi);
+    }
+    layout->stack[3 * *sp] = (uint16_t)part_begin;
+    layout->stack[3 * *sp + 1] = (uint16_t)end;
+    (*sp)++;
+
+    return parts + 1;
+}
+
+// Reverse the last count stack entries so the first part is popped first
+static void ocr_layout_stack_reverse(uint16_t *stack, uint32_t first, uint32_t count)
+{
+    for (uint32_t i = 0, j = count - 1; i < j; i++, j--) {
+        for (uint32_t f = 0; f < 3; f++) {
+            uint16_t t = stack[3 * (first + i) + f];
+            stack[3 * (first + i) + f] = stack[3 * (first + j) + f];
+            stack[3 * (first + j) + f] = t;
+        }
+    }
+}
+
+static void ocr_layout_emit_block(ocr_layout_t *layout, uint16_t b, uint8_t column)
+{
+    const ocr_layout_block_t *src = &layout->block_work[b];
+    ocr_layout_block_t *block = &layout->blocks[layout->block_count];
+
+    *block = *src;
+    block->first_line = layout->line_count;
+    block->column = column;
+
+    for (uint32_t l = src->first_line; l != OCR_LAYOUT_NONE; l = layout->line_next[l]) {
+        const ocr_layout_line_t *work = &layout->line_work[l];
+        ocr_layout_line_t *line = &layout->lines[layout->line_count++];
+
+        *line = *work;
+        line->first_box = layout->box_count;
+        line->block = layout->block_count;
+        memcpy(&layout->box_order[layout->box_count], &layout->sorted[work->first_box],
+               work->box_count * sizeof(uint16_t));
+        layout->box_count += work->box_count;
+    }
+    layout->block_count++;
+}
+
+// Horizontal cuts first (sections top to bottom), then vertical cuts (columns
+// left to right, or right to left on a vertical page); recurse on every part
+static void ocr_layout_order(ocr_layout_t *layout, uint32_t block_count)
+{
+    uint16_t *stack = layout->stack;
+    uint32_t sp = 0;
+
+    for (uint32_t b = 0; b < block_count; b++) {
+        layout->block_order[b] = (uint16_t)b;
+    }
+    stack[0] = 0;
+    stack[1] = (uint16_t)block_count;
+    stack[2] = 0;
+    sp = 1;
+
+    while (sp > 0) {
+        sp--;
+        const uint32_t begin = stack[3 * sp];
+        const uint32_t end = stack[3 * sp + 1];
+        const uint16_t column = stack[3 * sp + 2];
+
+        if (end - begin == 1) {
+            ocr_layout_emit_block(layout, layout->block_order[begin], (uint8_t)column);
+            continue;
+        }
+
+        // Sections keep the column of their parent
+        const uint32_t first = sp;
+        uint32_t parts = ocr_layout_cut(layout, begin, end, 0, &sp);
+        if (parts > 1) {
+            for (uint32_t p = 0; p < parts; p++) {
+                stack[3 * (first + p) + 2] = column;
+            }
+            ocr_layout_stack_reverse(stack, first, parts);
+            continue;
+        }
+        sp = first;
+
+        parts = ocr_layout_cut(layout, begin, end, 1, &sp);
+        if (parts > 1) {
+            if (parts > layout->column_count) {
+                layout->column_count = (uint16_t)parts;
+            }
+            for (uint32_t p = 0; p < parts; p++) {
+                stack[3 * (first + p) + 2] = (uint16_t)(layout->direction ? parts - 1 - p : p);
+            }
+            // Ascending x already pops the rightmost column first
+            if (!layout->direction) {
+                ocr_layout_stack_reverse(stack, first, parts);
+            }
+            continue;
+        }
+        sp = first;
+
+        // Overlapping blocks: order by their position across the dominant reading axis
+        uint32_t *keys = layout->keys + begin;
+        for (uint32_t k = begin; k < end; k++) {
+            const ocr_layout_block_t *b = &layout->block_work[layout->block_order[k]];
+            const uint32_t c = layout->direction ? (uint32_t)(OCR_LAYOUT_C_FLIP - (b->x + b->width)) : b->y;
+            keys[k - begin] = (c << 16) | layout->block_order[k];
+        }
+        ocr_layout_sort(keys, end - begin);
+        for (uint32_t k = 0; k < end - begin; k++) {
+            ocr_layout_emit_block(layout, (uint16_t)(keys[k] & 0xFFFFu), (uint8_t)column);
+        }
+    }
+}
+
+int ocr_layout_build(ocr_layout_t *layout, const ocr_det_boxes_t *boxes)
+{
+    uint32_t vertical = 0;
+
+    if (!layout || !boxes || boxes->count > layout->capacity) {
+        return -1;
+    }
+
+    layout->box_count = 0;
+    layout->line_count = 0;
+    layout->block_count = 0;
+    layout->column_count = boxes->count ? 1 : 0;
+
+    for (uint32_t i = 0; i < boxes->count; i++) {
+        vertical += boxes->direction[i] ? 1 : 0;
+    }
+    layout->direction = (2 * vertical > boxes->count) ? 1 : 0;
+
+    if (boxes->count == 0) {
+        return 0;
+    }
+
+    const uint32_t line_count = ocr_layout_lines(layout, boxes);
+    const uint32_t block_count = ocr_layout_blocks(layout, line_count);
+    ocr_layout_order(layout, block_count);
+
+    return (int)layout->line_count;
+}
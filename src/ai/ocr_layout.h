@@ -0,0 +1,98 @@
+/**
+ * @file ocr_layout.h
+ * @brief Reading-order reconstruction for detected text boxes
+ * @details Clusters boxes into lines, lines into blocks and orders blocks by
+ *          recursive XY cuts. Horizontal text reads left to right, top to
+ *          bottom; vertical text top to bottom, right to left.
+ *          Platform independent (no HAL dependency)
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#ifndef OCR_LAYOUT_H
+#define OCR_LAYOUT_H
+
+#include <stdint.h>
+#include "ocr_textdet.h"
+
+// Defaults (Q8 fractions of the line thickness)
+#define OCR_LAYOUT_LINE_OVERLAP_Q8  128   // Same line: overlap >= 50% of the thinner box
+#define OCR_LAYOUT_WORD_GAP_Q8      640   // Gap along a line > 2.5 thicknesses splits it
+#define OCR_LAYOUT_BLOCK_GAP_Q8     256   // Next line of a block starts within 1 thickness
+#define OCR_LAYOUT_MAX_COORD        4095  // Box coordinates must stay below this
+
+// Text line in reading order
+typedef struct {
+    uint16_t x, y, width, height;   // Bounds of its boxes
+    uint16_t first_box;             // Index into box_order
+    uint16_t box_count;
+    uint16_t block;                 // Owning block
+    uint8_t direction;              // 0=horizontal, 1=vertical
+} ocr_layout_line_t;
+
+// Text block (paragraph) in reading order
+typedef struct {
+    uint16_t x, y, width, height;   // Bounds of its lines
+    uint16_t first_line;            // Index into lines
+    uint16_t line_count;
+    uint8_t column;                 // Column within its section of the page
+    uint8_t direction;
+} ocr_layout_block_t;
+
+// Layout engine state and output
+typedef struct {
+    uint16_t capacity;              // Maximum boxes
+    uint16_t line_overlap_q8;
+    uint16_t word_gap_q8;
+    uint16_t block_gap_q8;
+
+    // Output
+    uint16_t *box_order;            // Box indices in reading order, contiguous per line
+    ocr_layout_line_t *lines;       // Lines in reading order, contiguous per block
+    ocr_layout_block_t *blocks;     // Blocks in reading order
+    uint16_t box_count;
+    uint16_t line_count;
+    uint16_t block_count;
+    uint16_t column_count;          // Most columns found side by side
+    uint8_t direction;              // Dominant direction of the page
+
+    // Working buffers
+    uint32_t *keys;                 // Sort keys
+    uint16_t *sorted;               // Boxes grouped by line
+    ocr_layout_line_t *line_work;   // Lines in detection order
+    uint16_t *line_next;            // Next line of the same block
+    ocr_layout_block_t *block_work; // Blocks as built (first_line = head of the chain)
+    uint16_t *block_tail;
+    uint16_t *open_blocks;          // Blocks that can still take a line
+    uint16_t *block_order;
+    uint16_t *stack;                // XY-cut segments (begin, end, column)
+} ocr_layout_t;
+
+/**
+ * @brief Get storage required for the layout engine
+ * @param capacity Maximum boxes (<= 65535)
+ * @return Required storage in bytes
+ */
+uint32_t ocr_layout_size(uint32_t capacity);
+
+/**
+ * @brief Initialize the layout engine with default thresholds
+ * @param layout Layout engine
+ * @param capacity Maximum boxes
+ * @param storage Storage (4-byte aligned, ocr_layout_size() bytes)
+ * @param storage_size Size of storage in bytes
+ * @return 0 on success, negative on error
+ */
+int ocr_layout_init(ocr_layout_t *layout, uint32_t capacity, void *storage, uint32_t storage_size);
+
+/**
+ * @brief Reconstruct lines, blocks and reading order
+ * @param layout Layout engine
+ * @param boxes Detected boxes (axis-aligned bounds and direction are used)
+ * @return Number of lines, negative on error
+ * @details Sorting dominates: O(n log n) for boxes and blocks per cut level.
+ *          Line and block sweeps are linear, times the columns open at once
+ */
+int ocr_layout_build(ocr_layout_t *layout, const ocr_det_boxes_t *boxes);
+
+#endif // OCR_LAYOUT_H
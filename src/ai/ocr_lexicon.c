@@ -0,0 +1,194 @@
+/**
+ * @file ocr_lexicon.c
+ * @brief Compact lexicon trie over recognition classes, read in place from flash
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#include "ocr_lexicon.h"
+#include "ocr_common.h"
+#include <string.h>
+
+// Image header: magic, node count, edge count
+#define OCR_LEXICON_HEADER_WORDS 3
+
+// Builder node (scratch): children kept as a list sorted by class
+typedef struct {
+    uint32_t first_child;
+    uint32_t next_sibling;
+    uint16_t label;
+    uint16_t word;
+} ocr_lexicon_build_node_t;
+
+#define OCR_LEXICON_BUILD_END 0xFFFFFFFFu
+
+int ocr_lexicon_map(ocr_lexicon_t *lexicon, const void *image, uint32_t image_size)
+{
+    const uint32_t *header = (const uint32_t*)image;
+
+    if (!lexicon || !image || image_size < OCR_LEXICON_HEADER_WORDS * sizeof(uint32_t) ||
+        header[0] != OCR_LEXICON_MAGIC || header[1] == 0 || header[2] + 1 != header[1]) {
+        return -1;
+    }
+    const uint32_t node_count = header[1];
+    const uint32_t edge_count = header[2];
+    const uint32_t needed = (OCR_LEXICON_HEADER_WORDS + node_count + 1) * sizeof(uint32_t) +
+                            edge_count * sizeof(uint16_t);
+    if (image_size < needed) {
+        return -1;
+    }
+
+    lexicon->nodes = header + OCR_LEXICON_HEADER_WORDS;
+    lexicon->labels = (const uint16_t*)(lexicon->nodes + node_count + 1);
+    lexicon->node_count = node_count;
+    lexicon->edge_count = edge_count;
+    return 0;
+}
+
+uint32_t ocr_lexicon_child(const ocr_lexicon_t *lexicon, uint32_t node, uint16_t label)
+{
+    if (node >= lexicon->node_count) {
+        return OCR_LEXICON_NONE;
+    }
+
+    // Binary search over the sorted edges of the node
+    uint32_t lo = lexicon->nodes[node] & ~OCR_LEXICON_WORD_FLAG;
+    uint32_t hi = lexicon->nodes[node + 1] & ~OCR_LEXICON_WORD_FLAG;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) >> 1;
+        if (lexicon->labels[mid] < label) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < (lexicon->nodes[node + 1] & ~OCR_LEXICON_WORD_FLAG) && lexicon->labels[lo] == label) {
+        return lo + 1;
+    }
+    return OCR_LEXICON_NONE;
+}
+
+uint8_t ocr_lexicon_is_word(const ocr_lexicon_t *lexicon, uint32_t node)
+{
+    return node < lexicon->node_count && (lexicon->nodes[node] & OCR_LEXICON_WORD_FLAG) != 0;
+}
+
+// ========================================================================
+// Builder
+// ========================================================================
+
+uint32_t ocr_lexicon_build_scratch_size(uint32_t words_size)
+{
+    // Every character is at least one byte: at most words_size nodes + root
+    return (words_size + 1) * (sizeof(ocr_lexicon_build_node_t) + sizeof(uint32_t));
+}
+
+uint32_t ocr_lexicon_build_image_size(uint32_t words_size)
+{
+    return (OCR_LEXICON_HEADER_WORDS + words_size + 2) * sizeof(uint32_t) +
+           ocr_align4(words_size * sizeof(uint16_t));
+}
+
+// Bytes of the UTF-8 character starting with lead, 0 if not a lead byte
+static uint32_t ocr_utf8_length(uint8_t lead)
+{
+    if (lead < 0x80) {
+        return 1;
+    }
+    if ((lead & 0xE0) == 0xC0) {
+        return 2;
+    }
+    if ((lead & 0xF0) == 0xE0) {
+        return 3;
+    }
+    if ((lead & 0xF8) == 0xF0) {
+        return 4;
+    }
+    return 0;
+}
+
+// Child of node with the class, created in class order if missing
+static uint32_t ocr_lexicon_build_child(ocr_lexicon_build_node_t *nodes, uint32_t *count,
+                                        uint32_t node, uint16_t label)
+{
+    uint32_t *link = &nodes[node].first_child;
+
+    while (*link != OCR_LEXICON_BUILD_END && nodes[*link].label < label) {
+        link = &nodes[*link].next_sibling;
+    }
+    if (*link != OCR_LEXICON_BUILD_END && nodes[*link].label == label) {
+        return *link;
+    }
+
+    uint32_t child = (*count)++;
+    nodes[child].first_child = OCR_LEXICON_BUILD_END;
+    nodes[child].next_sibling = *link;
+    nodes[child].label = label;
+    nodes[child].word = 0;
+    *link = child;
+    return child;
+}
+
+int ocr_lexicon_build(const ocr_charset_t *charset, const uint8_t *words, uint32_t words_size,
+                      void *scratch, uint32_t scratch_size, void *image, uint32_t image_size)
+{
+    if (!charset || !words || !scratch || !image ||
+        scratch_size < ocr_lexicon_build_scratch_size(words_size) ||
+        image_size < ocr_lexicon_build_image_size(words_size)) {
+        return -1;
+    }
+
+    ocr_lexicon_build_node_t *nodes = (ocr_lexicon_build_node_t*)scratch;
+    uint32_t *queue = (uint32_t*)(nodes + words_size + 1);
+    uint32_t count = 1;
+    nodes[0].first_child = OCR_LEXICON_BUILD_END;
+    nodes[0].next_sibling = OCR_LEXICON_BUILD_END;
+    nodes[0].word = 0;
+
+    // Insert every line
+    uint32_t node = OCR_LEXICON_ROOT;
+    for (uint32_t i = 0; i < words_size;) {
+        if (words[i] == '\n' || words[i] == '\r') {
+            nodes[node].word |= (node != OCR_LEXICON_ROOT);
+            node = OCR_LEXICON_ROOT;
+            i++;
+            continue;
+        }
+        uint32_t length = ocr_utf8_length(words[i]);
+        if (length == 0 || i + length > words_size) {
+            return -1;
+        }
+        int32_t entry = ocr_charset_find(charset, words + i, length);
+        if (entry < 0) {
+            return -1;
+        }
+        node = ocr_lexicon_build_child(nodes, &count, node, (uint16_t)(entry + 1));
+        i += length;
+    }
+    nodes[node].word |= (node != OCR_LEXICON_ROOT);
+
+    // Breadth-first numbering: the children of a node get consecutive numbers,
+    // so edge e (in this order) ends at node e + 1
+    uint32_t *header = (uint32_t*)image;
+    uint32_t *out_nodes = header + OCR_LEXICON_HEADER_WORDS;
+    uint16_t *out_labels = (uint16_t*)(out_nodes + count + 1);
+    uint32_t head = 0, tail = 0, edges = 0;
+
+    queue[tail++] = OCR_LEXICON_ROOT;
+    while (head < tail) {
+        uint32_t n = queue[head];
+        out_nodes[head] = edges | (nodes[n].word ? OCR_LEXICON_WORD_FLAG : 0);
+        for (uint32_t c = nodes[n].first_child; c != OCR_LEXICON_BUILD_END; c = nodes[c].next_sibling) {
+            out_labels[edges++] = nodes[c].label;
+            queue[tail++] = c;
+        }
+        head++;
+    }
+    out_nodes[count] = edges;
+
+    header[0] = OCR_LEXICON_MAGIC;
+    header[1] = count;
+    header[2] = edges;
+    return (int)((OCR_LEXICON_HEADER_WORDS + count + 1) * sizeof(uint32_t) +
+                 ocr_align4(edges * sizeof(uint16_t)));
+}
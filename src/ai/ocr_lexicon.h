@@ -0,0 +1,90 @@
+/**
+ * @file ocr_lexicon.h
+ * @brief Compact lexicon trie over recognition classes, read in place from flash
+ * @details Flash image (little endian, 4-byte aligned):
+ *            uint32 magic, node count, edge count
+ *            uint32 nodes[node count + 1]: first edge of each node, bit 31
+ *                   set if the node ends a word (last entry: sentinel)
+ *            uint16 labels[edge count]: edge classes, sorted per node
+ *          Nodes are numbered breadth first, so edge e leads to node e + 1
+ *          and no child pointers are stored (about 6 bytes per character).
+ *          The builder runs on the host or once at startup.
+ *          Platform independent (no HAL dependency)
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#ifndef OCR_LEXICON_H
+#define OCR_LEXICON_H
+
+#include <stdint.h>
+#include "ocr_ctc.h"
+
+#define OCR_LEXICON_MAGIC     0x3158454Cu   // "LEX1"
+#define OCR_LEXICON_ROOT      0u
+#define OCR_LEXICON_NONE      0xFFFFFFFFu   // Prefix has left the lexicon
+#define OCR_LEXICON_WORD_FLAG 0x80000000u
+
+// Mapped lexicon (pointers into the flash image)
+typedef struct {
+    const uint32_t *nodes;
+    const uint16_t *labels;
+    uint32_t node_count;
+    uint32_t edge_count;
+} ocr_lexicon_t;
+
+/**
+ * @brief Map a lexicon image in place
+ * @param lexicon Lexicon
+ * @param image Flash image (4-byte aligned, must outlive the lexicon)
+ * @param image_size Size of the image in bytes
+ * @return 0 on success, negative if the image is not a lexicon
+ */
+int ocr_lexicon_map(ocr_lexicon_t *lexicon, const void *image, uint32_t image_size);
+
+/**
+ * @brief Follow one class from a node
+ * @param lexicon Lexicon
+ * @param node Node (OCR_LEXICON_ROOT for the start of a word)
+ * @param label Recognition class
+ * @return Child node, OCR_LEXICON_NONE if no word continues with the class
+ */
+uint32_t ocr_lexicon_child(const ocr_lexicon_t *lexicon, uint32_t node, uint16_t label);
+
+/**
+ * @brief Check whether a node ends a word
+ * @param lexicon Lexicon
+ * @param node Node
+ * @return 1 if the classes up to the node are a word
+ */
+uint8_t ocr_lexicon_is_word(const ocr_lexicon_t *lexicon, uint32_t node);
+
+/**
+ * @brief Get scratch required to build a lexicon
+ * @param words_size Size of the word list in bytes
+ * @return Required scratch in bytes
+ */
+uint32_t ocr_lexicon_build_scratch_size(uint32_t words_size);
+
+/**
+ * @brief Get an upper bound of the image size of a lexicon
+ * @param words_size Size of the word list in bytes
+ * @return Image size in bytes, never exceeded by ocr_lexicon_build()
+ */
+uint32_t ocr_lexicon_build_image_size(uint32_t words_size);
+
+/**
+ * @brief Build a lexicon image from a word list
+ * @param charset Recognition dictionary (class i + 1 is entry i)
+ * @param words One UTF-8 word per line, same format as the dictionary
+ * @param words_size Size of the word list in bytes
+ * @param scratch Scratch (4-byte aligned, ocr_lexicon_build_scratch_size() bytes)
+ * @param scratch_size Size of scratch in bytes
+ * @param image Output image (4-byte aligned)
+ * @param image_size Size of image in bytes
+ * @return Image bytes written, negative on error (character not in the dictionary)
+ */
+int ocr_lexicon_build(const ocr_charset_t *charset, const uint8_t *words, uint32_t words_size,
+                      void *scratch, uint32_t scratch_size, void *image, uint32_t image_size);
+
+#endif // OCR_LEXICON_H
@@ -0,0 +1,210 @@
+/**
+ * @file ocr_prefilter.c
+ * @brief CPU text-presence prefilter ahead of NPU detection
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#include "ocr_prefilter.h"
+#include "ocr_common.h"
+#include <string.h>
+
+// Score per stroke and scanned pixel (Q11: 16 per stroke on a 16x8 scan)
+#define OCR_PREFILTER_SCORE_SHIFT 11
+
+uint32_t ocr_prefilter_size(uint16_t width, uint16_t height, uint16_t tile_size)
+{
+    if (tile_size == 0) {
+        return 0;
+    }
+    const uint32_t tiles = (uint32_t)((width + tile_size - 1) / tile_size) *
+                           ((height + tile_size - 1) / tile_size);
+    return ocr_align4(tiles * sizeof(uint16_t)) + ocr_align4(tiles);
+}
+
+int ocr_prefilter_init(ocr_prefilter_t *prefilter, uint16_t width, uint16_t height,
+                       uint16_t tile_size, void *storage, uint32_t storage_size)
+{
+    if (!prefilter || !storage || width < 3 || height == 0 || tile_size == 0 ||
+        storage_size < ocr_prefilter_size(width, height, tile_size)) {
+        return -1;
+    }
+
+    uint8_t *p = (uint8_t*)storage;
+    prefilter->width = width;
+    prefilter->height = height;
+    prefilter->tile_size = tile_size;
+    prefilter->tiles_x = (uint16_t)((width + tile_size - 1) / tile_size);
+    prefilter->tiles_y = (uint16_t)((height + tile_size - 1) / tile_size);
+
+    const uint32_t tiles = (uint32_t)prefilter->tiles_x * prefilter->tiles_y;
+    prefilter->strokes = (uint16_t*)p;
+    p += ocr_align4(tiles * sizeof(uint16_t));
+    prefilter->scores = p;
+    memset(prefilter->scores, 0, tiles);
+
+    prefilter->row_step = OCR_PREFILTER_ROW_STEP;
+    prefilter->edge_thresh = OCR_PREFILTER_EDGE_THRESH;
+    prefilter->max_stroke = OCR_PREFILTER_MAX_STROKE;
+    prefilter->tile_thresh = OCR_PREFILTER_TILE_THRESH;
+    prefilter->min_tiles = OCR_PREFILTER_MIN_TILES;
+    prefilter->likely_tiles = 0;
+    prefilter->max_score = 0;
+    return 0;
+}
+
+// Strokes of one row, added to the tiles of its tile row. The first stroke of
+// the row in each tile is not counted: a lone line (cable, door edge) crosses
+// a tile once per row, glyphs cross it several times
+static void ocr_prefilter_row(const ocr_prefilter_t *pf, const int8_t *row, uint32_t pixel_stride,
+                              uint16_t *strokes)
+{
+    const int32_t thresh = pf->edge_thresh;
+    const uint32_t max_stroke = pf->max_stroke;
+    const uint32_t tile = pf->tile_size;
+    int32_t last_sign = 0;
+    uint32_t last_x = 0;
+    uint32_t run_tile = 0;
+    uint32_t run = 0;
+
+    for (uint32_t x = 1; x + 1 < pf->width; x++) {
+        const int32_t g = (int32_t)row[(x + 1) * pixel_stride] - (int32_t)row[(x - 1) * pixel_stride];
+        int32_t sign;
+        if (g > thresh) {
+            sign = 1;
+        } else if (g < -thresh) {
+            sign = -1;
+        } else {
+            continue;
+        }
+
+        // Opposite edge close behind the last one: both sides of a stroke
+        if (sign != last_sign) {
+            if (last_sign != 0 && x - last_x <= max_stroke) {
+                const uint32_t t = x / tile;
+                if (t != run_tile) {
+                    strokes[run_tile] += (uint16_t)(run ? run - 1 : 0);
+                    run_tile = t;
+                    run = 0;
+                }
+                run++;
+            }
+            last_sign = sign;
+        }
+        last_x = x;
+    }
+    strokes[run_tile] += (uint16_t)(run ? run - 1 : 0);
+}
+
+uint32_t ocr_prefilter_run(ocr_prefilter_t *prefilter, const int8_t *plane,
+                           uint32_t pixel_stride, uint32_t row_stride)
+{
+    const uint32_t tiles_x = prefilter->tiles_x;
+    const uint32_t tile = prefilter->tile_size;
+    const uint32_t step = prefilter->row_step ? prefilter->row_step : 1;
+    uint32_t likely = 0;
+    uint8_t max_score = 0;
+
+    memset(prefilter->strokes, 0, (uint32_t)tiles_x * prefilter->tiles_y * sizeof(uint16_t));
+
+    for (uint32_t y = 0; y < prefilter->height; y += step) {
+        ocr_prefilter_row(prefilter, plane + y * row_stride, pixel_stride,
+                          prefilter->strokes + (y / tile) * tiles_x);
+    }
+
+    // Strokes per scanned pixel; partial edge tiles scan fewer pixels
+    for (uint32_t ty = 0; ty < prefilter->tiles_y; ty++) {
+        const uint32_t y0 = ty * tile;
+        const uint32_t y1 = (y0 + tile < prefilter->height) ? y0 + tile : prefilter->height;
+        const uint32_t rows = (y1 + step - 1) / step - (y0 + step - 1) / step;
+
+        for (uint32_t tx = 0; tx < tiles_x; tx++) {
+            const uint32_t x0 = tx * tile;
+            const uint32_t cols = (x0 + tile < prefilter->width) ? tile : prefilter->width - x0;
+            const uint32_t scanned = rows * cols;
+            const uint32_t n = prefilter->strokes[ty * tiles_x + tx];
+            uint32_t score = scanned ? (n << OCR_PREFILTER_SCORE_SHIFT) / scanned : 0;
+            score = (score > 255) ? 255 : score;
+
+            prefilter->scores[ty * tiles_x + tx] = (uint8_t)score;
+            likely += (score >= prefilter->tile_thresh);
+            max_score = (score > max_score) ? (uint8_t)score : max_score;
+        }
+    }
+
+    prefilter->likely_tiles = (uint16_t)likely;
+    prefilter->max_score = max_score;
+    return likely;
+}
+
+uint8_t ocr_prefilter_has_text(const ocr_prefilter_t *prefilter)
+{
+    return prefilter->likely_tiles >= prefilter->min_tiles;
+}
+
+// Tile is likely or next to a likely tile
+static uint8_t ocr_prefilter_kept(const ocr_prefilter_t *pf, uint32_t tx, uint32_t ty)
+{
+    const uint32_t x0 = tx ? tx - 1 : 0;
+    const uint32_t y0 = ty ? ty - 1 : 0;
+    const uint32_t x1 = (tx + 1 < pf->tiles_x) ? tx + 1 : tx;
+    const uint32_t y1 = (ty + 1 < pf->tiles_y) ? ty + 1 : ty;
+
+    for (uint32_t y = y0; y <= y1; y++) {
+        for (uint32_t x = x0; x <= x1; x++) {
+            if (pf->scores[y * pf->tiles_x + x] >= pf->tile_thresh) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+uint8_t ocr_prefilter_region_likely(const ocr_prefilter_t *prefilter, uint32_t x, uint32_t y,
+                                    uint32_t width, uint32_t height)
+{
+    const uint32_t tile = prefilter->tile_size;
+
+    if (width == 0 || height == 0 || x >= prefilter->width || y >= prefilter->height) {
+        return 0;
+    }
+    const uint32_t x1 = (x + width < prefilter->width) ? x + width : prefilter->width;
+    const uint32_t y1 = (y + height < prefilter->height) ? y + height : prefilter->height;
+
+    for (uint32_t ty = y / tile; ty <= (y1 - 1) / tile; ty++) {
+        for (uint32_t tx = x / tile; tx <= (x1 - 1) / tile; tx++) {
+            if (ocr_prefilter_kept(prefilter, tx, ty)) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+uint32_t ocr_prefilter_mask(const ocr_prefilter_t *prefilter, int8_t *map, uint32_t map_stride,
+                            uint16_t map_width, uint16_t map_height, int8_t fill)
+{
+    const uint32_t tile = prefilter->tile_size;
+    uint32_t cleared = 0;
+
+    for (uint32_t my = 0; my < map_height; my++) {
+        const uint32_t ty = (my * prefilter->height / map_height) / tile;
+        int8_t *row = map + my * map_stride;
+
+        for (uint32_t tx = 0; tx < prefilter->tiles_x; tx++) {
+            if (ocr_prefilter_kept(prefilter, tx, ty)) {
+                continue;
+            }
+            // Map columns whose input position falls into the tile
+            uint32_t mx0 = (tx * tile * map_width + prefilter->width - 1) / prefilter->width;
+            uint32_t mx1 = ((tx + 1) * tile * map_width + prefilter->width - 1) / prefilter->width;
+            mx1 = (mx1 < map_width) ? mx1 : map_width;
+            if (mx1 > mx0) {
+                memset(row + mx0, fill, mx1 - mx0);
+                cleared += mx1 - mx0;
+            }
+        }
+    }
+
+    return cleared;
+}
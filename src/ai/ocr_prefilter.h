@@ -0,0 +1,121 @@
+/**
+ * @file ocr_prefilter.h
+ * @brief CPU text-presence prefilter ahead of NPU detection
+ * @details Counts stroke-like edge pairs (a rising and a falling edge no
+ *          wider apart than a stroke) per tile of the downsampled detection
+ *          input. Walls, sky and smooth shading have none, so frames without
+ *          likely tiles skip detection. The per-tile scores restrict
+ *          detection to likely regions. Platform independent (no HAL dependency)
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#ifndef OCR_PREFILTER_H
+#define OCR_PREFILTER_H
+
+#include <stdint.h>
+
+// Defaults (calibrated on the synthetic scenes of prefilter_test)
+#define OCR_PREFILTER_TILE        16    // Tile edge (input pixels)
+#define OCR_PREFILTER_ROW_STEP    2     // Every second row is scanned
+#define OCR_PREFILTER_EDGE_THRESH 12    // Central difference of a stroke edge (input units)
+#define OCR_PREFILTER_MAX_STROKE  6     // Widest stroke: pixels between its two edges
+#define OCR_PREFILTER_TILE_THRESH 64    // Tile score that counts as likely text
+#define OCR_PREFILTER_MIN_TILES   2     // Likely tiles for a frame to go to detection
+
+// Prefilter state and per-tile score map
+typedef struct {
+    uint16_t width;                 // Input size
+    uint16_t height;
+    uint16_t tile_size;
+    uint16_t tiles_x;
+    uint16_t tiles_y;
+
+    // Parameters
+    uint8_t row_step;
+    uint8_t edge_thresh;
+    uint8_t max_stroke;
+    uint8_t tile_thresh;
+    uint16_t min_tiles;
+
+    uint16_t *strokes;              // Stroke count per tile (scratch)
+    uint8_t *scores;                // Text likelihood per tile, 0..255 (row-major)
+
+    // Last run
+    uint16_t likely_tiles;          // Tiles at or above tile_thresh
+    uint8_t max_score;
+} ocr_prefilter_t;
+
+/**
+ * @brief Get storage required for a prefilter
+ * @param width Input width
+ * @param height Input height
+ * @param tile_size Tile edge in input pixels
+ * @return Required storage in bytes
+ */
+uint32_t ocr_prefilter_size(uint16_t width, uint16_t height, uint16_t tile_size);
+
+/**
+ * @brief Initialize a prefilter with default parameters
+ * @param prefilter Prefilter
+ * @param width Input width
+ * @param height Input height
+ * @param tile_size Tile edge in input pixels (partial last tiles are kept)
+ * @param storage Storage (4-byte aligned, ocr_prefilter_size() bytes)
+ * @param storage_size Size of storage in bytes
+ * @return 0 on success, negative on error
+ */
+int ocr_prefilter_init(ocr_prefilter_t *prefilter, uint16_t width, uint16_t height,
+                       uint16_t tile_size, void *storage, uint32_t storage_size);
+
+/**
+ * @brief Score every tile of an 8-bit plane
+ * @param prefilter Prefilter
+ * @param plane Input plane, element (x, y) at plane[y * row_stride + x * pixel_stride]
+ * @param pixel_stride Elements between neighbouring pixels
+ * @param row_stride Elements between neighbouring rows
+ * @return Likely tiles (0 = no text expected)
+ * @details One pass over every row_step-th row: a central difference above
+ *          edge_thresh is an edge, and an edge of opposite sign within
+ *          max_stroke pixels closes a stroke. The score is the stroke count
+ *          per scanned pixel, so it does not depend on the tile size.
+ *          Contrast polarity does not matter (dark or light text)
+ */
+uint32_t ocr_prefilter_run(ocr_prefilter_t *prefilter, const int8_t *plane,
+                           uint32_t pixel_stride, uint32_t row_stride);
+
+/**
+ * @brief Frame decision of the last run
+ * @param prefilter Prefilter
+ * @return 1 if detection should run, 0 to skip it
+ */
+uint8_t ocr_prefilter_has_text(const ocr_prefilter_t *prefilter);
+
+/**
+ * @brief Check a region against the likely tiles of the last run
+ * @param prefilter Prefilter
+ * @param x Region left edge (input pixels)
+ * @param y Region top edge
+ * @param width Region width
+ * @param height Region height
+ * @return 1 if a likely tile, grown by one tile, overlaps the region
+ */
+uint8_t ocr_prefilter_region_likely(const ocr_prefilter_t *prefilter, uint32_t x, uint32_t y,
+                                    uint32_t width, uint32_t height);
+
+/**
+ * @brief Clear a detection map outside the likely tiles of the last run
+ * @param prefilter Prefilter
+ * @param map int8 map covering the same image as the prefilter input
+ * @param map_stride Map row stride in elements
+ * @param map_width Map width (any multiple or fraction of the input width)
+ * @param map_height Map height
+ * @param fill Value written outside the likely tiles (below any threshold)
+ * @return Pixels cleared
+ * @details Likely tiles are grown by one tile, so strokes that end just
+ *          across a tile edge stay
+ */
+uint32_t ocr_prefilter_mask(const ocr_prefilter_t *prefilter, int8_t *map, uint32_t map_stride,
+                            uint16_t map_width, uint16_t map_height, int8_t fill);
+
+#endif // OCR_PREFILTER_H
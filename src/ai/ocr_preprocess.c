@@ -0,0 +1,984 @@
+/**
+ * @file ocr_preprocess.c
+ * @brief Image preprocessing kernels for the OCR pipeline
+ * @details SIMD implementations are selected at compile time:
+ *          Helium/MVE (Cortex-M55), NEON and SSE2 (host builds), scalar fallback
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#include "ocr_preprocess.h"
+#include "ocr_common.h"
+#include "ocr_simd.h"
+#include <string.h>
+
+// RGB565 field layout
+#define RGB565_R_SHIFT 11
+#define RGB565_G_SHIFT 5
+#define RGB565_G_MASK  0x3F
+#define RGB565_B_MASK  0x1F
+
+// Output pixels produced per SIMD iteration (16 source pixels per row)
+#define OCR_SIMD_BLOCK 8
+
+// Output pixels staged per chunk in the fused tensor kernel
+#define OCR_FUSED_CHUNK 64
+
+static inline uint16_t ocr_avg4_rgb565(uint16_t p1, uint16_t p2, uint16_t p3, uint16_t p4)
+{
+    uint32_t avg_r = ((p1 >> RGB565_R_SHIFT) + (p2 >> RGB565_R_SHIFT) +
+                      (p3 >> RGB565_R_SHIFT) + (p4 >> RGB565_R_SHIFT)) / 4;
+    uint32_t avg_g = (((p1 >> RGB565_G_SHIFT) & RGB565_G_MASK) + ((p2 >> RGB565_G_SHIFT) & RGB565_G_MASK) +
+                      ((p3 >> RGB565_G_SHIFT) & RGB565_G_MASK) + ((p4 >> RGB565_G_SHIFT) & RGB565_G_MASK)) / 4;
+    uint32_t avg_b = ((p1 & RGB565_B_MASK) + (p2 & RGB565_B_MASK) +
+                      (p3 & RGB565_B_MASK) + (p4 & RGB565_B_MASK)) / 4;
+
+    return (uint16_t)((avg_r << RGB565_R_SHIFT) | (avg_g << RGB565_G_SHIFT) | avg_b);
+}
+
+static void ocr_downsample_row_scalar(const uint16_t *row0, const uint16_t *row1,
+                                      uint16_t *dst, uint32_t x_start, uint32_t x_end)
+{
+    for (uint32_t x = x_start; x < x_end; x++) {
+        dst[x] = ocr_avg4_rgb565(row0[2 * x], row0[2 * x + 1],
+                                 row1[2 * x], row1[2 * x + 1]);
+    }
+}
+
+// ========================================================================
+// SIMD Row Kernels
+// ========================================================================
+
+#if defined(OCR_SIMD_MVE) || defined(OCR_SIMD_NEON)
+
+// Helium and NEON share the same ACLE intrinsic names for this kernel.
+// vld2q de-interleaves even/odd pixels so horizontal pairs line up in lanes.
+static uint32_t ocr_downsample_row_simd(const uint16_t *row0, const uint16_t *row1,
+                                        uint16_t *dst, uint32_t width)
+{
+    const uint16x8_t g_mask = vdupq_n_u16(RGB565_G_MASK);
+    const uint16x8_t b_mask = vdupq_n_u16(RGB565_B_MASK);
+    uint32_t x = 0;
+
+    for (; x + OCR_SIMD_BLOCK <= width; x += OCR_SIMD_BLOCK) {
+        uint16x8x2_t top = vld2q_u16(row0 + 2 * x);
+        uint16x8x2_t bot = vld2q_u16(row1 + 2 * x);
+
+        uint16x8_t r = vaddq_u16(vaddq_u16(vshrq_n_u16(top.val[0], RGB565_R_SHIFT),
+                                           vshrq_n_u16(top.val[1], RGB565_R_SHIFT)),
+                                 vaddq_u16(vshrq_n_u16(bot.val[0], RGB565_R_SHIFT),
+                                           vshrq_n_u16(bot.val[1], RGB565_R_SHIFT)));
+        uint16x8_t g = vaddq_u16(vaddq_u16(vandq_u16(vshrq_n_u16(top.val[0], RGB565_G_SHIFT), g_mask),
+                                           vandq_u16(vshrq_n_u16(top.val[1], RGB565_G_SHIFT), g_mask)),
+                                 vaddq_u16(vandq_u16(vshrq_n_u16(bot.val[0], RGB565_G_SHIFT), g_mask),
+                                           vandq_u16(vshrq_n_u16(bot.val[1], RGB565_G_SHIFT), g_mask)));
+        uint16x8_t b = vaddq_u16(vaddq_u16(vandq_u16(top.val[0], b_mask),
+                                           vandq_u16(top.val[1], b_mask)),
+                                 vaddq_u16(vandq_u16(bot.val[0], b_mask),
+                                           vandq_u16(bot.val[1], b_mask)));
+
+        uint16x8_t out = vorrq_u16(vorrq_u16(vshlq_n_u16(vshrq_n_u16(r, 2), RGB565_R_SHIFT),
+                                             vshlq_n_u16(vshrq_n_u16(g, 2), RGB565_G_SHIFT)),
+                                   vshrq_n_u16(b, 2));
+        vst1q_u16(dst + x, out);
+    }
+
+    return x;
+}
+
+#elif defined(OCR_SIMD_SSE2)
+
+// Sum adjacent 16-bit lanes into 32-bit lanes
+static inline __m128i ocr_sse2_pair_sum(__m128i v, __m128i lo_mask)
+{
+    return _mm_add_epi32(_mm_srli_epi32(v, 16), _mm_and_si128(v, lo_mask));
+}
+
+static uint32_t ocr_downsample_row_simd(const uint16_t *row0, const uint16_t *row1,
+                                        uint16_t *dst, uint32_t width)
+{
+    const __m128i g_mask = _mm_set1_epi16(RGB565_G_MASK);
+    const __m128i b_mask = _mm_set1_epi16(RGB565_B_MASK);
+    const __m128i lo_mask = _mm_set1_epi32(0x0000FFFF);
+    uint32_t x = 0;
+
+    for (; x + OCR_SIMD_BLOCK <= width; x += OCR_SIMD_BLOCK) {
+        __m128i t0 = _mm_loadu_si128((const __m128i*)(row0 + 2 * x));
+        __m128i t1 = _mm_loadu_si128((const __m128i*)(row0 + 2 * x + 8));
+        __m128i b0 = _mm_loadu_si128((const __m128i*)(row1 + 2 * x));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(row1 + 2 * x + 8));
+
+        // Vertical sums per channel (max 2 * 63, no overflow)
+        __m128i r0 = _mm_add_epi16(_mm_srli_epi16(t0, RGB565_R_SHIFT), _mm_srli_epi16(b0, RGB565_R_SHIFT));
+        __m128i r1 = _mm_add_epi16(_mm_srli_epi16(t1, RGB565_R_SHIFT), _mm_srli_epi16(b1, RGB565_R_SHIFT));
+        __m128i g0 = _mm_add_epi16(_mm_and_si128(_mm_srli_epi16(t0, RGB565_G_SHIFT), g_mask),
+                                   _mm_and_si128(_mm_srli_epi16(b0, RGB565_G_SHIFT), g_mask));
+        __m128i g1 = _mm_add_epi16(_mm_and_si128(_mm_srli_epi16(t1, RGB565_G_SHIFT), g_mask),
+                                   _mm_and_si128(_mm_srli_epi16(b1, RGB565_G_SHIFT), g_mask));
+        __m128i bl0 = _mm_add_epi16(_mm_and_si128(t0, b_mask), _mm_and_si128(b0, b_mask));
+        __m128i bl1 = _mm_add_epi16(_mm_and_si128(t1, b_mask), _mm_and_si128(b1, b_mask));
+
+        // Horizontal pair sums, packed back to eight 16-bit lanes
+        __m128i r = _mm_packs_epi32(ocr_sse2_pair_sum(r0, lo_mask), ocr_sse2_pair_sum(r1, lo_mask));
+        __m128i g = _mm_packs_epi32(ocr_sse2_pair_sum(g0, lo_mask), ocr_sse2_pair_sum(g1, lo_mask));
+        __m128i b = _mm_packs_epi32(ocr_sse2_pair_sum(bl0, lo_mask), ocr_sse2_pair_sum(bl1, lo_mask));
+
+        __m128i out = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(r, 2), RGB565_R_SHIFT),
+                                                _mm_slli_epi16(_mm_srli_epi16(g, 2), RGB565_G_SHIFT)),
+                                   _mm_srli_epi16(b, 2));
+        _mm_storeu_si128((__m128i*)(dst + x), out);
+    }
+
+    return x;
+}
+
+#else
+
+static uint32_t ocr_downsample_row_simd(const uint16_t *row0, const uint16_t *row1,
+                                        uint16_t *dst, uint32_t width)
+{
+    (void)row0;
+    (void)row1;
+    (void)dst;
+    (void)width;
+    return 0;
+}
+
+#endif
+
+// ========================================================================
+// Public Kernels
+// ========================================================================
+
+void ocr_downsample_rgb565_2x2(const uint16_t *src, uint32_t src_stride,
+                               uint16_t *dst, uint32_t dst_stride,
+                               uint32_t dst_width, uint32_t dst_height)
+{
+    for (uint32_t y = 0; y < dst_height; y++) {
+        const uint16_t *row0 = src + (2 * y) * src_stride;
+        const uint16_t *row1 = row0 + src_stride;
+        uint16_t *out = dst + y * dst_stride;
+
+        // SIMD body, scalar tail for widths not a multiple of the block size
+        uint32_t done = ocr_downsample_row_simd(row0, row1, out, dst_width);
+        ocr_downsample_row_scalar(row0, row1, out, done, dst_width);
+    }
+}
+
+void ocr_downsample_rgb565_2x2_scalar(const uint16_t *src, uint32_t src_stride,
+                                      uint16_t *dst, uint32_t dst_stride,
+                                      uint32_t dst_width, uint32_t dst_height)
+{
+    for (uint32_t y = 0; y < dst_height; y++) {
+        const uint16_t *row0 = src + (2 * y) * src_stride;
+        ocr_downsample_row_scalar(row0, row0 + src_stride, dst + y * dst_stride, 0, dst_width);
+    }
+}
+
+// ========================================================================
+// Fused Preprocess-to-Tensor
+// ========================================================================
+
+int ocr_quantizer_init(ocr_tensor_quantizer_t *quantizer, uint16_t width, uint16_t height,
+                       uint8_t channels, uint8_t layout, float scale, int32_t zero_point,
+                       const float mean[OCR_TENSOR_MAX_CHANNELS],
+                       const float std[OCR_TENSOR_MAX_CHANNELS])
+{
+    if (!quantizer || !mean || !std || width == 0 || height == 0 || scale <= 0.0f ||
+        (channels != 1 && channels != 3) || layout > OCR_TENSOR_LAYOUT_NCHW) {
+        return -1;
+    }
+
+    quantizer->width = width;
+    quantizer->height = height;
+    quantizer->channels = channels;
+    quantizer->layout = layout;
+    quantizer->zero_point = (int8_t)((zero_point < -128) ? -128 : (zero_point > 127) ? 127 : zero_point);
+
+    for (uint32_t c = 0; c < OCR_TENSOR_MAX_CHANNELS; c++) {
+        // Grayscale tensors reuse the first channel's statistics
+        uint32_t src_c = (c < channels) ? c : 0;
+        if (std[src_c] <= 0.0f) {
+            return -1;
+        }
+
+        for (uint32_t v = 0; v < 256; v++) {
+            float normalized = ((float)v / 255.0f - mean[src_c]) / std[src_c];
+            float q = normalized / scale;
+            int32_t qi = (int32_t)(q >= 0.0f ? q + 0.5f : q - 0.5f) + zero_point;
+            if (qi < -128) qi = -128;
+            if (qi > 127) qi = 127;
+            quantizer->lut[c][v] = (int8_t)qi;
+        }
+    }
+
+    return 0;
+}
+
+// Fused 2x2 path for tensor rect [x_begin, x_end) x [y0, y1)
+static void ocr_2x2_rect_to_tensor(const ocr_tensor_quantizer_t *quantizer,
+                                   const uint16_t *src, uint32_t src_stride, int8_t *tensor,
+                                   uint32_t x_begin, uint32_t x_end, uint32_t y0, uint32_t y1)
+{
+    const uint32_t width = quantizer->width;
+    const uint32_t height = quantizer->height;
+    const uint32_t channels = quantizer->channels;
+
+    // NHWC: channels interleaved per pixel; NCHW: one plane per channel
+    const uint32_t px_stride = (quantizer->layout == OCR_TENSOR_LAYOUT_NHWC) ? channels : 1;
+    const uint32_t ch_stride = (quantizer->layout == OCR_TENSOR_LAYOUT_NHWC) ? 1 : width * height;
+
+    const int8_t *lut_r = quantizer->lut[0];
+    const int8_t *lut_g = quantizer->lut[1];
+    const int8_t *lut_b = quantizer->lut[2];
+
+    // Downsampled pixels are staged in a small chunk that stays in L1/DTCM,
+    // so the frame is read exactly once and no full-frame buffer is needed
+    uint16_t chunk[OCR_FUSED_CHUNK];
+
+    for (uint32_t y = y0; y < y1; y++) {
+        const uint16_t *row0 = src + (2 * y) * src_stride;
+        const uint16_t *row1 = row0 + src_stride;
+        int8_t *out = tensor + (y * width + x_begin) * px_stride;
+
+        for (uint32_t x0 = x_begin; x0 < x_end; x0 += OCR_FUSED_CHUNK) {
+            uint32_t n = (x_end - x0 < OCR_FUSED_CHUNK) ? x_end - x0 : OCR_FUSED_CHUNK;
+            uint32_t done = ocr_downsample_row_simd(row0 + 2 * x0, row1 + 2 * x0, chunk, n);
+            ocr_downsample_row_scalar(row0 + 2 * x0, row1 + 2 * x0, chunk, done, n);
+
+            for (uint32_t i = 0; i < n; i++, out += px_stride) {
+                uint16_t avg = chunk[i];
+                uint8_t r = ocr_expand5(avg >> RGB565_R_SHIFT);
+                uint8_t g = ocr_expand6((avg >> RGB565_G_SHIFT) & RGB565_G_MASK);
+                uint8_t b = ocr_expand5(avg & RGB565_B_MASK);
+
+                if (channels == 1) {
+                    out[0] = lut_r[(LUMA_R * r + LUMA_G * g + LUMA_B * b) >> 8];
+                } else {
+                    out[0] = lut_r[r];
+                    out[ch_stride] = lut_g[g];
+                    out[2 * ch_stride] = lut_b[b];
+                }
+            }
+        }
+    }
+}
+
+void ocr_preprocess_rgb565_2x2_to_tensor(const ocr_tensor_quantizer_t *quantizer,
+                                         const uint16_t *src, uint32_t src_stride,
+                                         int8_t *tensor)
+{
+    ocr_2x2_rect_to_tensor(quantizer, src, src_stride, tensor,
+                           0, quantizer->width, 0, quantizer->height);
+}
+
+void ocr_crop_to_tensor(const ocr_tensor_quantizer_t *quantizer, const uint16_t *src,
+                        uint32_t src_stride, uint32_t x, uint32_t y, int8_t *tensor)
+{
+    const uint32_t width = quantizer->width;
+    const uint32_t height = quantizer->height;
+    const uint32_t channels = quantizer->channels;
+    const uint32_t px_stride = (quantizer->layout == OCR_TENSOR_LAYOUT_NHWC) ? channels : 1;
+    const uint32_t ch_stride = (quantizer->layout == OCR_TENSOR_LAYOUT_NHWC) ? 1 : width * height;
+
+    const int8_t *lut_r = quantizer->lut[0];
+    const int8_t *lut_g = quantizer->lut[1];
+    const int8_t *lut_b = quantizer->lut[2];
+
+    for (uint32_t row = 0; row < height; row++) {
+        const uint16_t *in = src + (y + row) * src_stride + x;
+        int8_t *out = tensor + row * width * px_stride;
+
+        for (uint32_t i = 0; i < width; i++, out += px_stride) {
+            uint16_t px = in[i];
+            uint8_t r = ocr_expand5(px >> RGB565_R_SHIFT);
+            uint8_t g = ocr_expand6((px >> RGB565_G_SHIFT) & RGB565_G_MASK);
+            uint8_t b = ocr_expand5(px & RGB565_B_MASK);
+
+            if (channels == 1) {
+                out[0] = lut_r[(LUMA_R * r + LUMA_G * g + LUMA_B * b) >> 8];
+            } else {
+                out[0] = lut_r[r];
+                out[ch_stride] = lut_g[g];
+                out[2 * ch_stride] = lut_b[b];
+            }
+        }
+    }
+}
+
+void ocr_strip_to_tensor(const ocr_tensor_quantizer_t *quantizer, const uint16_t *src,
+                         uint32_t src_stride, uint32_t src_width, uint32_t src_height,
+                         int8_t *tensor)
+{
+    const uint32_t width = quantizer->width;
+    const uint32_t height = quantizer->height;
+    const uint32_t channels = quantizer->channels;
+    const uint32_t px_stride = (quantizer->layout == OCR_TENSOR_LAYOUT_NHWC) ? channels : 1;
+    const uint32_t ch_stride = (quantizer->layout == OCR_TENSOR_LAYOUT_NHWC) ? 1 : width * height;
+    const uint32_t copy_w = (src_width < width) ? src_width : width;
+    const uint32_t copy_h = (src_height < height) ? src_height : height;
+
+    const int8_t *lut_r = quantizer->lut[0];
+    const int8_t *lut_g = quantizer->lut[1];
+    const int8_t *lut_b = quantizer->lut[2];
+
+    // Padding first (planes are contiguous in either layout), then the strip over it
+    memset(tensor, quantizer->zero_point, width * height * channels);
+
+    for (uint32_t row = 0; row < copy_h; row++) {
+        const uint16_t *in = src + row * src_stride;
+        int8_t *out = tensor + row * width * px_stride;
+
+        for (uint32_t i = 0; i < copy_w; i++, out += px_stride) {
+            uint16_t px = in[i];
+            uint8_t r = ocr_expand5(px >> RGB565_R_SHIFT);
+            uint8_t g = ocr_expand6((px >> RGB565_G_SHIFT) & RGB565_G_MASK);
+            uint8_t b = ocr_expand5(px & RGB565_B_MASK);
+
+            if (channels == 1) {
+                out[0] = lut_r[(LUMA_R * r + LUMA_G * g + LUMA_B * b) >> 8];
+            } else {
+                out[0] = lut_r[r];
+                out[ch_stride] = lut_g[g];
+                out[2 * ch_stride] = lut_b[b];
+            }
+        }
+    }
+}
+
+void ocr_downsample_tensor_2x2(const int8_t *src, uint16_t src_width, uint16_t src_height,
+                               uint8_t channels, uint8_t layout, int8_t *dst)
+{
+    const uint32_t dst_width = src_width / 2;
+    const uint32_t dst_height = src_height / 2;
+    // NHWC: one image with interleaved pixels; NCHW: one single-channel image per plane
+    const uint32_t planes = (layout == OCR_TENSOR_LAYOUT_NCHW) ? channels : 1;
+    const uint32_t pixel = (layout == OCR_TENSOR_LAYOUT_NCHW) ? 1 : channels;
+    const uint32_t src_row = (uint32_t)src_width * pixel;
+    const uint32_t dst_row = dst_width * pixel;
+
+    for (uint32_t p = 0; p < planes; p++) {
+        const int8_t *plane = src + p * src_row * src_height;
+        int8_t *out = dst + p * dst_row * dst_height;
+
+        for (uint32_t y = 0; y < dst_height; y++) {
+            const int8_t *r0 = plane + (2 * y) * src_row;
+            const int8_t *r1 = r0 + src_row;
+            int8_t *o = out + y * dst_row;
+
+            for (uint32_t x = 0; x < dst_width; x++) {
+                const uint32_t i = 2 * x * pixel;
+                for (uint32_t c = 0; c < pixel; c++) {
+                    // Offset keeps the sum non-negative, so the division floors
+                    int32_t sum = r0[i + c] + r0[i + pixel + c] + r1[i + c] + r1[i + pixel + c];
+                    o[x * pixel + c] = (int8_t)((sum + 2 + 512) / 4 - 128);
+                }
+            }
+        }
+    }
+}
+
+// ========================================================================
+// Generic Resize Engine
+// ========================================================================
+
+// Intermediate precision: horizontal pass keeps 6 fractional bits
+#define OCR_RESIZE_H_SHIFT (OCR_RESIZE_COEF_BITS - 6)
+#define OCR_RESIZE_V_SHIFT (OCR_RESIZE_COEF_BITS + 6)
+
+static uint16_t ocr_resize_max_taps(uint16_t src, uint16_t dst, uint8_t mode)
+{
+    if (mode == OCR_RESIZE_BILINEAR) {
+        return 2;
+    }
+    // Box of width src/dst straddles at most ceil(src/dst) + 1 source pixels
+    return (uint16_t)((src + dst - 1) / dst + 1);
+}
+
+static uint32_t ocr_align8(uint32_t size)
+{
+    return (size + 7u) & ~7u;
+}
+
+static uint32_t ocr_resize_axis_size(uint16_t src, uint16_t dst, uint8_t mode)
+{
+    uint32_t taps = ocr_resize_max_taps(src, dst, mode);
+    return ocr_align8(dst * taps * sizeof(int16_t)) +
+           ocr_align8(dst * sizeof(uint16_t)) +
+           ocr_align8(dst * sizeof(uint8_t));
+}
+
+static uint8_t *ocr_resize_axis_bind(ocr_resize_axis_t *axis, uint16_t src, uint16_t dst,
+                                     uint8_t mode, uint8_t *mem)
+{
+    axis->max_taps = ocr_resize_max_taps(src, dst, mode);
+    axis->weight = (int16_t*)mem;
+    mem += ocr_align8(dst * axis->max_taps * sizeof(int16_t));
+    axis->offset = (uint16_t*)mem;
+    mem += ocr_align8(dst * sizeof(uint16_t));
+    axis->taps = mem;
+    mem += ocr_align8(dst * sizeof(uint8_t));
+    return mem;
+}
+
+static void ocr_resize_axis_area(ocr_resize_axis_t *axis, uint16_t src, uint16_t dst)
+{
+    // Work in units of 1/(src*dst): destination d covers [d*src, (d+1)*src),
+    // source i covers [i*dst, (i+1)*dst)
+    for (uint32_t d = 0; d < dst; d++) {
+        uint32_t d_begin = d * src;
+        uint32_t d_end = d_begin + src;
+        uint32_t i_first = d_begin / dst;
+        uint32_t i_last = (d_end - 1) / dst;
+        int16_t *w = &axis->weight[d * axis->max_taps];
+        int32_t total = 0;
+        uint32_t largest = 0;
+
+        axis->offset[d] = (uint16_t)i_first;
+        axis->taps[d] = (uint8_t)(i_last - i_first + 1);
+
+        for (uint32_t i = i_first; i <= i_last; i++) {
+            uint32_t s_begin = i * dst;
+            uint32_t s_end = s_begin + dst;
+            uint32_t lo = (s_begin > d_begin) ? s_begin : d_begin;
+            uint32_t hi = (s_end < d_end) ? s_end : d_end;
+            uint32_t k = i - i_first;
+
+            w[k] = (int16_t)(((hi - lo) * OCR_RESIZE_COEF_ONE + src / 2) / src);
+            total += w[k];
+            if (w[k] > w[largest]) {
+                largest = k;
+            }
+        }
+
+        // Rounding residue goes to the dominant tap so weights sum to exactly 1.0
+        w[largest] = (int16_t)(w[largest] + (OCR_RESIZE_COEF_ONE - total));
+    }
+}
+
+static void ocr_resize_axis_bilinear(ocr_resize_axis_t *axis, uint16_t src, uint16_t dst)
+{
+    // Pixel-center alignment: s = (d + 0.5) * src / dst - 0.5 = ((2d+1)*src - dst) / (2*dst)
+    for (uint32_t d = 0; d < dst; d++) {
+        int32_t num = (int32_t)((2 * d + 1) * src) - (int32_t)dst;
+        int32_t den = 2 * (int32_t)dst;
+        int32_t i0 = 0;
+        int32_t frac = 0;
+        int16_t *w = &axis->weight[d * axis->max_taps];
+
+        if (num > 0) {
+            i0 = num / den;
+            frac = (int32_t)(((int64_t)(num % den) * OCR_RESIZE_COEF_ONE + den / 2) / den);
+        }
+
+        if (src == 1) {
+            axis->offset[d] = 0;
+            axis->taps[d] = 1;
+            w[0] = OCR_RESIZE_COEF_ONE;
+            continue;
+        }
+        if (i0 >= (int32_t)src - 1) {
+            i0 = src - 2;
+            frac = OCR_RESIZE_COEF_ONE;
+        }
+
+        axis->offset[d] = (uint16_t)i0;
+        axis->taps[d] = 2;
+        w[0] = (int16_t)(OCR_RESIZE_COEF_ONE - frac);
+        w[1] = (int16_t)frac;
+    }
+}
+
+// Content rectangle inside the destination for the requested fit
+static void ocr_resize_fit_content(uint16_t src_width, uint16_t src_height,
+                                   uint16_t dst_width, uint16_t dst_height, uint8_t fit,
+                                   uint16_t *x, uint16_t *y, uint16_t *width, uint16_t *height)
+{
+    uint32_t w = dst_width;
+    uint32_t h = dst_height;
+
+    if (fit == OCR_RESIZE_FIT_LETTERBOX) {
+        // Uniform scale limited by the tighter axis
+        if ((uint32_t)src_width * dst_height > (uint32_t)src_height * dst_width) {
+            h = ((uint32_t)src_height * dst_width + src_width / 2) / src_width;
+        } else {
+            w = ((uint32_t)src_width * dst_height + src_height / 2) / src_height;
+        }
+        if (w == 0) w = 1;
+        if (h == 0) h = 1;
+    }
+
+    *width = (uint16_t)w;
+    *height = (uint16_t)h;
+    *x = (uint16_t)((dst_width - w) / 2);
+    *y = (uint16_t)((dst_height - h) / 2);
+}
+
+uint32_t ocr_resize_plan_size(uint16_t src_width, uint16_t src_height,
+                              uint16_t dst_width, uint16_t dst_height,
+                              uint8_t mode, uint8_t fit)
+{
+    uint16_t cx, cy, cw, ch;
+
+    if (src_width == 0 || src_height == 0 || dst_width == 0 || dst_height == 0 ||
+        mode > OCR_RESIZE_BILINEAR || fit > OCR_RESIZE_FIT_LETTERBOX) {
+        return 0;
+    }
+
+    ocr_resize_fit_content(src_width, src_height, dst_width, dst_height, fit, &cx, &cy, &cw, &ch);
+    if (ocr_resize_max_taps(src_width, cw, mode) > 255 ||
+        ocr_resize_max_taps(src_height, ch, mode) > 255) {
+        return 0;
+    }
+
+    return ocr_align8(cw * 3 * sizeof(int32_t)) +
+           ocr_resize_axis_size(src_width, cw, mode) +
+           ocr_resize_axis_size(src_height, ch, mode);
+}
+
+int ocr_resize_plan_init(ocr_resize_plan_t *plan, uint16_t src_width, uint16_t src_height,
+                         uint16_t dst_width, uint16_t dst_height, uint8_t mode, uint8_t fit,
+                         void *storage, uint32_t storage_size)
+{
+    uint32_t required = ocr_resize_plan_size(src_width, src_height, dst_width, dst_height, mode, fit);
+    if (!plan || !storage || required == 0 || storage_size < required) {
+        return -1;
+    }
+
+    uint8_t *mem = (uint8_t*)storage;
+
+    plan->src_width = src_width;
+    plan->src_height = src_height;
+    plan->dst_width = dst_width;
+    plan->dst_height = dst_height;
+    plan->mode = mode;
+    ocr_resize_fit_content(src_width, src_height, dst_width, dst_height, fit,
+                           &plan->content_x, &plan->content_y,
+                           &plan->content_width, &plan->content_height);
+
+    plan->accum = (int32_t*)mem;
+    mem += ocr_align8(plan->content_width * 3 * sizeof(int32_t));
+    mem = ocr_resize_axis_bind(&plan->x_axis, src_width, plan->content_width, mode, mem);
+    ocr_resize_axis_bind(&plan->y_axis, src_height, plan->content_height, mode, mem);
+
+    if (mode == OCR_RESIZE_AREA) {
+        ocr_resize_axis_area(&plan->x_axis, src_width, plan->content_width);
+        ocr_resize_axis_area(&plan->y_axis, src_height, plan->content_height);
+    } else {
+        ocr_resize_axis_bilinear(&plan->x_axis, src_width, plan->content_width);
+        ocr_resize_axis_bilinear(&plan->y_axis, src_height, plan->content_height);
+    }
+
+    return 0;
+}
+
+uint8_t ocr_resize_plan_is_2x(const ocr_resize_plan_t *plan)
+{
+    return (plan->mode == OCR_RESIZE_AREA &&
+            plan->content_width == plan->dst_width &&
+            plan->content_height == plan->dst_height &&
+            plan->src_width == 2 * plan->dst_width &&
+            plan->src_height == 2 * plan->dst_height);
+}
+
+void ocr_resize_plan_get_transform(const ocr_resize_plan_t *plan, ocr_frame_transform_t *transform)
+{
+    // Source pixels per destination pixel, rounded to nearest Q16
+    transform->scale_x_q16 = (((uint32_t)plan->src_width << 16) + plan->content_width / 2) /
+                             plan->content_width;
+    transform->scale_y_q16 = (((uint32_t)plan->src_height << 16) + plan->content_height / 2) /
+                             plan->content_height;
+    transform->offset_x = plan->content_x;
+    transform->offset_y = plan->content_y;
+    transform->src_width = plan->src_width;
+    transform->src_height = plan->src_height;
+}
+
+static uint16_t ocr_transform_axis(int32_t d, int32_t offset, uint32_t scale_q16,
+                                   uint16_t limit, uint8_t round_up)
+{
+    int32_t rel = d - offset;
+    if (rel <= 0) {
+        return 0;
+    }
+
+    uint32_t s = ((uint32_t)rel * scale_q16 + (round_up ? 0xFFFFu : 0u)) >> 16;
+    return (uint16_t)((s > limit) ? limit : s);
+}
+
+void ocr_transform_rect_to_source(const ocr_frame_transform_t *transform,
+                                  uint16_t *x, uint16_t *y, uint16_t *width, uint16_t *height)
+{
+    // Left/top edges round down, right/bottom round up so glyphs are never clipped
+    uint16_t x0 = ocr_transform_axis(*x, transform->offset_x, transform->scale_x_q16,
+                                     transform->src_width, 0);
+    uint16_t y0 = ocr_transform_axis(*y, transform->offset_y, transform->scale_y_q16,
+                                     transform->src_height, 0);
+    uint16_t x1 = ocr_transform_axis(*x + *width, transform->offset_x, transform->scale_x_q16,
+                                     transform->src_width, 1);
+    uint16_t y1 = ocr_transform_axis(*y + *height, transform->offset_y, transform->scale_y_q16,
+                                     transform->src_height, 1);
+
+    *x = x0;
+    *y = y0;
+    *width = (uint16_t)(x1 - x0);
+    *height = (uint16_t)(y1 - y0);
+}
+
+void ocr_transform_point_to_source(const ocr_frame_transform_t *transform, int32_t x, int32_t y,
+                                   int32_t *src_x_q16, int32_t *src_y_q16)
+{
+    *src_x_q16 = (int32_t)((int64_t)(x - transform->offset_x) * transform->scale_x_q16);
+    *src_y_q16 = (int32_t)((int64_t)(y - transform->offset_y) * transform->scale_y_q16);
+}
+
+// Accumulate one content row segment [x0, x1) into plan->accum as Q20 RGB888
+static void ocr_resize_row(ocr_resize_plan_t *plan, const uint16_t *src, uint32_t src_stride,
+                           uint32_t y, uint32_t x0, uint32_t x1)
+{
+    const ocr_resize_axis_t *xa = &plan->x_axis;
+    const ocr_resize_axis_t *ya = &plan->y_axis;
+    int32_t *accum = plan->accum;
+    const int16_t *wy = &ya->weight[y * ya->max_taps];
+    const uint32_t y_taps = ya->taps[y];
+
+    memset(&accum[x0 * 3], 0, (x1 - x0) * 3 * sizeof(int32_t));
+
+    for (uint32_t ky = 0; ky < y_taps; ky++) {
+        const uint16_t *row = src + (ya->offset[y] + ky) * src_stride;
+        const int32_t vw = wy[ky];
+
+        for (uint32_t x = x0; x < x1; x++) {
+            const uint16_t *px = row + xa->offset[x];
+            const int16_t *wx = &xa->weight[x * xa->max_taps];
+            const uint32_t x_taps = xa->taps[x];
+            int32_t r = 0, g = 0, b = 0;
+
+            for (uint32_t kx = 0; kx < x_taps; kx++) {
+                uint16_t p = px[kx];
+                r += wx[kx] * ocr_expand5(p >> RGB565_R_SHIFT);
+                g += wx[kx] * ocr_expand6((p >> RGB565_G_SHIFT) & RGB565_G_MASK);
+                b += wx[kx] * ocr_expand5(p & RGB565_B_MASK);
+            }
+
+            // Horizontal result in Q6, vertical accumulation in Q20
+            accum[3 * x + 0] += vw * ((r + (1 << (OCR_RESIZE_H_SHIFT - 1))) >> OCR_RESIZE_H_SHIFT);
+            accum[3 * x + 1] += vw * ((g + (1 << (OCR_RESIZE_H_SHIFT - 1))) >> OCR_RESIZE_H_SHIFT);
+            accum[3 * x + 2] += vw * ((b + (1 << (OCR_RESIZE_H_SHIFT - 1))) >> OCR_RESIZE_H_SHIFT);
+        }
+    }
+}
+
+static inline uint8_t ocr_resize_finish(int32_t acc)
+{
+    int32_t v = (acc + (1 << (OCR_RESIZE_V_SHIFT - 1))) >> OCR_RESIZE_V_SHIFT;
+    if (v < 0) v = 0;
+    if (v > 255) v = 255;
+    return (uint8_t)v;
+}
+
+// Fill a destination rectangle with the quantized normalized zero (letterbox padding)
+static void ocr_tensor_fill_pad(const ocr_tensor_quantizer_t *quantizer, int8_t *tensor,
+                                uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+    const uint32_t w = quantizer->width;
+    const uint32_t channels = quantizer->channels;
+
+    if (width == 0 || height == 0) {
+        return;
+    }
+
+    for (uint32_t row = y; row < y + height; row++) {
+        if (quantizer->layout == OCR_TENSOR_LAYOUT_NHWC) {
+            memset(&tensor[(row * w + x) * channels], quantizer->zero_point, width * channels);
+        } else {
+            for (uint32_t c = 0; c < channels; c++) {
+                memset(&tensor[c * w * quantizer->height + row * w + x], quantizer->zero_point, width);
+            }
+        }
+    }
+}
+
+static void ocr_resize_fill_padding(const ocr_resize_plan_t *plan,
+                                    const ocr_tensor_quantizer_t *quantizer, int8_t *tensor)
+{
+    const uint32_t width = plan->dst_width;
+    const uint32_t height = plan->dst_height;
+    const uint32_t cx = plan->content_x;
+    const uint32_t cy = plan->content_y;
+    const uint32_t cw = plan->content_width;
+    const uint32_t ch = plan->content_height;
+
+    // Letterbox padding: only the bands outside the content are written
+    ocr_tensor_fill_pad(quantizer, tensor, 0, 0, width, cy);
+    ocr_tensor_fill_pad(quantizer, tensor, 0, cy + ch, width, height - cy - ch);
+    ocr_tensor_fill_pad(quantizer, tensor, 0, cy, cx, ch);
+    ocr_tensor_fill_pad(quantizer, tensor, cx + cw, cy, width - cx - cw, ch);
+}
+
+// Generic path for content rect [x0, x1) x [y0, y1)
+static void ocr_resize_rect_to_tensor(ocr_resize_plan_t *plan, const ocr_tensor_quantizer_t *quantizer,
+                                      const uint16_t *src, uint32_t src_stride, int8_t *tensor,
+                                      uint32_t x0, uint32_t x1, uint32_t y0, uint32_t y1)
+{
+    const uint32_t width = plan->dst_width;
+    const uint32_t height = plan->dst_height;
+    const uint32_t cx = plan->content_x;
+    const uint32_t cy = plan->content_y;
+    const uint32_t channels = quantizer->channels;
+    const uint32_t px_stride = (quantizer->layout == OCR_TENSOR_LAYOUT_NHWC) ? channels : 1;
+    const uint32_t ch_stride = (quantizer->layout == OCR_TENSOR_LAYOUT_NHWC) ? 1 : width * height;
+
+    for (uint32_t y = y0; y < y1; y++) {
+        int8_t *out = tensor + ((cy + y) * width + cx + x0) * px_stride;
+        const int32_t *acc = plan->accum + 3 * x0;
+
+        ocr_resize_row(plan, src, src_stride, y, x0, x1);
+
+        for (uint32_t x = x0; x < x1; x++, out += px_stride, acc += 3) {
+            uint8_t r = ocr_resize_finish(acc[0]);
+            uint8_t g = ocr_resize_finish(acc[1]);
+            uint8_t b = ocr_resize_finish(acc[2]);
+
+            if (channels == 1) {
+                out[0] = quantizer->lut[0][(LUMA_R * r + LUMA_G * g + LUMA_B * b) >> 8];
+            } else {
+                out[0] = quantizer->lut[0][r];
+                out[ch_stride] = quantizer->lut[1][g];
+                out[2 * ch_stride] = quantizer->lut[2][b];
+            }
+        }
+    }
+}
+
+void ocr_resize_to_tensor(ocr_resize_plan_t *plan, const ocr_tensor_quantizer_t *quantizer,
+                          const uint16_t *src, uint32_t src_stride, int8_t *tensor)
+{
+    ocr_resize_fill_padding(plan, quantizer, tensor);
+    ocr_resize_rect_to_tensor(plan, quantizer, src, src_stride, tensor,
+                              0, plan->content_width, 0, plan->content_height);
+}
+
+void ocr_resize_region_rgb565(ocr_resize_plan_t *plan, const uint16_t *src, uint32_t src_stride,
+                              uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                              uint16_t *dst, uint32_t dst_stride)
+{
+    if (x >= plan->dst_width || y >= plan->dst_height) {
+        return;
+    }
+    if (x + width > plan->dst_width) width = plan->dst_width - x;
+    if (y + height > plan->dst_height) height = plan->dst_height - y;
+
+    // Intersection of the region with the letterbox content, in content coordinates
+    int32_t c0 = (int32_t)x - plan->content_x;
+    int32_t c1 = c0 + (int32_t)width;
+    if (c0 < 0) c0 = 0;
+    if (c1 > plan->content_width) c1 = plan->content_width;
+
+    for (uint32_t row = 0; row < height; row++) {
+        uint16_t *out = dst + row * dst_stride;
+        int32_t cy = (int32_t)(y + row) - plan->content_y;
+
+        // Padding reads as black
+        memset(out, 0, width * sizeof(uint16_t));
+        if (cy < 0 || cy >= plan->content_height || c0 >= c1) {
+            continue;
+        }
+
+        ocr_resize_row(plan, src, src_stride, (uint32_t)cy, (uint32_t)c0, (uint32_t)c1);
+
+        for (int32_t col = c0; col < c1; col++) {
+            const int32_t *acc = &plan->accum[3 * col];
+            uint32_t r = ocr_resize_finish(acc[0]) >> 3;
+            uint32_t g = ocr_resize_finish(acc[1]) >> 2;
+            uint32_t b = ocr_resize_finish(acc[2]) >> 3;
+            out[col + plan->content_x - x] = (uint16_t)((r << RGB565_R_SHIFT) | (g << RGB565_G_SHIFT) | b);
+        }
+    }
+}
+
+// ========================================================================
+// Dirty-Tile Preprocessing
+// ========================================================================
+
+// Source footprint of destination range [d0, d1) along one axis
+static void ocr_tile_footprint(const ocr_resize_axis_t *axis, uint32_t content_start,
+                               uint32_t content_size, uint32_t d0, uint32_t d1,
+                               uint16_t *src0, uint16_t *src1)
+{
+    uint32_t c0 = (d0 > content_start) ? d0 - content_start : 0;
+    uint32_t c1 = (d1 > content_start) ? d1 - content_start : 0;
+
+    if (c1 > content_size) {
+        c1 = content_size;
+    }
+    if (c0 >= c1) {
+        *src0 = 0;
+        *src1 = 0;
+        return;
+    }
+
+    // Offsets and tap ends grow monotonically with the destination index
+    *src0 = axis->offset[c0];
+    *src1 = (uint16_t)(axis->offset[c1 - 1] + axis->taps[c1 - 1]);
+}
+
+int ocr_resize_plan_bind_tiles(const ocr_resize_plan_t *plan, ocr_tile_map_t *map)
+{
+    const uint32_t t = map->tile_size;
+
+    if ((uint32_t)map->tiles_x * t < plan->dst_width || (uint32_t)map->tiles_y * t < plan->dst_height) {
+        return -1;
+    }
+
+    for (uint32_t tx = 0; tx < map->tiles_x; tx++) {
+        ocr_tile_footprint(&plan->x_axis, plan->content_x, plan->content_width,
+                           tx * t, (tx + 1) * t, &map->src_x0[tx], &map->src_x1[tx]);
+    }
+    for (uint32_t ty = 0; ty < map->tiles_y; ty++) {
+        ocr_tile_footprint(&plan->y_axis, plan->content_y, plan->content_height,
+                           ty * t, (ty + 1) * t, &map->src_y0[ty], &map->src_y1[ty]);
+    }
+
+    ocr_tile_map_invalidate(map);
+    return 0;
+}
+
+uint32_t ocr_resize_tiles_to_tensor(ocr_resize_plan_t *plan, const ocr_tensor_quantizer_t *quantizer,
+                                    const uint16_t *src, uint32_t src_stride, int8_t *tensor,
+                                    const ocr_tile_map_t *map)
+{
+    const uint32_t t = map->tile_size;
+    const uint32_t cx = plan->content_x;
+    const uint32_t cy = plan->content_y;
+    const uint32_t cw = plan->content_width;
+    const uint32_t ch = plan->content_height;
+    const uint8_t is_2x = ocr_resize_plan_is_2x(plan);
+    uint32_t bytes = 0;
+
+    if (map->full_refresh) {
+        if (is_2x) {
+            ocr_preprocess_rgb565_2x2_to_tensor(quantizer, src, src_stride, tensor);
+        } else {
+            ocr_resize_to_tensor(plan, quantizer, src, src_stride, tensor);
+        }
+        return (uint32_t)plan->src_width * plan->src_height * sizeof(uint16_t) +
+               (uint32_t)plan->dst_width * plan->dst_height * quantizer->channels;
+    }
+
+    for (uint32_t ty = 0; ty < map->tiles_y; ty++) {
+        uint32_t y0 = ty * t;
+        uint32_t y1 = y0 + t;
+
+        // Tile rows clipped to content coordinates
+        y0 = (y0 > cy) ? y0 - cy : 0;
+        y1 = (y1 > cy) ? y1 - cy : 0;
+        if (y1 > ch) {
+            y1 = ch;
+        }
+        if (y0 >= y1) {
+            continue;
+        }
+
+        for (uint32_t tx = 0; tx < map->tiles_x; tx++) {
+            if (!ocr_tile_map_is_dirty(map, tx, ty)) {
+                continue;
+            }
+
+            // Merge horizontal runs of dirty tiles into one rect
+            uint32_t run_end = tx + 1;
+            while (run_end < map->tiles_x && ocr_tile_map_is_dirty(map, run_end, ty)) {
+                run_end++;
+            }
+
+            uint32_t x0 = tx * t;
+            uint32_t x1 = run_end * t;
+            x0 = (x0 > cx) ? x0 - cx : 0;
+            x1 = (x1 > cx) ? x1 - cx : 0;
+            if (x1 > cw) {
+                x1 = cw;
+            }
+
+            if (x0 < x1) {
+                if (is_2x) {
+                    ocr_2x2_rect_to_tensor(quantizer, src, src_stride, tensor, x0, x1, y0, y1);
+                } else {
+                    ocr_resize_rect_to_tensor(plan, quantizer, src, src_stride, tensor, x0, x1, y0, y1);
+                }
+                bytes += (uint32_t)(map->src_x1[run_end - 1] - map->src_x0[tx]) *
+                         (map->src_y1[ty] - map->src_y0[ty]) * sizeof(uint16_t);
+                bytes += (x1 - x0) * (y1 - y0) * quantizer->channels;
+            }
+            tx = run_end;
+        }
+    }
+
+    return bytes;
+}
+
+// ========================================================================
+// Strip Streaming
+// ========================================================================
+
+void ocr_strip_stream_begin(ocr_strip_stream_t *stream, ocr_resize_plan_t *plan,
+                            const ocr_tensor_quantizer_t *quantizer,
+                            const uint16_t *src, uint32_t src_stride, int8_t *tensor)
+{
+    stream->plan = plan;
+    stream->quantizer = quantizer;
+    stream->src = src;
+    stream->src_stride = src_stride;
+    stream->tensor = tensor;
+    stream->next_row = 0;
+
+    // Padding does not depend on the frame, write it before any line arrives
+    ocr_resize_fill_padding(plan, quantizer, tensor);
+}
+
+uint32_t ocr_strip_stream_feed(ocr_strip_stream_t *stream, uint32_t lines_ready)
+{
+    ocr_resize_plan_t *plan = stream->plan;
+    const ocr_resize_axis_t *ya = &plan->y_axis;
+    uint32_t first = stream->next_row;
+    uint32_t last = first;
+
+    // Source rows needed per output row grow monotonically, so scan forward
+    // until the last tap of the next row has not landed yet
+    while (last < plan->content_height &&
+           (uint32_t)ya->offset[last] + ya->taps[last] <= lines_ready) {
+        last++;
+    }
+
+    if (last == first) {
+        return 0;
+    }
+
+    if (ocr_resize_plan_is_2x(plan)) {
+        ocr_2x2_rect_to_tensor(stream->quantizer, stream->src, stream->src_stride,
+                               stream->tensor, 0, plan->dst_width, first, last);
+    } else {
+        ocr_resize_rect_to_tensor(plan, stream->quantizer, stream->src, stream->src_stride,
+                                  stream->tensor, 0, plan->content_width, first, last);
+    }
+
+    stream->next_row = (uint16_t)last;
+    return last - first;
+}
+
+uint8_t ocr_strip_stream_done(const ocr_strip_stream_t *stream)
+{
+    return stream->next_row >= stream->plan->content_height;
+}
+
+const char* ocr_preprocess_kernel_name(void)
+{
+#if defined(OCR_SIMD_MVE)
+    return "mve";
+#elif defined(OCR_SIMD_NEON)
+    return "neon";
+#elif defined(OCR_SIMD_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,378 @@
+/**
+ * @file ocr_preprocess.h
+ * @brief Image preprocessing kernels for the OCR pipeline
+ * @details Platform independent pixel kernels (no HAL dependency) so they can be
+ *          built and verified on the host as well as on the Cortex-M55 target
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#ifndef OCR_PREPROCESS_H
+#define OCR_PREPROCESS_H
+
+#include <stdint.h>
+#include "ocr_frame_diff.h"
+
+// Tensor memory layouts
+typedef enum {
+    OCR_TENSOR_LAYOUT_NHWC = 0,     // Interleaved channels (Neural-ART native)
+    OCR_TENSOR_LAYOUT_NCHW          // Planar channels (PaddleOCR export)
+} ocr_tensor_layout_t;
+
+// Maximum channels of a model input tensor
+#define OCR_TENSOR_MAX_CHANNELS 3
+
+// Quantizer for a model input tensor
+// Built once at model load; per pixel work is table lookups only
+typedef struct {
+    uint16_t width;                 // Tensor width
+    uint16_t height;                // Tensor height
+    uint8_t channels;               // 1=grayscale, 3=RGB
+    uint8_t layout;                 // ocr_tensor_layout_t
+    int8_t zero_point;              // Quantized normalized zero (padding value)
+    int8_t lut[OCR_TENSOR_MAX_CHANNELS][256]; // 8-bit channel value -> int8
+} ocr_tensor_quantizer_t;
+
+// Resampling filters
+typedef enum {
+    OCR_RESIZE_AREA = 0,            // Box filter with fractional coverage
+    OCR_RESIZE_BILINEAR             // Two-tap linear, pixel-center aligned
+} ocr_resize_mode_t;
+
+// Aspect handling when source and destination ratios differ
+typedef enum {
+    OCR_RESIZE_FIT_STRETCH = 0,     // Independent x/y scale
+    OCR_RESIZE_FIT_LETTERBOX        // Uniform scale, centered, padded
+} ocr_resize_fit_t;
+
+// Fixed-point precision of resize coefficients
+#define OCR_RESIZE_COEF_BITS 14
+#define OCR_RESIZE_COEF_ONE  (1 << OCR_RESIZE_COEF_BITS)
+
+// Per-axis resampling coefficients
+typedef struct {
+    uint16_t *offset;               // First source index per destination index
+    uint8_t *taps;                  // Tap count per destination index
+    int16_t *weight;                // Q14 weights, max_taps per destination index
+    uint16_t max_taps;              // Weight table stride
+} ocr_resize_axis_t;
+
+// Resize plan for one source/destination geometry
+// Coefficients are computed once; per frame work is multiply-add only
+typedef struct {
+    uint16_t src_width;
+    uint16_t src_height;
+    uint16_t dst_width;
+    uint16_t dst_height;
+    uint8_t mode;                   // ocr_resize_mode_t
+    uint16_t content_x;             // Resampled content inside destination
+    uint16_t content_y;             // (equals full destination when stretching)
+    uint16_t content_width;
+    uint16_t content_height;
+    ocr_resize_axis_t x_axis;
+    ocr_resize_axis_t y_axis;
+    int32_t *accum;                 // Row accumulator scratch (content_width * 3)
+} ocr_resize_plan_t;
+
+// Destination -> source coordinate transform recorded per frame
+// src = (dst - offset) * scale, integer math only
+typedef struct {
+    uint32_t scale_x_q16;           // Source pixels per destination pixel (Q16)
+    uint32_t scale_y_q16;
+    uint16_t offset_x;              // Letterbox padding (destination pixels)
+    uint16_t offset_y;
+    uint16_t src_width;             // Source bounds for clamping
+    uint16_t src_height;
+} ocr_frame_transform_t;
+
+// Incremental preprocessing state for a frame arriving line by line
+typedef struct {
+    ocr_resize_plan_t *plan;
+    const ocr_tensor_quantizer_t *quantizer;
+    const uint16_t *src;            // Frame being captured
+    uint32_t src_stride;
+    int8_t *tensor;                 // Output tensor
+    uint16_t next_row;              // Next content row to produce
+} ocr_strip_stream_t;
+
+// ========================================================================
+// RGB565 Downsampling
+// ========================================================================
+
+/**
+ * @brief Downsample RGB565 image with 2x2 box average
+ * @param src Source image (RGB565)
+ * @param src_stride Source row stride in pixels
+ * @param dst Destination image (RGB565)
+ * @param dst_stride Destination row stride in pixels
+ * @param dst_width Destination width in pixels
+ * @param dst_height Destination height in pixels
+ * @details Uses the SIMD path selected at compile time (Helium/MVE, NEON, SSE2
+ *          or scalar). Output is bit-exact with ocr_downsample_rgb565_2x2_scalar()
+ */
+void ocr_downsample_rgb565_2x2(const uint16_t *src, uint32_t src_stride,
+                               uint16_t *dst, uint32_t dst_stride,
+                               uint32_t dst_width, uint32_t dst_height);
+
+/**
+ * @brief Scalar reference implementation of the 2x2 RGB565 downsample
+ * @details Each channel is the truncated mean of the four source samples
+ */
+void ocr_downsample_rgb565_2x2_scalar(const uint16_t *src, uint32_t src_stride,
+                                      uint16_t *dst, uint32_t dst_stride,
+                                      uint32_t dst_width, uint32_t dst_height);
+
+// ========================================================================
+// Fused Preprocess-to-Tensor
+// ========================================================================
+
+/**
+ * @brief Build input tensor quantizer from model quantization parameters
+ * @param quantizer Quantizer to initialize
+ * @param width Tensor width
+ * @param height Tensor height
+ * @param channels Tensor channels (1=grayscale, 3=RGB)
+ * @param layout Tensor layout (ocr_tensor_layout_t)
+ * @param scale Input quantization scale
+ * @param zero_point Input quantization zero point
+ * @param mean Per-channel normalization mean (0..1 pixel range)
+ * @param std Per-channel normalization standard deviation
+ * @return 0 on success, negative on error
+ * @details q = round(((v / 255 - mean) / std) / scale) + zero_point, saturated to int8
+ */
+int ocr_quantizer_init(ocr_tensor_quantizer_t *quantizer, uint16_t width, uint16_t height,
+                       uint8_t channels, uint8_t layout, float scale, int32_t zero_point,
+                       const float mean[OCR_TENSOR_MAX_CHANNELS],
+                       const float std[OCR_TENSOR_MAX_CHANNELS]);
+
+/**
+ * @brief Downsample, convert and quantize an RGB565 frame in a single pass
+ * @param quantizer Tensor quantizer (geometry, layout, LUT)
+ * @param src Source frame (RGB565), at least 2x the tensor size
+ * @param src_stride Source row stride in pixels
+ * @param tensor Output int8 tensor (width * height * channels bytes)
+ * @details 2x2 box average, RGB888 or BT.601 grayscale conversion,
+ *          mean/std normalization and quantization with NHWC/NCHW output
+ */
+void ocr_preprocess_rgb565_2x2_to_tensor(const ocr_tensor_quantizer_t *quantizer,
+                                         const uint16_t *src, uint32_t src_stride,
+                                         int8_t *tensor);
+
+/**
+ * @brief Convert and quantize a window of an RGB565 frame at 1:1 scale
+ * @param quantizer Tensor quantizer (geometry = window size, layout, LUT)
+ * @param src Source frame (RGB565)
+ * @param src_stride Source row stride in pixels
+ * @param x Window left edge (window inside the frame)
+ * @param y Window top edge
+ * @param tensor Output int8 tensor (width * height * channels bytes)
+ * @details Input of one detection tile: camera pixels, no resampling
+ */
+void ocr_crop_to_tensor(const ocr_tensor_quantizer_t *quantizer, const uint16_t *src,
+                        uint32_t src_stride, uint32_t x, uint32_t y, int8_t *tensor);
+
+/**
+ * @brief Convert and quantize a recognition strip into a model input
+ * @param quantizer Tensor quantizer (geometry = model input, layout, LUT)
+ * @param src Strip (RGB565)
+ * @param src_stride Strip row stride in pixels
+ * @param src_width Strip width
+ * @param src_height Strip height
+ * @param tensor Output int8 tensor (width * height * channels bytes)
+ * @details The strip is placed at the top left and the rest is padded with
+ *          the quantized zero (PP-OCR right padding); a strip larger than the
+ *          input is clipped. The recognition pipeline quantizes inside the
+ *          fused warps (ocr_geometry.h); this is their two-pass reference
+ */
+void ocr_strip_to_tensor(const ocr_tensor_quantizer_t *quantizer, const uint16_t *src,
+                         uint32_t src_stride, uint32_t src_width, uint32_t src_height,
+                         int8_t *tensor);
+
+/**
+ * @brief Halve a quantized tensor with a 2x2 box average (coarse pyramid level)
+ * @param src Source int8 tensor
+ * @param src_width Source width (odd last column is dropped)
+ * @param src_height Source height (odd last row is dropped)
+ * @param channels Channels
+ * @param layout Tensor layout (ocr_tensor_layout_t), kept in the output
+ * @param dst Output tensor ((src_width / 2) * (src_height / 2) * channels bytes)
+ * @details Averaging in the int8 domain is exact for an affine quantization,
+ *          so the output keeps the scale and zero point of the source.
+ *          Rounds half up
+ */
+void ocr_downsample_tensor_2x2(const int8_t *src, uint16_t src_width, uint16_t src_height,
+                               uint8_t channels, uint8_t layout, int8_t *dst);
+
+// ========================================================================
+// Generic Resize Engine
+// ========================================================================
+
+/**
+ * @brief Get storage required for a resize plan
+ * @param src_width Source width
+ * @param src_height Source height
+ * @param dst_width Destination width
+ * @param dst_height Destination height
+ * @param mode Resampling filter (ocr_resize_mode_t)
+ * @param fit Aspect handling (ocr_resize_fit_t)
+ * @return Required storage in bytes, 0 on invalid geometry
+ */
+uint32_t ocr_resize_plan_size(uint16_t src_width, uint16_t src_height,
+                              uint16_t dst_width, uint16_t dst_height,
+                              uint8_t mode, uint8_t fit);
+
+/**
+ * @brief Build resize plan and its fixed-point coefficient tables
+ * @param plan Plan to initialize
+ * @param src_width Source width
+ * @param src_height Source height
+ * @param dst_width Destination width
+ * @param dst_height Destination height
+ * @param mode Resampling filter (ocr_resize_mode_t)
+ * @param fit Aspect handling (ocr_resize_fit_t)
+ * @param storage Table storage (8-byte aligned, ocr_resize_plan_size() bytes)
+ * @param storage_size Size of storage in bytes
+ * @return 0 on success, negative on error
+ * @details All divisions happen here; call at camera configuration or model load
+ */
+int ocr_resize_plan_init(ocr_resize_plan_t *plan, uint16_t src_width, uint16_t src_height,
+                         uint16_t dst_width, uint16_t dst_height, uint8_t mode, uint8_t fit,
+                         void *storage, uint32_t storage_size);
+
+/**
+ * @brief Check whether a plan is an exact 2x2 box decimation
+ * @param plan Resize plan
+ * @return 1 if the 2x2 SIMD kernels can be used instead, 0 otherwise
+ */
+uint8_t ocr_resize_plan_is_2x(const ocr_resize_plan_t *plan);
+
+/**
+ * @brief Get the destination -> source transform of a plan
+ * @param plan Resize plan
+ * @param transform Output transform
+ */
+void ocr_resize_plan_get_transform(const ocr_resize_plan_t *plan, ocr_frame_transform_t *transform);
+
+/**
+ * @brief Map a destination-space rectangle back to source coordinates
+ * @param transform Frame transform
+ * @param x Left edge (in: destination, out: source)
+ * @param y Top edge (in: destination, out: source)
+ * @param width Width (in: destination, out: source)
+ * @param height Height (in: destination, out: source)
+ * @details Edges are rounded outward and clamped to the source bounds
+ */
+void ocr_transform_rect_to_source(const ocr_frame_transform_t *transform,
+                                  uint16_t *x, uint16_t *y, uint16_t *width, uint16_t *height);
+
+/**
+ * @brief Map a destination-space point back to source coordinates
+ * @param transform Frame transform
+ * @param x Destination x (may lie in the padding or outside the image)
+ * @param y Destination y
+ * @param src_x_q16 Output source x (Q16, not clamped)
+ * @param src_y_q16 Output source y (Q16, not clamped)
+ * @details For quad corners, which may legitimately extend past the frame
+ */
+void ocr_transform_point_to_source(const ocr_frame_transform_t *transform, int32_t x, int32_t y,
+                                   int32_t *src_x_q16, int32_t *src_y_q16);
+
+/**
+ * @brief Resize, convert and quantize an RGB565 frame into a model tensor
+ * @param plan Resize plan (destination geometry must match the quantizer)
+ * @param quantizer Tensor quantizer
+ * @param src Source frame (RGB565)
+ * @param src_stride Source row stride in pixels
+ * @param tensor Output int8 tensor
+ * @details Letterbox padding is filled with the quantized normalized zero
+ */
+void ocr_resize_to_tensor(ocr_resize_plan_t *plan, const ocr_tensor_quantizer_t *quantizer,
+                          const uint16_t *src, uint32_t src_stride, int8_t *tensor);
+
+/**
+ * @brief Resize a destination-space region of an RGB565 frame to RGB565
+ * @param plan Resize plan
+ * @param src Source frame (RGB565)
+ * @param src_stride Source row stride in pixels
+ * @param x Region left edge (destination coordinates)
+ * @param y Region top edge (destination coordinates)
+ * @param width Region width (clipped to the plan)
+ * @param height Region height (clipped to the plan)
+ * @param dst Output RGB565 image
+ * @param dst_stride Output row stride in pixels
+ */
+void ocr_resize_region_rgb565(ocr_resize_plan_t *plan, const uint16_t *src, uint32_t src_stride,
+                              uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                              uint16_t *dst, uint32_t dst_stride);
+
+// ========================================================================
+// Dirty-Tile Preprocessing
+// ========================================================================
+
+/**
+ * @brief Compute source footprints of a tile map from a resize plan
+ * @param plan Resize plan
+ * @param map Tile map covering the plan destination
+ * @return 0 on success, negative if the map does not cover the destination
+ * @details Tiles over letterbox padding get an empty footprint and stay clean
+ */
+int ocr_resize_plan_bind_tiles(const ocr_resize_plan_t *plan, ocr_tile_map_t *map);
+
+/**
+ * @brief Recompute only the dirty tiles of a persistent tensor
+ * @param plan Resize plan
+ * @param quantizer Tensor quantizer
+ * @param src Source frame (RGB565)
+ * @param src_stride Source row stride in pixels
+ * @param tensor Tensor holding the previous frame's result
+ * @param map Tile map after ocr_tile_map_update()
+ * @return Bytes touched (source read + tensor written)
+ * @details A full refresh map rewrites the whole tensor, padding included.
+ *          Clean tiles are bit-identical to a full recompute of the old frame
+ */
+uint32_t ocr_resize_tiles_to_tensor(ocr_resize_plan_t *plan, const ocr_tensor_quantizer_t *quantizer,
+                                    const uint16_t *src, uint32_t src_stride, int8_t *tensor,
+                                    const ocr_tile_map_t *map);
+
+// ========================================================================
+// Strip Streaming
+// ========================================================================
+
+/**
+ * @brief Start strip-streamed preprocessing of a frame
+ * @param stream Stream state
+ * @param plan Resize plan
+ * @param quantizer Tensor quantizer
+ * @param src Frame buffer being filled by the camera DMA
+ * @param src_stride Source row stride in pixels
+ * @param tensor Output int8 tensor
+ * @details Writes letterbox padding immediately; content rows follow as lines land
+ */
+void ocr_strip_stream_begin(ocr_strip_stream_t *stream, ocr_resize_plan_t *plan,
+                            const ocr_tensor_quantizer_t *quantizer,
+                            const uint16_t *src, uint32_t src_stride, int8_t *tensor);
+
+/**
+ * @brief Consume newly captured source lines
+ * @param stream Stream state
+ * @param lines_ready Number of complete source lines in the frame buffer
+ * @return Number of tensor rows produced by this call
+ * @details Produces every output row whose source taps are all available;
+ *          output is identical to ocr_resize_to_tensor() / the 2x2 fused kernel
+ */
+uint32_t ocr_strip_stream_feed(ocr_strip_stream_t *stream, uint32_t lines_ready);
+
+/**
+ * @brief Check whether all tensor rows have been produced
+ * @param stream Stream state
+ * @return 1 when complete, 0 otherwise
+ */
+uint8_t ocr_strip_stream_done(const ocr_strip_stream_t *stream);
+
+/**
+ * @brief Get name of the compiled-in SIMD kernel
+ * @return "mve", "neon", "sse2" or "scalar"
+ */
+const char* ocr_preprocess_kernel_name(void);
+
+#endif // OCR_PREPROCESS_H
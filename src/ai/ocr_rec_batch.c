@@ -0,0 +1,82 @@
+/**
+ * @file ocr_rec_batch.c
+ * @brief Batched recognition: crops packed into one batch tensor per inference
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#include "ocr_rec_batch.h"
+#include <stddef.h>
+
+// The output tensor starts on an 8-byte boundary after the inputs
+static uint32_t ocr_align8(uint32_t size)
+{
+    return (size + 7) & ~7u;
+}
+
+uint32_t ocr_rec_batch_plan(uint32_t input_size, uint32_t output_size,
+                            uint32_t max_batch, uint32_t budget)
+{
+    uint32_t slots = (max_batch < OCR_REC_MAX_BATCH) ? max_batch : OCR_REC_MAX_BATCH;
+
+    while (slots > 0 && ocr_rec_batch_size(input_size, output_size, slots) > budget) {
+        slots--;
+    }
+    return slots;
+}
+
+uint32_t ocr_rec_batch_size(uint32_t input_size, uint32_t output_size, uint32_t capacity)
+{
+    if (input_size == 0 || output_size == 0 || capacity == 0 || capacity > OCR_REC_MAX_BATCH) {
+        return 0;
+    }
+    return ocr_align8(capacity * input_size) + capacity * output_size;
+}
+
+int ocr_rec_batch_init(ocr_rec_batch_t *batch, uint32_t input_size, uint32_t output_size,
+                       uint32_t capacity, void *storage, uint32_t storage_size)
+{
+    uint32_t size = ocr_rec_batch_size(input_size, output_size, capacity);
+
+    if (!batch || !storage || size == 0 || storage_size < size) {
+        return -1;
+    }
+
+    batch->input = (int8_t*)storage;
+    batch->output = batch->input + ocr_align8(capacity * input_size);
+    batch->input_size = input_size;
+    batch->output_size = output_size;
+    batch->capacity = (uint16_t)capacity;
+    batch->count = 0;
+    return 0;
+}
+
+int8_t* ocr_rec_batch_next(ocr_rec_batch_t *batch)
+{
+    if (batch->count >= batch->capacity) {
+        return NULL;
+    }
+    return batch->input + (uint32_t)batch->count * batch->input_size;
+}
+
+int ocr_rec_batch_push(ocr_rec_batch_t *batch, uint16_t tag)
+{
+    if (batch->count >= batch->capacity) {
+        return -1;
+    }
+    batch->tag[batch->count++] = tag;
+    return 0;
+}
+
+const int8_t* ocr_rec_batch_output(const ocr_rec_batch_t *batch, uint32_t slot)
+{
+    if (slot >= batch->count) {
+        return NULL;
+    }
+    return batch->output + slot * batch->output_size;
+}
+
+void ocr_rec_batch_clear(ocr_rec_batch_t *batch)
+{
+    batch->count = 0;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file ocr_rec_batch.h
+ * @brief Batched recognition: crops packed into one batch tensor per inference
+ * @details Height-normalized crops are staged in consecutive slots of one
+ *          batch input (the batch dimension of the compiled model), inferred
+ *          with a single call, and the per-slot outputs are scattered back to
+ *          the boxes they were staged for. Input and output slots share one
+ *          activation budget, so the batch size is planned from the memory
+ *          left for them. Platform independent (no HAL dependency)
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#ifndef OCR_REC_BATCH_H
+#define OCR_REC_BATCH_H
+
+#include <stdint.h>
+
+// Defaults
+#define OCR_REC_MAX_BATCH     16    // Slots of one batch (bounds the slot tags)
+
+// One batch (input and output tensors in one allocation)
+typedef struct {
+    int8_t *input;                  // capacity * input_size, slot-major
+    int8_t *output;                 // capacity * output_size, slot-major
+    uint32_t input_size;            // One model input
+    uint32_t output_size;           // One model output
+    uint16_t capacity;              // Slots
+    uint16_t count;                 // Slots staged
+    uint16_t tag[OCR_REC_MAX_BATCH]; // Box each slot was staged for
+} ocr_rec_batch_t;
+
+/**
+ * @brief Plan the batch size for an activation budget
+ * @param input_size Bytes of one model input
+ * @param output_size Bytes of one model output
+ * @param max_batch Batch dimension of the compiled model
+ * @param budget Bytes available for the batch
+ * @return Slots that fit (0 if not even one does)
+ */
+uint32_t ocr_rec_batch_plan(uint32_t input_size, uint32_t output_size,
+                            uint32_t max_batch, uint32_t budget);
+
+/**
+ * @brief Get storage required for a batch
+ * @param input_size Bytes of one model input
+ * @param output_size Bytes of one model output
+ * @param capacity Slots (1..OCR_REC_MAX_BATCH)
+ * @return Required storage in bytes, 0 if invalid
+ */
+uint32_t ocr_rec_batch_size(uint32_t input_size, uint32_t output_size, uint32_t capacity);
+
+/**
+ * @brief Initialize an empty batch
+ * @param batch Batch
+ * @param input_size Bytes of one model input
+ * @param output_size Bytes of one model output
+ * @param capacity Slots
+ * @param storage Storage (8-byte aligned, ocr_rec_batch_size() bytes)
+ * @param storage_size Size of storage in bytes
+ * @return 0 on success, negative on error
+ */
+int ocr_rec_batch_init(ocr_rec_batch_t *batch, uint32_t input_size, uint32_t output_size,
+                       uint32_t capacity, void *storage, uint32_t storage_size);
+
+/**
+ * @brief Input of the next free slot, to crop into
+ * @param batch Batch
+ * @return Input of the slot (input_size bytes), NULL if the batch is full
+ * @details The slot joins the batch only with ocr_rec_batch_push(), so a
+ *          crop that fails is simply overwritten by the next one
+ */
+int8_t* ocr_rec_batch_next(ocr_rec_batch_t *batch);
+
+/**
+ * @brief Add the slot returned by ocr_rec_batch_next() to the batch
+ * @param batch Batch
+ * @param tag Box the slot was staged for
+ * @return 0 on success, negative if the batch is full
+ */
+int ocr_rec_batch_push(ocr_rec_batch_t *batch, uint16_t tag);
+
+/**
+ * @brief Output of a slot after inference
+ * @param batch Batch
+ * @param slot Slot (0..count-1)
+ * @return Output of the slot (output_size bytes), NULL if out of range
+ */
+const int8_t* ocr_rec_batch_output(const ocr_rec_batch_t *batch, uint32_t slot);
+
+/**
+ * @brief Empty the batch for the next group of crops
+ * @param batch Batch
+ */
+void ocr_rec_batch_clear(ocr_rec_batch_t *batch);
+
+#endif // OCR_REC_BATCH_H
@@ -0,0 +1,61 @@
+/**
+ * @file ocr_rec_bucket.c
+ * @brief Width buckets: recognition model variants selected per crop width
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#include "ocr_rec_bucket.h"
+#include <stddef.h>
+
+void ocr_rec_buckets_init(ocr_rec_buckets_t *buckets)
+{
+    if (buckets) {
+        buckets->count = 0;
+    }
+}
+
+int ocr_rec_buckets_add(ocr_rec_buckets_t *buckets, uint16_t width, uint8_t model)
+{
+    if (!buckets || width == 0 || buckets->count >= OCR_REC_MAX_BUCKETS) {
+        return -1;
+    }
+
+    // Insertion into the sorted table (a handful of entries)
+    uint32_t pos = buckets->count;
+    while (pos > 0 && buckets->bucket[pos - 1].width >= width) {
+        if (buckets->bucket[pos - 1].width == width) {
+            return -1;
+        }
+        pos--;
+    }
+    for (uint32_t i = buckets->count; i > pos; i--) {
+        buckets->bucket[i] = buckets->bucket[i - 1];
+    }
+    buckets->bucket[pos].width = width;
+    buckets->bucket[pos].model = model;
+    buckets->count++;
+    return buckets->count;
+}
+
+int ocr_rec_buckets_select(const ocr_rec_buckets_t *buckets, uint16_t strip_width)
+{
+    if (!buckets || buckets->count == 0) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < buckets->count; i++) {
+        if (strip_width <= buckets->bucket[i].width) {
+            return (int)i;
+        }
+    }
+    return buckets->count - 1;
+}
+
+uint16_t ocr_rec_buckets_max_width(const ocr_rec_buckets_t *buckets)
+{
+    if (!buckets || buckets->count == 0) {
+        return 0;
+    }
+    return buckets->bucket[buckets->count - 1].width;
+}
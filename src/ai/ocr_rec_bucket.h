@@ -0,0 +1,65 @@
+/**
+ * @file ocr_rec_bucket.h
+ * @brief Width buckets: recognition model variants selected per crop width
+ * @details The recognition model is compiled at a few input widths (e.g.
+ *          80/160/320/640 at height 48). Each height-normalized strip goes to
+ *          the narrowest variant it fits without being squashed, so short
+ *          words do not pay for a line's worth of padding and long lines keep
+ *          their aspect ratio. Strips wider than the widest variant are
+ *          scaled down into it. Platform independent (no HAL dependency)
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#ifndef OCR_REC_BUCKET_H
+#define OCR_REC_BUCKET_H
+
+#include <stdint.h>
+
+// Defaults
+#define OCR_REC_MAX_BUCKETS   4     // Width variants of the recognition model
+
+// One width variant
+typedef struct {
+    uint16_t width;                 // Model input width (pixels)
+    uint8_t model;                  // Model the variant is (caller's id, e.g. ai_model_type_t)
+} ocr_rec_bucket_t;
+
+// Variants sorted by width, narrowest first
+typedef struct {
+    ocr_rec_bucket_t bucket[OCR_REC_MAX_BUCKETS];
+    uint8_t count;
+} ocr_rec_buckets_t;
+
+/**
+ * @brief Initialize an empty bucket table
+ * @param buckets Bucket table
+ */
+void ocr_rec_buckets_init(ocr_rec_buckets_t *buckets);
+
+/**
+ * @brief Add a model variant, keeping the table sorted by width
+ * @param buckets Bucket table
+ * @param width Model input width
+ * @param model Model id
+ * @return Bucket count on success, negative if full, zero width or a duplicate width
+ */
+int ocr_rec_buckets_add(ocr_rec_buckets_t *buckets, uint16_t width, uint8_t model);
+
+/**
+ * @brief Narrowest bucket a strip fits into
+ * @param buckets Bucket table
+ * @param strip_width Strip width at the model input height
+ * @return Bucket index, the widest bucket for a strip wider than all of them,
+ *         negative if the table is empty
+ */
+int ocr_rec_buckets_select(const ocr_rec_buckets_t *buckets, uint16_t strip_width);
+
+/**
+ * @brief Widest bucket width (longest strip recognized unscaled)
+ * @param buckets Bucket table
+ * @return Width in pixels, 0 if the table is empty
+ */
+uint16_t ocr_rec_buckets_max_width(const ocr_rec_buckets_t *buckets);
+
+#endif // OCR_REC_BUCKET_H
@@ -0,0 +1,37 @@
+/**
+ * @file ocr_simd.h
+ * @brief Compile-time SIMD kernel selection shared by the OCR kernels
+ * @details Exactly one of OCR_SIMD_MVE, OCR_SIMD_NEON, OCR_SIMD_SSE2 or
+ *          OCR_SIMD_SCALAR is defined, with the matching intrinsics header
+ *          included. Define OCR_SIMD_FORCE_SCALAR to disable SIMD in every
+ *          kernel (reference builds, bit-exactness checks). Platform
+ *          independent (no HAL dependency)
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#ifndef OCR_SIMD_H
+#define OCR_SIMD_H
+
+#if defined(OCR_SIMD_FORCE_SCALAR)
+#define OCR_SIMD_SCALAR 1
+#elif defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+#include <arm_mve.h>
+#define OCR_SIMD_MVE 1
+#if (__ARM_FEATURE_MVE & 2)
+#define OCR_SIMD_MVE_FLOAT 1        // Float MVE (integer-only cores take the scalar path)
+#endif
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define OCR_SIMD_NEON 1
+#if defined(__aarch64__)
+#define OCR_SIMD_NEON_A64 1         // AArch64-only intrinsics (across-vector reductions)
+#endif
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define OCR_SIMD_SSE2 1
+#else
+#define OCR_SIMD_SCALAR 1
+#endif
+
+#endif // OCR_SIMD_H
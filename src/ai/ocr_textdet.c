@@ -0,0 +1,1573 @@
+/**
+ * @file ocr_textdet.c
+ * @brief Text detection postprocessing on quantized model outputs
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#include "ocr_textdet.h"
+#include "ocr_common.h"
+#include "ocr_simd.h"
+#include <math.h>
+#include <string.h>
+
+// Round-to-nearest division, d > 0
+static inline int64_t ocr_div_round(int64_t n, int64_t d)
+{
+    return (n >= 0) ? (n + d / 2) / d : -((-n + d / 2) / d);
+}
+
+static int8_t ocr_prob_to_q(float prob, float scale, int32_t zero_point)
+{
+    int32_t q = (int32_t)lrintf(prob / scale) + zero_point;
+    return (int8_t)(q < -128 ? -128 : (q > 127 ? 127 : q));
+}
+
+// ========================================================================
+// Box set
+// ========================================================================
+
+uint32_t ocr_det_boxes_size(uint32_t capacity)
+{
+    return 4u * ocr_align4(capacity * sizeof(uint16_t)) + 2u * ocr_align4(capacity) +
+           2u * 4u * capacity * sizeof(int16_t);
+}
+
+int ocr_det_boxes_init(ocr_det_boxes_t *boxes, uint32_t capacity, void *storage, uint32_t storage_size)
+{
+    uint8_t *p = (uint8_t*)storage;
+    const uint32_t field = ocr_align4(capacity * sizeof(uint16_t));
+
+    if (!boxes || !storage || capacity == 0 || storage_size < ocr_det_boxes_size(capacity)) {
+        return -1;
+    }
+
+    // Corner arrays (4 per box), then one array per field
+    boxes->quad_x = (int16_t*)p;
+    p += 4u * capacity * sizeof(int16_t);
+    boxes->quad_y = (int16_t*)p;
+    p += 4u * capacity * sizeof(int16_t);
+    boxes->x = (uint16_t*)p;
+    p += field;
+    boxes->y = (uint16_t*)p;
+    p += field;
+    boxes->width = (uint16_t*)p;
+    p += field;
+    boxes->height = (uint16_t*)p;
+    p += field;
+    boxes->score = p;
+    p += ocr_align4(capacity);
+    boxes->direction = p;
+    boxes->count = 0;
+    boxes->capacity = capacity;
+
+    return 0;
+}
+
+void ocr_det_boxes_get(const ocr_det_boxes_t *boxes, uint32_t index, ocr_det_box_t *box)
+{
+    box->x = boxes->x[index];
+    box->y = boxes->y[index];
+    box->width = boxes->width[index];
+    box->height = boxes->height[index];
+    box->score = boxes->score[index];
+    box->direction = boxes->direction[index];
+    for (int i = 0; i < 4; i++) {
+        box->quad_x[i] = boxes->quad_x[4 * index + i];
+        box->quad_y[i] = boxes->quad_y[4 * index + i];
+    }
+}
+
+static void ocr_det_boxes_put(ocr_det_boxes_t *boxes, uint32_t index, const ocr_det_box_t *box)
+{
+    boxes->x[index] = box->x;
+    boxes->y[index] = box->y;
+    boxes->width[index] = box->width;
+    boxes->height[index] = box->height;
+    boxes->score[index] = box->score;
+    boxes->direction[index] = box->direction;
+    for (int i = 0; i < 4; i++) {
+        boxes->quad_x[4 * index + i] = box->quad_x[i];
+        boxes->quad_y[4 * index + i] = box->quad_y[i];
+    }
+}
+
+// Long side at least ratio x short side (Q8)
+static inline int ocr_det_box_elongated(const ocr_det_boxes_t *boxes, uint32_t i, uint32_t ratio_q8)
+{
+    const uint32_t w = boxes->width[i];
+    const uint32_t h = boxes->height[i];
+    return (w > h ? w : h) * 256u >= ratio_q8 * (w > h ? h : w);
+}
+
+uint32_t ocr_det_classify_direction(ocr_det_boxes_t *boxes, float ratio)
+{
+    const uint32_t ratio_q8 = (uint32_t)(ratio * 256.0f + 0.5f);
+    uint32_t votes[2] = {0, 0};
+    uint32_t changed = 0;
+
+    for (uint32_t i = 0; i < boxes->count; i++) {
+        if (ocr_det_box_elongated(boxes, i, ratio_q8)) {
+            votes[boxes->direction[i] ? 1 : 0]++;
+        }
+    }
+
+    for (uint32_t i = 0; i < boxes->count; i++) {
+        if (ocr_det_box_elongated(boxes, i, ratio_q8)) {
+            continue;
+        }
+
+        // Nearest elongated box within reach (centers in 2x units)
+        const int32_t cx = 2 * boxes->x[i] + boxes->width[i];
+        const int32_t cy = 2 * boxes->y[i] + boxes->height[i];
+        const int32_t side = (boxes->width[i] > boxes->height[i]) ? boxes->width[i] : boxes->height[i];
+        int64_t best = (int64_t)(2 * OCR_DET_DIRECTION_REACH * side) * (2 * OCR_DET_DIRECTION_REACH * side);
+        int32_t direction = -1;
+        for (uint32_t j = 0; j < boxes->count; j++) {
+            if (j == i || !ocr_det_box_elongated(boxes, j, ratio_q8)) {
+                continue;
+            }
+            const int32_t dx = 2 * boxes->x[j] + boxes->width[j] - cx;
+            const int32_t dy = 2 * boxes->y[j] + boxes->height[j] - cy;
+            const int64_t d2 = (int64_t)dx * dx + (int64_t)dy * dy;
+            if (d2 <= best) {
+                best = d2;
+                direction = boxes->direction[j] ? 1 : 0;
+            }
+        }
+        if (direction < 0 && votes[0] != votes[1]) {
+            direction = (votes[1] > votes[0]) ? 1 : 0;
+        }
+        if (direction < 0 || direction == (boxes->direction[i] ? 1 : 0)) {
+            continue;
+        }
+
+        // Corners restart at the new reading start: TL for horizontal, top-right for vertical
+        ocr_det_box_t box;
+        ocr_det_boxes_get(boxes, i, &box);
+        const int shift = direction ? 1 : 3;
+        for (int k = 0; k < 4; k++) {
+            boxes->quad_x[4 * i + k] = box.quad_x[(k + shift) & 3];
+            boxes->quad_y[4 * i + k] = box.quad_y[(k + shift) & 3];
+        }
+        boxes->direction[i] = (uint8_t)direction;
+        changed++;
+    }
+
+    return changed;
+}
+
+// ========================================================================
+// DBNet
+// ========================================================================
+
+// Hull scratch per coordinate: candidate points, then the hull itself
+static uint32_t ocr_dbnet_hull_capacity(uint16_t height)
+{
+    return 2u * ((uint32_t)height + 2u);
+}
+
+uint32_t ocr_dbnet_size(uint16_t width, uint16_t height, uint16_t max_labels)
+{
+    return (uint32_t)max_labels * sizeof(ocr_dbnet_component_t) +
+           ocr_align4((uint32_t)width * height * sizeof(uint16_t)) +
+           ocr_align4((uint32_t)max_labels * sizeof(uint16_t)) +
+           ocr_align4(2u * height * sizeof(int16_t)) +
+           2u * ocr_align4(2u * ocr_dbnet_hull_capacity(height) * sizeof(int16_t));
+}
+
+int ocr_dbnet_init(ocr_dbnet_t *dbnet, uint16_t width, uint16_t height, uint8_t map_scale,
+                   uint16_t max_labels, float prob_scale, int32_t prob_zero_point,
+                   void *storage, uint32_t storage_size)
+{
+    uint8_t *p = (uint8_t*)storage;
+    const uint32_t hull_capacity = ocr_dbnet_hull_capacity(height);
+
+    if (!dbnet || !storage || width == 0 || height == 0 || width > 1024 || height > 1024 ||
+        map_scale == 0 || max_labels < 2 || prob_scale <= 0.0f ||
+        storage_size < ocr_dbnet_size(width, height, max_labels)) {
+        return -1;
+    }
+
+    memset(dbnet, 0, sizeof(*dbnet));
+    dbnet->width = width;
+    dbnet->height = height;
+    dbnet->map_scale = map_scale;
+    dbnet->max_labels = max_labels;
+    dbnet->zero_point = (int8_t)prob_zero_point;
+    dbnet->thresh_q = ocr_prob_to_q(OCR_DBNET_THRESH, prob_scale, prob_zero_point);
+    dbnet->box_thresh_q = ocr_prob_to_q(OCR_DBNET_BOX_THRESH, prob_scale, prob_zero_point);
+    dbnet->unclip_ratio_q8 = (uint16_t)lrintf(OCR_DBNET_UNCLIP_RATIO * 256.0f);
+    dbnet->min_area = OCR_DBNET_MIN_AREA;
+    dbnet->min_size = OCR_DBNET_MIN_SIZE;
+    dbnet->score_mul_q16 = (uint32_t)lrintf(prob_scale * 255.0f * 65536.0f);
+
+    dbnet->components = (ocr_dbnet_component_t*)p;
+    p += (uint32_t)max_labels * sizeof(ocr_dbnet_component_t);
+    dbnet->labels = (uint16_t*)p;
+    p += ocr_align4((uint32_t)width * height * sizeof(uint16_t));
+    dbnet->parent = (uint16_t*)p;
+    p += ocr_align4((uint32_t)max_labels * sizeof(uint16_t));
+    dbnet->row_left = (int16_t*)p;
+    dbnet->row_right = dbnet->row_left + height;
+    p += ocr_align4(2u * height * sizeof(int16_t));
+    dbnet->hull_x = (int16_t*)p;
+    p += ocr_align4(2u * hull_capacity * sizeof(int16_t));
+    dbnet->hull_y = (int16_t*)p;
+
+    return 0;
+}
+
+static inline uint16_t ocr_uf_find(uint16_t *parent, uint16_t a)
+{
+    // Path halving
+    while (parent[a] != a) {
+        parent[a] = parent[parent[a]];
+        a = parent[a];
+    }
+    return a;
+}
+
+// Smaller label becomes the root, so parent[l] < l always holds
+static inline void ocr_uf_union(uint16_t *parent, uint16_t a, uint16_t b)
+{
+    a = ocr_uf_find(parent, a);
+    b = ocr_uf_find(parent, b);
+    if (a < b) {
+        parent[b] = a;
+    } else if (b < a) {
+        parent[a] = b;
+    }
+}
+
+/**
+ * @brief Label text pixels and accumulate per-label statistics in one raster pass
+ * @return Number of provisional labels used + 1
+ */
+static uint32_t ocr_dbnet_label(ocr_dbnet_t *db, const int8_t *map, uint32_t map_stride)
+{
+    const uint32_t w = db->width;
+    const int8_t thresh = db->thresh_q;
+    uint16_t *parent = db->parent;
+    uint32_t next = 1;
+
+    parent[0] = 0;
+    for (uint32_t y = 0; y < db->height; y++) {
+        const int8_t *row = map + y * map_stride;
+        uint16_t *lab = db->labels + y * w;
+        const uint16_t *up = (y > 0) ? lab - w : NULL;
+
+        for (uint32_t x = 0; x < w; x++) {
+            if (row[x] <= thresh) {
+                lab[x] = 0;
+                continue;
+            }
+
+            // 8-connectivity: a labeled N already joins NW, NE and W
+            uint16_t l = up ? up[x] : 0;
+            if (l == 0) {
+                uint16_t ne = (up && x + 1 < w) ? up[x + 1] : 0;
+                uint16_t left = (x > 0) ? lab[x - 1] : 0;
+                if (left == 0 && up && x > 0) {
+                    left = up[x - 1];
+                }
+                if (ne != 0) {
+                    l = ne;
+                    if (left != 0) {
+                        ocr_uf_union(parent, ne, left);
+                    }
+                } else {
+                    l = left;
+                }
+            }
+
+            ocr_dbnet_component_t *c;
+            if (l == 0) {
+                if (next >= db->max_labels) {
+                    // Out of labels: drop the pixel, keep the pass bounded
+                    lab[x] = 0;
+                    db->dropped_pixels++;
+                    continue;
+                }
+                l = (uint16_t)next++;
+                parent[l] = l;
+                c = &db->components[l];
+                c->area = 0;
+                c->sum = 0;
+                c->x0 = c->x1 = (uint16_t)x;
+                c->y0 = c->y1 = (uint16_t)y;
+            } else {
+                c = &db->components[l];
+                if (x < c->x0) c->x0 = (uint16_t)x;
+                if (x > c->x1) c->x1 = (uint16_t)x;
+                c->y1 = (uint16_t)y;
+            }
+
+            lab[x] = l;
+            c->area++;
+            c->sum += row[x];
+        }
+    }
+
+    return next;
+}
+
+// Flatten the forest and fold each label's statistics into its root
+static uint32_t ocr_dbnet_resolve(ocr_dbnet_t *db, uint32_t label_count)
+{
+    uint16_t *parent = db->parent;
+    uint32_t roots = 0;
+
+    for (uint32_t l = 1; l < label_count; l++) {
+        if (parent[l] == l) {
+            roots++;
+            continue;
+        }
+
+        // parent[l] < l was resolved already, so one hop reaches the root
+        uint16_t root = parent[parent[l]];
+        ocr_dbnet_component_t *r = &db->components[root];
+        const ocr_dbnet_component_t *c = &db->components[l];
+
+        parent[l] = root;
+        r->area += c->area;
+        r->sum += c->sum;
+        if (c->x0 < r->x0) r->x0 = c->x0;
+        if (c->x1 > r->x1) r->x1 = c->x1;
+        if (c->y0 < r->y0) r->y0 = c->y0;
+        if (c->y1 > r->y1) r->y1 = c->y1;
+    }
+
+    return roots;
+}
+
+static inline int32_t ocr_cross(int32_t ox, int32_t oy, int32_t ax, int32_t ay, int32_t bx, int32_t by)
+{
+    return (ax - ox) * (by - oy) - (ay - oy) * (bx - ox);
+}
+
+/**
+ * @brief Convex hull of a component from its per-row extents (pixel corners)
+ * @return Hull vertex count, vertices at hull_x/hull_y + capacity
+ */
+static uint32_t ocr_dbnet_hull(ocr_dbnet_t *db, uint16_t root, const ocr_dbnet_component_t *c)
+{
+    const uint32_t capacity = ocr_dbnet_hull_capacity(db->height);
+    const uint16_t *parent = db->parent;
+    int16_t *px = db->hull_x;
+    int16_t *py = db->hull_y;
+    int16_t *hx = db->hull_x + capacity;
+    int16_t *hy = db->hull_y + capacity;
+    uint32_t n = 0;
+
+    // A connected component touches every row of its bounds
+    for (uint32_t y = c->y0; y <= c->y1; y++) {
+        const uint16_t *lab = db->labels + y * db->width;
+        int32_t l = c->x0;
+        int32_t r = c->x1;
+
+        while (l < r && parent[lab[l]] != root) l++;
+        while (r > l && parent[lab[r]] != root) r--;
+        db->row_left[y - c->y0] = (int16_t)l;
+        db->row_right[y - c->y0] = (int16_t)(r + 1);
+    }
+
+    // Two points per pixel boundary line, already sorted by (y, x)
+    for (uint32_t y = c->y0; y <= (uint32_t)c->y1 + 1; y++) {
+        uint32_t i = y - c->y0;
+        int16_t lo = INT16_MAX;
+        int16_t hi = INT16_MIN;
+
+        if (y > c->y0) {
+            lo = db->row_left[i - 1];
+            hi = db->row_right[i - 1];
+        }
+        if (y <= c->y1) {
+            if (db->row_left[i] < lo) lo = db->row_left[i];
+            if (db->row_right[i] > hi) hi = db->row_right[i];
+        }
+        px[n] = lo;
+        py[n] = (int16_t)y;
+        n++;
+        px[n] = hi;
+        py[n] = (int16_t)y;
+        n++;
+    }
+
+    // Monotone chain (y-major order)
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        while (k >= 2 && ocr_cross(hx[k - 2], hy[k - 2], hx[k - 1], hy[k - 1], px[i], py[i]) <= 0) k--;
+        hx[k] = px[i];
+        hy[k] = py[i];
+        k++;
+    }
+    for (int32_t i = (int32_t)n - 2, t = (int32_t)k + 1; i >= 0; i--) {
+        while ((int32_t)k >= t && ocr_cross(hx[k - 2], hy[k - 2], hx[k - 1], hy[k - 1], px[i], py[i]) <= 0) k--;
+        hx[k] = px[i];
+        hy[k] = py[i];
+        k++;
+    }
+
+    return k - 1;
+}
+
+// Rectangle in the frame of a hull edge: origin + (e * p + n * q) / |e|^2, n = (ey, -ex)
+typedef struct {
+    int32_t ox, oy;
+    int32_t ex, ey;
+    int64_t l2;
+    int64_t p0, p1, q0, q1;
+} ocr_edge_rect_t;
+
+/**
+ * @brief Minimum-area enclosing rectangle by rotating calipers over hull edges
+ * @details Integer only: extents are kept scaled by |e| and areas compared by
+ *          cross-multiplying with |e|^2
+ */
+static int ocr_dbnet_min_area_rect(const int16_t *hx, const int16_t *hy, uint32_t m, ocr_edge_rect_t *best)
+{
+    int64_t best_area = -1;
+
+    for (uint32_t i = 0; i < m; i++) {
+        const uint32_t j = (i + 1 == m) ? 0 : i + 1;
+        const int32_t ex = hx[j] - hx[i];
+        const int32_t ey = hy[j] - hy[i];
+        const int64_t l2 = (int64_t)ex * ex + (int64_t)ey * ey;
+        int32_t p0 = 0, p1 = 0, q0 = 0, q1 = 0;
+
+        if (l2 == 0) {
+            continue;
+        }
+        for (uint32_t k = 0; k < m; k++) {
+            const int32_t dx = hx[k] - hx[i];
+            const int32_t dy = hy[k] - hy[i];
+            const int32_t p = dx * ex + dy * ey;
+            const int32_t q = dx * ey - dy * ex;
+            if (p < p0) p0 = p;
+            if (p > p1) p1 = p;
+            if (q < q0) q0 = q;
+            if (q > q1) q1 = q;
+        }
+
+        // area = (p1 - p0) * (q1 - q0) / l2
+        const int64_t area = (int64_t)(p1 - p0) * (q1 - q0);
+        if (best_area < 0 || area * best->l2 < best_area * l2) {
+            best_area = area;
+            best->ox = hx[i];
+            best->oy = hy[i];
+            best->ex = ex;
+            best->ey = ey;
+            best->l2 = l2;
+            best->p0 = p0;
+            best->p1 = p1;
+            best->q0 = q0;
+            best->q1 = q1;
+        }
+    }
+
+    return best_area < 0 ? -1 : 0;
+}
+
+/**
+ * @brief Unclip, order corners along the reading direction and scale to input pixels
+ */
+static void ocr_dbnet_emit(const ocr_dbnet_t *db, ocr_edge_rect_t *r, ocr_det_box_t *box)
+{
+    const int64_t pw = r->p1 - r->p0;
+    const int64_t ph = r->q1 - r->q0;
+    int32_t cx[4], cy[4];
+    int32_t dx, dy;
+
+    // DBNet unclip: offset D = area * ratio / perimeter. In |e|-scaled units
+    // D * |e| = pw * ph * ratio / (2 * (pw + ph)), so no square root is needed
+    const int64_t delta = (pw * ph * db->unclip_ratio_q8) / (512 * (pw + ph));
+    r->p0 -= delta;
+    r->p1 += delta;
+    r->q0 -= delta;
+    r->q1 += delta;
+
+    // Corners in 1/16 map pixels
+    const int64_t ps[4] = {r->p0, r->p1, r->p1, r->p0};
+    const int64_t qs[4] = {r->q0, r->q0, r->q1, r->q1};
+    int32_t sum_x = 0, sum_y = 0;
+    for (int i = 0; i < 4; i++) {
+        cx[i] = r->ox * 16 + (int32_t)ocr_div_round((r->ex * ps[i] + r->ey * qs[i]) * 16, r->l2);
+        cy[i] = r->oy * 16 + (int32_t)ocr_div_round((r->ey * ps[i] - r->ex * qs[i]) * 16, r->l2);
+        sum_x += cx[i];
+        sum_y += cy[i];
+    }
+
+    // Reading direction = long side, pointing right (or down when vertical)
+    if (pw >= ph) {
+        dx = r->ex;
+        dy = r->ey;
+    } else {
+        dx = r->ey;
+        dy = -r->ex;
+    }
+    if (dx < 0 || (dx == 0 && dy < 0)) {
+        dx = -dx;
+        dy = -dy;
+    }
+    box->direction = ((int64_t)dy * dy > (int64_t)dx * dx) ? 1 : 0;
+
+    const int32_t scale = db->map_scale;
+    const int32_t limit_x = (int32_t)db->width * scale;
+    const int32_t limit_y = (int32_t)db->height * scale;
+    int32_t min_x = INT32_MAX, min_y = INT32_MAX, max_x = INT32_MIN, max_y = INT32_MIN;
+    for (int i = 0; i < 4; i++) {
+        // Center is the corner mean (x4 to stay integer)
+        const int64_t rx = (int64_t)cx[i] * 4 - sum_x;
+        const int64_t ry = (int64_t)cy[i] * 4 - sum_y;
+        const int64_t s = rx * dx + ry * dy;
+        const int64_t t = ry * dx - rx * dy;
+        const int idx = (s < 0) ? (t < 0 ? 0 : 3) : (t < 0 ? 1 : 2);
+        const int32_t qx = (int32_t)ocr_div_round((int64_t)cx[i] * scale, 16);
+        const int32_t qy = (int32_t)ocr_div_round((int64_t)cy[i] * scale, 16);
+
+        box->quad_x[idx] = (int16_t)qx;
+        box->quad_y[idx] = (int16_t)qy;
+        if (qx < min_x) min_x = qx;
+        if (qx > max_x) max_x = qx;
+        if (qy < min_y) min_y = qy;
+        if (qy > max_y) max_y = qy;
+    }
+
+    min_x = min_x < 0 ? 0 : min_x;
+    min_y = min_y < 0 ? 0 : min_y;
+    max_x = max_x > limit_x ? limit_x : max_x;
+    max_y = max_y > limit_y ? limit_y : max_y;
+    box->x = (uint16_t)min_x;
+    box->y = (uint16_t)min_y;
+    box->width = (uint16_t)(max_x > min_x ? max_x - min_x : 0);
+    box->height = (uint16_t)(max_y > min_y ? max_y - min_y : 0);
+}
+
+uint32_t ocr_dbnet_decode(ocr_dbnet_t *dbnet, const int8_t *map, uint32_t map_stride,
+                          ocr_det_boxes_t *boxes)
+{
+    const uint32_t capacity = ocr_dbnet_hull_capacity(dbnet->height);
+    const int64_t min_size2 = (int64_t)dbnet->min_size * dbnet->min_size;
+    uint32_t count = 0;
+
+    dbnet->overflow = 0;
+    dbnet->dropped_pixels = 0;
+
+    const uint32_t labels = ocr_dbnet_label(dbnet, map, map_stride);
+    dbnet->component_count = (uint16_t)ocr_dbnet_resolve(dbnet, labels);
+
+    for (uint32_t l = 1; l < labels; l++) {
+        const ocr_dbnet_component_t *c = &dbnet->components[l];
+        ocr_edge_rect_t rect;
+
+        if (dbnet->parent[l] != l || c->area < dbnet->min_area ||
+            c->sum < (int32_t)dbnet->box_thresh_q * (int32_t)c->area) {
+            continue;
+        }
+        if (count == boxes->capacity) {
+            dbnet->overflow++;
+            continue;
+        }
+
+        uint32_t m = ocr_dbnet_hull(dbnet, (uint16_t)l, c);
+        if (ocr_dbnet_min_area_rect(dbnet->hull_x + capacity, dbnet->hull_y + capacity, m, &rect) != 0) {
+            continue;
+        }
+
+        // Short side (map pixels) = min(extent) / |e|
+        const int64_t pw = rect.p1 - rect.p0;
+        const int64_t ph = rect.q1 - rect.q0;
+        const int64_t short_side = pw < ph ? pw : ph;
+        if (short_side * short_side < min_size2 * rect.l2) {
+            continue;
+        }
+
+        ocr_det_box_t box;
+        ocr_dbnet_emit(dbnet, &rect, &box);
+
+        int32_t mean = (int32_t)ocr_div_round(c->sum, c->area);
+        int32_t score = (int32_t)(((int64_t)(mean - dbnet->zero_point) * dbnet->score_mul_q16) >> 16);
+        box.score = (uint8_t)(score < 0 ? 0 : (score > 255 ? 255 : score));
+        ocr_det_boxes_put(boxes, count, &box);
+        count++;
+    }
+
+    boxes->count = count;
+    return count;
+}
+
+// ========================================================================
+// Rotated IoU and NMS
+// ========================================================================
+
+// Bounds of removed entries never overlap anything
+#define OCR_QUAD_EMPTY_MIN   1e30f
+#define OCR_QUAD_EMPTY_MAX   (-1e30f)
+
+// Clipping a convex polygon by a half-plane adds at most one vertex
+#define OCR_QUAD_CLIP_MAX    8
+
+uint32_t ocr_quad_set_size(uint32_t capacity)
+{
+    // quad (8), bounds (4), area, score, support, iou + order
+    return capacity * (16u * sizeof(float) + sizeof(uint32_t));
+}
+
+int ocr_quad_set_init(ocr_quad_set_t *set, uint32_t capacity, void *storage, uint32_t storage_size)
+{
+    float *p = (float*)storage;
+
+    if (!set || !storage || capacity == 0 || capacity > 65535 ||
+        storage_size < ocr_quad_set_size(capacity)) {
+        return -1;
+    }
+
+    set->quad = p;
+    p += 8u * capacity;
+    set->min_x = p;
+    p += capacity;
+    set->min_y = p;
+    p += capacity;
+    set->max_x = p;
+    p += capacity;
+    set->max_y = p;
+    p += capacity;
+    set->area = p;
+    p += capacity;
+    set->score = p;
+    p += capacity;
+    set->support = p;
+    p += capacity;
+    set->iou = p;
+    p += capacity;
+    set->order = (uint32_t*)p;
+    set->count = 0;
+    set->capacity = capacity;
+
+    return 0;
+}
+
+// Twice the signed area (positive for TL, TR, BR, BL in image coordinates)
+static float ocr_polygon_area2(const float *pts, uint32_t n)
+{
+    float a = 0.0f;
+    for (uint32_t i = 0; i < n; i++) {
+        const uint32_t j = (i + 1 == n) ? 0 : i + 1;
+        a += pts[2 * i] * pts[2 * j + 1] - pts[2 * j] * pts[2 * i + 1];
+    }
+    return a;
+}
+
+static void ocr_quad_set_store(ocr_quad_set_t *set, uint32_t i, const float quad[8], float score, float support)
+{
+    float *q = set->quad + 8u * i;
+    float x0 = quad[0], x1 = quad[0], y0 = quad[1], y1 = quad[1];
+
+    for (int k = 0; k < 8; k++) {
+        q[k] = quad[k];
+    }
+    for (int k = 1; k < 4; k++) {
+        if (quad[2 * k] < x0) x0 = quad[2 * k];
+        if (quad[2 * k] > x1) x1 = quad[2 * k];
+        if (quad[2 * k + 1] < y0) y0 = quad[2 * k + 1];
+        if (quad[2 * k + 1] > y1) y1 = quad[2 * k + 1];
+    }
+    set->min_x[i] = x0;
+    set->min_y[i] = y0;
+    set->max_x[i] = x1;
+    set->max_y[i] = y1;
+    set->area[i] = 0.5f * fabsf(ocr_polygon_area2(quad, 4));
+    set->score[i] = score;
+    set->support[i] = support;
+}
+
+static void ocr_quad_set_remove(ocr_quad_set_t *set, uint32_t i)
+{
+    set->min_x[i] = set->min_y[i] = OCR_QUAD_EMPTY_MIN;
+    set->max_x[i] = set->max_y[i] = OCR_QUAD_EMPTY_MAX;
+    set->area[i] = 0.0f;
+    set->score[i] = 0.0f;
+}
+
+int32_t ocr_quad_set_push(ocr_quad_set_t *set, const float quad[8], float score, float support)
+{
+    if (set->count >= set->capacity) {
+        return -1;
+    }
+    ocr_quad_set_store(set, set->count, quad, score, support);
+    return (int32_t)set->count++;
+}
+
+/**
+ * @brief Area of a ∩ b for convex quads (Sutherland-Hodgman, a clipped by each edge of b)
+ */
+static float ocr_quad_intersection(const float *a, const float *b)
+{
+    float buf0[2 * OCR_QUAD_CLIP_MAX], buf1[2 * OCR_QUAD_CLIP_MAX];
+    float *in = buf0;
+    float *out = buf1;
+    uint32_t n = 4;
+    const float orient = (ocr_polygon_area2(b, 4) >= 0.0f) ? 1.0f : -1.0f;
+
+    memcpy(in, a, 8 * sizeof(float));
+    for (uint32_t e = 0; e < 4 && n > 0; e++) {
+        const uint32_t f = (e + 1) & 3;
+        const float ex = b[2 * e], ey = b[2 * e + 1];
+        const float dx = b[2 * f] - ex, dy = b[2 * f + 1] - ey;
+        uint32_t m = 0;
+
+        for (uint32_t i = 0; i < n; i++) {
+            const uint32_t j = (i + 1 == n) ? 0 : i + 1;
+            const float px = in[2 * i], py = in[2 * i + 1];
+            const float qx = in[2 * j], qy = in[2 * j + 1];
+            const float sp = orient * (dx * (py - ey) - dy * (px - ex));
+            const float sq = orient * (dx * (qy - ey) - dy * (qx - ex));
+
+            if (sp >= 0.0f) {
+                out[2 * m] = px;
+                out[2 * m + 1] = py;
+                m++;
+            }
+            if ((sp >= 0.0f) != (sq >= 0.0f) && m < OCR_QUAD_CLIP_MAX) {
+                const float t = sp / (sp - sq);
+                out[2 * m] = px + t * (qx - px);
+                out[2 * m + 1] = py + t * (qy - py);
+                m++;
+            }
+        }
+
+        float *tmp = in;
+        in = out;
+        out = tmp;
+        n = m;
+    }
+
+    return (n < 3) ? 0.0f : 0.5f * fabsf(ocr_polygon_area2(in, n));
+}
+
+float ocr_quad_iou(const float a[8], const float b[8])
+{
+    const float inter = ocr_quad_intersection(a, b);
+    const float uni = 0.5f * (fabsf(ocr_polygon_area2(a, 4)) + fabsf(ocr_polygon_area2(b, 4))) - inter;
+    return (uni > 0.0f) ? inter / uni : 0.0f;
+}
+
+static inline float ocr_quad_iou_entry(const ocr_quad_set_t *set, const float *quad, float area, uint32_t j)
+{
+    const float inter = ocr_quad_intersection(quad, set->quad + 8u * j);
+    const float uni = area + set->area[j] - inter;
+    return (uni > 0.0f) ? inter / uni : 0.0f;
+}
+
+void ocr_quad_iou_batch_scalar(const ocr_quad_set_t *set, const float quad[8], uint32_t begin,
+                               uint32_t end, float *iou)
+{
+    const float area = 0.5f * fabsf(ocr_polygon_area2(quad, 4));
+
+    for (uint32_t j = begin; j < end; j++) {
+        iou[j - begin] = (set->score[j] > 0.0f) ? ocr_quad_iou_entry(set, quad, area, j) : 0.0f;
+    }
+}
+
+void ocr_quad_iou_batch(const ocr_quad_set_t *set, const float quad[8], uint32_t begin, uint32_t end,
+                        float min_iou, float *iou)
+{
+    float qx0 = quad[0], qx1 = quad[0], qy0 = quad[1], qy1 = quad[1];
+    for (int k = 1; k < 4; k++) {
+        if (quad[2 * k] < qx0) qx0 = quad[2 * k];
+        if (quad[2 * k] > qx1) qx1 = quad[2 * k];
+        if (quad[2 * k + 1] < qy0) qy0 = quad[2 * k + 1];
+        if (quad[2 * k + 1] > qy1) qy1 = quad[2 * k + 1];
+    }
+    const float area = 0.5f * fabsf(ocr_polygon_area2(quad, 4));
+
+    // Box overlap I bounds the polygon overlap, and I / (A + B - I) grows with I,
+    // so an entry can only pass when I * (1 + t) > t * (A + B)
+    const float k1 = 1.0f + min_iou;
+    uint32_t j = begin;
+
+#if defined(OCR_SIMD_SSE2)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 vx0 = _mm_set1_ps(qx0), vx1 = _mm_set1_ps(qx1);
+    const __m128 vy0 = _mm_set1_ps(qy0), vy1 = _mm_set1_ps(qy1);
+    const __m128 vk1 = _mm_set1_ps(k1), vt = _mm_set1_ps(min_iou), va = _mm_set1_ps(area);
+    for (; j + 4 <= end; j += 4) {
+        __m128 ix = _mm_sub_ps(_mm_min_ps(vx1, _mm_loadu_ps(set->max_x + j)),
+                               _mm_max_ps(vx0, _mm_loadu_ps(set->min_x + j)));
+        __m128 iy = _mm_sub_ps(_mm_min_ps(vy1, _mm_loadu_ps(set->max_y + j)),
+                               _mm_max_ps(vy0, _mm_loadu_ps(set->min_y + j)));
+        __m128 inter = _mm_mul_ps(_mm_max_ps(ix, zero), _mm_max_ps(iy, zero));
+        __m128 rhs = _mm_mul_ps(vt, _mm_add_ps(va, _mm_loadu_ps(set->area + j)));
+        const int mask = _mm_movemask_ps(_mm_cmpgt_ps(_mm_mul_ps(inter, vk1), rhs));
+        _mm_storeu_ps(iou + (j - begin), zero);
+        for (int lane = 0; mask != 0 && lane < 4; lane++) {
+            if (mask & (1 << lane)) {
+                iou[j - begin + lane] = ocr_quad_iou_entry(set, quad, area, j + lane);
+            }
+        }
+    }
+#elif defined(OCR_SIMD_NEON)
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t vx0 = vdupq_n_f32(qx0), vx1 = vdupq_n_f32(qx1);
+    const float32x4_t vy0 = vdupq_n_f32(qy0), vy1 = vdupq_n_f32(qy1);
+    const float32x4_t vk1 = vdupq_n_f32(k1), vt = vdupq_n_f32(min_iou), va = vdupq_n_f32(area);
+    for (; j + 4 <= end; j += 4) {
+        float32x4_t ix = vsubq_f32(vminq_f32(vx1, vld1q_f32(set->max_x + j)),
+                                   vmaxq_f32(vx0, vld1q_f32(set->min_x + j)));
+        float32x4_t iy = vsubq_f32(vminq_f32(vy1, vld1q_f32(set->max_y + j)),
+                                   vmaxq_f32(vy0, vld1q_f32(set->min_y + j)));
+        float32x4_t inter = vmulq_f32(vmaxq_f32(ix, zero), vmaxq_f32(iy, zero));
+        float32x4_t rhs = vmulq_f32(vt, vaddq_f32(va, vld1q_f32(set->area + j)));
+        uint32x4_t pass = vcgtq_f32(vmulq_f32(inter, vk1), rhs);
+        const uint32_t mask = (vgetq_lane_u32(pass, 0) & 1u) | (vgetq_lane_u32(pass, 1) & 2u) |
+                              (vgetq_lane_u32(pass, 2) & 4u) | (vgetq_lane_u32(pass, 3) & 8u);
+        vst1q_f32(iou + (j - begin), zero);
+        for (int lane = 0; mask != 0 && lane < 4; lane++) {
+            if (mask & (1u << lane)) {
+                iou[j - begin + lane] = ocr_quad_iou_entry(set, quad, area, j + lane);
+            }
+        }
+    }
+#elif defined(OCR_SIMD_MVE_FLOAT)
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t vx0 = vdupq_n_f32(qx0), vx1 = vdupq_n_f32(qx1);
+    const float32x4_t vy0 = vdupq_n_f32(qy0), vy1 = vdupq_n_f32(qy1);
+    const float32x4_t vk1 = vdupq_n_f32(k1), vt = vdupq_n_f32(min_iou), va = vdupq_n_f32(area);
+    for (; j + 4 <= end; j += 4) {
+        float32x4_t ix = vsubq_f32(vminnmq_f32(vx1, vldrwq_f32(set->max_x + j)),
+                                   vmaxnmq_f32(vx0, vldrwq_f32(set->min_x + j)));
+        float32x4_t iy = vsubq_f32(vminnmq_f32(vy1, vldrwq_f32(set->max_y + j)),
+                                   vmaxnmq_f32(vy0, vldrwq_f32(set->min_y + j)));
+        float32x4_t inter = vmulq_f32(vmaxnmq_f32(ix, zero), vmaxnmq_f32(iy, zero));
+        float32x4_t rhs = vmulq_f32(vt, vaddq_f32(va, vldrwq_f32(set->area + j)));
+        // Predicate has 4 bits per 32-bit lane
+        const mve_pred16_t mask = vcmpgtq_f32(vmulq_f32(inter, vk1), rhs);
+        vstrwq_f32(iou + (j - begin), zero);
+        for (int lane = 0; mask != 0 && lane < 4; lane++) {
+            if (mask & (1u << (4 * lane))) {
+                iou[j - begin + lane] = ocr_quad_iou_entry(set, quad, area, j + lane);
+            }
+        }
+    }
+#endif
+
+    for (; j < end; j++) {
+        const float ix = fminf(qx1, set->max_x[j]) - fmaxf(qx0, set->min_x[j]);
+        const float iy = fminf(qy1, set->max_y[j]) - fmaxf(qy0, set->min_y[j]);
+        const float inter = fmaxf(ix, 0.0f) * fmaxf(iy, 0.0f);
+        iou[j - begin] = (inter * k1 > min_iou * (area + set->area[j])) ?
+                         ocr_quad_iou_entry(set, quad, area, j) : 0.0f;
+    }
+}
+
+// Entry a sorts after b: lower score, ties by index so the order is deterministic
+static inline int ocr_nms_after(const float *score, uint32_t a, uint32_t b)
+{
+    return score[a] < score[b] || (score[a] == score[b] && a > b);
+}
+
+static void ocr_nms_sift(uint32_t *order, const float *score, uint32_t root, uint32_t n)
+{
+    for (;;) {
+        uint32_t child = 2 * root + 1;
+        if (child >= n) {
+            break;
+        }
+        if (child + 1 < n && ocr_nms_after(score, order[child + 1], order[child])) {
+            child++;
+        }
+        if (!ocr_nms_after(score, order[child], order[root])) {
+            break;
+        }
+        uint32_t t = order[root];
+        order[root] = order[child];
+        order[child] = t;
+        root = child;
+    }
+}
+
+uint32_t ocr_quad_nms(ocr_quad_set_t *set, float iou_thresh)
+{
+    uint32_t *order = set->order;
+    const float *score = set->score;
+    uint32_t n = 0;
+    uint32_t kept = 0;
+
+    for (uint32_t i = 0; i < set->count; i++) {
+        if (score[i] > 0.0f) {
+            order[n++] = i;
+        }
+    }
+
+    // Heap sort with the lowest score at the root leaves the order descending
+    for (uint32_t i = n / 2; i-- > 0;) {
+        ocr_nms_sift(order, score, i, n);
+    }
+    for (uint32_t end = n; end > 1; end--) {
+        uint32_t t = order[0];
+        order[0] = order[end - 1];
+        order[end - 1] = t;
+        ocr_nms_sift(order, score, 0, end - 1);
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        const uint32_t idx = order[i];
+        if (score[idx] <= 0.0f) {
+            continue;   // Suppressed
+        }
+        order[kept++] = idx;
+
+        // Removed entries drop out of the box bound, so later queries get cheaper
+        ocr_quad_iou_batch(set, set->quad + 8u * idx, 0, set->count, iou_thresh, set->iou);
+        for (uint32_t j = 0; j < set->count; j++) {
+            if (j != idx && set->iou[j] > iou_thresh) {
+                ocr_quad_set_remove(set, j);
+            }
+        }
+    }
+
+    return kept;
+}
+
+// ========================================================================
+// EAST
+// ========================================================================
+
+// Score-weighted polygon of consecutive text pixels in one row
+typedef struct {
+    float sum[8];
+    float weight;
+    float support;
+} ocr_east_run_t;
+
+uint32_t ocr_east_size(uint32_t max_candidates)
+{
+    return 2u * 256u * sizeof(float) + ocr_quad_set_size(max_candidates);
+}
+
+int ocr_east_init(ocr_east_t *east, uint16_t width, uint16_t height, uint8_t map_scale,
+                  uint32_t max_candidates, const ocr_east_quant_t *quant,
+                  void *storage, uint32_t storage_size)
+{
+    if (!east || !quant || !storage || width == 0 || height == 0 || map_scale == 0 ||
+        quant->score_scale <= 0.0f || quant->geo_scale <= 0.0f ||
+        storage_size < ocr_east_size(max_candidates)) {
+        return -1;
+    }
+
+    memset(east, 0, sizeof(*east));
+    east->width = width;
+    east->height = height;
+    east->map_scale = map_scale;
+    east->quant = *quant;
+    east->score_thresh_q = ocr_prob_to_q(OCR_EAST_SCORE_THRESH, quant->score_scale, quant->score_zero_point);
+    east->merge_iou = OCR_EAST_MERGE_IOU;
+    east->nms_iou = OCR_EAST_NMS_IOU;
+
+    // The angle channel has 256 possible values: no trigonometry per pixel
+    east->cos_lut = (float*)storage;
+    east->sin_lut = east->cos_lut + 256;
+    for (int32_t q = -128; q < 128; q++) {
+        const float angle = (float)(q - quant->angle_zero_point) * quant->angle_scale;
+        east->cos_lut[q + 128] = cosf(angle);
+        east->sin_lut[q + 128] = sinf(angle);
+    }
+
+    return ocr_quad_set_init(&east->set, max_candidates, east->sin_lut + 256,
+                             storage_size - 2u * 256u * sizeof(float));
+}
+
+/**
+ * @brief Rectangle predicted by one pixel: distances to its edges along u = (cos, sin)
+ *        (reading direction) and v = (-sin, cos) (down the text)
+ */
+static void ocr_east_pixel_quad(const ocr_east_t *east, uint32_t x, uint32_t y, const int8_t *g, float quad[8])
+{
+    const float scale = east->quant.geo_scale;
+    const int32_t zp = east->quant.geo_zero_point;
+    const float top = (float)(g[0] - zp) * scale;
+    const float right = (float)(g[1] - zp) * scale;
+    const float bottom = (float)(g[2] - zp) * scale;
+    const float left = (float)(g[3] - zp) * scale;
+    const float c = east->cos_lut[g[4] + 128];
+    const float s = east->sin_lut[g[4] + 128];
+    const float px = ((float)x + 0.5f) * east->map_scale;
+    const float py = ((float)y + 0.5f) * east->map_scale;
+
+    quad[0] = px - left * c + top * s;          // TL = p - left u - top v
+    quad[1] = py - left * s - top * c;
+    quad[2] = px + right * c + top * s;         // TR = p + right u - top v
+    quad[3] = py + right * s - top * c;
+    quad[4] = px + right * c - bottom * s;      // BR = p + right u + bottom v
+    quad[5] = py + right * s + bottom * c;
+    quad[6] = px - left * c - bottom * s;       // BL = p - left u + bottom v
+    quad[7] = py - left * s + bottom * c;
+}
+
+/**
+ * @brief Merge a finished row run into the candidates of this or the previous row
+ */
+static void ocr_east_flush(ocr_east_t *east, const ocr_east_run_t *run, uint32_t prev_begin, uint32_t row_begin)
+{
+    ocr_quad_set_t *set = &east->set;
+    const float inv = 1.0f / run->weight;
+    float quad[8];
+    int32_t best = -1;
+    float best_iou = east->merge_iou;
+
+    for (int k = 0; k < 8; k++) {
+        quad[k] = run->sum[k] * inv;
+    }
+
+    if (set->count > prev_begin) {
+        ocr_quad_iou_batch(set, quad, prev_begin, set->count, east->merge_iou, set->iou);
+        for (uint32_t j = prev_begin; j < set->count; j++) {
+            if (set->iou[j - prev_begin] > best_iou) {
+                best_iou = set->iou[j - prev_begin];
+                best = (int32_t)j;
+            }
+        }
+    }
+
+    if (best < 0) {
+        if (ocr_quad_set_push(set, quad, run->weight, run->support) < 0) {
+            east->dropped_candidates++;
+        }
+        return;
+    }
+
+    // Score-weighted average of the matched polygon and the run
+    const float w = set->score[best] + run->weight;
+    const float *q = set->quad + 8u * (uint32_t)best;
+    float merged[8];
+    for (int k = 0; k < 8; k++) {
+        merged[k] = (q[k] * set->score[best] + run->sum[k]) / w;
+    }
+    const float support = set->support[best] + run->support;
+
+    if ((uint32_t)best >= row_begin || set->count == set->capacity) {
+        ocr_quad_set_store(set, (uint32_t)best, merged, w, support);
+    } else {
+        // Continued from the previous row: move into this row's range
+        ocr_quad_set_push(set, merged, w, support);
+        ocr_quad_set_remove(set, (uint32_t)best);
+    }
+}
+
+/**
+ * @brief Round corners, order them along the reading direction and clamp bounds
+ */
+static void ocr_east_emit(const ocr_east_t *east, uint32_t idx, ocr_det_box_t *box)
+{
+    const ocr_quad_set_t *set = &east->set;
+    const float *q = set->quad + 8u * idx;
+    const float limit_x = (float)east->width * east->map_scale;
+    const float limit_y = (float)east->height * east->map_scale;
+    float min_x = q[0], max_x = q[0], min_y = q[1], max_y = q[1];
+
+    // EAST angles stay within +-45 deg, so vertical text is a tall box: read down its long side
+    const float w2 = (q[2] - q[0]) * (q[2] - q[0]) + (q[3] - q[1]) * (q[3] - q[1]);
+    const float h2 = (q[4] - q[2]) * (q[4] - q[2]) + (q[5] - q[3]) * (q[5] - q[3]);
+    const int rot = (h2 > w2) ? 1 : 0;
+    box->direction = (uint8_t)rot;
+
+    for (int i = 0; i < 4; i++) {
+        const int src = (i + rot) & 3;
+        const float x = q[2 * src], y = q[2 * src + 1];
+        box->quad_x[i] = (int16_t)lrintf(x);
+        box->quad_y[i] = (int16_t)lrintf(y);
+        if (x < min_x) min_x = x;
+        if (x > max_x) max_x = x;
+        if (y < min_y) min_y = y;
+        if (y > max_y) max_y = y;
+    }
+
+    min_x = min_x < 0.0f ? 0.0f : min_x;
+    min_y = min_y < 0.0f ? 0.0f : min_y;
+    max_x = max_x > limit_x ? limit_x : max_x;
+    max_y = max_y > limit_y ? limit_y : max_y;
+    box->x = (uint16_t)lrintf(min_x);
+    box->y = (uint16_t)lrintf(min_y);
+    box->width = (uint16_t)(max_x > min_x ? lrintf(max_x) - box->x : 0);
+    box->height = (uint16_t)(max_y > min_y ? lrintf(max_y) - box->y : 0);
+
+    const float mean = set->score[idx] / set->support[idx];
+    const int32_t score = (int32_t)lrintf(mean * 255.0f);
+    box->score = (uint8_t)(score < 0 ? 0 : (score > 255 ? 255 : score));
+}
+
+uint32_t ocr_east_decode(ocr_east_t *east, const int8_t *score, uint32_t score_pixel_stride,
+                         const int8_t *geometry, uint32_t geo_pixel_stride,
+                         ocr_det_boxes_t *boxes)
+{
+    ocr_quad_set_t *set = &east->set;
+    const int8_t thresh = east->score_thresh_q;
+    const float score_scale = east->quant.score_scale;
+    const int32_t score_zp = east->quant.score_zero_point;
+    uint32_t prev_begin = 0;
+
+    set->count = 0;
+    east->raw_candidates = 0;
+    east->merged_candidates = 0;
+    east->dropped_candidates = 0;
+    east->overflow = 0;
+
+    for (uint32_t y = 0; y < east->height; y++) {
+        const uint32_t row_begin = set->count;
+        ocr_east_run_t run;
+        run.weight = 0.0f;
+        run.support = 0.0f;
+
+        for (uint32_t x = 0; x < east->width; x++) {
+            const uint32_t i = y * east->width + x;
+            const int8_t q = score[i * score_pixel_stride];
+            if (q <= thresh) {
+                continue;
+            }
+
+            const float prob = (float)(q - score_zp) * score_scale;
+            float quad[8];
+            east->raw_candidates++;
+            ocr_east_pixel_quad(east, x, y, geometry + i * geo_pixel_stride, quad);
+
+            if (run.weight > 0.0f) {
+                const float inv = 1.0f / run.weight;
+                float current[8];
+                for (int k = 0; k < 8; k++) {
+                    current[k] = run.sum[k] * inv;
+                }
+                if (ocr_quad_iou(current, quad) > east->merge_iou) {
+                    for (int k = 0; k < 8; k++) {
+                        run.sum[k] += quad[k] * prob;
+                    }
+                    run.weight += prob;
+                    run.support += 1.0f;
+                    continue;
+                }
+                ocr_east_flush(east, &run, prev_begin, row_begin);
+            }
+
+            for (int k = 0; k < 8; k++) {
+                run.sum[k] = quad[k] * prob;
+            }
+            run.weight = prob;
+            run.support = 1.0f;
+        }
+
+        if (run.weight > 0.0f) {
+            ocr_east_flush(east, &run, prev_begin, row_begin);
+        }
+        // A row without text breaks locality: the next row only sees its own range
+        prev_begin = row_begin;
+    }
+
+    for (uint32_t i = 0; i < set->count; i++) {
+        if (set->score[i] > 0.0f) {
+            east->merged_candidates++;
+        }
+    }
+
+    const uint32_t kept = ocr_quad_nms(set, east->nms_iou);
+    const uint32_t count = kept < boxes->capacity ? kept : boxes->capacity;
+    east->overflow = kept - count;
+    for (uint32_t i = 0; i < count; i++) {
+        ocr_det_box_t box;
+        ocr_east_emit(east, set->order[i], &box);
+        ocr_det_boxes_put(boxes, i, &box);
+    }
+    boxes->count = count;
+
+    return count;
+}
+
+// ========================================================================
+// Coarse-pass regions
+// ========================================================================
+
+uint32_t ocr_det_roi_size(uint16_t map_width, uint16_t map_height, uint16_t cell_size)
+{
+    if (cell_size == 0) {
+        return 0;
+    }
+    const uint32_t cells = (uint32_t)((map_width + cell_size - 1) / cell_size) *
+                           ((map_height + cell_size - 1) / cell_size);
+    return ocr_align4(cells * sizeof(uint16_t)) + ocr_align4(cells);
+}
+
+int ocr_det_roi_init(ocr_det_roi_t *roi, uint16_t map_width, uint16_t map_height, uint16_t cell_size,
+                     float threshold, uint16_t min_pixels, float prob_scale, int32_t prob_zero_point,
+                     void *storage, uint32_t storage_size)
+{
+    if (!roi || !storage || map_width == 0 || map_height == 0 || cell_size == 0 ||
+        prob_scale <= 0.0f || storage_size < ocr_det_roi_size(map_width, map_height, cell_size)) {
+        return -1;
+    }
+
+    memset(roi, 0, sizeof(*roi));
+    roi->map_width = map_width;
+    roi->map_height = map_height;
+    roi->cell_size = cell_size;
+    roi->cols = (uint16_t)((map_width + cell_size - 1) / cell_size);
+    roi->rows = (uint16_t)((map_height + cell_size - 1) / cell_size);
+    roi->min_pixels = min_pixels ? min_pixels : 1;
+    roi->threshold_q = ocr_prob_to_q(threshold, prob_scale, prob_zero_point);
+    roi->counts = (uint16_t*)storage;
+    roi->cells = (uint8_t*)storage + ocr_align4((uint32_t)roi->cols * roi->rows * sizeof(uint16_t));
+
+    return 0;
+}
+
+uint32_t ocr_det_roi_find(ocr_det_roi_t *roi, const int8_t *map, uint32_t map_stride)
+{
+    const uint32_t cols = roi->cols;
+    const uint32_t rows = roi->rows;
+    const uint32_t cell = roi->cell_size;
+    const int8_t thresh = roi->threshold_q;
+    uint32_t cx0 = cols, cy0 = rows, cx1 = 0, cy1 = 0;
+
+    memset(roi->counts, 0, cols * rows * sizeof(uint16_t));
+    memset(roi->cells, 0, cols * rows);
+    roi->text_cells = 0;
+    roi->active_cells = 0;
+
+    // Text pixels per cell, one cell-wide run at a time
+    for (uint32_t y = 0; y < roi->map_height; y++) {
+        const int8_t *row = map + y * map_stride;
+        uint16_t *count = roi->counts + (y / cell) * cols;
+        for (uint32_t c = 0, x = 0; c < cols; c++) {
+            const uint32_t end = (x + cell < roi->map_width) ? x + cell : roi->map_width;
+            uint32_t n = 0;
+            for (; x < end; x++) {
+                n += (row[x] > thresh);
+            }
+            count[c] = (uint16_t)(count[c] + n);
+        }
+    }
+
+    // Grow qualifying cells by one cell in every direction
+    for (uint32_t cy = 0; cy < rows; cy++) {
+        for (uint32_t cx = 0; cx < cols; cx++) {
+            if (roi->counts[cy * cols + cx] < roi->min_pixels) {
+                continue;
+            }
+            roi->text_cells++;
+            const uint32_t gx0 = cx ? cx - 1 : 0, gx1 = (cx + 1 < cols) ? cx + 1 : cx;
+            const uint32_t gy0 = cy ? cy - 1 : 0, gy1 = (cy + 1 < rows) ? cy + 1 : cy;
+            for (uint32_t gy = gy0; gy <= gy1; gy++) {
+                memset(roi->cells + gy * cols + gx0, 1, gx1 - gx0 + 1);
+            }
+            cx0 = (gx0 < cx0) ? gx0 : cx0;
+            cy0 = (gy0 < cy0) ? gy0 : cy0;
+            cx1 = (gx1 + 1 > cx1) ? gx1 + 1 : cx1;
+            cy1 = (gy1 + 1 > cy1) ? gy1 + 1 : cy1;
+        }
+    }
+
+    for (uint32_t i = 0; i < cols * rows; i++) {
+        roi->active_cells += roi->cells[i];
+    }
+    if (roi->active_cells == 0) {
+        roi->x0 = roi->y0 = roi->x1 = roi->y1 = 0;
+        return 0;
+    }
+    roi->x0 = (uint16_t)(cx0 * cell);
+    roi->y0 = (uint16_t)(cy0 * cell);
+    roi->x1 = (uint16_t)((cx1 * cell < roi->map_width) ? cx1 * cell : roi->map_width);
+    roi->y1 = (uint16_t)((cy1 * cell < roi->map_height) ? cy1 * cell : roi->map_height);
+
+    return roi->active_cells;
+}
+
+uint32_t ocr_det_roi_mask(const ocr_det_roi_t *roi, int8_t *map, uint32_t map_stride,
+                          uint16_t map_width, uint16_t map_height, int8_t fill)
+{
+    const uint32_t cols = roi->cols;
+    const uint32_t cell = roi->cell_size;
+    uint32_t cleared = 0;
+
+    // Cell edges scaled to the target map; rounding down keeps the tiling gap-free
+    for (uint32_t cy = 0; cy < roi->rows; cy++) {
+        const uint32_t y0 = (uint32_t)(cy * cell) * map_height / roi->map_height;
+        uint32_t y1 = (uint32_t)((cy + 1) * cell) * map_height / roi->map_height;
+        y1 = (y1 < map_height) ? y1 : map_height;
+        const uint8_t *active = roi->cells + cy * cols;
+
+        for (uint32_t cx = 0; cx < cols; cx++) {
+            if (active[cx]) {
+                continue;
+            }
+            // Merge a run of inactive cells into one span per row
+            uint32_t run = cx;
+            while (run + 1 < cols && !active[run + 1]) {
+                run++;
+            }
+            const uint32_t x0 = (uint32_t)(cx * cell) * map_width / roi->map_width;
+            uint32_t x1 = (uint32_t)((run + 1) * cell) * map_width / roi->map_width;
+            x1 = (x1 < map_width) ? x1 : map_width;
+            if (x1 > x0) {
+                for (uint32_t y = y0; y < y1; y++) {
+                    memset(map + y * map_stride + x0, fill, x1 - x0);
+                }
+                cleared += (x1 - x0) * (y1 > y0 ? y1 - y0 : 0);
+            }
+            cx = run;
+        }
+    }
+
+    return cleared;
+}
+
+// ========================================================================
+// Tiled Detection
+// ========================================================================
+
+// Tiles along one axis: fewest that keep the overlap
+static uint16_t ocr_det_tiles_along(uint16_t frame, uint16_t tile, uint16_t overlap)
+{
+    const uint32_t step = tile - overlap;
+    return (tile >= frame) ? 1 : (uint16_t)(1 + (frame - tile + step - 1) / step);
+}
+
+// Tile origin along one axis, spread evenly between the frame edges
+static uint16_t ocr_det_tile_origin(uint16_t frame, uint16_t tile, uint16_t n, uint32_t i)
+{
+    return (n > 1) ? (uint16_t)((i * (uint32_t)(frame - tile) + (n - 1) / 2) / (n - 1)) : 0;
+}
+
+// Overlap left by the widest step between neighbouring tiles
+static uint16_t ocr_det_tile_overlap(uint16_t frame, uint16_t tile, uint16_t n)
+{
+    return (n > 1) ? (uint16_t)(tile - (frame - tile + n - 2) / (n - 1)) : 0;
+}
+
+int ocr_det_tiling_init(ocr_det_tiling_t *tiling, uint16_t frame_width, uint16_t frame_height,
+                        uint16_t tile_width, uint16_t tile_height, uint16_t overlap)
+{
+    if (!tiling || tile_width == 0 || tile_height == 0 || tile_width > frame_width ||
+        tile_height > frame_height || overlap >= tile_width || overlap >= tile_height) {
+        return -1;
+    }
+
+    const uint16_t cols = ocr_det_tiles_along(frame_width, tile_width, overlap);
+    const uint16_t rows = ocr_det_tiles_along(frame_height, tile_height, overlap);
+    if ((uint32_t)cols * rows > (0xFFFFu >> OCR_DET_TAG_TILE_SHIFT)) {
+        return -1;
+    }
+
+    tiling->frame_width = frame_width;
+    tiling->frame_height = frame_height;
+    tiling->tile_width = tile_width;
+    tiling->tile_height = tile_height;
+    tiling->cols = cols;
+    tiling->rows = rows;
+    tiling->count = (uint16_t)(cols * rows);
+    tiling->overlap_x = ocr_det_tile_overlap(frame_width, tile_width, cols);
+    tiling->overlap_y = ocr_det_tile_overlap(frame_height, tile_height, rows);
+    tiling->seam_margin = OCR_DET_SEAM_MARGIN;
+    tiling->seam_overlap_q8 = (uint16_t)(OCR_DET_SEAM_OVERLAP * 256.0f + 0.5f);
+    return 0;
+}
+
+void ocr_det_tiling_origin(const ocr_det_tiling_t *tiling, uint32_t tile, uint16_t *x, uint16_t *y)
+{
+    *x = ocr_det_tile_origin(tiling->frame_width, tiling->tile_width, tiling->cols, tile % tiling->cols);
+    *y = ocr_det_tile_origin(tiling->frame_height, tiling->tile_height, tiling->rows, tile / tiling->cols);
+}
+
+void ocr_det_boxes_tail(const ocr_det_boxes_t *boxes, ocr_det_boxes_t *tail)
+{
+    const uint32_t n = boxes->count;
+
+    tail->x = boxes->x + n;
+    tail->y = boxes->y + n;
+    tail->width = boxes->width + n;
+    tail->height = boxes->height + n;
+    tail->score = boxes->score + n;
+    tail->direction = boxes->direction + n;
+    tail->quad_x = boxes->quad_x + 4 * n;
+    tail->quad_y = boxes->quad_y + 4 * n;
+    tail->count = 0;
+    tail->capacity = boxes->capacity - n;
+}
+
+uint32_t ocr_det_tiling_place(const ocr_det_tiling_t *tiling, uint32_t tile, ocr_det_boxes_t *boxes,
+                              uint32_t first, uint16_t *tags)
+{
+    const uint32_t margin = tiling->seam_margin;
+    uint16_t ox, oy;
+    uint32_t cut = 0;
+
+    ocr_det_tiling_origin(tiling, tile, &ox, &oy);
+
+    // Inner tile edges only: the frame border does not cut anything
+    const uint8_t seam_left = ox > 0;
+    const uint8_t seam_top = oy > 0;
+    const uint8_t seam_right = ox + tiling->tile_width < tiling->frame_width;
+    const uint8_t seam_bottom = oy + tiling->tile_height < tiling->frame_height;
+
+    for (uint32_t i = first; i < boxes->count; i++) {
+        uint16_t seams = 0;
+        if (seam_left && boxes->x[i] <= margin) {
+            seams |= OCR_DET_SEAM_LEFT;
+        }
+        if (seam_right && boxes->x[i] + boxes->width[i] + margin >= tiling->tile_width) {
+            seams |= OCR_DET_SEAM_RIGHT;
+        }
+        if (seam_top && boxes->y[i] <= margin) {
+            seams |= OCR_DET_SEAM_TOP;
+        }
+        if (seam_bottom && boxes->y[i] + boxes->height[i] + margin >= tiling->tile_height) {
+            seams |= OCR_DET_SEAM_BOTTOM;
+        }
+        tags[i] = (uint16_t)((tile << OCR_DET_TAG_TILE_SHIFT) | seams);
+        cut += (seams != 0);
+
+        boxes->x[i] = (uint16_t)(boxes->x[i] + ox);
+        boxes->y[i] = (uint16_t)(boxes->y[i] + oy);
+        for (int k = 0; k < 4; k++) {
+            boxes->quad_x[4 * i + k] = (int16_t)(boxes->quad_x[4 * i + k] + ox);
+            boxes->quad_y[4 * i + k] = (int16_t)(boxes->quad_y[4 * i + k] + oy);
+        }
+    }
+
+    return cut;
+}
+
+// Seam pair decision
+enum {
+    OCR_SEAM_KEEP_BOTH = 0,
+    OCR_SEAM_UNION,
+    OCR_SEAM_KEEP_I,                // j is a cut copy of complete box i
+    OCR_SEAM_KEEP_J
+};
+
+static int ocr_det_seam_pair(const ocr_det_tiling_t *tiling, const ocr_det_boxes_t *b,
+                             const uint16_t *tags, uint32_t i, uint32_t j)
+{
+    const int32_t ax0 = b->x[i], ay0 = b->y[i], ax1 = ax0 + b->width[i], ay1 = ay0 + b->height[i];
+    const int32_t bx0 = b->x[j], by0 = b->y[j], bx1 = bx0 + b->width[j], by1 = by0 + b->height[j];
+    const int32_t ix = (ax1 < bx1 ? ax1 : bx1) - (ax0 > bx0 ? ax0 : bx0);
+    const int32_t iy = (ay1 < by1 ? ay1 : by1) - (ay0 > by0 ? ay0 : by0);
+    const uint32_t si = tags[i] & OCR_DET_SEAM_MASK;
+    const uint32_t sj = tags[j] & OCR_DET_SEAM_MASK;
+    const int32_t margin = tiling->seam_margin;
+
+    // Same text seen by both tiles
+    if (ix > 0 && iy > 0) {
+        const uint32_t area_i = (uint32_t)b->width[i] * b->height[i];
+        const uint32_t area_j = (uint32_t)b->width[j] * b->height[j];
+        const uint32_t smaller = area_i < area_j ? area_i : area_j;
+        if ((uint64_t)ix * iy * 256u >= (uint64_t)tiling->seam_overlap_q8 * smaller) {
+            if (si && !sj) return OCR_SEAM_KEEP_J;
+            if (sj && !si) return OCR_SEAM_KEEP_I;
+            return OCR_SEAM_UNION;
+        }
+    }
+
+    // Pieces of one line cut on facing sides, overlapping across the seam
+    const int32_t min_h = b->height[i] < b->height[j] ? b->height[i] : b->height[j];
+    const int32_t min_w = b->width[i] < b->width[j] ? b->width[i] : b->width[j];
+    if ((((si & OCR_DET_SEAM_RIGHT) && (sj & OCR_DET_SEAM_LEFT) && ax0 < bx0) ||
+         ((si & OCR_DET_SEAM_LEFT) && (sj & OCR_DET_SEAM_RIGHT) && bx0 < ax0)) &&
+        ix >= -margin && 2 * iy >= min_h) {
+        return OCR_SEAM_UNION;
+    }
+    if ((((si & OCR_DET_SEAM_BOTTOM) && (sj & OCR_DET_SEAM_TOP) && ay0 < by0) ||
+         ((si & OCR_DET_SEAM_TOP) && (sj & OCR_DET_SEAM_BOTTOM) && by0 < ay0)) &&
+        iy >= -margin && 2 * ix >= min_w) {
+        return OCR_SEAM_UNION;
+    }
+
+    return OCR_SEAM_KEEP_BOTH;
+}
+
+// Seam flag of the union on one side: from the box that reaches further out
+static uint16_t ocr_det_seam_side(int32_t a, int32_t b, uint32_t sa, uint32_t sb, uint32_t flag)
+{
+    return (uint16_t)((a < b) ? (sa & flag) : (b < a) ? (sb & flag) : ((sa | sb) & flag));
+}
+
+// Box i becomes the axis-aligned union of boxes i and j
+static void ocr_det_seam_union(ocr_det_boxes_t *b, uint16_t *tags, uint32_t i, uint32_t j)
+{
+    const int32_t ax0 = b->x[i], ay0 = b->y[i], ax1 = ax0 + b->width[i], ay1 = ay0 + b->height[i];
+    const int32_t bx0 = b->x[j], by0 = b->y[j], bx1 = bx0 + b->width[j], by1 = by0 + b->height[j];
+    const uint32_t si = tags[i] & OCR_DET_SEAM_MASK;
+    const uint32_t sj = tags[j] & OCR_DET_SEAM_MASK;
+    const int32_t x0 = ax0 < bx0 ? ax0 : bx0;
+    const int32_t y0 = ay0 < by0 ? ay0 : by0;
+    const int32_t x1 = ax1 > bx1 ? ax1 : bx1;
+    const int32_t y1 = ay1 > by1 ? ay1 : by1;
+
+    const uint16_t seams = ocr_det_seam_side(ax0, bx0, si, sj, OCR_DET_SEAM_LEFT) |
+                           ocr_det_seam_side(-ax1, -bx1, si, sj, OCR_DET_SEAM_RIGHT) |
+                           ocr_det_seam_side(ay0, by0, si, sj, OCR_DET_SEAM_TOP) |
+                           ocr_det_seam_side(-ay1, -by1, si, sj, OCR_DET_SEAM_BOTTOM);
+    tags[i] = (uint16_t)((tags[i] & ~OCR_DET_SEAM_MASK) | seams);
+
+    b->x[i] = (uint16_t)x0;
+    b->y[i] = (uint16_t)y0;
+    b->width[i] = (uint16_t)(x1 - x0);
+    b->height[i] = (uint16_t)(y1 - y0);
+    if (b->score[j] > b->score[i]) {
+        b->score[i] = b->score[j];
+    }
+    if (b->direction[i] != b->direction[j]) {
+        b->direction[i] = (y1 - y0 > x1 - x0) ? 1 : 0;
+    }
+
+    // Corners TL, TR, BR, BL; a vertical box starts at the top-right
+    const int16_t cx[4] = {(int16_t)x0, (int16_t)x1, (int16_t)x1, (int16_t)x0};
+    const int16_t cy[4] = {(int16_t)y0, (int16_t)y0, (int16_t)y1, (int16_t)y1};
+    const int shift = b->direction[i] ? 1 : 0;
+    for (int k = 0; k < 4; k++) {
+        b->quad_x[4 * i + k] = cx[(k + shift) & 3];
+        b->quad_y[4 * i + k] = cy[(k + shift) & 3];
+    }
+}
+
+static void ocr_det_boxes_move(ocr_det_boxes_t *boxes, uint16_t *tags, uint32_t dst, uint32_t src)
+{
+    ocr_det_box_t box;
+    ocr_det_boxes_get(boxes, src, &box);
+    ocr_det_boxes_put(boxes, dst, &box);
+    tags[dst] = tags[src];
+}
+
+uint32_t ocr_det_tiling_merge(const ocr_det_tiling_t *tiling, ocr_det_boxes_t *boxes, uint16_t *tags)
+{
+    uint32_t merged = 0;
+
+    for (uint32_t i = 0; i < boxes->count; i++) {
+        uint32_t j = i + 1;
+        while (j < boxes->count) {
+            // Boxes of one tile are distinct components
+            if ((tags[i] >> OCR_DET_TAG_TILE_SHIFT) == (tags[j] >> OCR_DET_TAG_TILE_SHIFT)) {
+                j++;
+                continue;
+            }
+
+            const int action = ocr_det_seam_pair(tiling, boxes, tags, i, j);
+            if (action == OCR_SEAM_KEEP_BOTH) {
+                j++;
+                continue;
+            }
+            if (action == OCR_SEAM_UNION) {
+                ocr_det_seam_union(boxes, tags, i, j);
+            } else if (action == OCR_SEAM_KEEP_J) {
+                ocr_det_boxes_move(boxes, tags, i, j);
+            }
+
+            // Drop j (last box takes its slot); box i changed, so rescan its pairs
+            boxes->count--;
+            if (j != boxes->count) {
+                ocr_det_boxes_move(boxes, tags, j, boxes->count);
+            }
+            merged++;
+            j = i + 1;
+        }
+    }
+
+    return merged;
+}
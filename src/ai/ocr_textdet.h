@@ -0,0 +1,509 @@
+/**
+ * @file ocr_textdet.h
+ * @brief Text detection postprocessing on quantized model outputs
+ * @details DBNet probability-map decoding: threshold, union-find connected
+ *          components, min-area rectangles and unclip expansion, all on the
+ *          int8 map. EAST score/geometry decoding with locality-aware NMS on
+ *          a batched rotated-IoU kernel. Coarse-pass region gating for
+ *          multi-scale detection. Tile planning and seam merging for
+ *          full-resolution tiled detection. Platform independent (no HAL dependency)
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#ifndef OCR_TEXTDET_H
+#define OCR_TEXTDET_H
+
+#include <stdint.h>
+
+// DBNet defaults (probability domain, converted to int8 once at init)
+#define OCR_DBNET_THRESH          0.3f  // Text pixel threshold
+#define OCR_DBNET_BOX_THRESH      0.6f  // Minimum mean probability of a box
+#define OCR_DBNET_UNCLIP_RATIO    1.5f  // Offset = area * ratio / perimeter
+#define OCR_DBNET_MIN_AREA        12    // Components below this (pixels) are noise
+#define OCR_DBNET_MIN_SIZE        3     // Shorter rectangle side (map pixels) below this is dropped
+#define OCR_DBNET_MAX_LABELS      4096  // Provisional labels per frame (bounds scratch and time)
+
+// EAST defaults
+#define OCR_EAST_SCORE_THRESH     0.8f  // Text pixel threshold
+#define OCR_EAST_MERGE_IOU        0.2f  // Locality-aware merge of neighbouring pixels
+#define OCR_EAST_NMS_IOU          0.2f  // Final rotated NMS
+#define OCR_EAST_MAP_SCALE        4     // Input pixels per map pixel
+#define OCR_EAST_MAX_CANDIDATES   1024  // Merged polygons per frame
+
+// Coarse-pass region defaults
+#define OCR_DET_ROI_CELL          8     // Cell side in coarse map pixels
+#define OCR_DET_ROI_THRESH        0.3f  // Text pixel threshold on the coarse map
+#define OCR_DET_ROI_MIN_PIXELS    3     // Text pixels for a cell to hold text
+
+// Tiled detection defaults
+#define OCR_DET_TILE_OVERLAP      32    // Minimum tile overlap (input pixels): a small-print line fits inside
+#define OCR_DET_SEAM_MARGIN       2     // Box edge this close to an inner tile edge was cut by the seam
+#define OCR_DET_SEAM_OVERLAP      0.5f  // Intersection / smaller box that makes two tile boxes one
+
+// Reading direction
+#define OCR_DET_VERTICAL_RATIO    1.5f  // Long / short side that decides the direction on its own
+#define OCR_DET_DIRECTION_REACH   3     // Near-square boxes follow elongated boxes this many sizes away
+
+// Detection head of the text detection model
+typedef enum {
+    OCR_DET_HEAD_DBNET = 0,         // Probability map
+    OCR_DET_HEAD_EAST               // Score map + RBOX geometry (4 distances, angle)
+} ocr_det_head_t;
+
+// Detected text box (detection input coordinates)
+typedef struct {
+    uint16_t x, y, width, height;   // Axis-aligned bounds of the quad, clamped to the input
+    int16_t quad_x[4];              // Corners TL, TR, BR, BL along the reading direction
+    int16_t quad_y[4];
+    uint8_t score;                  // Mean probability, 0..255
+    uint8_t direction;              // 0=horizontal, 1=vertical (reading edge TL->TR mostly vertical)
+} ocr_det_box_t;
+
+// Detected text boxes of one frame (structure of arrays, one field per array)
+typedef struct {
+    uint16_t *x;                    // Axis-aligned bounds of the quad, clamped to the input
+    uint16_t *y;
+    uint16_t *width;
+    uint16_t *height;
+    uint8_t *score;                 // Mean probability, 0..255
+    uint8_t *direction;             // 0=horizontal, 1=vertical
+    int16_t *quad_x;                // 4 corners per box: TL, TR, BR, BL along the reading direction
+    int16_t *quad_y;
+    uint32_t count;
+    uint32_t capacity;
+} ocr_det_boxes_t;
+
+// Per-label statistics accumulated during labeling
+typedef struct {
+    uint32_t area;
+    int32_t sum;                    // Sum of int8 probabilities
+    uint16_t x0, y0, x1, y1;        // Inclusive bounds
+} ocr_dbnet_component_t;
+
+// DBNet postprocessor state and working buffers
+typedef struct {
+    uint16_t width;                 // Probability map size
+    uint16_t height;
+    uint8_t map_scale;              // Input pixels per map pixel
+    int8_t thresh_q;                // Text pixel: p > thresh_q
+    int8_t box_thresh_q;            // Box kept if mean >= box_thresh_q
+    int8_t zero_point;
+    uint16_t unclip_ratio_q8;       // Unclip ratio (Q8)
+    uint16_t min_area;
+    uint16_t min_size;
+    uint16_t max_labels;
+    uint32_t score_mul_q16;         // (q - zero_point) -> 0..255 score
+
+    uint16_t *labels;               // width * height provisional labels (0 = background)
+    uint16_t *parent;               // Union-find forest over labels
+    ocr_dbnet_component_t *components;
+    int16_t *row_left;              // Per-row extents of the component being traced
+    int16_t *row_right;
+    int16_t *hull_x;                // Hull candidate points / hull
+    int16_t *hull_y;
+
+    // Last decode
+    uint16_t component_count;       // Components after merging
+    uint16_t overflow;              // Boxes past the area/score filters that did not fit
+    uint32_t dropped_pixels;        // Text pixels lost to label exhaustion
+} ocr_dbnet_t;
+
+/**
+ * @brief Get storage required for the DBNet postprocessor
+ * @param width Probability map width
+ * @param height Probability map height
+ * @param max_labels Provisional label budget (<= 65535)
+ * @return Required storage in bytes
+ */
+uint32_t ocr_dbnet_size(uint16_t width, uint16_t height, uint16_t max_labels);
+
+/**
+ * @brief Initialize the DBNet postprocessor with default thresholds
+ * @param dbnet Postprocessor to initialize
+ * @param width Probability map width
+ * @param height Probability map height
+ * @param map_scale Input pixels per map pixel (1 for full-resolution maps)
+ * @param max_labels Provisional label budget
+ * @param prob_scale Map quantization scale (probability = (q - zero_point) * scale)
+ * @param prob_zero_point Map quantization zero point
+ * @param storage Storage (4-byte aligned, ocr_dbnet_size() bytes)
+ * @param storage_size Size of storage in bytes
+ * @return 0 on success, negative on error
+ * @details Thresholds are converted to the int8 domain here, decode never dequantizes
+ */
+int ocr_dbnet_init(ocr_dbnet_t *dbnet, uint16_t width, uint16_t height, uint8_t map_scale,
+                   uint16_t max_labels, float prob_scale, int32_t prob_zero_point,
+                   void *storage, uint32_t storage_size);
+
+/**
+ * @brief Decode a probability map into rotated text boxes
+ * @param dbnet Postprocessor
+ * @param map int8 probability map (width x height)
+ * @param map_stride Map row stride in elements
+ * @param boxes Output box set (filled up to its capacity)
+ * @return Number of boxes written
+ * @details Single raster pass labels and accumulates statistics; each kept
+ *          component is traced inside its bounds only. Labels beyond
+ *          max_labels are dropped (counted), so time is bounded by the map size
+ */
+uint32_t ocr_dbnet_decode(ocr_dbnet_t *dbnet, const int8_t *map, uint32_t map_stride,
+                          ocr_det_boxes_t *boxes);
+
+/**
+ * @brief Get storage required for a box set
+ * @param capacity Maximum boxes
+ * @return Required storage in bytes
+ */
+uint32_t ocr_det_boxes_size(uint32_t capacity);
+
+/**
+ * @brief Initialize an empty box set
+ * @param boxes Box set to initialize
+ * @param capacity Maximum boxes
+ * @param storage Storage (4-byte aligned, ocr_det_boxes_size() bytes)
+ * @param storage_size Size of storage in bytes
+ * @return 0 on success, negative on error
+ */
+int ocr_det_boxes_init(ocr_det_boxes_t *boxes, uint32_t capacity, void *storage, uint32_t storage_size);
+
+/**
+ * @brief Copy one box out of a box set
+ * @param boxes Box set
+ * @param index Box index (< count)
+ * @param box Output box
+ */
+void ocr_det_boxes_get(const ocr_det_boxes_t *boxes, uint32_t index, ocr_det_box_t *box);
+
+/**
+ * @brief Settle the reading direction of boxes without a clear long side
+ * @param boxes Decoded boxes (direction taken from the long side)
+ * @param ratio Long / short side ratio from which the long side decides
+ * @return Boxes whose direction changed
+ * @details A single glyph or a short word is near square. It follows the
+ *          nearest elongated box within OCR_DET_DIRECTION_REACH box sizes
+ *          (one kanji in a tategaki column), else the majority of the
+ *          elongated boxes of the frame. Corners are re-ordered to start at
+ *          the new reading start
+ */
+uint32_t ocr_det_classify_direction(ocr_det_boxes_t *boxes, float ratio);
+
+// ========================================================================
+// Rotated IoU and NMS
+// ========================================================================
+
+// Quadrilateral set (SoA so IoU against many entries vectorizes)
+typedef struct {
+    float *quad;                    // 8 floats per entry: x0, y0 .. x3, y3 (TL, TR, BR, BL)
+    float *min_x;                   // Axis-aligned bounds (empty for removed entries)
+    float *min_y;
+    float *max_x;
+    float *max_y;
+    float *area;
+    float *score;                   // Summed pixel scores: merge weight and NMS order (0 = removed)
+    float *support;                 // Pixels merged into the entry
+    float *iou;                     // Batch IoU output
+    uint32_t *order;                // NMS order, kept entries first
+    uint32_t count;
+    uint32_t capacity;
+} ocr_quad_set_t;
+
+/**
+ * @brief Get storage required for a quadrilateral set
+ * @param capacity Maximum entries
+ * @return Required storage in bytes
+ */
+uint32_t ocr_quad_set_size(uint32_t capacity);
+
+/**
+ * @brief Initialize an empty quadrilateral set
+ * @param set Set to initialize
+ * @param capacity Maximum entries
+ * @param storage Storage (4-byte aligned, ocr_quad_set_size() bytes)
+ * @param storage_size Size of storage in bytes
+ * @return 0 on success, negative on error
+ */
+int ocr_quad_set_init(ocr_quad_set_t *set, uint32_t capacity, void *storage, uint32_t storage_size);
+
+/**
+ * @brief Append a quadrilateral
+ * @param set Set
+ * @param quad Corners (convex, consistent winding)
+ * @param score Score / merge weight (> 0)
+ * @param support Pixels represented by the entry
+ * @return Index of the new entry, negative when the set is full
+ */
+int32_t ocr_quad_set_push(ocr_quad_set_t *set, const float quad[8], float score, float support);
+
+/**
+ * @brief Intersection over union of two convex quadrilaterals
+ * @param a First quad
+ * @param b Second quad
+ * @return IoU in [0, 1]
+ */
+float ocr_quad_iou(const float a[8], const float b[8]);
+
+/**
+ * @brief IoU of one quad against a range of set entries
+ * @param set Set
+ * @param quad Query quad
+ * @param begin First entry
+ * @param end One past the last entry
+ * @param min_iou Pruning threshold
+ * @param iou Output, iou[i - begin] for each entry
+ * @details Axis-aligned overlap bounds the IoU from above; that bound is
+ *          evaluated four entries at a time and only entries that can exceed
+ *          min_iou are clipped exactly. Values <= min_iou are not exact
+ *          (0 for pruned entries). Removed entries always give 0
+ */
+void ocr_quad_iou_batch(const ocr_quad_set_t *set, const float quad[8], uint32_t begin, uint32_t end,
+                        float min_iou, float *iou);
+
+/**
+ * @brief Scalar reference for ocr_quad_iou_batch (exact IoU for every entry)
+ */
+void ocr_quad_iou_batch_scalar(const ocr_quad_set_t *set, const float quad[8], uint32_t begin,
+                               uint32_t end, float *iou);
+
+/**
+ * @brief Rotated non-maximum suppression over the whole set
+ * @param set Set (suppressed entries are removed)
+ * @param iou_thresh Entries overlapping a kept entry by more than this are suppressed
+ * @return Number of kept entries, indices in set->order by descending score
+ */
+uint32_t ocr_quad_nms(ocr_quad_set_t *set, float iou_thresh);
+
+// ========================================================================
+// EAST
+// ========================================================================
+
+// Output quantization of an EAST head
+typedef struct {
+    float score_scale;
+    int32_t score_zero_point;
+    float geo_scale;                // Distance channels, input pixels
+    int32_t geo_zero_point;
+    float angle_scale;              // Angle channel, radians
+    int32_t angle_zero_point;
+} ocr_east_quant_t;
+
+// EAST postprocessor state
+typedef struct {
+    uint16_t width;                 // Score map size
+    uint16_t height;
+    uint8_t map_scale;              // Input pixels per map pixel
+    int8_t score_thresh_q;          // Text pixel: score > score_thresh_q
+    ocr_east_quant_t quant;
+    float merge_iou;
+    float nms_iou;
+    float *cos_lut;                 // Angle channel value -> cos / sin (256 entries)
+    float *sin_lut;
+    ocr_quad_set_t set;             // Merged candidates
+
+    // Last decode
+    uint32_t raw_candidates;        // Pixels above the score threshold
+    uint32_t merged_candidates;     // Polygons after locality-aware merging
+    uint32_t dropped_candidates;    // Polygons lost to a full candidate set
+    uint32_t overflow;              // Boxes kept by NMS that did not fit
+} ocr_east_t;
+
+/**
+ * @brief Get storage required for the EAST postprocessor
+ * @param max_candidates Merged polygon capacity
+ * @return Required storage in bytes
+ */
+uint32_t ocr_east_size(uint32_t max_candidates);
+
+/**
+ * @brief Initialize the EAST postprocessor with default thresholds
+ * @param east Postprocessor to initialize
+ * @param width Score map width
+ * @param height Score map height
+ * @param map_scale Input pixels per map pixel
+ * @param max_candidates Merged polygon capacity
+ * @param quant Output quantization
+ * @param storage Storage (4-byte aligned, ocr_east_size() bytes)
+ * @param storage_size Size of storage in bytes
+ * @return 0 on success, negative on error
+ */
+int ocr_east_init(ocr_east_t *east, uint16_t width, uint16_t height, uint8_t map_scale,
+                  uint32_t max_candidates, const ocr_east_quant_t *quant,
+                  void *storage, uint32_t storage_size);
+
+/**
+ * @brief Decode EAST score and RBOX geometry maps into rotated text boxes
+ * @param east Postprocessor
+ * @param score int8 score map, element (x, y) at score[(y * width + x) * score_pixel_stride]
+ * @param score_pixel_stride Elements between neighbouring score pixels (1 for a plane)
+ * @param geometry int8 geometry, 5 consecutive channels per pixel: distances to
+ *                 top, right, bottom, left edge and angle (positive = clockwise)
+ * @param geo_pixel_stride Elements between neighbouring geometry pixels (>= 5)
+ * @param boxes Output box set, highest score first (filled up to its capacity)
+ * @return Number of boxes written
+ * @details Locality-aware NMS: consecutive pixels of a row are merged into
+ *          one score-weighted polygon, which is then merged into a matching
+ *          polygon of the previous row, so a text line reaches rotated NMS
+ *          as one candidate instead of one per pixel
+ */
+uint32_t ocr_east_decode(ocr_east_t *east, const int8_t *score, uint32_t score_pixel_stride,
+                         const int8_t *geometry, uint32_t geo_pixel_stride,
+                         ocr_det_boxes_t *boxes);
+
+// ========================================================================
+// Coarse-pass regions (multi-scale detection)
+// ========================================================================
+
+// Text regions found on a low-resolution probability map, on a cell grid
+typedef struct {
+    uint16_t map_width;             // Coarse map geometry
+    uint16_t map_height;
+    uint16_t cell_size;             // Cell side in coarse map pixels
+    uint16_t cols, rows;
+    uint16_t min_pixels;            // Text pixels for a cell to qualify
+    int8_t threshold_q;             // Text pixel threshold, int8 domain
+    uint16_t *counts;               // Text pixels per cell
+    uint8_t *cells;                 // 1 = cell holds text or touches one that does
+
+    // Last search
+    uint32_t text_cells;            // Cells that qualified on their own
+    uint32_t active_cells;          // After growing by one cell
+    uint16_t x0, y0, x1, y1;        // Bounds of active cells, coarse map pixels (x1, y1 exclusive)
+} ocr_det_roi_t;
+
+/**
+ * @brief Get storage required for coarse-pass regions
+ * @param map_width Coarse map width
+ * @param map_height Coarse map height
+ * @param cell_size Cell side in coarse map pixels
+ * @return Required storage in bytes
+ */
+uint32_t ocr_det_roi_size(uint16_t map_width, uint16_t map_height, uint16_t cell_size);
+
+/**
+ * @brief Initialize coarse-pass regions
+ * @param roi Regions to initialize
+ * @param map_width Coarse map width
+ * @param map_height Coarse map height
+ * @param cell_size Cell side in coarse map pixels
+ * @param threshold Text pixel threshold (probability)
+ * @param min_pixels Text pixels for a cell to qualify
+ * @param prob_scale Map quantization scale
+ * @param prob_zero_point Map quantization zero point
+ * @param storage Storage (4-byte aligned, ocr_det_roi_size() bytes)
+ * @param storage_size Size of storage in bytes
+ * @return 0 on success, negative on error
+ */
+int ocr_det_roi_init(ocr_det_roi_t *roi, uint16_t map_width, uint16_t map_height, uint16_t cell_size,
+                     float threshold, uint16_t min_pixels, float prob_scale, int32_t prob_zero_point,
+                     void *storage, uint32_t storage_size);
+
+/**
+ * @brief Find the cells of a coarse probability map that hold text
+ * @param roi Regions
+ * @param map int8 coarse map (one element per pixel)
+ * @param map_stride Map row stride in elements
+ * @return Active cells (qualifying cells grown by one cell), 0 = no text
+ * @details Growing keeps strokes that straddle a cell edge or fall just
+ *          below the threshold at coarse resolution
+ */
+uint32_t ocr_det_roi_find(ocr_det_roi_t *roi, const int8_t *map, uint32_t map_stride);
+
+/**
+ * @brief Clear a finer map outside the active cells
+ * @param roi Regions from ocr_det_roi_find()
+ * @param map int8 map covering the same image as the coarse map
+ * @param map_stride Map row stride in elements
+ * @param map_width Map width (any multiple or fraction of the coarse width)
+ * @param map_height Map height
+ * @param fill Value written outside the regions (below any threshold)
+ * @return Pixels cleared
+ */
+uint32_t ocr_det_roi_mask(const ocr_det_roi_t *roi, int8_t *map, uint32_t map_stride,
+                          uint16_t map_width, uint16_t map_height, int8_t fill);
+
+// ========================================================================
+// Tiled Detection
+// ========================================================================
+
+// Sides of a tile box cut by an inner tile edge (low bits of a box tag)
+#define OCR_DET_SEAM_LEFT         0x1u
+#define OCR_DET_SEAM_RIGHT        0x2u
+#define OCR_DET_SEAM_TOP          0x4u
+#define OCR_DET_SEAM_BOTTOM       0x8u
+#define OCR_DET_SEAM_MASK         0xFu
+#define OCR_DET_TAG_TILE_SHIFT    4     // Tile index above the seam bits
+
+// Overlapping tiles covering a frame larger than the detection input
+typedef struct {
+    uint16_t frame_width;
+    uint16_t frame_height;
+    uint16_t tile_width;            // Detection input size
+    uint16_t tile_height;
+    uint16_t overlap_x;             // Smallest overlap of neighbouring tiles (>= requested)
+    uint16_t overlap_y;
+    uint16_t cols;
+    uint16_t rows;
+    uint16_t count;                 // cols * rows
+    uint8_t seam_margin;            // OCR_DET_SEAM_MARGIN
+    uint16_t seam_overlap_q8;       // OCR_DET_SEAM_OVERLAP (Q8)
+} ocr_det_tiling_t;
+
+/**
+ * @brief Plan the tiles of a frame
+ * @param tiling Tiling to initialize
+ * @param frame_width Frame width
+ * @param frame_height Frame height
+ * @param tile_width Tile width (<= frame width)
+ * @param tile_height Tile height (<= frame height)
+ * @param overlap Minimum overlap of neighbouring tiles (< tile width and height)
+ * @return 0 on success, negative on error
+ * @details Uses the fewest tiles that keep the overlap, spread evenly so the
+ *          first and last tile end at the frame edges (at most 4095 tiles)
+ */
+int ocr_det_tiling_init(ocr_det_tiling_t *tiling, uint16_t frame_width, uint16_t frame_height,
+                        uint16_t tile_width, uint16_t tile_height, uint16_t overlap);
+
+/**
+ * @brief Get the frame position of a tile
+ * @param tiling Tiling
+ * @param tile Tile index (< count, row-major)
+ * @param x Output: left edge in the frame
+ * @param y Output: top edge in the frame
+ */
+void ocr_det_tiling_origin(const ocr_det_tiling_t *tiling, uint32_t tile, uint16_t *x, uint16_t *y);
+
+/**
+ * @brief View of the free slots of a box set (decoders fill it like a fresh set)
+ * @param boxes Box set
+ * @param tail Output: set over slots count..capacity-1, empty
+ */
+void ocr_det_boxes_tail(const ocr_det_boxes_t *boxes, ocr_det_boxes_t *tail);
+
+/**
+ * @brief Move the boxes of one tile into frame coordinates
+ * @param tiling Tiling
+ * @param tile Tile the boxes were detected in
+ * @param boxes Frame box set; boxes first..count-1 are in tile coordinates
+ * @param first First box of the tile
+ * @param tags Per-box tag (capacity entries): tile index and OCR_DET_SEAM_* sides
+ * @return Boxes touching a seam
+ * @details Frame edges are not seams: a box there is complete
+ */
+uint32_t ocr_det_tiling_place(const ocr_det_tiling_t *tiling, uint32_t tile, ocr_det_boxes_t *boxes,
+                              uint32_t first, uint16_t *tags);
+
+/**
+ * @brief Merge the boxes of different tiles that show the same text
+ * @param tiling Tiling
+ * @param boxes Frame box set
+ * @param tags Per-box tags from ocr_det_tiling_place()
+ * @return Boxes folded into another box
+ * @details Two boxes of different tiles are one when they overlap by
+ *          seam_overlap of the smaller box: the complete one is kept over a
+ *          cut one, else both become their union. A line longer than the
+ *          overlap is cut in both tiles; pieces cut on facing sides that
+ *          overlap across the seam are joined. Joined boxes are axis-aligned
+ */
+uint32_t ocr_det_tiling_merge(const ocr_det_tiling_t *tiling, ocr_det_boxes_t *boxes, uint16_t *tags);
+
+#endif // OCR_TEXTDET_H
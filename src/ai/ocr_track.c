@@ -0,0 +1,331 @@
+/**
+ * @file ocr_track.c
+ * @brief Temporal text-box tracker with a per-track recognition cache
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#include "ocr_track.h"
+#include "ocr_common.h"
+#include <string.h>
+
+// Association rounds: mutual best pairs are fixed each round, the rest retried
+#define OCR_TRACK_MATCH_ROUNDS 4
+
+static float ocr_track_iou(float ax, float ay, float aw, float ah, const ocr_track_box_t *b)
+{
+    const float bx1 = (float)b->x + b->width;
+    const float by1 = (float)b->y + b->height;
+    const float ix0 = (ax > b->x) ? ax : b->x;
+    const float iy0 = (ay > b->y) ? ay : b->y;
+    const float ix1 = (ax + aw < bx1) ? ax + aw : bx1;
+    const float iy1 = (ay + ah < by1) ? ay + ah : by1;
+
+    if (ix1 <= ix0 || iy1 <= iy0) {
+        return 0.0f;
+    }
+    const float inter = (ix1 - ix0) * (iy1 - iy0);
+    return inter / (aw * ah + (float)b->width * b->height - inter);
+}
+
+// IoU of a box with the track predicted one frame ahead
+static inline float ocr_track_predicted_iou(const ocr_track_t *t, const ocr_track_box_t *b)
+{
+    return ocr_track_iou(t->x + t->vx, t->y + t->vy, t->width, t->height, b);
+}
+
+uint32_t ocr_tracker_size(uint32_t capacity, uint32_t max_boxes)
+{
+    return capacity * sizeof(ocr_track_t) + 2u * ocr_align4(capacity * sizeof(uint16_t)) +
+           ocr_align4(max_boxes * sizeof(uint16_t));
+}
+
+int ocr_tracker_init(ocr_tracker_t *tracker, uint32_t capacity, uint32_t max_boxes,
+                     void *storage, uint32_t storage_size)
+{
+    uint8_t *p = (uint8_t*)storage;
+
+    if (!tracker || !storage || capacity == 0 || capacity >= OCR_TRACK_NONE ||
+        max_boxes == 0 || max_boxes >= OCR_TRACK_NONE ||
+        storage_size < ocr_tracker_size(capacity, max_boxes)) {
+        return -1;
+    }
+
+    memset(tracker, 0, sizeof(*tracker));
+    tracker->tracks = (ocr_track_t*)p;
+    p += capacity * sizeof(ocr_track_t);
+    tracker->track_match = (uint16_t*)p;
+    p += ocr_align4(capacity * sizeof(uint16_t));
+    tracker->track_best = (uint16_t*)p;
+    p += ocr_align4(capacity * sizeof(uint16_t));
+    tracker->obs_match = (uint16_t*)p;
+    tracker->capacity = (uint16_t)capacity;
+    tracker->obs_capacity = (uint16_t)max_boxes;
+    tracker->next_id = 1;
+
+    tracker->min_iou = OCR_TRACK_MIN_IOU;
+    tracker->velocity_gain = OCR_TRACK_VELOCITY_GAIN;
+    tracker->max_misses = OCR_TRACK_MAX_MISSES;
+    tracker->sig_thresh = OCR_TRACK_SIG_THRESH;
+    tracker->sig_cells = OCR_TRACK_SIG_CELLS;
+    tracker->size_change_q8 = OCR_TRACK_SIZE_CHANGE_Q8;
+
+    return 0;
+}
+
+void ocr_tracker_reset(ocr_tracker_t *tracker)
+{
+    tracker->count = 0;
+}
+
+// Mutual best IoU: a pair is fixed when each is the other's best free partner.
+// Greedy by IoU without building the full pair list (n x m entries)
+static uint32_t ocr_tracker_associate(ocr_tracker_t *tracker, const ocr_track_box_t *boxes,
+                                      uint32_t count)
+{
+    uint16_t *track_match = tracker->track_match;
+    uint16_t *track_best = tracker->track_best;
+    uint16_t *obs_match = tracker->obs_match;
+    uint32_t matched = 0;
+
+    for (uint32_t t = 0; t < tracker->count; t++) {
+        track_match[t] = OCR_TRACK_NONE;
+    }
+    for (uint32_t o = 0; o < count; o++) {
+        obs_match[o] = OCR_TRACK_NONE;
+    }
+
+    for (uint32_t round = 0; round < OCR_TRACK_MATCH_ROUNDS; round++) {
+        uint32_t fixed = 0;
+
+        for (uint32_t t = 0; t < tracker->count; t++) {
+            float best = tracker->min_iou;
+            track_best[t] = OCR_TRACK_NONE;
+            if (track_match[t] != OCR_TRACK_NONE) {
+                continue;
+            }
+            for (uint32_t o = 0; o < count; o++) {
+                if (obs_match[o] != OCR_TRACK_NONE) {
+                    continue;
+                }
+                const float iou = ocr_track_predicted_iou(&tracker->tracks[t], &boxes[o]);
+                if (iou >= best) {
+                    best = iou;
+                    track_best[t] = (uint16_t)o;
+                }
+            }
+        }
+
+        for (uint32_t o = 0; o < count; o++) {
+            float best = tracker->min_iou;
+            uint32_t best_t = OCR_TRACK_NONE;
+            if (obs_match[o] != OCR_TRACK_NONE) {
+                continue;
+            }
+            for (uint32_t t = 0; t < tracker->count; t++) {
+                if (track_match[t] != OCR_TRACK_NONE || track_best[t] == OCR_TRACK_NONE) {
+                    continue;   // Taken, or nothing in reach
+                }
+                const float iou = ocr_track_predicted_iou(&tracker->tracks[t], &boxes[o]);
+                if (iou >= best) {
+                    best = iou;
+                    best_t = t;
+                }
+            }
+            if (best_t != OCR_TRACK_NONE && track_best[best_t] == o) {
+                track_match[best_t] = (uint16_t)o;
+                obs_match[o] = (uint16_t)best_t;
+                fixed++;
+            }
+        }
+
+        matched += fixed;
+        if (fixed == 0) {
+            break;
+        }
+    }
+
+    return matched;
+}
+
+int ocr_tracker_update(ocr_tracker_t *tracker, const ocr_track_box_t *boxes, uint32_t count,
+                       uint16_t *track_of)
+{
+    const float gain = tracker ? tracker->velocity_gain : 0.0f;
+    uint32_t kept = 0;
+    int assigned = 0;
+
+    if (!tracker || (!boxes && count > 0) || !track_of || count > tracker->obs_capacity) {
+        return -1;
+    }
+
+    tracker->matched = (uint16_t)ocr_tracker_associate(tracker, boxes, count);
+    tracker->created = 0;
+    tracker->dropped = 0;
+
+    // Advance tracks, compacting out the expired ones; track_best becomes old -> new index
+    for (uint32_t t = 0; t < tracker->count; t++) {
+        ocr_track_t *track = &tracker->tracks[t];
+        const uint32_t o = tracker->track_match[t];
+
+        if (o != OCR_TRACK_NONE) {
+            const ocr_track_box_t *b = &boxes[o];
+            track->vx += gain * (((float)b->x - track->x) - track->vx);
+            track->vy += gain * (((float)b->y - track->y) - track->vy);
+            track->x = b->x;
+            track->y = b->y;
+            track->width = b->width;
+            track->height = b->height;
+            track->hits++;
+            track->misses = 0;
+        } else if (++track->misses > tracker->max_misses) {
+            tracker->track_best[t] = OCR_TRACK_NONE;
+            tracker->dropped++;
+            continue;
+        } else {
+            // Coast on the prediction so a briefly missed box is found again
+            track->x += track->vx;
+            track->y += track->vy;
+        }
+
+        tracker->track_best[t] = (uint16_t)kept;
+        if (kept != t) {
+            tracker->tracks[kept] = *track;
+        }
+        kept++;
+    }
+    tracker->count = (uint16_t)kept;
+
+    for (uint32_t o = 0; o < count; o++) {
+        const uint32_t t = tracker->obs_match[o];
+        if (t != OCR_TRACK_NONE) {
+            track_of[o] = tracker->track_best[t];
+            assigned++;
+            continue;
+        }
+        if (tracker->count >= tracker->capacity) {
+            track_of[o] = OCR_TRACK_NONE;   // No room: recognized every frame
+            continue;
+        }
+
+        ocr_track_t *track = &tracker->tracks[tracker->count];
+        memset(track, 0, sizeof(*track));
+        track->id = tracker->next_id++;
+        if (tracker->next_id == 0) {
+            tracker->next_id = 1;
+        }
+        track->x = boxes[o].x;
+        track->y = boxes[o].y;
+        track->width = boxes[o].width;
+        track->height = boxes[o].height;
+        track->hits = 1;
+        track_of[o] = tracker->count++;
+        tracker->created++;
+        assigned++;
+    }
+
+    return assigned;
+}
+
+void ocr_track_signature(const int8_t *plane, uint32_t pixel_stride, uint32_t row_stride,
+                         const ocr_track_box_t *box, int8_t signature[OCR_TRACK_SIG_LENGTH])
+{
+    // Inset so a box edge jittering by a pixel does not pull background into the cells
+    const uint32_t inset = box->height / OCR_TRACK_SIG_INSET;
+    const uint32_t bx = box->x + inset;
+    const uint32_t by = box->y + inset;
+    const uint32_t bw = (box->width > 2 * inset) ? box->width - 2 * inset : 1;
+    const uint32_t bh = (box->height > 2 * inset) ? box->height - 2 * inset : 1;
+
+    for (uint32_t r = 0; r < OCR_TRACK_SIG_ROWS; r++) {
+        uint32_t y0 = by + r * bh / OCR_TRACK_SIG_ROWS;
+        uint32_t y1 = by + (r + 1) * bh / OCR_TRACK_SIG_ROWS;
+        y1 = (y1 > y0) ? y1 : y0 + 1;
+
+        for (uint32_t c = 0; c < OCR_TRACK_SIG_COLS; c++) {
+            uint32_t x0 = bx + c * bw / OCR_TRACK_SIG_COLS;
+            uint32_t x1 = bx + (c + 1) * bw / OCR_TRACK_SIG_COLS;
+            x1 = (x1 > x0) ? x1 : x0 + 1;
+
+            int32_t sum = 0;
+            for (uint32_t y = y0; y < y1; y++) {
+                const int8_t *row = plane + y * row_stride;
+                for (uint32_t x = x0; x < x1; x++) {
+                    sum += row[x * pixel_stride];
+                }
+            }
+            const int32_t n = (int32_t)((x1 - x0) * (y1 - y0));
+            signature[r * OCR_TRACK_SIG_COLS + c] = (int8_t)(sum / n);
+        }
+    }
+}
+
+// Relative size change above the limit (Q8 fraction of the cached size)
+static inline int ocr_track_resized(uint32_t now, uint32_t then, uint32_t limit_q8)
+{
+    const uint32_t diff = (now > then) ? now - then : then - now;
+    return diff * 256u > limit_q8 * then;
+}
+
+const ocr_track_t* ocr_tracker_lookup(ocr_tracker_t *tracker, uint32_t track,
+                                      const ocr_track_box_t *box,
+                                      const int8_t signature[OCR_TRACK_SIG_LENGTH])
+{
+    if (track == OCR_TRACK_NONE || track >= tracker->count || !tracker->tracks[track].has_text) {
+        tracker->recognitions++;
+        return NULL;
+    }
+
+    const ocr_track_t *t = &tracker->tracks[track];
+    if (ocr_track_resized(box->width, t->text_width, tracker->size_change_q8) ||
+        ocr_track_resized(box->height, t->text_height, tracker->size_change_q8)) {
+        tracker->recognitions++;
+        return NULL;
+    }
+
+    // A cell changed when it leaves the range of the cached cell and its
+    // neighbours along the line: text shifted by less than a cell stays inside
+    uint32_t changed = 0;
+    for (uint32_t r = 0; r < OCR_TRACK_SIG_ROWS; r++) {
+        const int8_t *cached = &t->signature[r * OCR_TRACK_SIG_COLS];
+        const int8_t *now = &signature[r * OCR_TRACK_SIG_COLS];
+        for (uint32_t c = 0; c < OCR_TRACK_SIG_COLS; c++) {
+            int32_t lo = cached[c], hi = cached[c];
+            if (c > 0) {
+                lo = (cached[c - 1] < lo) ? cached[c - 1] : lo;
+                hi = (cached[c - 1] > hi) ? cached[c - 1] : hi;
+            }
+            if (c + 1 < OCR_TRACK_SIG_COLS) {
+                lo = (cached[c + 1] < lo) ? cached[c + 1] : lo;
+                hi = (cached[c + 1] > hi) ? cached[c + 1] : hi;
+            }
+            const int32_t d = (now[c] < lo) ? lo - now[c] : (now[c] > hi) ? now[c] - hi : 0;
+            changed += (uint32_t)(d > tracker->sig_thresh);
+        }
+    }
+    if (changed >= tracker->sig_cells) {
+        tracker->recognitions++;
+        return NULL;
+    }
+
+    tracker->reused++;
+    return t;
+}
+
+void ocr_tracker_store(ocr_tracker_t *tracker, uint32_t track, const ocr_track_box_t *box,
+                       const int8_t signature[OCR_TRACK_SIG_LENGTH],
+                       const char *text, float confidence)
+{
+    if (track == OCR_TRACK_NONE || track >= tracker->count) {
+        return;
+    }
+
+    ocr_track_t *t = &tracker->tracks[track];
+    strncpy(t->text, text, OCR_TRACK_TEXT_LENGTH - 1);
+    t->text[OCR_TRACK_TEXT_LENGTH - 1] = '\0';
+    t->confidence = confidence;
+    t->text_width = box->width;
+    t->text_height = box->height;
+    memcpy(t->signature, signature, OCR_TRACK_SIG_LENGTH);
+    t->has_text = 1;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file ocr_track.h
+ * @brief Temporal text-box tracker with a per-track recognition cache
+ * @details IoU association against constant-velocity predictions gives each
+ *          text box a persistent track. A track keeps its recognized string,
+ *          so recognition only reruns for new tracks or when the content of
+ *          the crop changed. Platform independent (no HAL dependency)
+ * @author μTRON Competition Team
+ * @date 2025
+ */
+
+#ifndef OCR_TRACK_H
+#define OCR_TRACK_H
+
+#include <stdint.h>
+
+// Defaults
+#define OCR_TRACK_MAX             64    // Tracks kept at once
+#define OCR_TRACK_TEXT_LENGTH     64    // Cached text per track (matches a recognition region)
+#define OCR_TRACK_SIG_COLS        16    // Crop signature grid (along the line)
+#define OCR_TRACK_SIG_ROWS        4
+#define OCR_TRACK_SIG_INSET       8     // Grid inset: box height / 8 on every side
+#define OCR_TRACK_SIG_LENGTH      (OCR_TRACK_SIG_COLS * OCR_TRACK_SIG_ROWS)
+#define OCR_TRACK_MIN_IOU         0.3f  // Association gate against the predicted box
+#define OCR_TRACK_VELOCITY_GAIN   0.5f  // Velocity smoothing (1 = last displacement only)
+#define OCR_TRACK_MAX_MISSES      5     // Frames a track survives without a box (100 ms)
+#define OCR_TRACK_SIG_THRESH      24    // Cell change that counts as different content
+#define OCR_TRACK_SIG_CELLS       4     // Changed cells that force recognition
+#define OCR_TRACK_SIZE_CHANGE_Q8  51    // Box size change (20%) that forces recognition
+#define OCR_TRACK_NONE            0xFFFFu
+
+// Box observed in the current frame
+typedef struct {
+    uint16_t x, y, width, height;
+} ocr_track_box_t;
+
+// One tracked text box
+typedef struct {
+    uint32_t id;                    // Persistent id (never 0)
+    float x, y, width, height;      // Last box
+    float vx, vy;                   // Displacement per frame
+    uint16_t hits;                  // Frames matched
+    uint8_t misses;                 // Consecutive frames without a box
+    uint8_t has_text;               // Cache below is valid
+    uint16_t text_width;            // Box size the cache was recognized at
+    uint16_t text_height;
+    float confidence;
+    char text[OCR_TRACK_TEXT_LENGTH];
+    int8_t signature[OCR_TRACK_SIG_LENGTH]; // Crop signature the cache belongs to
+} ocr_track_t;
+
+// Tracker state
+typedef struct {
+    ocr_track_t *tracks;
+    uint16_t capacity;
+    uint16_t count;                 // Tracks in use (dense, 0..count-1)
+    uint32_t next_id;
+
+    // Association scratch, one entry per track / observation
+    uint16_t *track_match;          // Box matched to each track
+    uint16_t *track_best;           // Best free box per track, then index remap
+    uint16_t *obs_match;            // Track matched to each box
+    uint16_t obs_capacity;
+
+    // Parameters
+    float min_iou;
+    float velocity_gain;
+    uint8_t max_misses;
+    uint8_t sig_thresh;
+    uint8_t sig_cells;
+    uint16_t size_change_q8;
+
+    // Last update
+    uint16_t matched;               // Observations continuing a track
+    uint16_t created;               // New tracks
+    uint16_t dropped;               // Tracks removed after too many misses
+
+    // Cumulative recognition bookkeeping
+    uint32_t recognitions;          // Crops that had to be recognized
+    uint32_t reused;                // Crops answered from a track cache
+} ocr_tracker_t;
+
+/**
+ * @brief Get storage required for a tracker
+ * @param capacity Maximum tracks
+ * @param max_boxes Maximum observations per frame
+ * @return Required storage in bytes
+ */
+uint32_t ocr_tracker_size(uint32_t capacity, uint32_t max_boxes);
+
+/**
+ * @brief Initialize a tracker with default parameters
+ * @param tracker Tracker
+ * @param capacity Maximum tracks (< 65535)
+ * @param max_boxes Maximum observations per frame (< 65535)
+ * @param storage Storage (4-byte aligned, ocr_tracker_size() bytes)
+ * @param storage_size Size of storage in bytes
+ * @return 0 on success, negative on error
+ */
+int ocr_tracker_init(ocr_tracker_t *tracker, uint32_t capacity, uint32_t max_boxes,
+                     void *storage, uint32_t storage_size);
+
+/**
+ * @brief Drop all tracks (scene cut, new input geometry)
+ * @param tracker Tracker
+ */
+void ocr_tracker_reset(ocr_tracker_t *tracker);
+
+/**
+ * @brief Associate the boxes of a frame with tracks
+ * @param tracker Tracker
+ * @param boxes Boxes of the frame
+ * @param count Number of boxes (<= max_boxes)
+ * @param track_of Output: track index per box, OCR_TRACK_NONE when no track was free
+ * @return Number of boxes with a track, negative on error
+ * @details Tracks are predicted one frame ahead with their velocity, then
+ *          matched to boxes by mutual best IoU above the gate. Unmatched boxes
+ *          start tracks; tracks unmatched for more than max_misses frames are
+ *          dropped. Track indices are valid until the next update
+ */
+int ocr_tracker_update(ocr_tracker_t *tracker, const ocr_track_box_t *boxes, uint32_t count,
+                       uint16_t *track_of);
+
+/**
+ * @brief Crop signature: mean of each cell of a grid laid over the box interior
+ * @param plane 8-bit plane, element (x, y) at plane[y * row_stride + x * pixel_stride]
+ * @param pixel_stride Elements between neighbouring pixels
+ * @param row_stride Elements between neighbouring rows
+ * @param box Box inside the plane
+ * @param signature Output (OCR_TRACK_SIG_LENGTH values)
+ * @details The grid follows the box, so the signature does not change when
+ *          the same text moves; it does when the text itself changes
+ */
+void ocr_track_signature(const int8_t *plane, uint32_t pixel_stride, uint32_t row_stride,
+                         const ocr_track_box_t *box, int8_t signature[OCR_TRACK_SIG_LENGTH]);
+
+/**
+ * @brief Look up the cached recognition of a track
+ * @param tracker Tracker
+ * @param track Track index from ocr_tracker_update() (OCR_TRACK_NONE allowed)
+ * @param box Current box of the track
+ * @param signature Current crop signature
+ * @return Cached track if its text still applies (counted as reused), NULL if
+ *         the crop has to be recognized (counted as a recognition)
+ * @details The cache applies while the box size stays within size_change_q8
+ *          and fewer than sig_cells signature cells left the range of their
+ *          cached value and its neighbours along the line by more than
+ *          sig_thresh. Box jitter shifts glyphs by less than a cell and stays
+ *          inside that range; a single changed word does not
+ */
+const ocr_track_t* ocr_tracker_lookup(ocr_tracker_t *tracker, uint32_t track,
+                                      const ocr_track_box_t *box,
+                                      const int8_t signature[OCR_TRACK_SIG_LENGTH]);
+
+/**
+ * @brief Store a recognition result in a track
+ * @param tracker Tracker
+ * @param track Track index (OCR_TRACK_NONE is ignored)
+ * @param box Box the text was recognized in
+ * @param signature Crop signature the text belongs to
+ * @param text Recognized text (truncated to OCR_TRACK_TEXT_LENGTH - 1)
+ * @param confidence Recognition confidence
+ */
+void ocr_tracker_store(ocr_tracker_t *tracker, uint32_t track, const ocr_track_box_t *box,
+                       const int8_t signature[OCR_TRACK_SIG_LENGTH],
+                       const char *text, float confidence);
+
+#endif // OCR_TRACK_H
@@ -11,11 +11,44 @@
 #include "audio_task.h"
 #include "system_task.h"
 #include "hal.h"
+#include "ocr_preprocess.h"
 
 // Neural-ART SDK includes (platform specific)
 #include "neural_art_runtime.h"
 #include "stm32cube_ai.h"
 
+// Pool allocation headers and alignment kept free when sizing per-frame buffers
+#define AI_POOL_ALLOC_SLACK 256
+
+// How a box is sampled from the camera frame into its recognition strip
+typedef enum {
+    AI_CROP_AFFINE = 0,             // Deskew rotate-crop: one bilinear grid
+    AI_CROP_BOX,                    // Axis-aligned crop-resize (area average on strong reductions)
+    AI_CROP_ROTATE90,               // Tategaki column turned into a strip, in blocks of columns
+    AI_CROP_QUAD                    // Perspective quad rectified into the strip
+} ai_crop_mode_t;
+
+// Crop geometry of one box, known before the crop is made (selects the bucket)
+typedef struct {
+    uint8_t mode;                   // ai_crop_mode_t
+    uint16_t width;                 // Strip size
+    uint16_t height;
+    ocr_affine_q16_t affine;        // AI_CROP_AFFINE: strip -> frame sampling grid
+    uint16_t box_x, box_y;          // AI_CROP_BOX / AI_CROP_ROTATE90: box in frame pixels
+    uint16_t box_width, box_height;
+    ocr_perspective_t persp;        // AI_CROP_QUAD
+} ai_crop_plan_t;
+
+// Recognition of one box, filled before the text is assembled in reading order
+typedef struct {
+    char text[OCR_REGION_TEXT_LENGTH];
+    float confidence;
+    int32_t status;                 // 0, or the AI_ERROR_* of the box
+    uint8_t fresh;                  // Recognized this frame (not answered from a track)
+    uint8_t bucket;                 // Recognition width bucket of the crop
+    ai_crop_plan_t plan;            // Crop geometry, planned once per box
+} ai_region_result_t;
+
 // Global AI task context
 ai_task_context_t ai_context;
 ai_state_t ai_current_state = AI_STATE_IDLE;
@@ -23,6 +56,35 @@ ai_state_t ai_current_state = AI_STATE_IDLE;
 // Static function prototypes
 static int ai_neural_art_init_npu(void);
 static int ai_load_ocr_models(void);
+static int ai_setup_input_quantizers(void);
+static int ai_setup_recognition_decoder(void);
+static int ai_preprocess_streaming(const frame_buffer_t *input_frame, int8_t *tensor);
+static void ai_camera_line_callback(frame_buffer_t *frame, uint32_t lines_done);
+static uint8_t ai_frame_is_static(const frame_buffer_t *frame);
+static int ai_setup_dirty_tiles(void);
+static int ai_setup_adaptive_stage(void);
+static void ai_estimate_skew(const frame_buffer_t *frame);
+static void ai_release_input_tensor(int8_t *tensor);
+static uint32_t ai_text_box_capacity(void);
+static void ai_release_text_boxes(void *storage);
+static uint32_t ai_track_frame_size(uint32_t capacity);
+static uint8_t ai_quad_is_level(const text_bbox_t *bbox);
+static void ai_track_signature(const int8_t *tensor, const ocr_track_box_t *box,
+                               int8_t signature[OCR_TRACK_SIG_LENGTH]);
+static int ai_plan_region(const text_bbox_t *bbox, ai_crop_plan_t *plan);
+static void ai_stage_region(const frame_buffer_t *frame, const ai_crop_plan_t *plan,
+                            const ocr_tensor_quantizer_t *quantizer, int8_t *input);
+static void ai_recognize_batch(uint32_t bucket, ocr_rec_batch_t *batch, ai_region_result_t *regions);
+static int ai_recognize_regions(const frame_buffer_t *frame, const int8_t *tensor,
+                                const ocr_det_boxes_t *boxes, const ocr_track_box_t *track_boxes,
+                                const uint16_t *track_of, ai_region_result_t *regions);
+static uint8_t ai_model_is_optional(int model);
+static uint8_t ai_multiscale_ready(void);
+static uint8_t ai_tiled_ready(void);
+static void ai_set_box_space(uint8_t tiled);
+static void ai_frame_box_to_input(const ocr_track_box_t *box, ocr_track_box_t *input_box);
+static uint8_t ai_prefilter_frame(const int8_t *tensor);
+static void ai_get_text_bbox(const ocr_det_boxes_t *boxes, uint32_t index, text_bbox_t *bbox);
 static int ai_setup_memory_pools(void);
 static int ai_validate_model_performance(void);
 static void ai_performance_monitor_task(void);
@@ -33,6 +95,21 @@ extern const uint8_t ocr_text_detection_model_data[];
 extern const uint32_t ocr_text_detection_model_size;
 extern const uint8_t ocr_text_recognition_model_data[];
 extern const uint32_t ocr_text_recognition_model_size;
+extern const uint8_t ocr_text_detection_coarse_model_data[];
+extern const uint32_t ocr_text_detection_coarse_model_size;
+// Recognition width variants (size 0 = variant not built, its crops use the next wider one)
+extern const uint8_t ocr_text_recognition_w80_model_data[];
+extern const uint32_t ocr_text_recognition_w80_model_size;
+extern const uint8_t ocr_text_recognition_w160_model_data[];
+extern const uint32_t ocr_text_recognition_w160_model_size;
+extern const uint8_t ocr_text_recognition_w640_model_data[];
+extern const uint32_t ocr_text_recognition_w640_model_size;
+// Recognition dictionary (PP-OCR dict file: one UTF-8 character per line)
+extern const uint8_t ocr_text_recognition_charset_data[];
+extern const uint32_t ocr_text_recognition_charset_size;
+// Recognition lexicon (ocr_lexicon image: place, product and station names; size 0 = none)
+extern const uint32_t ocr_text_recognition_lexicon_data[];
+extern const uint32_t ocr_text_recognition_lexicon_size;
 
 // Model calibration data for quantization
 extern const float model_calibration_data[];
@@ -58,6 +135,23 @@ void create_ai_task(void)
     ai_context.config.precision_mode = AI_PRECISION_INT8;
     ai_context.config.confidence_threshold = 0.95f;
     ai_context.config.max_inference_time_us = 8000; // 8ms target
+    ai_context.config.change_threshold = 6;         // Block luma delta (sensor noise ~2)
+    ai_context.config.change_min_blocks = 1;
+    ai_context.config.max_static_frames = 50;       // Re-read at least once per second
+    ai_context.config.dirty_tile_threshold = 4;
+    ai_context.config.adaptive_mode = OCR_ADAPTIVE_CONTRAST;
+    ai_context.config.enable_deskew = 1;            // Handheld use: 5-15 degree skew
+    ai_context.config.max_text_boxes = OCR_MAX_TEXT_BOXES; // Menus and receipts: 40+ lines
+    ai_context.config.enable_multiscale = 1;        // Most frames hold no text
+    ai_context.config.enable_tracking = 1;          // Same lines stay in view for many frames
+    ai_context.config.enable_fullres_crop = 1;      // Small print needs camera pixels
+    ai_context.config.enable_tiled_detection = 0;   // One inference per tile: opt-in for small print
+    ai_context.config.det_tile_overlap = OCR_DET_TILE_OVERLAP;
+    ai_context.config.enable_prefilter = 1;         // Camera often points at walls and desks
+    ai_context.config.prefilter_restrict = 0;       // Low-contrast text may miss its tile
+    ai_context.config.rec_beam_width = 0;           // Greedy; OCR_BEAM_WIDTH fixes look-alike kana/kanji
+    ai_context.config.rec_max_batch = 0;            // Model batch, shrunk to the activation budget
+    ai_context.config.enable_rec_buckets = 1;       // Most words are far shorter than 320 pixels
     ai_context.config.debug_enabled = 1;
     
     // Create μTRON OS task
@@ -94,7 +188,36 @@ void ai_task_entry(void *arg)
         // Check if new frame is available from camera
         frame_buffer_t *frame = camera_get_frame();
         if (frame != NULL && frame->ready) {
+            // A completed frame supersedes the published one (the ISR
+            // publishes the capture in progress again on its next line)
+            ai_context.stream_frame = NULL;
+            if (frame == ai_context.stream_consumed) {
+                // Already processed while it was captured
+                ai_context.stream_consumed = NULL;
+                camera_release_frame(frame);
+                frame = NULL;
+            }
+        } else if (frame == NULL && ai_context.config.enable_strip_streaming) {
+            // Start on the frame still being captured
+            frame = ai_context.stream_frame;
+        }
+        
+        // Same page held still: reuse the last result, leave the NPU idle
+        if (frame != NULL && frame->ready && ai_frame_is_static(frame)) {
+            ai_context.stats.frames_received++;
+            ai_context.stats.frames_skipped++;
+            ai_context.stats.npu_time_saved_us += ai_context.stats.avg_inference_time_us;
+            camera_release_frame(frame);
+            frame = NULL;
+        }
+        
+        if (frame != NULL && (frame->ready || frame == ai_context.stream_frame)) {
             
+            ai_context.stats.frames_received++;
+            if (!frame->ready) {
+                // Streamed frame has no signature, compare the next one afresh
+                ai_context.last_signature.valid = 0;
+            }
             ai_context.current_state = AI_STATE_INFERENCING;
             inference_start_time = hal_get_time_us();
             
@@ -106,6 +229,9 @@ void ai_task_entry(void *arg)
             uint32_t inference_time_us = inference_end_time - inference_start_time;
             
             if (processing_result == 0) {
+                ai_context.last_result = ocr_result;
+                ai_context.last_result_valid = 1;
+                
                 // Update performance statistics
                 ai_stats_update_timing(inference_time_us);
                 ai_stats_update_quality(ocr_result.confidence, 
@@ -133,12 +259,22 @@ void ai_task_entry(void *arg)
                 }
                 
             } else {
+                // Next frame must be processed again
+                ai_context.last_result_valid = 0;
+                
                 // Handle processing error
                 ai_handle_inference_error(processing_result);
                 ai_context.stats.failed_inferences++;
             }
             
-            // Release camera frame
+            // Release camera frame; a capture still running comes back
+            // from camera_get_frame() once done and must not be processed twice
+            if (frame == ai_context.stream_frame) {
+                ai_context.stream_frame = NULL;
+            }
+            if (!frame->ready) {
+                ai_context.stream_consumed = frame;
+            }
             camera_release_frame(frame);
             ai_context.current_state = AI_STATE_READY;
         }
@@ -187,6 +323,19 @@ int ai_init(void)
         return AI_ERROR_MODEL_LOAD_FAILED;
     }
     
+    // Build preprocessing resize tables for the default camera geometry
+    result = ai_configure_input(NULL);
+    if (result != 0) {
+        hal_debug_printf("[AI_TASK] Input configuration failed: %d\n", result);
+        return AI_ERROR_INIT_FAILED;
+    }
+    
+    // Overlap detection preprocessing with the camera DMA
+    // (the adaptive stage needs whole windows, so it takes complete frames)
+    if (ai_context.config.enable_strip_streaming && !ai_context.config.enable_preprocessing) {
+        camera_set_line_callback(ai_camera_line_callback, CAMERA_STRIP_LINES);
+    }
+    
     // Validate model performance
     result = ai_validate_model_performance();
     if (result != 0) {
@@ -201,6 +350,198 @@ int ai_init(void)
     return 0;
 }
 
+int ai_configure_input(const camera_config_t *camera_config)
+{
+    const ocr_tensor_quantizer_t *quantizer = &ai_context.det_quantizer;
+    uint16_t frame_width = camera_config ? (uint16_t)camera_config->width : CAMERA_WIDTH;
+    uint16_t frame_height = camera_config ? (uint16_t)camera_config->height : CAMERA_HEIGHT;
+    uint8_t fit = ai_context.config.letterbox_input ? OCR_RESIZE_FIT_LETTERBOX : OCR_RESIZE_FIT_STRETCH;
+    
+    uint32_t storage_size = ocr_resize_plan_size(frame_width, frame_height,
+                                                 quantizer->width, quantizer->height,
+                                                 OCR_RESIZE_AREA, fit);
+    if (storage_size == 0) {
+        hal_debug_printf("[AI_TASK] Unsupported input geometry %dx%d -> %dx%d\n",
+                       frame_width, frame_height, quantizer->width, quantizer->height);
+        return AI_ERROR_INPUT_INVALID;
+    }
+    
+    // Replace previous tables, newest allocation first (stack-like pool)
+    if (ai_context.prefilter_storage) {
+        ai_memory_free(ai_context.prefilter_storage);
+        ai_context.prefilter_storage = NULL;
+    }
+    if (ai_context.tracker_storage) {
+        ai_memory_free(ai_context.tracker_storage);
+        ai_context.tracker_storage = NULL;
+    }
+    if (ai_context.skew_scratch) {
+        ai_memory_free(ai_context.skew_scratch);
+        ai_context.skew_scratch = NULL;
+    }
+    if (ai_context.input_buffer) {
+        ai_memory_free(ai_context.input_buffer);
+        ai_context.input_buffer = NULL;
+    }
+    if (ai_context.det_adaptive_storage) {
+        ai_memory_free(ai_context.det_adaptive_storage);
+        ai_context.det_adaptive_storage = NULL;
+    }
+    if (ai_context.det_tensor) {
+        ai_memory_free(ai_context.det_tensor);
+        ai_context.det_tensor = NULL;
+    }
+    if (ai_context.det_tiles_storage) {
+        ai_memory_free(ai_context.det_tiles_storage);
+        ai_context.det_tiles_storage = NULL;
+    }
+    if (ai_context.det_resize_storage) {
+        ai_memory_free(ai_context.det_resize_storage);
+        ai_context.det_resize_storage = NULL;
+    }
+    
+    ai_context.det_resize_storage = ai_memory_alloc(storage_size);
+    if (!ai_context.det_resize_storage) {
+        return AI_ERROR_MEMORY_ALLOC_FAILED;
+    }
+    
+    // All divisions happen here, the per-frame loop is multiply-add only
+    ocr_resize_plan_init(&ai_context.det_resize, frame_width, frame_height,
+                         quantizer->width, quantizer->height, OCR_RESIZE_AREA, fit,
+                         ai_context.det_resize_storage, storage_size);
+    ai_context.frame_width = frame_width;
+    ai_context.frame_height = frame_height;
+    
+    // Detection tiles are detection inputs cut 1:1 from the frame (none when
+    // the frame is not larger than the input)
+    if (ocr_det_tiling_init(&ai_context.det_tiling, frame_width, frame_height,
+                            quantizer->width, quantizer->height,
+                            ai_context.config.det_tile_overlap) != 0) {
+        ai_context.det_tiling.count = 0;
+    }
+    
+    if (ai_context.config.enable_dirty_tiles) {
+        int result = ai_setup_dirty_tiles();
+        if (result != 0) {
+            return result;
+        }
+    }
+    
+    if (ai_context.config.enable_preprocessing) {
+        int result = ai_setup_adaptive_stage();
+        if (result != 0) {
+            return result;
+        }
+    }
+    
+    if (ai_context.config.enable_deskew) {
+        ai_context.skew_scratch = ai_memory_alloc(OCR_SKEW_SCRATCH_SIZE);
+        if (!ai_context.skew_scratch) {
+            return AI_ERROR_MEMORY_ALLOC_FAILED;
+        }
+    }
+    
+    // Track positions are in detection input coordinates: start over
+    if (ai_context.config.enable_tracking) {
+        uint32_t tracker_size = ocr_tracker_size(OCR_TRACK_MAX, ai_context.config.max_text_boxes);
+        ai_context.tracker_storage = ai_memory_alloc(tracker_size);
+        if (!ai_context.tracker_storage) {
+            return AI_ERROR_MEMORY_ALLOC_FAILED;
+        }
+        ocr_tracker_init(&ai_context.tracker, OCR_TRACK_MAX, ai_context.config.max_text_boxes,
+                         ai_context.tracker_storage, tracker_size);
+    }
+    
+    // Prefilter tiles are in detection input pixels
+    if (ai_context.config.enable_prefilter) {
+        uint32_t prefilter_size = ocr_prefilter_size(quantizer->width, quantizer->height,
+                                                     OCR_PREFILTER_TILE);
+        ai_context.prefilter_storage = ai_memory_alloc(prefilter_size);
+        if (!ai_context.prefilter_storage) {
+            return AI_ERROR_MEMORY_ALLOC_FAILED;
+        }
+        if (ocr_prefilter_init(&ai_context.prefilter, quantizer->width, quantizer->height,
+                               OCR_PREFILTER_TILE, ai_context.prefilter_storage, prefilter_size) != 0) {
+            ai_memory_free(ai_context.prefilter_storage);
+            ai_context.prefilter_storage = NULL;
+            return AI_ERROR_INPUT_INVALID;
+        }
+    }
+    
+    hal_debug_printf("[AI_TASK] Input resize %dx%d -> %dx%d (%s%s, %d bytes tables)\n",
+                   frame_width, frame_height, quantizer->width, quantizer->height,
+                   ocr_resize_plan_is_2x(&ai_context.det_resize) ? "2x2 SIMD" : "generic",
+                   ai_context.config.letterbox_input ? ", letterbox" : "", storage_size);
+    if (ai_tiled_ready()) {
+        hal_debug_printf("[AI_TASK] Tiled detection: %dx%d tiles of %dx%d (overlap %dx%d)\n",
+                       ai_context.det_tiling.cols, ai_context.det_tiling.rows,
+                       quantizer->width, quantizer->height,
+                       ai_context.det_tiling.overlap_x, ai_context.det_tiling.overlap_y);
+    }
+    return 0;
+}
+
+static int ai_setup_dirty_tiles(void)
+{
+    const ocr_tensor_quantizer_t *quantizer = &ai_context.det_quantizer;
+    uint16_t tiles_x = (quantizer->width + OCR_TILE_SIZE - 1) / OCR_TILE_SIZE;
+    uint16_t tiles_y = (quantizer->height + OCR_TILE_SIZE - 1) / OCR_TILE_SIZE;
+    uint32_t storage_size = ocr_tile_map_size(tiles_x, tiles_y);
+    
+    ai_context.det_tiles_storage = ai_memory_alloc(storage_size);
+    if (!ai_context.det_tiles_storage) {
+        return AI_ERROR_MEMORY_ALLOC_FAILED;
+    }
+    
+    // Clean tiles keep last frame's values, so the tensor outlives the frame
+    ai_context.det_tensor = ai_memory_alloc(ai_context.models[AI_MODEL_TEXT_DETECTION].input_size);
+    if (!ai_context.det_tensor) {
+        return AI_ERROR_MEMORY_ALLOC_FAILED;
+    }
+    
+    ocr_tile_map_init(&ai_context.det_tiles, OCR_TILE_SIZE, tiles_x, tiles_y,
+                      ai_context.config.dirty_tile_threshold,
+                      ai_context.det_tiles_storage, storage_size);
+    if (ocr_resize_plan_bind_tiles(&ai_context.det_resize, &ai_context.det_tiles) != 0) {
+        return AI_ERROR_INPUT_INVALID;
+    }
+    
+    hal_debug_printf("[AI_TASK] Dirty tiles %dx%d (%dpx), %d bytes signatures\n",
+                   tiles_x, tiles_y, OCR_TILE_SIZE, storage_size);
+    return 0;
+}
+
+static int ai_setup_adaptive_stage(void)
+{
+    const ocr_tensor_quantizer_t *quantizer = &ai_context.det_quantizer;
+    uint32_t storage_size = ocr_adaptive_size(quantizer->width, OCR_ADAPTIVE_RADIUS);
+    
+    ai_context.det_adaptive_storage = ai_memory_alloc(storage_size);
+    if (!ai_context.det_adaptive_storage) {
+        return AI_ERROR_MEMORY_ALLOC_FAILED;
+    }
+    
+    // Pool cost at 320x240: about 46 KB for the luma and integral ring
+    // (2r + 2 rows, independent of height) plus 150 KB for the resized
+    // RGB565 image the window statistics are taken from
+    ai_context.input_buffer = ai_memory_alloc((uint32_t)quantizer->width * quantizer->height * 2);
+    if (!ai_context.input_buffer) {
+        return AI_ERROR_MEMORY_ALLOC_FAILED;
+    }
+    
+    if (ocr_adaptive_init(&ai_context.det_adaptive, quantizer->width, quantizer->height,
+                          ai_context.config.adaptive_mode, OCR_ADAPTIVE_RADIUS,
+                          ai_context.det_adaptive_storage, storage_size) != 0) {
+        return AI_ERROR_INPUT_INVALID;
+    }
+    
+    hal_debug_printf("[AI_TASK] Adaptive stage mode %d, %dx%d window, %d + %d bytes\n",
+                   ai_context.config.adaptive_mode, 2 * OCR_ADAPTIVE_RADIUS + 1,
+                   2 * OCR_ADAPTIVE_RADIUS + 1, storage_size,
+                   quantizer->width * quantizer->height * 2);
+    return 0;
+}
+
 // ========================================================================
 // Neural-ART NPU Management
 // ========================================================================
@@ -245,7 +586,7 @@ static int ai_load_ocr_models(void)
     
     hal_debug_printf("[AI_TASK] Loading OCR models...\n");
     
-    // Load text detection model (EAST/CRAFT)
+    // Load text detection model (DBNet/EAST)
     result = neural_art_load_model(ai_context.models[0].npu_handle,
                                   ocr_text_detection_model_data,
                                   ocr_text_detection_model_size,
@@ -265,8 +606,47 @@ static int ai_load_ocr_models(void)
         return AI_ERROR_MODEL_LOAD_FAILED;
     }
     
+    // Load coarse text detection model if built (multi-scale mode); without
+    // it ai_multiscale_ready() stays false and detection runs single-scale
+    if (ocr_text_detection_coarse_model_size > 0) {
+        result = neural_art_load_model(ai_context.models[0].npu_handle,
+                                      ocr_text_detection_coarse_model_data,
+                                      ocr_text_detection_coarse_model_size,
+                                      &ai_context.models[AI_MODEL_TEXT_DETECTION_COARSE]);
+        if (result != NEURAL_ART_SUCCESS) {
+            hal_debug_printf("[AI_TASK] Coarse text detection model load failed: %d, single-scale detection\n",
+                             result);
+            memset(&ai_context.models[AI_MODEL_TEXT_DETECTION_COARSE], 0, sizeof(neural_art_model_t));
+        }
+    }
+    
+    // Load the recognition width variants that were built
+    const struct {
+        ai_model_type_t type;
+        const uint8_t *data;
+        uint32_t size;
+    } variants[] = {
+        { AI_MODEL_TEXT_RECOGNITION_W80,  ocr_text_recognition_w80_model_data,  ocr_text_recognition_w80_model_size },
+        { AI_MODEL_TEXT_RECOGNITION_W160, ocr_text_recognition_w160_model_data, ocr_text_recognition_w160_model_size },
+        { AI_MODEL_TEXT_RECOGNITION_W640, ocr_text_recognition_w640_model_data, ocr_text_recognition_w640_model_size },
+    };
+    for (uint32_t v = 0; v < sizeof(variants) / sizeof(variants[0]); v++) {
+        if (variants[v].size == 0) {
+            continue;
+        }
+        result = neural_art_load_model(ai_context.models[0].npu_handle, variants[v].data, variants[v].size,
+                                      &ai_context.models[variants[v].type]);
+        if (result != NEURAL_ART_SUCCESS) {
+            hal_debug_printf("[AI_TASK] Recognition variant %d load failed: %d\n", variants[v].type, result);
+            return AI_ERROR_MODEL_LOAD_FAILED;
+        }
+    }
+    
     // Verify models are loaded correctly
     for (int i = 0; i < AI_MODEL_COUNT; i++) {
+        if (ai_model_is_optional(i) && !ai_context.models[i].model_data) {
+            continue;   // Optional model not built
+        }
         if (!neural_art_is_model_ready(&ai_context.models[i])) {
             hal_debug_printf("[AI_TASK] Model %d not ready\n", i);
             return AI_ERROR_MODEL_LOAD_FAILED;
@@ -276,6 +656,132 @@ static int ai_load_ocr_models(void)
     }
     
     hal_debug_printf("[AI_TASK] All OCR models loaded successfully\n");
+    int setup_result = ai_setup_input_quantizers();
+    if (setup_result != 0) {
+        return setup_result;
+    }
+    return ai_setup_recognition_decoder();
+}
+
+static int ai_setup_input_quantizers(void)
+{
+    const neural_art_model_t *det = &ai_context.models[AI_MODEL_TEXT_DETECTION];
+    
+    // Quantization LUTs are derived once from model metadata
+    if (ocr_quantizer_init(&ai_context.det_quantizer, det->input_width, det->input_height,
+                           det->input_channels, det->input_layout,
+                           det->input_scale, det->input_zero_point,
+                           det->input_mean, det->input_std) != 0) {
+        hal_debug_printf("[AI_TASK] Invalid detection input quantization parameters\n");
+        return AI_ERROR_MODEL_LOAD_FAILED;
+    }
+    
+    hal_debug_printf("[AI_TASK] Detection input: %dx%dx%d, scale %.5f, zp %d\n",
+                   det->input_width, det->input_height, det->input_channels,
+                   det->input_scale, det->input_zero_point);
+    
+    // Width buckets from the model metadata: every loaded recognizer, or the
+    // base model alone; crops are quantized into a batch slot of their bucket
+    ocr_rec_buckets_init(&ai_context.rec_buckets);
+    for (int i = 0; i < AI_MODEL_COUNT; i++) {
+        const neural_art_model_t *rec = &ai_context.models[i];
+        if (!rec->loaded || !rec->recognizer ||
+            (!ai_context.config.enable_rec_buckets && i != AI_MODEL_TEXT_RECOGNITION)) {
+            continue;
+        }
+        if (ocr_rec_buckets_add(&ai_context.rec_buckets, rec->input_width, (uint8_t)i) < 0) {
+            hal_debug_printf("[AI_TASK] Recognition model %d: width %d not usable as a bucket\n",
+                           i, rec->input_width);
+        }
+    }
+    for (uint32_t b = 0; b < ai_context.rec_buckets.count; b++) {
+        const neural_art_model_t *rec = &ai_context.models[ai_context.rec_buckets.bucket[b].model];
+        if (rec->input_height != OCR_STRIP_HEIGHT ||
+            ocr_quantizer_init(&ai_context.rec_quantizer[b], rec->input_width, rec->input_height,
+                               rec->input_channels, rec->input_layout,
+                               rec->input_scale, rec->input_zero_point,
+                               rec->input_mean, rec->input_std) != 0) {
+            hal_debug_printf("[AI_TASK] Invalid recognition input quantization parameters\n");
+            return AI_ERROR_MODEL_LOAD_FAILED;
+        }
+        hal_debug_printf("[AI_TASK] Recognition input: %dx%dx%d, batch up to %d\n",
+                       rec->input_width, rec->input_height, rec->input_channels, rec->max_batch);
+    }
+    if (ai_context.rec_buckets.count == 0) {
+        return AI_ERROR_MODEL_LOAD_FAILED;
+    }
+    return 0;
+}
+
+static int ai_setup_recognition_decoder(void)
+{
+    const neural_art_model_t *rec = &ai_context.models[AI_MODEL_TEXT_RECOGNITION];
+    
+    // Index built once; the dictionary itself stays in flash
+    if (!ai_context.rec_charset_storage) {
+        uint32_t index_size = ocr_charset_size(ocr_text_recognition_charset_data,
+                                               ocr_text_recognition_charset_size);
+        ai_context.rec_charset_storage = index_size ? ai_memory_alloc(index_size) : NULL;
+        if (!ai_context.rec_charset_storage) {
+            return AI_ERROR_MEMORY_ALLOC_FAILED;
+        }
+        if (ocr_charset_init(&ai_context.rec_charset, ocr_text_recognition_charset_data,
+                             ocr_text_recognition_charset_size,
+                             ai_context.rec_charset_storage, index_size) != 0) {
+            hal_debug_printf("[AI_TASK] Invalid recognition dictionary\n");
+            return AI_ERROR_MODEL_LOAD_FAILED;
+        }
+    }
+    
+    // Exported PP-OCR models end in a softmax: their output is quantized over [0, 1]
+    uint8_t probs = (rec->output_zero_point == -128 &&
+                     rec->output_scale * 255.0f > 0.99f && rec->output_scale * 255.0f < 1.01f);
+    if (ocr_ctc_init(&ai_context.rec_ctc, &ai_context.rec_charset, rec->output_channels,
+                     probs ? OCR_CTC_OUTPUT_PROBS : OCR_CTC_OUTPUT_LOGITS,
+                     rec->output_scale, rec->output_zero_point) != 0) {
+        hal_debug_printf("[AI_TASK] Recognition classes %d do not match the dictionary (%d entries)\n",
+                       rec->output_channels, ai_context.rec_charset.count);
+        return AI_ERROR_MODEL_LOAD_FAILED;
+    }
+    
+    // One decoder for every bucket: only the timestep count differs
+    for (uint32_t b = 0; b < ai_context.rec_buckets.count; b++) {
+        const neural_art_model_t *variant = &ai_context.models[ai_context.rec_buckets.bucket[b].model];
+        if (variant->output_channels != rec->output_channels ||
+            variant->output_scale != rec->output_scale ||
+            variant->output_zero_point != rec->output_zero_point) {
+            hal_debug_printf("[AI_TASK] Recognition width %d: output does not match the base model\n",
+                           variant->input_width);
+            return AI_ERROR_MODEL_LOAD_FAILED;
+        }
+    }
+    
+    hal_debug_printf("[AI_TASK] Recognition decoder: %d timesteps x %d classes (%s), %d dictionary entries\n",
+                   rec->output_width * rec->output_height, rec->output_channels,
+                   probs ? "softmax" : "logits", ai_context.rec_charset.count);
+    
+    // Beam arena sized once for the configured width (worst case of any line)
+    uint16_t width = ai_context.config.rec_beam_width;
+    if (width > 0 && !ai_context.rec_beam_storage) {
+        const ocr_lexicon_t *lexicon = NULL;
+        if (ocr_text_recognition_lexicon_size > 0) {
+            if (ocr_lexicon_map(&ai_context.rec_lexicon, ocr_text_recognition_lexicon_data,
+                                ocr_text_recognition_lexicon_size) != 0) {
+                hal_debug_printf("[AI_TASK] Invalid recognition lexicon\n");
+                return AI_ERROR_MODEL_LOAD_FAILED;
+            }
+            lexicon = &ai_context.rec_lexicon;
+        }
+        uint32_t beam_size = ocr_beam_size(width);
+        ai_context.rec_beam_storage = beam_size ? ai_memory_alloc(beam_size) : NULL;
+        if (!ai_context.rec_beam_storage ||
+            ocr_beam_init(&ai_context.rec_beam, &ai_context.rec_ctc, lexicon, width,
+                          ai_context.rec_beam_storage, beam_size) != 0) {
+            return AI_ERROR_MEMORY_ALLOC_FAILED;
+        }
+        hal_debug_printf("[AI_TASK] Beam search: width %d, %d-byte arena, %d lexicon nodes\n",
+                       width, beam_size, lexicon ? lexicon->node_count : 0);
+    }
     return 0;
 }
 
@@ -340,7 +846,7 @@ static int ai_validate_model_performance(void)
 
 int ocr_process_frame(const frame_buffer_t *frame, ocr_result_t *result)
 {
-    if (!frame || !result || !frame->ready) {
+    if (!frame || !result || (!frame->ready && frame != ai_context.stream_frame)) {
         return AI_ERROR_INPUT_INVALID;
     }
     
@@ -351,67 +857,217 @@ int ocr_process_frame(const frame_buffer_t *frame, ocr_result_t *result)
     memset(result, 0, sizeof(ocr_result_t));
     result->timestamp = hal_get_tick();
     
-    // Step 1: Preprocess image for OCR
-    uint8_t *preprocessed_image = ai_memory_alloc(OCR_INPUT_WIDTH * OCR_INPUT_HEIGHT * 2);
-    if (!preprocessed_image) {
-        return AI_ERROR_MEMORY_ALLOC_FAILED;
+    // Step 1: Preprocess frame straight into the detection input tensor
+    // (dirty-tile mode keeps one tensor across frames)
+    int8_t *input_tensor = ai_context.det_tensor;
+    if (!input_tensor) {
+        input_tensor = ai_memory_alloc(ai_context.models[AI_MODEL_TEXT_DETECTION].input_size);
+        if (!input_tensor) {
+            return AI_ERROR_MEMORY_ALLOC_FAILED;
+        }
     }
     
-    processing_result = ocr_preprocess_image(frame, preprocessed_image);
+    processing_result = ocr_preprocess_to_tensor(frame, input_tensor);
     if (processing_result != 0) {
-        ai_memory_free(preprocessed_image);
+        ai_release_input_tensor(input_tensor);
         return processing_result;
     }
     
-    // Step 2: Detect text regions
-    text_bbox_t text_boxes[16]; // Support up to 16 text regions
-    int detected_boxes = ocr_detect_text(preprocessed_image, text_boxes, 16);
+    // Step 1b: Frames without stroke-like edges skip detection (walls, desks)
+    uint8_t skip_detection = ai_context.prefilter_storage && !ai_prefilter_frame(input_tensor);
+    
+    // Step 2: Detect text regions into box storage sized for this frame
+    ocr_det_boxes_t *text_boxes = &ai_context.text_boxes;
+    uint32_t box_capacity = ai_text_box_capacity();
+    uint32_t box_storage_size = ocr_det_boxes_size(box_capacity);
+    void *box_storage = box_capacity ? ai_memory_alloc(box_storage_size) : NULL;
+    if (!box_storage) {
+        ai_release_input_tensor(input_tensor);
+        return AI_ERROR_MEMORY_ALLOC_FAILED;
+    }
+    ocr_det_boxes_init(text_boxes, box_capacity, box_storage, box_storage_size);
+    ai_context.stats.text_box_capacity = box_capacity;
+    
+    // Tiled mode: boxes in camera pixels; the detection tensor still carries
+    // the tracker signatures
+    uint8_t tiled = ai_tiled_ready();
+    ai_set_box_space(tiled);
+    int detected_boxes = 0;
+    if (!skip_detection) {
+        ai_context.det_likely = (ai_context.prefilter_storage && ai_context.config.prefilter_restrict) ?
+                                &ai_context.prefilter : NULL;
+        detected_boxes = tiled ? ocr_detect_text_tiled(frame, text_boxes) :
+                                 ocr_detect_text((const uint8_t*)input_tensor, text_boxes);
+        ai_context.det_likely = NULL;
+    }
     if (detected_boxes < 0) {
-        ai_memory_free(preprocessed_image);
+        ai_release_text_boxes(box_storage);
+        ai_release_input_tensor(input_tensor);
         return detected_boxes;
     }
     
     result->bbox_count = detected_boxes;
     
-    // Step 3: Recognize text in each detected region
-    char combined_text[OCR_MAX_TEXT_LENGTH] = {0};
+    // Step 2b: One skew estimate per frame, shared by all regions
+    if (detected_boxes > 0) {
+        ai_estimate_skew(frame);
+    }
+    
+    // Step 3: Reading order (scratch sized like the boxes, freed before them)
+    uint32_t layout_storage_size = ocr_layout_size(box_capacity);
+    void *layout_storage = ai_memory_alloc(layout_storage_size);
+    if (!layout_storage) {
+        ai_release_text_boxes(box_storage);
+        ai_release_input_tensor(input_tensor);
+        return AI_ERROR_MEMORY_ALLOC_FAILED;
+    }
+    
+    ocr_layout_t layout;
+    uint32_t layout_start = hal_get_time_us();
+    ocr_layout_init(&layout, box_capacity, layout_storage, layout_storage_size);
+    ocr_layout_build(&layout, text_boxes);
+    ai_context.stats.layout_time_us = hal_get_time_us() - layout_start;
+    ai_context.stats.layout_lines = layout.line_count;
+    ai_context.stats.layout_blocks = layout.block_count;
+    ai_context.stats.layout_columns = layout.column_count;
+    
+    // Step 3b: Carry boxes over from the previous frame (without room: recognize all)
+    void *track_storage = NULL;
+    ocr_track_box_t *track_boxes = NULL;
+    uint16_t *track_of = NULL;
+    if (ai_context.tracker_storage && box_capacity > 0) {
+        track_storage = ai_memory_alloc(ai_track_frame_size(box_capacity));
+    }
+    if (track_storage) {
+        const uint16_t space_w = ai_context.box_width;
+        const uint16_t space_h = ai_context.box_height;
+        track_boxes = (ocr_track_box_t*)track_storage;
+        track_of = (uint16_t*)(track_boxes + box_capacity);
+        for (uint32_t i = 0; i < text_boxes->count; i++) {
+            uint16_t x = (text_boxes->x[i] < space_w) ? text_boxes->x[i] : space_w - 1;
+            uint16_t y = (text_boxes->y[i] < space_h) ? text_boxes->y[i] : space_h - 1;
+            track_boxes[i].x = x;
+            track_boxes[i].y = y;
+            track_boxes[i].width = (text_boxes->width[i] < space_w - x) ?
+                                   text_boxes->width[i] : space_w - x;
+            track_boxes[i].height = (text_boxes->height[i] < space_h - y) ?
+                                    text_boxes->height[i] : space_h - y;
+        }
+        ocr_tracker_update(&ai_context.tracker, track_boxes, text_boxes->count, track_of);
+    }
+    
+    // Step 4: Recognize every box (track hits first, the rest in batches), then
+    // assemble line by line; words joined by ' ' (nothing within a tategaki
+    // column), lines by '\n'
+    ai_region_result_t *regions = NULL;
+    if (text_boxes->count > 0) {
+        regions = ai_memory_alloc(text_boxes->count * sizeof(ai_region_result_t));
+        if (!regions) {
+            if (track_storage) {
+                ai_memory_free(track_storage);
+            }
+            ai_memory_free(layout_storage);
+            ai_release_text_boxes(box_storage);
+            ai_release_input_tensor(input_tensor);
+            return AI_ERROR_MEMORY_ALLOC_FAILED;
+        }
+        ai_recognize_regions(frame, input_tensor, text_boxes, track_boxes, track_of, regions);
+    }
+    
+    char *text = result->text;
+    uint32_t text_length = 0;
     float total_confidence = 0.0f;
     int recognized_regions = 0;
+    int32_t last_block = -1;
     
-    for (int i = 0; i < detected_boxes && i < 16; i++) {
-        char region_text[64];
-        float region_confidence;
+    for (uint32_t l = 0; l < layout.line_count; l++) {
+        const ocr_layout_line_t *line = &layout.lines[l];
+        ocr_line_t *out = NULL;
+        float line_confidence = 0.0f;
+        uint32_t line_words = 0;
         
-        processing_result = ocr_recognize_text(preprocessed_image, &text_boxes[i], 
-                                             region_text, &region_confidence);
-        if (processing_result == 0 && region_confidence > 0.5f) {
-            // Append text with space separator
-            if (strlen(combined_text) > 0) {
-                strcat(combined_text, " ");
+        for (uint32_t k = 0; k < line->box_count; k++) {
+            uint32_t index = layout.box_order[line->first_box + k];
+            const char *region_text = regions[index].text;
+            float region_confidence = regions[index].confidence;
+            if (regions[index].status != 0 || region_confidence <= 0.5f) {
+                continue;
+            }
+            
+            // Separator before the word: none at the start or inside a column,
+            // else space or newline
+            uint32_t word_length = strlen(region_text);
+            uint32_t separator = (text_length > 0 && !(line_words > 0 && line->direction)) ? 1 : 0;
+            if (text_length + separator + word_length >= OCR_MAX_TEXT_LENGTH) {
+                // Text full: confidence still counts, the text does not
+                total_confidence += region_confidence;
+                recognized_regions++;
+                continue;
+            }
+            if (separator) {
+                text[text_length++] = (line_words > 0) ? ' ' : '\n';
+            }
+            
+            if (line_words == 0 && result->line_count < OCR_MAX_RESULT_LINES) {
+                const ocr_layout_block_t *block = &layout.blocks[line->block];
+                if ((int32_t)line->block != last_block) {
+                    last_block = line->block;
+                    result->block_count++;
+                }
+                out = &result->lines[result->line_count++];
+                out->text_offset = (uint16_t)text_length;
+                out->block = result->block_count - 1;
+                out->column = block->column;
+                out->direction = line->direction;
+            }
+            memcpy(&text[text_length], region_text, word_length);
+            text_length += word_length;
+            text[text_length] = '\0';
+            
+            line_confidence += region_confidence;
+            line_words++;
+            if (out) {
+                out->text_length = (uint16_t)(text_length - out->text_offset);
+                out->confidence = line_confidence / line_words;
             }
-            strncat(combined_text, region_text, sizeof(combined_text) - strlen(combined_text) - 1);
             
             total_confidence += region_confidence;
             recognized_regions++;
         }
     }
     
-    // Step 4: Post-process results
+    // Step 5: Post-process results
     if (recognized_regions > 0) {
-        strncpy(result->text, combined_text, OCR_MAX_TEXT_LENGTH - 1);
         result->confidence = total_confidence / recognized_regions;
-        result->char_count = strlen(result->text);
-        result->word_count = 1; // Simple word count (spaces + 1)
+        result->char_count = text_length;
+        result->word_count = 1; // Separators + 1
         for (char *p = result->text; *p; p++) {
-            if (*p == ' ') result->word_count++;
+            if (*p == ' ' || *p == '\n') result->word_count++;
         }
         
         // Detect language (simple heuristic)
         result->language_detected = tts_detect_language(result->text);
     }
     
-    // Cleanup
-    ai_memory_free(preprocessed_image);
+    if (track_storage) {
+        const ocr_tracker_t *tracker = &ai_context.tracker;
+        uint32_t crops = tracker->recognitions + tracker->reused;
+        ai_context.stats.track_recognitions = tracker->recognitions;
+        ai_context.stats.track_reused = tracker->reused;
+        ai_context.stats.track_saved_percent = crops ? (uint32_t)((uint64_t)tracker->reused * 100 / crops) : 0;
+        ai_context.stats.track_active = tracker->count;
+    }
+    
+    // Cleanup (pool is LIFO: tensor, boxes, layout, tracking, regions)
+    if (regions) {
+        ai_memory_free(regions);
+    }
+    if (track_storage) {
+        ai_memory_free(track_storage);
+    }
+    ai_memory_free(layout_storage);
+    ai_release_text_boxes(box_storage);
+    ai_release_input_tensor(input_tensor);
     
     // Update statistics
     uint32_t end_time = hal_get_time_us();
@@ -430,128 +1086,1095 @@ int ocr_process_frame(const frame_buffer_t *frame, ocr_result_t *result)
     return 0;
 }
 
+static void ai_release_input_tensor(int8_t *tensor)
+{
+    if (tensor != ai_context.det_tensor) {
+        ai_memory_free(tensor);
+    }
+}
+
+/**
+ * @brief Box capacity for this frame: the configured cap, limited by what the
+ *        pool can hold next to the detection output, decoder scratch and layout
+ */
+static uint32_t ai_text_box_capacity(void)
+{
+    const neural_art_model_t *det = &ai_context.models[AI_MODEL_TEXT_DETECTION];
+    uint32_t free_bytes = 0;
+    uint32_t reserve = det->output_size + AI_POOL_ALLOC_SLACK;
+    
+    if (det->output_head == OCR_DET_HEAD_EAST) {
+        reserve += ocr_east_size(OCR_EAST_MAX_CANDIDATES);
+    } else {
+        reserve += ocr_dbnet_size(det->output_width, det->output_height, OCR_DBNET_MAX_LABELS);
+    }
+    
+    // Tiled mode: one tile tensor under the fine pass, and a tag per box
+    uint32_t per_tag = 0;
+    if (ai_tiled_ready()) {
+        reserve += det->input_size + 2 * AI_POOL_ALLOC_SLACK;
+        per_tag = sizeof(uint16_t);
+    } else if (ai_multiscale_ready()) {
+        // Coarse regions stay allocated under the fine pass; the coarse tensors are
+        // freed before it and need less than its output and decoder scratch
+        const neural_art_model_t *coarse = &ai_context.models[AI_MODEL_TEXT_DETECTION_COARSE];
+        reserve += ocr_det_roi_size(coarse->output_width, coarse->output_height, OCR_DET_ROI_CELL) +
+                   AI_POOL_ALLOC_SLACK;
+    }
+    
+    ai_memory_get_stats(NULL, &free_bytes, NULL);
+    if (free_bytes <= reserve) {
+        return 0;
+    }
+    
+    uint32_t per_box = ocr_det_boxes_size(1) + ocr_layout_size(1) + per_tag + sizeof(ai_region_result_t) +
+                       (ai_context.tracker_storage ? ai_track_frame_size(1) : 0);
+    uint32_t fit = (free_bytes - reserve) / per_box;
+    return (fit < ai_context.config.max_text_boxes) ? fit : ai_context.config.max_text_boxes;
+}
+
+static void ai_release_text_boxes(void *storage)
+{
+    ai_context.text_boxes.count = 0;
+    ai_context.text_boxes.capacity = 0;
+    ai_memory_free(storage);
+}
+
+/**
+ * @brief Per-frame tracking arrays: box geometry and track index per box
+ */
+static uint32_t ai_track_frame_size(uint32_t capacity)
+{
+    return capacity * (sizeof(ocr_track_box_t) + sizeof(uint16_t));
+}
+
+/**
+ * @brief Quad that is its own bounding box (level text, no perspective)
+ * @details Horizontal quads start at the top-left, vertical ones at the top-right
+ */
+static uint8_t ai_quad_is_level(const text_bbox_t *bbox)
+{
+    const int16_t *qx = bbox->quad_x;
+    const int16_t *qy = bbox->quad_y;
+    
+    if (bbox->text_direction) {
+        return qx[0] == qx[1] && qx[2] == qx[3] && qy[0] == qy[3] && qy[1] == qy[2];
+    }
+    return qy[0] == qy[1] && qy[2] == qy[3] && qx[0] == qx[3] && qx[1] == qx[2];
+}
+
+/**
+ * @brief Per-region view of one detected box (input of recognition)
+ */
+static void ai_get_text_bbox(const ocr_det_boxes_t *boxes, uint32_t index, text_bbox_t *bbox)
+{
+    const int16_t *qx = &boxes->quad_x[4 * index];
+    const int16_t *qy = &boxes->quad_y[4 * index];
+    
+    bbox->x = boxes->x[index];
+    bbox->y = boxes->y[index];
+    bbox->width = boxes->width[index];
+    bbox->height = boxes->height[index];
+    bbox->confidence = boxes->score[index] / 255.0f;
+    bbox->text_direction = boxes->direction[index];
+    bbox->has_quad = 1;
+    for (int k = 0; k < 4; k++) {
+        bbox->quad_x[k] = qx[k];
+        bbox->quad_y[k] = qy[k];
+    }
+}
+
 int ocr_preprocess_image(const frame_buffer_t *input_frame, uint8_t *output_buffer)
 {
     if (!input_frame || !output_buffer) {
         return AI_ERROR_INPUT_INVALID;
     }
     
-    // Convert from camera format (640x480 RGB565) to OCR format (320x240)
-    // Simple downsampling with 2x2 average
-    uint16_t *src = (uint16_t*)input_frame->data;
-    uint16_t *dst = (uint16_t*)output_buffer;
+    ocr_resize_plan_t *plan = &ai_context.det_resize;
     
-    for (int y = 0; y < OCR_INPUT_HEIGHT; y++) {
-        for (int x = 0; x < OCR_INPUT_WIDTH; x++) {
-            // Sample 2x2 region from source image
-            int src_x = x * 2;
-            int src_y = y * 2;
-            
-            uint16_t pixel1 = src[src_y * CAMERA_WIDTH + src_x];
-            uint16_t pixel2 = src[src_y * CAMERA_WIDTH + src_x + 1];
-            uint16_t pixel3 = src[(src_y + 1) * CAMERA_WIDTH + src_x];
-            uint16_t pixel4 = src[(src_y + 1) * CAMERA_WIDTH + src_x + 1];
-            
-            // Simple average (could be improved with proper filtering)
-            uint32_t avg_r = ((pixel1 >> 11) + (pixel2 >> 11) + (pixel3 >> 11) + (pixel4 >> 11)) / 4;
-            uint32_t avg_g = (((pixel1 >> 5) & 0x3F) + ((pixel2 >> 5) & 0x3F) + 
-                             ((pixel3 >> 5) & 0x3F) + ((pixel4 >> 5) & 0x3F)) / 4;
-            uint32_t avg_b = ((pixel1 & 0x1F) + (pixel2 & 0x1F) + (pixel3 & 0x1F) + (pixel4 & 0x1F)) / 4;
-            
-            dst[y * OCR_INPUT_WIDTH + x] = (avg_r << 11) | (avg_g << 5) | avg_b;
+    if (ocr_resize_plan_is_2x(plan)) {
+        // 2x2 box average, vectorized (Helium/MVE on Cortex-M55)
+        ocr_downsample_rgb565_2x2((const uint16_t*)input_frame->data, ai_context.frame_width,
+                                  (uint16_t*)output_buffer, plan->dst_width,
+                                  plan->dst_width, plan->dst_height);
+    } else {
+        // Arbitrary ratio through the precomputed coefficient tables
+        ocr_resize_region_rgb565(plan, (const uint16_t*)input_frame->data, ai_context.frame_width,
+                                 0, 0, plan->dst_width, plan->dst_height,
+                                 (uint16_t*)output_buffer, plan->dst_width);
+    }
+    
+    return 0;
+}
+
+int ocr_preprocess_to_tensor(const frame_buffer_t *input_frame, int8_t *tensor)
+{
+    const ocr_tensor_quantizer_t *quantizer = &ai_context.det_quantizer;
+    ocr_resize_plan_t *plan = &ai_context.det_resize;
+    
+    if (!input_frame || !tensor || !input_frame->data) {
+        return AI_ERROR_INPUT_INVALID;
+    }
+    
+    // Plan must have been built for the current model input
+    if (plan->dst_width != quantizer->width || plan->dst_height != quantizer->height) {
+        return AI_ERROR_INPUT_INVALID;
+    }
+    
+    // Record detection -> camera mapping for this frame
+    ocr_resize_plan_get_transform(plan, &ai_context.frame_transform);
+    
+    // Frame still in capture: consume strips as the DMA lands them
+    if (!input_frame->ready && input_frame == ai_context.stream_frame) {
+        if (tensor == ai_context.det_tensor) {
+            // Tile signatures are stale after a streamed full pass
+            ocr_tile_map_invalidate(&ai_context.det_tiles);
+        }
+        return ai_preprocess_streaming(input_frame, tensor);
+    }
+    
+    // Adaptive contrast / binarization needs the resized image and its
+    // window statistics, so it bypasses the fused and tiled paths
+    if (ai_context.config.enable_preprocessing && ai_context.input_buffer) {
+        uint32_t start_time = hal_get_time_us();
+        
+        if (tensor == ai_context.det_tensor) {
+            ocr_tile_map_invalidate(&ai_context.det_tiles);
         }
+        ocr_preprocess_image(input_frame, ai_context.input_buffer);
+        ocr_adaptive_rgb565_to_tensor(&ai_context.det_adaptive, quantizer,
+                                      (const uint16_t*)ai_context.input_buffer, plan->dst_width, tensor);
+        
+        ai_context.stats.adaptive_time_us = hal_get_time_us() - start_time;
+        return 0;
+    }
+    
+    // Persistent tensor: recompute only the tiles that changed
+    if (tensor == ai_context.det_tensor) {
+        const uint16_t *src = (const uint16_t*)input_frame->data;
+        ocr_tile_map_update(&ai_context.det_tiles, src, ai_context.frame_width);
+        uint32_t bytes = ocr_resize_tiles_to_tensor(plan, quantizer, src, ai_context.frame_width,
+                                                    tensor, &ai_context.det_tiles);
+        ai_context.stats.dirty_tiles = ai_context.det_tiles.dirty_count;
+        ai_context.stats.preprocess_bytes_touched = bytes + ai_context.det_tiles.bytes_scanned;
+        return 0;
+    }
+    
+    // Resize + RGB888/grayscale + normalize + quantize in one pass
+    if (ocr_resize_plan_is_2x(plan)) {
+        ocr_preprocess_rgb565_2x2_to_tensor(quantizer, (const uint16_t*)input_frame->data,
+                                            ai_context.frame_width, tensor);
+    } else {
+        ocr_resize_to_tensor(plan, quantizer, (const uint16_t*)input_frame->data,
+                             ai_context.frame_width, tensor);
     }
     
     return 0;
 }
 
-int ocr_detect_text(const uint8_t *image, text_bbox_t *bboxes, uint32_t max_boxes)
+static uint8_t ai_frame_is_static(const frame_buffer_t *frame)
 {
-    neural_art_result_t result;
+    ocr_frame_signature_t signature;
+    ocr_signature_delta_t delta;
     
-    // Run text detection model on NPU
-    void *detection_output = ai_memory_alloc(1024); // Temporary output buffer
-    if (!detection_output) {
+    if (ai_context.config.change_threshold == 0) {
+        ai_context.last_signature.valid = 0;
+        return 0;
+    }
+    
+    ocr_frame_signature_compute((const uint16_t*)frame->data, ai_context.frame_width,
+                                ai_context.frame_width, ai_context.frame_height, &signature);
+    
+    if (ai_context.last_result_valid && ai_context.last_signature.valid &&
+        ai_context.static_frame_count < ai_context.config.max_static_frames) {
+        ocr_frame_signature_compare(&ai_context.last_signature, &signature,
+                                    ai_context.config.change_threshold, &delta);
+        if (delta.changed_blocks < ai_context.config.change_min_blocks) {
+            // Keep the old reference so slow drift still accumulates
+            ai_context.static_frame_count++;
+            return 1;
+        }
+    }
+    
+    ai_context.last_signature = signature;
+    ai_context.static_frame_count = 0;
+    return 0;
+}
+
+static void ai_camera_line_callback(frame_buffer_t *frame, uint32_t lines_done)
+{
+    // Interrupt context: only publish the frame, the AI task does the work
+    if (lines_done > 0 && ai_context.stream_frame == NULL) {
+        ai_context.stream_frame = frame;
+    }
+}
+
+static int ai_preprocess_streaming(const frame_buffer_t *input_frame, int8_t *tensor)
+{
+    ocr_strip_stream_t *stream = &ai_context.det_stream;
+    uint32_t start_time = hal_get_time_us();
+    
+    ocr_strip_stream_begin(stream, &ai_context.det_resize, &ai_context.det_quantizer,
+                           (const uint16_t*)input_frame->data, ai_context.frame_width, tensor);
+    
+    while (!ocr_strip_stream_done(stream)) {
+        uint32_t lines = input_frame->ready ? ai_context.frame_height : input_frame->lines_ready;
+        
+        if (ocr_strip_stream_feed(stream, lines) == 0) {
+            if (hal_get_time_us() - start_time > CAMERA_TASK_TIMEOUT_MS * 1000U) {
+                return AI_ERROR_INFERENCE_TIMEOUT;
+            }
+            // Next strip is one line event away
+            hal_delay_us(50);
+        }
+    }
+    
+    return 0;
+}
+
+static void ai_estimate_skew(const frame_buffer_t *frame)
+{
+    memset(&ai_context.frame_skew, 0, sizeof(ai_context.frame_skew));
+    if (!ai_context.skew_scratch) {
+        return;
+    }
+    
+    // Edge map on the detection-resolution grid bounds the cost
+    uint32_t start_time = hal_get_time_us();
+    uint16_t step = ai_context.frame_width / ai_context.det_resize.dst_width;
+    ocr_skew_estimate((const uint16_t*)frame->data, ai_context.frame_width,
+                      ai_context.frame_width, ai_context.frame_height,
+                      step ? step : 1, ai_context.skew_scratch, &ai_context.frame_skew);
+    
+    ai_context.stats.skew_time_us = hal_get_time_us() - start_time;
+    ai_context.stats.skew_angle_cdeg = ai_context.frame_skew.angle_cdeg;
+}
+
+const ocr_tile_map_t* ocr_get_dirty_tiles(void)
+{
+    return ai_context.det_tensor ? &ai_context.det_tiles : NULL;
+}
+
+const ocr_prefilter_t* ocr_get_text_prefilter(void)
+{
+    return ai_context.prefilter_storage ? &ai_context.prefilter : NULL;
+}
+
+int ocr_bbox_to_frame(const text_bbox_t *bbox, text_bbox_t *frame_bbox)
+{
+    if (!bbox || !frame_bbox) {
+        return AI_ERROR_INPUT_INVALID;
+    }
+    
+    *frame_bbox = *bbox;
+    ocr_transform_rect_to_source(&ai_context.box_transform,
+                                 &frame_bbox->x, &frame_bbox->y,
+                                 &frame_bbox->width, &frame_bbox->height);
+    
+    if (bbox->has_quad) {
+        for (int i = 0; i < 4; i++) {
+            int32_t qx, qy;
+            ocr_transform_point_to_source(&ai_context.box_transform,
+                                          bbox->quad_x[i], bbox->quad_y[i], &qx, &qy);
+            frame_bbox->quad_x[i] = (int16_t)((qx + 0x8000) >> 16);
+            frame_bbox->quad_y[i] = (int16_t)((qy + 0x8000) >> 16);
+        }
+    }
+    
+    return (frame_bbox->width > 0 && frame_bbox->height > 0) ? 0 : AI_ERROR_INPUT_INVALID;
+}
+
+/**
+ * @brief DBNet head: probability map -> rotated boxes
+ * @return Number of boxes, negative on error
+ */
+static int ai_decode_dbnet(const neural_art_model_t *det, const int8_t *output, ocr_det_boxes_t *boxes)
+{
+    ocr_dbnet_t dbnet;
+    int count = AI_ERROR_INPUT_INVALID;
+    uint32_t scratch_size = ocr_dbnet_size(det->output_width, det->output_height,
+                                           OCR_DBNET_MAX_LABELS);
+    void *scratch = ai_memory_alloc(scratch_size);
+    if (!scratch) {
         return AI_ERROR_MEMORY_ALLOC_FAILED;
     }
     
-    result = neural_art_inference(&ai_context.models[AI_MODEL_TEXT_DETECTION],
-                                 image, detection_output);
+    // Thresholds applied in the int8 domain
+    if (ocr_dbnet_init(&dbnet, det->output_width, det->output_height,
+                       (uint8_t)(det->input_width / det->output_width),
+                       OCR_DBNET_MAX_LABELS, det->output_scale, det->output_zero_point,
+                       scratch, scratch_size) == 0) {
+        count = (int)ocr_dbnet_decode(&dbnet, output, det->output_width, boxes);
+        ai_context.stats.det_components = dbnet.component_count;
+        ai_context.stats.det_dropped_boxes = dbnet.overflow;
+    }
     
-    if (result != NEURAL_ART_SUCCESS) {
-        ai_memory_free(detection_output);
-        return AI_ERROR_NPU_ERROR;
+    ai_memory_free(scratch);
+    return count;
+}
+
+/**
+ * @brief EAST head: score plane followed by NHWC geometry (5 channels) -> rotated boxes
+ * @return Number of boxes, negative on error
+ */
+static int ai_decode_east(const neural_art_model_t *det, const int8_t *output, ocr_det_boxes_t *boxes)
+{
+    ocr_east_t east;
+    int count = AI_ERROR_INPUT_INVALID;
+    const uint32_t plane = (uint32_t)det->output_width * det->output_height;
+    const ocr_east_quant_t quant = {
+        det->output_scale, det->output_zero_point,
+        det->output_geo_scale, det->output_geo_zero_point,
+        det->output_angle_scale, det->output_angle_zero_point,
+    };
+    uint32_t scratch_size = ocr_east_size(OCR_EAST_MAX_CANDIDATES);
+    void *scratch = ai_memory_alloc(scratch_size);
+    if (!scratch) {
+        return AI_ERROR_MEMORY_ALLOC_FAILED;
+    }
+    
+    // Locality-aware NMS: per-pixel geometry merged row by row before rotated NMS
+    if (ocr_east_init(&east, det->output_width, det->output_height,
+                      (uint8_t)(det->input_width / det->output_width),
+                      OCR_EAST_MAX_CANDIDATES, &quant, scratch, scratch_size) == 0) {
+        count = (int)ocr_east_decode(&east, output, 1, output + plane, 5, boxes);
+        ai_context.stats.det_components = east.merged_candidates;
+        ai_context.stats.det_dropped_boxes = east.overflow;
+    }
+    
+    ai_memory_free(scratch);
+    return count;
+}
+
+/**
+ * @brief Models the task runs without: coarse detection and recognition width variants
+ */
+static uint8_t ai_model_is_optional(int model)
+{
+    return model == AI_MODEL_TEXT_DETECTION_COARSE || model >= AI_MODEL_TEXT_RECOGNITION_W80;
+}
+
+/**
+ * @brief Multi-scale mode is usable: enabled, and the coarse model takes the
+ *        2x2-averaged detection tensor and emits a single-channel map
+ */
+static uint8_t ai_multiscale_ready(void)
+{
+    const neural_art_model_t *det = &ai_context.models[AI_MODEL_TEXT_DETECTION];
+    const neural_art_model_t *coarse = &ai_context.models[AI_MODEL_TEXT_DETECTION_COARSE];
+    
+    return ai_context.config.enable_multiscale && coarse->loaded &&
+           coarse->input_width == det->input_width / 2 &&
+           coarse->input_height == det->input_height / 2 &&
+           coarse->input_channels == det->input_channels &&
+           coarse->input_layout == det->input_layout &&
+           coarse->output_width > 0 && coarse->output_height > 0 &&
+           coarse->output_size == (uint32_t)coarse->output_width * coarse->output_height;
+}
+
+/**
+ * @brief Tiled mode is usable: enabled, and the frame needs more than one tile
+ */
+static uint8_t ai_tiled_ready(void)
+{
+    return ai_context.config.enable_tiled_detection && ai_context.det_tiling.count > 1;
+}
+
+/**
+ * @brief Coordinates of this frame's boxes: camera pixels after tiled
+ *        detection, else the detection input grid
+ */
+static void ai_set_box_space(uint8_t tiled)
+{
+    // Track positions do not carry over between coordinate spaces
+    if (ai_context.tracker_storage && tiled != ai_context.boxes_in_frame) {
+        ocr_tracker_reset(&ai_context.tracker);
+    }
+    ai_context.boxes_in_frame = tiled;
+    if (tiled) {
+        ocr_frame_transform_t *identity = &ai_context.box_transform;
+        identity->scale_x_q16 = 1u << 16;
+        identity->scale_y_q16 = 1u << 16;
+        identity->offset_x = 0;
+        identity->offset_y = 0;
+        identity->src_width = ai_context.frame_width;
+        identity->src_height = ai_context.frame_height;
+        ai_context.box_width = ai_context.frame_width;
+        ai_context.box_height = ai_context.frame_height;
+    } else {
+        ai_context.box_transform = ai_context.frame_transform;
+        ai_context.box_width = ai_context.det_quantizer.width;
+        ai_context.box_height = ai_context.det_quantizer.height;
     }
+}
+
+/**
+ * @brief Score the tiles of the detection input for text
+ * @return 1 if detection should run, 0 for a frame without likely text
+ * @details Runs on the first channel of the tensor, one pass over every
+ *          second row (a small fraction of one detection inference)
+ */
+static uint8_t ai_prefilter_frame(const int8_t *tensor)
+{
+    const ocr_tensor_quantizer_t *quantizer = &ai_context.det_quantizer;
+    ai_performance_stats_t *stats = &ai_context.stats;
+    uint8_t nhwc = (quantizer->layout == OCR_TENSOR_LAYOUT_NHWC);
+    uint32_t start_time = hal_get_time_us();
     
-    // Parse detection output (simplified - actual implementation would be more complex)
-    int detected_count = 0;
-    // TODO: Implement proper EAST/CRAFT output parsing
+    stats->prefilter_likely_tiles = ocr_prefilter_run(&ai_context.prefilter, tensor,
+                                                      nhwc ? quantizer->channels : 1,
+                                                      nhwc ? (uint32_t)quantizer->width * quantizer->channels :
+                                                             quantizer->width);
+    uint8_t has_text = ocr_prefilter_has_text(&ai_context.prefilter);
+    
+    stats->prefilter_frames++;
+    stats->prefilter_skips += !has_text;
+    stats->prefilter_skip_percent = stats->prefilter_skips * 100 / stats->prefilter_frames;
+    stats->prefilter_avg_us = (uint32_t)(
+        ((uint64_t)stats->prefilter_avg_us * (stats->prefilter_frames - 1) +
+         (hal_get_time_us() - start_time)) / stats->prefilter_frames);
+    return has_text;
+}
+
+/**
+ * @brief Full-resolution pass, decoded only inside the coarse regions / likely tiles if given
+ * @return Number of boxes, negative on error
+ */
+static int ai_detect_fine(const uint8_t *image, const ocr_det_roi_t *roi,
+                          const ocr_prefilter_t *likely, ocr_det_boxes_t *boxes)
+{
+    const neural_art_model_t *det = &ai_context.models[AI_MODEL_TEXT_DETECTION];
+    neural_art_result_t result;
+    int detected_count;
     
-    // For demo purposes, create a single text region covering most of the image
-    if (max_boxes > 0) {
-        bboxes[0].x = OCR_INPUT_WIDTH / 4;
-        bboxes[0].y = OCR_INPUT_HEIGHT / 4;
-        bboxes[0].width = OCR_INPUT_WIDTH / 2;
-        bboxes[0].height = OCR_INPUT_HEIGHT / 4;
-        bboxes[0].confidence = 0.9f;
-        bboxes[0].text_direction = 0; // Horizontal
-        detected_count = 1;
+    // Pool is LIFO: output, then decoder scratch (freed in reverse)
+    int8_t *detection_output = ai_memory_alloc(det->output_size);
+    if (!detection_output) {
+        return AI_ERROR_MEMORY_ALLOC_FAILED;
+    }
+    
+    // Run text detection model on NPU
+    result = neural_art_inference(det, image, detection_output);
+    if (result != NEURAL_ART_SUCCESS) {
+        detected_count = AI_ERROR_NPU_ERROR;
+    } else {
+        // Decoders write straight into the SoA box storage
+        uint32_t start_time = hal_get_time_us();
+        
+        // Probability / score plane comes first for both heads
+        if (roi) {
+            ocr_det_roi_mask(roi, detection_output, det->output_width,
+                             det->output_width, det->output_height, INT8_MIN);
+        }
+        if (likely) {
+            ocr_prefilter_mask(likely, detection_output, det->output_width,
+                               det->output_width, det->output_height, INT8_MIN);
+        }
+        if (det->output_head == OCR_DET_HEAD_EAST) {
+            detected_count = ai_decode_east(det, detection_output, boxes);
+        } else {
+            detected_count = ai_decode_dbnet(det, detection_output, boxes);
+        }
+        if (detected_count > 0) {
+            // Single glyphs have no long side: settle them from their neighbours
+            ocr_det_classify_direction(boxes, OCR_DET_VERTICAL_RATIO);
+        }
+        ai_context.stats.det_postprocess_time_us = hal_get_time_us() - start_time;
+        if (detected_count >= 0) {
+            ai_context.stats.text_box_overflow += ai_context.stats.det_dropped_boxes;
+            ai_context.stats.det_vertical_boxes = 0;
+            for (uint32_t i = 0; i < boxes->count; i++) {
+                ai_context.stats.det_vertical_boxes += boxes->direction[i];
+            }
+        }
     }
     
     ai_memory_free(detection_output);
     return detected_count;
 }
 
-int ocr_recognize_text(const uint8_t *image, const text_bbox_t *bbox, 
-                      char *text_output, float *confidence)
+/**
+ * @brief Half-resolution pass: find the cells of the frame that hold text
+ * @return Active cells (0 = no text), negative on error
+ */
+static int ai_detect_coarse(const uint8_t *image, ocr_det_roi_t *roi)
 {
-    neural_art_result_t result;
+    const neural_art_model_t *det = &ai_context.models[AI_MODEL_TEXT_DETECTION];
+    const neural_art_model_t *coarse = &ai_context.models[AI_MODEL_TEXT_DETECTION_COARSE];
+    int active = AI_ERROR_NPU_ERROR;
+    
+    int8_t *coarse_input = ai_memory_alloc(coarse->input_size);
+    if (!coarse_input) {
+        return AI_ERROR_MEMORY_ALLOC_FAILED;
+    }
+    int8_t *coarse_output = ai_memory_alloc(coarse->output_size);
+    if (!coarse_output) {
+        ai_memory_free(coarse_input);
+        return AI_ERROR_MEMORY_ALLOC_FAILED;
+    }
+    
+    // Pyramid level from the detection tensor: no second preprocessing pass
+    ocr_downsample_tensor_2x2((const int8_t*)image, det->input_width, det->input_height,
+                              det->input_channels, det->input_layout, coarse_input);
+    
+    if (neural_art_inference(coarse, coarse_input, coarse_output) == NEURAL_ART_SUCCESS) {
+        active = (int)ocr_det_roi_find(roi, coarse_output, coarse->output_width);
+    }
     
-    if (!image || !bbox || !text_output || !confidence) {
+    ai_memory_free(coarse_output);
+    ai_memory_free(coarse_input);
+    return active;
+}
+
+/**
+ * @brief Running average of detection time per frame, per mode
+ */
+static void ai_stats_update_detection(uint8_t pyramid, uint8_t coarse_exit, uint32_t time_us)
+{
+    ai_performance_stats_t *stats = &ai_context.stats;
+    
+    if (pyramid) {
+        stats->det_pyramid_frames++;
+        stats->det_coarse_exits += coarse_exit;
+        stats->det_pyramid_avg_us = (uint32_t)(
+            ((uint64_t)stats->det_pyramid_avg_us * (stats->det_pyramid_frames - 1) + time_us) /
+            stats->det_pyramid_frames);
+        stats->det_coarse_exit_percent = stats->det_coarse_exits * 100 / stats->det_pyramid_frames;
+    } else {
+        stats->det_single_frames++;
+        stats->det_single_avg_us = (uint32_t)(
+            ((uint64_t)stats->det_single_avg_us * (stats->det_single_frames - 1) + time_us) /
+            stats->det_single_frames);
+    }
+}
+
+int ocr_detect_text(const uint8_t *image, ocr_det_boxes_t *boxes)
+{
+    const neural_art_model_t *det = &ai_context.models[AI_MODEL_TEXT_DETECTION];
+    const neural_art_model_t *coarse = &ai_context.models[AI_MODEL_TEXT_DETECTION_COARSE];
+    uint32_t start_time = hal_get_time_us();
+    int detected_count;
+    
+    if (!boxes || boxes->capacity == 0 || det->output_width == 0 || det->output_height == 0) {
         return AI_ERROR_INPUT_INVALID;
     }
     
-    // Extract text region from image
-    uint8_t *region_buffer = ai_memory_alloc(bbox->width * bbox->height * 2);
-    if (!region_buffer) {
+    if (!ai_multiscale_ready()) {
+        detected_count = ai_detect_fine(image, NULL, ai_context.det_likely, boxes);
+        if (detected_count >= 0) {
+            ai_stats_update_detection(0, 0, hal_get_time_us() - start_time);
+        }
+        return detected_count;
+    }
+    
+    // Regions outlive the coarse tensors, so they are allocated first
+    ocr_det_roi_t roi;
+    uint32_t roi_size = ocr_det_roi_size(coarse->output_width, coarse->output_height, OCR_DET_ROI_CELL);
+    void *roi_storage = ai_memory_alloc(roi_size);
+    if (!roi_storage) {
         return AI_ERROR_MEMORY_ALLOC_FAILED;
     }
+    ocr_det_roi_init(&roi, coarse->output_width, coarse->output_height, OCR_DET_ROI_CELL,
+                     OCR_DET_ROI_THRESH, OCR_DET_ROI_MIN_PIXELS,
+                     coarse->output_scale, coarse->output_zero_point, roi_storage, roi_size);
+    
+    detected_count = ai_detect_coarse(image, &roi);
+    if (detected_count > 0) {
+        ai_context.stats.det_coarse_cells = roi.active_cells;
+        detected_count = ai_detect_fine(image, &roi, ai_context.det_likely, boxes);
+        if (detected_count >= 0) {
+            ai_stats_update_detection(1, 0, hal_get_time_us() - start_time);
+        }
+    } else if (detected_count == 0) {
+        // No text anywhere: the full-resolution pass is skipped
+        boxes->count = 0;
+        ai_context.stats.det_coarse_cells = 0;
+        ai_context.stats.det_components = 0;
+        ai_context.stats.det_dropped_boxes = 0;
+        ai_stats_update_detection(1, 1, hal_get_time_us() - start_time);
+    }
+    
+    ai_memory_free(roi_storage);
+    return detected_count;
+}
+
+int ocr_detect_text_tiled(const frame_buffer_t *frame, ocr_det_boxes_t *boxes)
+{
+    const neural_art_model_t *det = &ai_context.models[AI_MODEL_TEXT_DETECTION];
+    const ocr_det_tiling_t *tiling = &ai_context.det_tiling;
+    ai_performance_stats_t *stats = &ai_context.stats;
+    uint32_t start_time = hal_get_time_us();
+    uint32_t seam_boxes = 0, merges = 0, dropped = 0, skipped = 0;
+    int result = 0;
     
-    // Crop region (simplified)
-    uint16_t *src = (uint16_t*)image;
-    uint16_t *dst = (uint16_t*)region_buffer;
+    if (!frame || !frame->data || !boxes || boxes->capacity == 0 || tiling->count == 0 ||
+        det->output_width == 0 || det->output_height == 0) {
+        return AI_ERROR_INPUT_INVALID;
+    }
+    
+    // Pool is LIFO: tags live for the whole frame, one tile tensor is reused
+    uint16_t *tags = ai_memory_alloc(boxes->capacity * sizeof(uint16_t));
+    if (!tags) {
+        return AI_ERROR_MEMORY_ALLOC_FAILED;
+    }
+    int8_t *tile_tensor = ai_memory_alloc(det->input_size);
+    if (!tile_tensor) {
+        ai_memory_free(tags);
+        return AI_ERROR_MEMORY_ALLOC_FAILED;
+    }
     
-    for (int y = 0; y < bbox->height; y++) {
-        for (int x = 0; x < bbox->width; x++) {
-            int src_x = bbox->x + x;
-            int src_y = bbox->y + y;
-            if (src_x < OCR_INPUT_WIDTH && src_y < OCR_INPUT_HEIGHT) {
-                dst[y * bbox->width + x] = src[src_y * OCR_INPUT_WIDTH + src_x];
+    boxes->count = 0;
+    for (uint32_t t = 0; t < tiling->count; t++) {
+        ocr_det_boxes_t tail;
+        uint16_t ox, oy;
+        
+        ocr_det_tiling_origin(tiling, t, &ox, &oy);
+        if (ai_context.det_likely) {
+            // Tile footprint on the detection input the prefilter scored
+            ocr_track_box_t tile_box = {ox, oy, tiling->tile_width, tiling->tile_height};
+            ocr_track_box_t input_box;
+            ai_frame_box_to_input(&tile_box, &input_box);
+            if (!ocr_prefilter_region_likely(ai_context.det_likely, input_box.x, input_box.y,
+                                             input_box.width, input_box.height)) {
+                skipped++;
+                continue;
             }
         }
+        ocr_crop_to_tensor(&ai_context.det_quantizer, (const uint16_t*)frame->data,
+                           ai_context.frame_width, ox, oy, tile_tensor);
+        
+        // Tile boxes fill the free slots, then move to camera pixels; merging
+        // after every tile frees the slots of duplicates for the next one
+        uint32_t first = boxes->count;
+        ocr_det_boxes_tail(boxes, &tail);
+        result = ai_detect_fine((const uint8_t*)tile_tensor, NULL, NULL, &tail);
+        if (result < 0) {
+            break;
+        }
+        boxes->count += tail.count;
+        dropped += stats->det_dropped_boxes;
+        seam_boxes += ocr_det_tiling_place(tiling, t, boxes, first, tags);
+        merges += ocr_det_tiling_merge(tiling, boxes, tags);
     }
     
-    // Run text recognition model
-    char recognition_output[64];
-    result = neural_art_inference(&ai_context.models[AI_MODEL_TEXT_RECOGNITION],
-                                 region_buffer, recognition_output);
+    ai_memory_free(tile_tensor);
+    ai_memory_free(tags);
+    if (result < 0) {
+        boxes->count = 0;
+        return result;
+    }
     
-    if (result == NEURAL_ART_SUCCESS) {
-        // Parse recognition output (simplified - actual would decode CTC output)
-        strncpy(text_output, "Sample Text", 63); // Demo output
-        text_output[63] = '\0';
-        *confidence = 0.92f; // Demo confidence
-    } else {
-        text_output[0] = '\0';
-        *confidence = 0.0f;
-        ai_memory_free(region_buffer);
-        return AI_ERROR_NPU_ERROR;
+    stats->det_dropped_boxes = dropped;
+    stats->det_vertical_boxes = 0;
+    for (uint32_t i = 0; i < boxes->count; i++) {
+        stats->det_vertical_boxes += boxes->direction[i];
+    }
+    stats->det_tiles = tiling->count;
+    stats->det_seam_boxes = seam_boxes;
+    stats->det_seam_merges = merges;
+    stats->det_tiles_skipped = skipped;
+    stats->det_tiled_frames++;
+    stats->det_tiled_avg_us = (uint32_t)(
+        ((uint64_t)stats->det_tiled_avg_us * (stats->det_tiled_frames - 1) +
+         (hal_get_time_us() - start_time)) / stats->det_tiled_frames);
+    
+    return (int)boxes->count;
+}
+
+int ocr_recognize_text(const frame_buffer_t *frame, const text_bbox_t *bbox,
+                      char *text_output, float *confidence)
+{
+    if (!frame || !frame->data || !bbox || !text_output || !confidence) {
+        return AI_ERROR_INPUT_INVALID;
+    }
+    text_output[0] = '\0';
+    *confidence = 0.0f;
+    
+    ai_crop_plan_t plan;
+    ai_region_result_t region;
+    region.status = ai_plan_region(bbox, &plan);
+    if (region.status != 0) {
+        return region.status;
     }
     
-    ai_memory_free(region_buffer);
+    // A batch of one, in the narrowest bucket the strip fits
+    uint32_t bucket = (uint32_t)ocr_rec_buckets_select(&ai_context.rec_buckets, plan.width);
+    const neural_art_model_t *rec = &ai_context.models[ai_context.rec_buckets.bucket[bucket].model];
+    uint32_t batch_size = ocr_rec_batch_size(rec->input_size, rec->output_size, 1);
+    void *batch_storage = ai_memory_alloc(batch_size);
+    if (!batch_storage) {
+        return AI_ERROR_MEMORY_ALLOC_FAILED;
+    }
+    ocr_rec_batch_t batch;
+    ocr_rec_batch_init(&batch, rec->input_size, rec->output_size, 1, batch_storage, batch_size);
+    ai_stage_region(frame, &plan, &ai_context.rec_quantizer[bucket], ocr_rec_batch_next(&batch));
+    ocr_rec_batch_push(&batch, 0);
+    ai_recognize_batch(bucket, &batch, &region);
+    ai_memory_free(batch_storage);
+    
+    if (region.status == 0) {
+        strcpy(text_output, region.text);
+        *confidence = region.confidence;
+    }
+    return region.status;
+}
+
+/**
+ * @brief Crop geometry of one box: how it is cropped and the strip it becomes
+ * @details Height-normalized strip (deskewed, rectified or rotated as the box
+ *          needs), at most as long as the widest recognition bucket
+ */
+static int ai_plan_region(const text_bbox_t *bbox, ai_crop_plan_t *plan)
+{
+    const uint32_t space_w = ai_context.box_width;
+    const uint32_t space_h = ai_context.box_height;
+    const uint16_t max_width = ocr_rec_buckets_max_width(&ai_context.rec_buckets);
+    
+    // Clip box to its coordinate space; the crop itself is staged later
+    uint32_t crop_x = bbox->x;
+    uint32_t crop_y = bbox->y;
+    if (crop_x >= space_w || crop_y >= space_h) {
+        return AI_ERROR_INPUT_INVALID;
+    }
+    uint32_t crop_w = (crop_x + bbox->width > space_w) ? space_w - crop_x : bbox->width;
+    uint32_t crop_h = (crop_y + bbox->height > space_h) ? space_h - crop_y : bbox->height;
+    
+    // Skewed line: the box encloses a rotated strip, crop the strip itself
+    // (the estimate follows horizontal lines; tategaki columns are cropped level)
+    const ocr_skew_t *skew = &ai_context.frame_skew;
+    uint8_t vertical = bbox->text_direction;
+    uint8_t deskew = !vertical && ai_context.skew_scratch && skew->confidence >= OCR_DESKEW_MIN_CONFIDENCE &&
+                     (skew->angle_cdeg >= OCR_DESKEW_MIN_ANGLE_CDEG ||
+                      skew->angle_cdeg <= -OCR_DESKEW_MIN_ANGLE_CDEG);
+    uint16_t region_w = (uint16_t)crop_w;
+    uint16_t region_h = (uint16_t)crop_h;
+    
+    // Quad from the detector: rectify into a height-normalized strip instead.
+    // Level quads are plain boxes and take the exact crop-resize path below.
+    // Tile boxes are camera pixels already, so they always crop at full resolution
+    uint8_t fullres = ai_context.config.enable_fullres_crop || ai_context.boxes_in_frame;
+    if (bbox->has_quad && !(fullres && ai_quad_is_level(bbox))) {
+        float quad_x[4], quad_y[4];
+        for (int i = 0; i < 4; i++) {
+            int32_t qx, qy;
+            ocr_transform_point_to_source(&ai_context.box_transform,
+                                          bbox->quad_x[i], bbox->quad_y[i], &qx, &qy);
+            quad_x[i] = qx * (1.0f / 65536.0f);
+            quad_y[i] = qy * (1.0f / 65536.0f);
+        }
+        uint16_t strip_w = ocr_quad_strip_width(quad_x, quad_y, OCR_STRIP_HEIGHT, max_width);
+        if (strip_w > 0 &&
+            ocr_perspective_from_quad(&plan->persp, quad_x, quad_y, strip_w, OCR_STRIP_HEIGHT) == 0) {
+            plan->mode = AI_CROP_QUAD;
+            plan->width = strip_w;
+            plan->height = OCR_STRIP_HEIGHT;
+            return 0;
+        }
+    }
+    if (deskew) {
+        ocr_deskew_extent((uint16_t)crop_w, (uint16_t)crop_h, skew->angle_cdeg, &region_w, &region_h);
+    }
+    
+    // Box in camera frame pixels (scaled from the detection input grid)
+    text_bbox_t frame_box;
+    text_bbox_t clipped = *bbox;
+    clipped.width = (uint16_t)crop_w;
+    clipped.height = (uint16_t)crop_h;
+    clipped.has_quad = 0;
+    ocr_bbox_to_frame(&clipped, &frame_box);
+    if (frame_box.x >= ai_context.frame_width || frame_box.y >= ai_context.frame_height ||
+        frame_box.width == 0 || frame_box.height == 0) {
+        return AI_ERROR_INPUT_INVALID;
+    }
+    if (frame_box.x + frame_box.width > ai_context.frame_width) {
+        frame_box.width = ai_context.frame_width - frame_box.x;
+    }
+    if (frame_box.y + frame_box.height > ai_context.frame_height) {
+        frame_box.height = ai_context.frame_height - frame_box.y;
+    }
+    float sample_scale = (float)frame_box.width / (float)crop_w;  // Frame pixels per region pixel
+    
+    // Full resolution: line thickness normalized to the strip height, so
+    // small glyphs are enlarged from camera pixels instead of detection pixels
+    if (fullres) {
+        float line_w = (deskew ? region_w : crop_w) * sample_scale;
+        float line_h = (deskew ? region_h : crop_h) * sample_scale;
+        float thickness = (line_w < line_h) ? line_w : line_h;
+        float length = (line_w < line_h) ? line_h : line_w;
+        sample_scale = thickness / OCR_STRIP_HEIGHT;
+        if (length / sample_scale > max_width) {
+            sample_scale = length / max_width;
+        }
+        region_w = (uint16_t)(line_w / sample_scale + 0.5f);
+        region_h = (uint16_t)(line_h / sample_scale + 0.5f);
+        region_w = region_w ? region_w : 1;
+        region_h = region_h ? region_h : 1;
+    
+        // Tategaki: the column is turned into a strip read left to right
+        if (vertical) {
+            uint16_t length = region_h;
+            region_h = region_w;
+            region_w = length;
+        }
+    }
+    
+    if (deskew) {
+        // Rotate-and-crop around the box center, one sampling grid
+        ocr_affine_rotate_crop(&plan->affine,
+                               frame_box.x + 0.5f * (frame_box.width - 1),
+                               frame_box.y + 0.5f * (frame_box.height - 1),
+                               skew->angle_cdeg, sample_scale, region_w, region_h);
+        plan->mode = AI_CROP_AFFINE;
+    } else {
+        // Tategaki column read top to bottom (same strip as a vertical quad),
+        // or height-normalized / detection grid size crop
+        plan->box_x = frame_box.x;
+        plan->box_y = frame_box.y;
+        plan->box_width = frame_box.width;
+        plan->box_height = frame_box.height;
+        plan->mode = (fullres && vertical) ? AI_CROP_ROTATE90 : AI_CROP_BOX;
+    }
+    plan->width = region_w;
+    plan->height = region_h;
     return 0;
 }
 
+/**
+ * @brief Crop one planned box from the camera frame into a recognition input
+ * @details Crop, resize and quantization with the quantizer of the bucket in
+ *          one pass, straight into the batch slot (no intermediate strip)
+ */
+static void ai_stage_region(const frame_buffer_t *frame, const ai_crop_plan_t *plan,
+                            const ocr_tensor_quantizer_t *quantizer, int8_t *input)
+{
+    const uint16_t *src = (const uint16_t*)frame->data;
+    
+    switch (plan->mode) {
+        case AI_CROP_QUAD:
+            ocr_warp_perspective_to_tensor(quantizer, src, ai_context.frame_width,
+                                           ai_context.frame_width, ai_context.frame_height, &plan->persp,
+                                           plan->width, plan->height, input);
+            break;
+        case AI_CROP_BOX:
+            ocr_crop_resize_to_tensor(quantizer, src, ai_context.frame_width,
+                                      ai_context.frame_width, ai_context.frame_height,
+                                      plan->box_x, plan->box_y, plan->box_width, plan->box_height,
+                                      plan->width, plan->height, input);
+            break;
+        case AI_CROP_ROTATE90:
+            ocr_crop_rotate90_to_tensor(quantizer, src, ai_context.frame_width,
+                                        ai_context.frame_width, ai_context.frame_height,
+                                        plan->box_x, plan->box_y, plan->box_width, plan->box_height,
+                                        plan->width, plan->height, input);
+            break;
+        default:
+            ocr_warp_affine_to_tensor(quantizer, src, ai_context.frame_width,
+                                      ai_context.frame_width, ai_context.frame_height, &plan->affine,
+                                      plan->width, plan->height, input);
+            break;
+    }
+}
+
+/**
+ * @brief One inference over the staged crops, outputs decoded back to their boxes
+ */
+static void ai_recognize_batch(uint32_t bucket, ocr_rec_batch_t *batch, ai_region_result_t *regions)
+{
+    const ai_model_type_t model_type = (ai_model_type_t)ai_context.rec_buckets.bucket[bucket].model;
+    const neural_art_model_t *rec = &ai_context.models[model_type];
+    const uint32_t timesteps = (uint32_t)rec->output_width * rec->output_height;
+    uint32_t start_time = hal_get_time_us();
+    
+    int result = neural_art_inference_batch(model_type, batch->input, batch->output, batch->count);
+    
+    for (uint32_t slot = 0; slot < batch->count; slot++) {
+        ai_region_result_t *region = &regions[batch->tag[slot]];
+        region->text[0] = '\0';
+        region->confidence = 0.0f;
+        region->status = AI_ERROR_NPU_ERROR;
+        if (result != NEURAL_ART_SUCCESS) {
+            continue;
+        }
+    
+        // Timestep-major int8 scores, decoded in place
+        const int8_t *output = ocr_rec_batch_output(batch, slot);
+        ocr_ctc_result_t decoded;
+        uint32_t decode_start = hal_get_time_us();
+        int bytes;
+        if (ai_context.rec_beam_storage) {
+            bytes = ocr_beam_decode(&ai_context.rec_beam, output, timesteps,
+                                    region->text, OCR_REGION_TEXT_LENGTH, &decoded);
+            ai_context.stats.rec_lexicon_fallbacks += ai_context.rec_beam.fallback;
+        } else {
+            bytes = ocr_ctc_greedy(&ai_context.rec_ctc, output, timesteps,
+                                   region->text, OCR_REGION_TEXT_LENGTH, &decoded);
+        }
+        if (bytes >= 0) {
+            region->confidence = decoded.confidence;
+            region->status = 0;
+            ai_context.stats.rec_truncated += decoded.truncated;
+        }
+        ai_context.stats.rec_decode_time_us = hal_get_time_us() - decode_start;
+    }
+    
+    // Inference and decoding amortized over the boxes of the batch
+    ai_context.stats.rec_batches++;
+    ai_context.stats.rec_bucket_boxes[bucket] += batch->count;
+    ai_context.stats.rec_box_us[batch->count - 1] = (hal_get_time_us() - start_time) / batch->count;
+    ocr_rec_batch_clear(batch);
+}
+
+/**
+ * @brief Recognize the boxes of a frame
+ * @details Boxes whose track still holds their text are answered first; the
+ *          rest go to the narrowest width bucket their strip fits. Each bucket
+ *          is sampled from the frame straight into batches sized for the
+ *          activation budget left for recognition, one inference per batch.
+ *          A box that cannot be planned or inferred keeps its AI_ERROR_* status
+ */
+static int ai_recognize_regions(const frame_buffer_t *frame, const int8_t *tensor,
+                                const ocr_det_boxes_t *boxes, const ocr_track_box_t *track_boxes,
+                                const uint16_t *track_of, ai_region_result_t *regions)
+{
+    const ocr_rec_buckets_t *buckets = &ai_context.rec_buckets;
+    uint32_t pending[OCR_REC_MAX_BUCKETS] = {0};
+    int8_t signature[OCR_TRACK_SIG_LENGTH];
+    text_bbox_t bbox;
+    
+    for (uint32_t i = 0; i < boxes->count; i++) {
+        ai_region_result_t *region = &regions[i];
+        region->text[0] = '\0';
+        region->confidence = 0.0f;
+        region->status = 0;
+        region->fresh = 1;
+        if (track_of) {
+            ai_track_signature(tensor, &track_boxes[i], signature);
+            const ocr_track_t *cached = ocr_tracker_lookup(&ai_context.tracker, track_of[i],
+                                                           &track_boxes[i], signature);
+            if (cached) {
+                strcpy(region->text, cached->text);
+                region->confidence = cached->confidence;
+                region->fresh = 0;
+                continue;
+            }
+        }
+    
+        // Strip width known from the geometry alone: route to its bucket
+        ai_get_text_bbox(boxes, i, &bbox);
+        region->status = ai_plan_region(&bbox, &region->plan);
+        if (region->status == 0) {
+            region->bucket = (uint8_t)ocr_rec_buckets_select(buckets, region->plan.width);
+            pending[region->bucket]++;
+        }
+    }
+    
+    // One bucket at a time, so each gets the whole activation budget
+    int status = 0;
+    for (uint32_t b = 0; b < buckets->count; b++) {
+        if (pending[b] == 0) {
+            continue;
+        }
+        const neural_art_model_t *rec = &ai_context.models[buckets->bucket[b].model];
+    
+        // Batch size: model batch, configured cap, boxes left, and what the pool holds
+        uint32_t free_bytes = 0;
+        ai_memory_get_stats(NULL, &free_bytes, NULL);
+        uint32_t budget = (free_bytes > AI_POOL_ALLOC_SLACK) ? free_bytes - AI_POOL_ALLOC_SLACK : 0;
+        uint32_t max_batch = rec->max_batch;
+        if (ai_context.config.rec_max_batch && ai_context.config.rec_max_batch < max_batch) {
+            max_batch = ai_context.config.rec_max_batch;
+        }
+        max_batch = (pending[b] < max_batch) ? pending[b] : max_batch;
+        uint32_t capacity = ocr_rec_batch_plan(rec->input_size, rec->output_size, max_batch, budget);
+        uint32_t batch_size = ocr_rec_batch_size(rec->input_size, rec->output_size, capacity);
+        void *batch_storage = batch_size ? ai_memory_alloc(batch_size) : NULL;
+        ai_context.stats.rec_batch_size = batch_storage ? capacity : 0;
+        if (!batch_storage) {
+            for (uint32_t i = 0; i < boxes->count; i++) {
+                if (regions[i].fresh && regions[i].status == 0 && regions[i].bucket == b) {
+                    regions[i].status = AI_ERROR_MEMORY_ALLOC_FAILED;
+                }
+            }
+            status = AI_ERROR_MEMORY_ALLOC_FAILED;
+            continue;
+        }
+    
+        ocr_rec_batch_t batch;
+        ocr_rec_batch_init(&batch, rec->input_size, rec->output_size, capacity, batch_storage, batch_size);
+        for (uint32_t i = 0; i < boxes->count; i++) {
+            if (!regions[i].fresh || regions[i].status != 0 || regions[i].bucket != b) {
+                continue;
+            }
+            ai_stage_region(frame, &regions[i].plan, &ai_context.rec_quantizer[b],
+                            ocr_rec_batch_next(&batch));
+            ocr_rec_batch_push(&batch, (uint16_t)i);
+            if (batch.count == batch.capacity) {
+                ai_recognize_batch(b, &batch, regions);
+            }
+        }
+        if (batch.count > 0) {
+            ai_recognize_batch(b, &batch, regions);
+        }
+        ai_memory_free(batch_storage);
+    }
+    
+    // New text goes to the tracks
+    if (track_of) {
+        for (uint32_t i = 0; i < boxes->count; i++) {
+            if (regions[i].fresh && regions[i].status == 0 && regions[i].confidence > 0.5f) {
+                ai_track_signature(tensor, &track_boxes[i], signature);
+                ocr_tracker_store(&ai_context.tracker, track_of[i], &track_boxes[i], signature,
+                                  regions[i].text, regions[i].confidence);
+            }
+        }
+    }
+    return status;
+}
+
+/**
+ * @brief Camera-pixel box -> detection input grid (inverse of frame_transform)
+ */
+static void ai_frame_box_to_input(const ocr_track_box_t *box, ocr_track_box_t *input_box)
+{
+    const ocr_frame_transform_t *t = &ai_context.frame_transform;
+    const ocr_tensor_quantizer_t *quantizer = &ai_context.det_quantizer;
+    uint32_t x0 = (uint32_t)(((uint64_t)box->x << 16) / t->scale_x_q16) + t->offset_x;
+    uint32_t y0 = (uint32_t)(((uint64_t)box->y << 16) / t->scale_y_q16) + t->offset_y;
+    uint32_t x1 = (uint32_t)((((uint64_t)(box->x + box->width) << 16) + t->scale_x_q16 - 1) /
+                             t->scale_x_q16) + t->offset_x;
+    uint32_t y1 = (uint32_t)((((uint64_t)(box->y + box->height) << 16) + t->scale_y_q16 - 1) /
+                             t->scale_y_q16) + t->offset_y;
+    
+    x0 = (x0 < quantizer->width) ? x0 : quantizer->width - 1u;
+    y0 = (y0 < quantizer->height) ? y0 : quantizer->height - 1u;
+    x1 = (x1 < quantizer->width) ? x1 : quantizer->width;
+    y1 = (y1 < quantizer->height) ? y1 : quantizer->height;
+    input_box->x = (uint16_t)x0;
+    input_box->y = (uint16_t)y0;
+    input_box->width = (uint16_t)((x1 > x0) ? x1 - x0 : 1);
+    input_box->height = (uint16_t)((y1 > y0) ? y1 - y0 : 1);
+}
+
+/**
+ * @brief Crop signature of a box, compared against its track's cache
+ * @details Taken from the first channel of the detection input; tile boxes
+ *          (camera pixels) are mapped onto it first
+ */
+static void ai_track_signature(const int8_t *tensor, const ocr_track_box_t *box,
+                               int8_t signature[OCR_TRACK_SIG_LENGTH])
+{
+    const ocr_tensor_quantizer_t *quantizer = &ai_context.det_quantizer;
+    uint8_t nhwc = (quantizer->layout == OCR_TENSOR_LAYOUT_NHWC);
+    ocr_track_box_t input_box = *box;
+    
+    if (ai_context.boxes_in_frame) {
+        ai_frame_box_to_input(box, &input_box);
+    }
+    ocr_track_signature(tensor, nhwc ? quantizer->channels : 1,
+                        nhwc ? (uint32_t)quantizer->width * quantizer->channels : quantizer->width,
+                        &input_box, signature);
+}
+
 // ========================================================================
 // Performance Monitoring
 // ========================================================================
@@ -580,6 +2203,11 @@ static void ai_performance_monitor_task(void)
         hal_debug_printf("[AI_TASK] PERF WARNING: Low NPU utilization %d%%\n", npu_utilization);
     }
     
+    if (ai_context.stats.frames_received > 0) {
+        ai_context.stats.skip_rate_percent = (uint32_t)(
+            (uint64_t)ai_context.stats.frames_skipped * 100 / ai_context.stats.frames_received);
+    }
+    
     // Log periodic performance summary
     if (ai_context.config.debug_enabled) {
         hal_debug_printf("[AI_TASK] PERF: %d inferences, avg %dμs, NPU %d%%, mem %dKB\n",
@@ -587,6 +2215,96 @@ static void ai_performance_monitor_task(void)
                        ai_context.stats.avg_inference_time_us,
                        npu_utilization,
                        memory_used / 1024);
+        hal_debug_printf("[AI_TASK] GATE: %d/%d frames skipped (%d%%), NPU time saved %dms\n",
+                       ai_context.stats.frames_skipped,
+                       ai_context.stats.frames_received,
+                       ai_context.stats.skip_rate_percent,
+                       ai_context.stats.npu_time_saved_us / 1000);
+        if (ai_context.det_tensor) {
+            hal_debug_printf("[AI_TASK] TILES: %d/%d dirty, %d bytes touched\n",
+                           ai_context.stats.dirty_tiles,
+                           ai_context.det_tiles.tiles_x * ai_context.det_tiles.tiles_y,
+                           ai_context.stats.preprocess_bytes_touched);
+        }
+        if (ai_context.config.enable_preprocessing) {
+            hal_debug_printf("[AI_TASK] ADAPTIVE: %dμs per frame\n", ai_context.stats.adaptive_time_us);
+        }
+        if (ai_context.config.enable_deskew) {
+            hal_debug_printf("[AI_TASK] SKEW: %.2f deg (conf %d), %dμs per frame\n",
+                           ai_context.stats.skew_angle_cdeg / 100.0f,
+                           ai_context.frame_skew.confidence,
+                           ai_context.stats.skew_time_us);
+        }
+        hal_debug_printf("[AI_TASK] DETECT: %d candidates, %d boxes dropped, %dμs postprocess\n",
+                       ai_context.stats.det_components,
+                       ai_context.stats.det_dropped_boxes,
+                       ai_context.stats.det_postprocess_time_us);
+        hal_debug_printf("[AI_TASK] BOXES: capacity %d, %d lost to the cap\n",
+                       ai_context.stats.text_box_capacity,
+                       ai_context.stats.text_box_overflow);
+        if (ai_context.stats.det_pyramid_frames > 0) {
+            hal_debug_printf("[AI_TASK] PYRAMID: %d/%d frames ended at the coarse pass (%d%%), %d cells last frame\n",
+                           ai_context.stats.det_coarse_exits,
+                           ai_context.stats.det_pyramid_frames,
+                           ai_context.stats.det_coarse_exit_percent,
+                           ai_context.stats.det_coarse_cells);
+        }
+        hal_debug_printf("[AI_TASK] DETECT TIME: %dμs/frame pyramid (%d frames), %dμs/frame single scale (%d frames)\n",
+                       ai_context.stats.det_pyramid_avg_us,
+                       ai_context.stats.det_pyramid_frames,
+                       ai_context.stats.det_single_avg_us,
+                       ai_context.stats.det_single_frames);
+        if (ai_context.stats.det_tiled_frames > 0) {
+            hal_debug_printf("[AI_TASK] TILED: %d tiles (%d skipped), %dμs/frame (%d frames), %d seam boxes, %d merged\n",
+                           ai_context.stats.det_tiles,
+                           ai_context.stats.det_tiles_skipped,
+                           ai_context.stats.det_tiled_avg_us,
+                           ai_context.stats.det_tiled_frames,
+                           ai_context.stats.det_seam_boxes,
+                           ai_context.stats.det_seam_merges);
+        }
+        if (ai_context.stats.prefilter_frames > 0) {
+            hal_debug_printf("[AI_TASK] PREFILTER: %d/%d frames skipped detection (%d%%), %dμs/frame, %d likely tiles\n",
+                           ai_context.stats.prefilter_skips,
+                           ai_context.stats.prefilter_frames,
+                           ai_context.stats.prefilter_skip_percent,
+                           ai_context.stats.prefilter_avg_us,
+                           ai_context.stats.prefilter_likely_tiles);
+        }
+        hal_debug_printf("[AI_TASK] LAYOUT: %d lines, %d blocks, %d columns, %d vertical boxes, %dμs\n",
+                       ai_context.stats.layout_lines,
+                       ai_context.stats.layout_blocks,
+                       ai_context.stats.layout_columns,
+                       ai_context.stats.det_vertical_boxes,
+                       ai_context.stats.layout_time_us);
+        if (ai_context.tracker_storage) {
+            hal_debug_printf("[AI_TASK] TRACK: %d tracks, %d crops reused, %d recognized (%d%% saved)\n",
+                           ai_context.stats.track_active,
+                           ai_context.stats.track_reused,
+                           ai_context.stats.track_recognitions,
+                           ai_context.stats.track_saved_percent);
+        }
+        hal_debug_printf("[AI_TASK] DECODE: %dμs/region, %d regions truncated\n",
+                       ai_context.stats.rec_decode_time_us,
+                       ai_context.stats.rec_truncated);
+        hal_debug_printf("[AI_TASK] REC BATCH: %d slots, %d inferences\n",
+                       ai_context.stats.rec_batch_size,
+                       ai_context.stats.rec_batches);
+        for (uint32_t b = 0; b < OCR_REC_MAX_BATCH; b++) {
+            if (ai_context.stats.rec_box_us[b]) {
+                hal_debug_printf("[AI_TASK]   batch %2d: %dμs/box\n", b + 1, ai_context.stats.rec_box_us[b]);
+            }
+        }
+        for (uint32_t b = 0; b < ai_context.rec_buckets.count; b++) {
+            hal_debug_printf("[AI_TASK] REC WIDTH %3d: %d crops\n",
+                           ai_context.rec_buckets.bucket[b].width,
+                           ai_context.stats.rec_bucket_boxes[b]);
+        }
+        if (ai_context.rec_beam_storage) {
+            hal_debug_printf("[AI_TASK] BEAM: width %d, %d regions outside the lexicon\n",
+                           ai_context.rec_beam.width,
+                           ai_context.stats.rec_lexicon_fallbacks);
+        }
     }
 }
 
@@ -633,7 +2351,8 @@ int ai_get_result(ocr_result_t *result)
     }
     
     // Copy last result (simplified - should use proper result queue)
-    memcpy(result, ai_context.result_buffer, sizeof(ocr_result_t));
+    // Static frames skipped by the change gate keep this result current
+    memcpy(result, &ai_context.last_result, sizeof(ocr_result_t));
     return 0;
 }
 
@@ -653,6 +2372,9 @@ int ai_self_test(void)
     
     // Test 2: Model loading
     for (int i = 0; i < AI_MODEL_COUNT; i++) {
+        if (ai_model_is_optional(i) && !ai_context.models[i].model_data) {
+            continue;
+        }
         if (!ai_context.models[i].loaded) {
             hal_debug_printf("[AI_TASK] Self-test FAIL: Model %d not loaded\n", i);
             return -2;
@@ -11,6 +11,19 @@
 
 #include "utron_config.h"
 #include "camera_task.h"
+#include "ocr_preprocess.h"
+#include "ocr_frame_diff.h"
+#include "ocr_binarize.h"
+#include "ocr_geometry.h"
+#include "ocr_textdet.h"
+#include "ocr_layout.h"
+#include "ocr_track.h"
+#include "ocr_prefilter.h"
+#include "ocr_ctc.h"
+#include "ocr_lexicon.h"
+#include "ocr_beam.h"
+#include "ocr_rec_batch.h"
+#include "ocr_rec_bucket.h"
 
 // Neural-ART NPU configuration
 #define NPU_FREQUENCY_HZ      1000000000U  // 1GHz
@@ -25,8 +38,18 @@
 // OCR model configuration
 #define OCR_INPUT_WIDTH       320   // Optimized for NPU
 #define OCR_INPUT_HEIGHT      240   // Optimized for NPU
+#define OCR_COARSE_INPUT_WIDTH  (OCR_INPUT_WIDTH / 2)   // Coarse detection pass (multi-scale mode)
+#define OCR_COARSE_INPUT_HEIGHT (OCR_INPUT_HEIGHT / 2)
 #define OCR_MAX_TEXT_LENGTH   256   // Maximum recognized text
 #define OCR_MIN_CONFIDENCE    0.95f // >95% accuracy target
+#define OCR_MAX_TEXT_BOXES    256   // Default hard cap on text boxes per frame
+#define OCR_MAX_RESULT_LINES  32    // Lines kept in the structured result
+#define OCR_REC_CLASSES       6625  // CTC blank + 6,623 dictionary characters + ' ' (PP-OCR Japanese)
+#define OCR_REGION_TEXT_LENGTH 64   // Recognized text per region, terminator included
+
+// Deskew before recognition
+#define OCR_DESKEW_MIN_ANGLE_CDEG  50   // Below 0.5 degrees the axis-aligned crop is kept
+#define OCR_DESKEW_MIN_CONFIDENCE  20   // Weaker projection peaks are not trusted
 
 // Memory pool configuration  
 #define AI_MEMORY_POOL_SIZE   NPU_MAX_MEMORY_BYTES
@@ -35,9 +58,13 @@
 
 // Neural-ART model types
 typedef enum {
-    AI_MODEL_TEXT_DETECTION = 0,    // EAST/CRAFT text detection
+    AI_MODEL_TEXT_DETECTION = 0,    // DBNet/EAST text detection
     AI_MODEL_TEXT_RECOGNITION,      // CRNN text recognition  
     AI_MODEL_PREPROCESSING,         // Image preprocessing
+    AI_MODEL_TEXT_DETECTION_COARSE, // Half-resolution text/no-text pass (multi-scale mode, optional)
+    AI_MODEL_TEXT_RECOGNITION_W80,  // Recognition width variants (optional, see ocr_rec_bucket.h)
+    AI_MODEL_TEXT_RECOGNITION_W160,
+    AI_MODEL_TEXT_RECOGNITION_W640,
     AI_MODEL_COUNT
 } ai_model_type_t;
 
@@ -58,22 +85,38 @@ typedef enum {
     AI_PRECISION_FLOAT32   // Debug mode only
 } ai_precision_t;
 
+// One recognized line of the result, in reading order
+typedef struct {
+    uint16_t text_offset;           // Start of the line in ocr_result_t.text
+    uint16_t text_length;           // Bytes, without the trailing newline
+    uint16_t block;                 // Block (paragraph) index
+    uint8_t column;                 // Column within its section of the page
+    uint8_t direction;              // 0=horizontal, 1=vertical
+    float confidence;               // Mean confidence of its recognized words
+} ocr_line_t;
+
 // OCR result structure
 typedef struct {
-    char text[OCR_MAX_TEXT_LENGTH];  // Recognized text
+    char text[OCR_MAX_TEXT_LENGTH];  // Recognized text: words joined by ' ', lines by '\n'
     float confidence;                // Overall confidence score
     uint32_t char_count;            // Number of characters
     uint32_t word_count;            // Number of words
     uint32_t bbox_count;            // Number of bounding boxes
     uint32_t timestamp;             // Inference timestamp
     uint8_t language_detected;      // 0=Japanese, 1=English, 2=Mixed
+    ocr_line_t lines[OCR_MAX_RESULT_LINES]; // Lines in reading order
+    uint16_t line_count;
+    uint16_t block_count;
 } ocr_result_t;
 
 // Bounding box structure for detected text
 typedef struct {
-    uint16_t x, y, width, height;   // Rectangle coordinates
+    uint16_t x, y, width, height;   // Rectangle coordinates (bounds of the quad if present)
     float confidence;               // Detection confidence
-    uint8_t text_direction;         // 0=horizontal, 1=vertical
+    uint8_t text_direction;         // 0=horizontal, 1=vertical (tategaki, read top to bottom)
+    uint8_t has_quad;               // Rotated / perspective text: quad below is valid
+    int16_t quad_x[4];              // Corners TL, TR, BR, BL along the reading direction
+    int16_t quad_y[4];
 } text_bbox_t;
 
 // Neural-ART model handle
@@ -84,7 +127,33 @@ typedef struct {
     ai_precision_t precision;       // Current precision mode
     uint32_t input_size;            // Input tensor size
     uint32_t output_size;           // Output tensor size
+    uint8_t max_batch;              // Inputs per inference (batch dimension of the compiled model)
+    uint8_t recognizer;             // CTC recognition model: a width bucket of input_width
     uint8_t loaded;                 // Model loaded flag
+    
+    // Input tensor metadata (from the converted model)
+    uint16_t input_width;           // Input tensor width
+    uint16_t input_height;          // Input tensor height
+    uint8_t input_channels;         // 1=grayscale, 3=RGB
+    uint8_t input_layout;           // ocr_tensor_layout_t
+    float input_scale;              // Input quantization scale
+    int32_t input_zero_point;       // Input quantization zero point
+    float input_mean[3];            // Normalization mean (0..1 pixel range)
+    float input_std[3];             // Normalization standard deviation
+    
+    // Output tensor metadata (first output)
+    uint16_t output_width;          // Output map width
+    uint16_t output_height;         // Output map height
+    uint16_t output_channels;       // Output channels (recognition: classes per timestep)
+    float output_scale;             // Output quantization scale
+    int32_t output_zero_point;      // Output quantization zero point
+    
+    // Detection head (text detection model)
+    uint8_t output_head;            // ocr_det_head_t
+    float output_geo_scale;         // EAST distance channels (input pixels)
+    int32_t output_geo_zero_point;
+    float output_angle_scale;       // EAST angle channel (radians)
+    int32_t output_angle_zero_point;
 } neural_art_model_t;
 
 // AI task performance statistics
@@ -108,12 +177,104 @@ typedef struct {
     float avg_confidence_score;
     uint32_t low_confidence_count;  // Below threshold
     uint32_t character_accuracy;    // Character-level accuracy
+    
+    // Change-detection gate
+    uint32_t frames_received;       // Frames seen by the AI task
+    uint32_t frames_skipped;        // Static frames, OCR not run
+    uint32_t skip_rate_percent;     // frames_skipped / frames_received
+    uint32_t npu_time_saved_us;     // Skipped frames x average inference time
+    
+    // Dirty-tile preprocessing (last frame)
+    uint32_t dirty_tiles;           // Tiles recomputed
+    uint32_t preprocess_bytes_touched; // Source scanned/read + tensor written
+    
+    // Adaptive preprocessing stage (last frame)
+    uint32_t adaptive_time_us;
+    
+    // Skew estimation (last frame)
+    uint32_t skew_time_us;
+    int32_t skew_angle_cdeg;        // Estimated text angle, 1/100 degree
+    
+    // Detection postprocessing (last frame)
+    uint32_t det_postprocess_time_us;
+    uint32_t det_components;        // Connected components (DBNet) / merged candidates (EAST)
+    uint32_t det_dropped_boxes;     // Valid boxes beyond capacity
+    uint32_t text_box_capacity;     // Box storage sized for the frame
+    uint32_t text_box_overflow;     // Boxes lost to the capacity (cumulative)
+    uint32_t det_vertical_boxes;    // Boxes read top to bottom (tategaki)
+    
+    // Reading order (last frame)
+    uint32_t layout_time_us;
+    uint32_t layout_lines;
+    uint32_t layout_blocks;
+    uint32_t layout_columns;
+    
+    // Multi-scale detection (cumulative)
+    uint32_t det_single_frames;     // Frames detected at full scale only
+    uint32_t det_single_avg_us;     // Average detection time per frame, single scale
+    uint32_t det_pyramid_frames;    // Frames through the coarse pass
+    uint32_t det_pyramid_avg_us;    // Average detection time per frame, pyramid mode
+    uint32_t det_coarse_exits;      // Coarse pass found no text, fine pass skipped
+    uint32_t det_coarse_exit_percent;
+    uint32_t det_coarse_cells;      // Active coarse cells (last pyramid frame)
+    
+    // Tiled detection
+    uint32_t det_tiled_frames;      // Frames detected tile by tile (cumulative)
+    uint32_t det_tiled_avg_us;      // Average detection time per frame, all tiles
+    uint32_t det_tiles;             // Tiles per frame
+    uint32_t det_seam_boxes;        // Tile boxes cut by a seam (last frame)
+    uint32_t det_seam_merges;       // Tile boxes folded into another box (last frame)
+    uint32_t det_tiles_skipped;     // Tiles without likely text, not inferred (last frame)
+    
+    // Text prefilter
+    uint32_t prefilter_frames;      // Frames scored by the prefilter (cumulative)
+    uint32_t prefilter_skips;       // Frames sent past detection (cumulative)
+    uint32_t prefilter_skip_percent;
+    uint32_t prefilter_avg_us;      // Average prefilter time per frame
+    uint32_t prefilter_likely_tiles; // Likely text tiles (last frame)
+    
+    // Recognition decoding
+    uint32_t rec_decode_time_us;    // CTC decoding of the last region
+    uint32_t rec_truncated;         // Regions cut at OCR_REGION_TEXT_LENGTH (cumulative)
+    uint32_t rec_lexicon_fallbacks; // Beam regions no lexicon word fit, read greedily (cumulative)
+    
+    // Batched recognition
+    uint32_t rec_batches;           // Recognition inferences (cumulative)
+    uint32_t rec_batch_size;        // Slots of the last frame's batch (activation budget)
+    uint32_t rec_box_us[OCR_REC_MAX_BATCH]; // Inference + decoding per box, by batch size (last batch)
+    uint32_t rec_bucket_boxes[OCR_REC_MAX_BUCKETS]; // Crops recognized per width bucket (cumulative)
+    
+    // Text tracking (cumulative)
+    uint32_t track_recognitions;    // Crops sent to recognition
+    uint32_t track_reused;          // Crops answered from a track cache
+    uint32_t track_saved_percent;   // Recognition calls saved
+    uint32_t track_active;          // Tracks alive (last frame)
 } ai_performance_stats_t;
 
 // AI task configuration
 typedef struct {
     ai_precision_t precision_mode;
-    uint8_t enable_preprocessing;
+    uint8_t enable_preprocessing;   // Adaptive contrast / binarization stage
+    uint8_t adaptive_mode;          // ocr_adaptive_mode_t
+    uint8_t letterbox_input;        // Preserve camera aspect ratio, pad detection input
+    uint8_t enable_strip_streaming; // Preprocess while the frame is still being captured
+    uint8_t change_threshold;       // Block luma delta counted as change (0 = gate off)
+    uint8_t change_min_blocks;      // Changed blocks needed to rerun OCR
+    uint16_t max_static_frames;     // Force a rerun after this many skips
+    uint8_t enable_dirty_tiles;     // Recompute only changed tiles of the input tensor
+    uint8_t dirty_tile_threshold;   // Cell-mean luma delta counted as a dirty tile
+    uint8_t enable_deskew;          // Estimate skew and rotate-crop recognition input
+    uint16_t max_text_boxes;        // Hard cap on text boxes per frame
+    uint8_t enable_multiscale;      // Coarse pass first (if its model is built); fine pass only on frames/regions with text
+    uint8_t enable_tracking;        // Track boxes across frames, recognize new/changed crops only
+    uint8_t enable_fullres_crop;    // Recognition crops from the camera frame, not the detection grid
+    uint8_t enable_tiled_detection; // Detect on overlapping full-resolution tiles (one inference per tile)
+    uint16_t det_tile_overlap;      // Minimum tile overlap in camera pixels
+    uint8_t enable_prefilter;       // Skip detection on frames without stroke-like edges
+    uint8_t prefilter_restrict;     // Also clear the detection map / skip tiles outside likely tiles
+    uint8_t rec_beam_width;         // CTC prefix beam search width (0 = greedy decoding)
+    uint8_t rec_max_batch;          // Crops per recognition inference (0 = model batch, 1 = one per box)
+    uint8_t enable_rec_buckets;     // Narrowest recognition width variant per crop (0 = base model only)
     uint8_t enable_postprocessing;
     float confidence_threshold;
     uint32_t max_inference_time_us;
@@ -135,10 +296,48 @@ typedef struct {
     uint8_t *scratch_buffer;
     
     // Input/Output buffers
-    uint8_t *input_buffer;          // Preprocessed image
+    ocr_tensor_quantizer_t det_quantizer; // Detection input quantizer
+    ocr_rec_buckets_t rec_buckets;  // Recognition width variants, narrowest first
+    ocr_tensor_quantizer_t rec_quantizer[OCR_REC_MAX_BUCKETS]; // Input quantizer per bucket (one batch slot)
+    ocr_resize_plan_t det_resize;   // Camera frame -> detection input resize plan
+    void *det_resize_storage;       // Resize coefficient tables (AI pool)
+    uint16_t frame_width;           // Camera frame geometry the plan was built for
+    uint16_t frame_height;
+    ocr_frame_transform_t frame_transform; // Detection input -> camera frame (per frame)
+    ocr_det_tiling_t det_tiling;    // Detection-input-sized tiles over the camera frame
+    uint8_t boxes_in_frame;         // Boxes of this frame are in camera pixels (tiled detection)
+    ocr_frame_transform_t box_transform; // Box coordinates -> camera frame (per frame)
+    uint16_t box_width;             // Box coordinate space (per frame)
+    uint16_t box_height;
+    ocr_strip_stream_t det_stream;  // Strip-streaming state for the frame in capture
+    ocr_tile_map_t det_tiles;       // Dirty tiles of the persistent detection tensor
+    void *det_tiles_storage;        // Tile signatures and bitmap (AI pool)
+    int8_t *det_tensor;             // Persistent detection tensor (dirty-tile mode)
+    ocr_adaptive_t det_adaptive;    // Adaptive contrast / binarization stage
+    void *det_adaptive_storage;     // Luma plane and integral images (AI pool)
+    void *skew_scratch;             // Edge points and projection profile (AI pool)
+    ocr_skew_t frame_skew;          // Skew estimate of the frame being recognized
+    ocr_tracker_t tracker;          // Text tracks and their cached recognition
+    void *tracker_storage;          // Tracks and association scratch (AI pool)
+    ocr_prefilter_t prefilter;      // Text-presence prefilter on the detection input
+    void *prefilter_storage;        // Per-tile strokes and scores (AI pool)
+    ocr_charset_t rec_charset;      // Recognition dictionary, read in place from flash
+    void *rec_charset_storage;      // Dictionary block index (AI pool, kept while loaded)
+    ocr_ctc_t rec_ctc;              // Greedy CTC decoder of the recognition output
+    ocr_lexicon_t rec_lexicon;      // Word trie, read in place from flash
+    ocr_beam_t rec_beam;            // Lexicon-constrained beam search (rec_beam_width > 0)
+    void *rec_beam_storage;         // Beam arena (AI pool, kept while loaded)
+    const ocr_prefilter_t *det_likely; // Likely tiles detection is restricted to (per frame)
+    frame_buffer_t * volatile stream_frame; // Frame in capture (set from camera ISR)
+    frame_buffer_t *stream_consumed; // Streamed frame released before its capture completed
+    ocr_frame_signature_t last_signature; // Signature of the last processed frame
+    ocr_result_t last_result;       // Result reused for static frames
+    uint8_t last_result_valid;
+    uint16_t static_frame_count;    // Consecutive skipped frames
+    uint8_t *input_buffer;          // Preprocessed image (RGB565, adaptive stage input)
     uint8_t *output_buffer;         // Raw inference output
     ocr_result_t *result_buffer;    // Processed OCR result
-    text_bbox_t *bbox_buffer;       // Detected text boxes
+    ocr_det_boxes_t text_boxes;     // Detected text boxes of the frame (SoA, AI pool)
     
     // Performance monitoring
     ai_performance_stats_t stats;
@@ -185,6 +384,17 @@ int ai_init(void);
  */
 int ai_configure(const ai_task_config_t *config);
 
+/**
+ * @brief Configure preprocessing for a camera frame geometry
+ * @param camera_config Camera configuration (NULL for CAMERA_WIDTH x CAMERA_HEIGHT)
+ * @return 0 on success, negative on error
+ * @details Builds the resize coefficient tables from the camera geometry to the
+ *          detection model input (stretched, or letterboxed when
+ *          config.letterbox_input is set). Called at model load; call again
+ *          whenever the camera geometry changes
+ */
+int ai_configure_input(const camera_config_t *camera_config);
+
 /**
  * @brief Shutdown AI subsystem
  * @return 0 on success, negative on error
@@ -229,6 +439,17 @@ int neural_art_unload_model(ai_model_type_t model_type);
  */
 int neural_art_inference(ai_model_type_t model_type, const void *input, void *output);
 
+/**
+ * @brief Execute one NPU inference over a batch of inputs
+ * @param model_type Model to use for inference
+ * @param input Batch input (batch consecutive input tensors)
+ * @param output Batch output (batch consecutive output tensors)
+ * @param batch Inputs in the batch (1..max_batch of the model)
+ * @return 0 on success, negative on error
+ * @details Setup and weight fetch are paid once for the whole batch
+ */
+int neural_art_inference_batch(ai_model_type_t model_type, const void *input, void *output, uint32_t batch);
+
 /**
  * @brief Get NPU status
  * @return Current NPU utilization percentage
@@ -257,26 +478,90 @@ int ocr_process_frame(const frame_buffer_t *frame, ocr_result_t *result);
  */
 int ocr_preprocess_image(const frame_buffer_t *input_frame, uint8_t *output_buffer);
 
+/**
+ * @brief Preprocess frame straight into the detection input tensor
+ * @param input_frame Raw camera frame
+ * @param tensor Detection model int8 input tensor
+ * @return 0 on success, negative on error
+ * @details Fused downsample, color conversion, normalization and quantization
+ *          using the detection model's quantization parameters. Passing the
+ *          persistent tensor (dirty-tile mode) recomputes only changed tiles
+ */
+int ocr_preprocess_to_tensor(const frame_buffer_t *input_frame, int8_t *tensor);
+
+/**
+ * @brief Get dirty tiles of the last preprocessed frame
+ * @return Tile map, NULL when dirty-tile preprocessing is disabled
+ * @details Detection postprocessing may restrict its work to dirty tiles
+ */
+const ocr_tile_map_t* ocr_get_dirty_tiles(void);
+
+/**
+ * @brief Get the text prefilter of the last processed frame
+ * @return Prefilter with its per-tile score map, NULL when the prefilter is disabled
+ * @details Tiles are in detection input pixels; frames without likely tiles
+ *          skipped detection
+ */
+const ocr_prefilter_t* ocr_get_text_prefilter(void);
+
 /**
  * @brief Detect text regions in image
- * @param image Preprocessed image
- * @param bboxes Detected text bounding boxes
- * @param max_boxes Maximum number of boxes
+ * @param image Detection input tensor
+ * @param boxes Detected text boxes (filled up to their capacity, overflow counted in stats)
+ * @return Number of detected boxes, negative on error
+ * @details In multi-scale mode a half-resolution pass runs first: frames without
+ *          text end there, otherwise the full-resolution pass is decoded only
+ *          in the regions the coarse pass marked. With prefilter restriction
+ *          the map is also cleared outside the likely text tiles of the frame
+ */
+int ocr_detect_text(const uint8_t *image, ocr_det_boxes_t *boxes);
+
+/**
+ * @brief Detect text on overlapping full-resolution tiles of the camera frame
+ * @param frame Camera frame (RGB565)
+ * @param boxes Detected text boxes in camera pixels (filled up to their capacity)
  * @return Number of detected boxes, negative on error
+ * @details Each tile is a detection input cut 1:1 from the frame, so text is
+ *          seen at camera resolution within the activation budget of one
+ *          input. Tile boxes are moved to frame coordinates and merged across
+ *          seams after every tile. With prefilter restriction, tiles without
+ *          likely text are not inferred
  */
-int ocr_detect_text(const uint8_t *image, text_bbox_t *bboxes, uint32_t max_boxes);
+int ocr_detect_text_tiled(const frame_buffer_t *frame, ocr_det_boxes_t *boxes);
 
 /**
  * @brief Recognize text in bounding box
- * @param image Source image
- * @param bbox Text bounding box
- * @param text_output Recognized text output
- * @param confidence Confidence score output
+ * @param frame Source camera frame
+ * @param bbox Text bounding box (detection input coordinates)
+ * @param text_output Recognized text output (OCR_REGION_TEXT_LENGTH bytes, UTF-8)
+ * @param confidence Confidence score output (mean character probability)
  * @return 0 on success, negative on error
- */
-int ocr_recognize_text(const uint8_t *image, const text_bbox_t *bbox, 
+ * @details The box is scaled to camera frame pixels and sampled from the
+ *          frame straight into the model input: crop, resize and quantization
+ *          in one pass, no intermediate strip. With enable_fullres_crop the
+ *          strip's line thickness is OCR_STRIP_HEIGHT. Vertical boxes are
+ *          rotated 90 degrees in the same pass, so the strip reads left to
+ *          right from the top of the column. The strip is recognized by
+ *          the narrowest width variant it fits (longer lines are scaled down
+ *          into the widest one). The int8 output is decoded
+ *          greedily (CTC) through the dictionary; characters that do not fit
+ *          the text buffer are dropped whole. One inference per call:
+ *          ocr_process_frame() batches the boxes of a frame instead
+ */
+int ocr_recognize_text(const frame_buffer_t *frame, const text_bbox_t *bbox, 
                       char *text_output, float *confidence);
 
+/**
+ * @brief Map a detected box back to camera frame coordinates
+ * @param bbox Box in the coordinates of the current frame's boxes (detection
+ *        input, or camera pixels after tiled detection)
+ * @param frame_bbox Output box in full-resolution camera coordinates
+ * @return 0 on success, negative on error
+ * @details Uses the scale/offset recorded for the current frame (integer math),
+ *          removing letterbox padding. Quad corners are mapped unclamped
+ */
+int ocr_bbox_to_frame(const text_bbox_t *bbox, text_bbox_t *frame_bbox);
+
 /**
  * @brief Post-process OCR results
  * @param raw_result Raw OCR output
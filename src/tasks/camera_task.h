@@ -21,6 +21,9 @@
 #define FRAME_BUFFER_COUNT 2  // Double buffering
 #define FRAME_BUFFER_SIZE  CAMERA_FRAME_SIZE
 
+// Line events during capture (strip-streaming preprocessing)
+#define CAMERA_STRIP_LINES 16  // DMA line-count event granularity
+
 // Camera task timing
 #define CAMERA_TASK_PERIOD_MS 20  // 50 FPS
 #define CAMERA_TASK_TIMEOUT_MS 100
@@ -49,8 +52,12 @@ typedef struct {
     uint32_t size;
     uint32_t timestamp;
     uint8_t ready;
+    volatile uint16_t lines_ready;  // Complete lines written by DMA (capture in progress)
 } frame_buffer_t;
 
+// Line-count callback, invoked from DMA interrupt context
+typedef void (*camera_line_callback_t)(frame_buffer_t *frame, uint32_t lines_done);
+
 // Global variables
 extern frame_buffer_t frame_buffers[FRAME_BUFFER_COUNT];
 extern uint8_t current_frame_index;
@@ -80,6 +87,8 @@ int camera_init(void);
  * @brief Configure camera parameters
  * @param config Camera configuration structure
  * @return 0 on success, negative on error
+ * @details Does not reconfigure the AI preprocessing: after a resolution
+ *          change the caller must call ai_configure_input() with the new config
  */
 int camera_configure(const camera_config_t *config);
 
@@ -124,6 +133,21 @@ void camera_release_frame(frame_buffer_t *frame);
  */
 void camera_dma_isr_handler(void);
 
+/**
+ * @brief Camera line-count interrupt handler
+ * @details Called every CAMERA_STRIP_LINES lines while a frame is captured;
+ *          updates frame->lines_ready and invokes the line callback
+ */
+void camera_dma_line_isr_handler(void);
+
+/**
+ * @brief Register line-count callback
+ * @param callback Callback (NULL to disable line events)
+ * @param lines_per_event Lines between events (0 = CAMERA_STRIP_LINES)
+ * @details Callback runs in interrupt context and must only signal
+ */
+void camera_set_line_callback(camera_line_callback_t callback, uint32_t lines_per_event);
+
 /**
  * @brief Camera error handler
  * @details Handle camera errors and recovery
@@ -0,0 +1,400 @@
+/**
+ * @file beam_test.c
+ * @brief 語彙制約付きCTCプレフィックスビームサーチのテスト＋ベンチマーク
+ *
+ * 目的: 語彙トライ（フラッシュイメージ）の構築・参照が正しいこと、
+ *       ビーム幅1・語彙なしでグリーディと同じ結果になること、
+ *       似た字形のかな・漢字（ソ/ン、カ/力、ロ/口、未/末 …）の取り違えを
+ *       語彙で正しい単語に戻せること、語彙外の明瞭な文字列は読めること、
+ *       空白で単語が区切られること、ビーム状態が固定サイズのアリーナに収まることを確認
+ * 計測: 合成した取り違えセットでの完全一致率（グリーディ / ビーム / ビーム＋語彙）、
+ *       80タイムステップ x 6,625クラスでのビーム幅ごとのデコード時間
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "bench_timer.h"
+#include "ocr_ctc.h"
+#include "ocr_lexicon.h"
+#include "ocr_beam.h"
+
+#define TIMESTEPS 80
+#define BIG_ENTRIES 6623            // PP-OCR辞書規模（+ブランク +空白 = 6,625クラス）
+#define BIG_CLASSES (BIG_ENTRIES + 2)
+#define REGION_TEXT 64              // ai_taskの領域テキスト
+#define CONFUSION_LINES 400
+#define SMALL_CLASSES_MAX 64         // 取り違えセットの辞書（+ブランク +空白）
+
+static int failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("❌ FAIL: %s\n", msg); failures++; } \
+    else { printf("✅ %s\n", msg); } \
+} while (0)
+
+// 辞書の文字（前半は似た字形の組: ソ/ン、シ/ツ、カ/力 …）
+static const char pairs[] = "ソンシツカ力ロ口ニ二エ工タ夕ハ八ト卜ー一未末土士";
+static const char others[] = "フャメラビュスアコクバガイレ来曜新宿東京品川渋谷場番入週方駅改札大阪";
+
+// 語彙: 駅名・地名・商品名
+static const char words[] =
+    "ソフト\nシャツ\nカメラ\nロビー\nニュース\nエアコン\nタクシー\nハンバーガー\nトイレ\n"
+    "未来\n土曜\n工場\n一番\n入口\n週末\n力士\n夕方\n新宿\n東京\n品川\n渋谷\n大阪\n東京駅\n";
+
+static uint8_t dict[512];
+static uint32_t dict_size = 0;
+static uint8_t charset_storage[256] __attribute__((aligned(4)));
+static uint8_t scratch[4096] __attribute__((aligned(4)));
+static uint8_t image[2048] __attribute__((aligned(4)));
+static uint8_t arena[64 * 1024] __attribute__((aligned(4)));
+static int8_t scores[TIMESTEPS * BIG_CLASSES];
+static uint8_t big_dict[BIG_ENTRIES * 4];
+static uint32_t big_dict_size = 0;
+static uint8_t big_storage[4096] __attribute__((aligned(4)));
+static uint32_t seed = 2222;
+
+static uint32_t utf8_length(uint8_t lead) {
+    return (lead < 0x80) ? 1 : ((lead & 0xE0) == 0xC0) ? 2 : ((lead & 0xF0) == 0xE0) ? 3 : 4;
+}
+
+static void build_dict(void) {
+    const char *parts[2] = {pairs, others};
+    dict_size = 0;
+    for (int p = 0; p < 2; p++) {
+        for (const char *s = parts[p]; *s;) {
+            uint32_t len = utf8_length((uint8_t)*s);
+            memcpy(dict + dict_size, s, len);
+            dict_size += len;
+            dict[dict_size++] = '\n';
+            s += len;
+        }
+    }
+}
+
+static uint32_t utf8_encode(uint32_t cp, uint8_t *out) {
+    if (cp < 0x80) { out[0] = (uint8_t)cp; return 1; }
+    if (cp < 0x800) { out[0] = 0xC0 | (cp >> 6); out[1] = 0x80 | (cp & 0x3F); return 2; }
+    out[0] = 0xE0 | (cp >> 12); out[1] = 0x80 | ((cp >> 6) & 0x3F); out[2] = 0x80 | (cp & 0x3F);
+    return 3;
+}
+
+static void build_big_dict(void) {
+    big_dict_size = 0;
+    for (uint32_t i = 0; i < BIG_ENTRIES; i++) {
+        uint32_t cp = (i < 94) ? 0x21 + i : (i < 94 + 64) ? 0xC0 + (i - 94) : 0x3041 + (i - 94 - 64);
+        big_dict_size += utf8_encode(cp, big_dict + big_dict_size);
+        big_dict[big_dict_size++] = '\n';
+    }
+}
+
+// 文字列 -> クラス列（空白は最後のクラス）
+static uint32_t to_classes(const ocr_charset_t *cs, const char *text, uint16_t *out) {
+    uint32_t n = 0;
+    while (*text) {
+        uint32_t len = utf8_length((uint8_t)*text);
+        out[n++] = (*text == ' ') ? (uint16_t)(cs->count + 1)
+                                  : (uint16_t)(ocr_charset_find(cs, (const uint8_t*)text, len) + 1);
+        text += len;
+    }
+    return n;
+}
+
+// 似た字形の相手（なければ0）: 辞書の前半は2文字ずつの組
+static uint16_t partner(uint16_t cls) {
+    uint32_t pair_entries = 0;
+    for (const char *s = pairs; *s; s += utf8_length((uint8_t)*s)) pair_entries++;
+    if (cls == 0 || cls > pair_entries) return 0;
+    return (uint16_t)(((cls - 1) ^ 1) + 1);
+}
+
+static int8_t quantize(float p) {
+    int q = (int)(p * 255.0f + 0.5f) - 128;
+    return (int8_t)(q > 127 ? 127 : q < -128 ? -128 : q);
+}
+
+/**
+ * @brief 取り違えを含むsoftmax出力を合成（PROBS、scale 1/255、zp -128）
+ * @param confuse 似た字形の文字が相手の字に読まれる確率（%）
+ */
+static void synth_confusion(const uint16_t *labels, uint32_t count, uint32_t classes,
+                            uint32_t confuse, int8_t *out) {
+    uint32_t t = 0;
+    memset(out, -128, TIMESTEPS * classes);
+    for (uint32_t i = 0; i <= count && t < TIMESTEPS; i++) {
+        uint32_t blanks = 1 + bench_rand(&seed) % 2;
+        uint32_t frames = (i < count) ? 2 + bench_rand(&seed) % 2 : 0;
+        uint16_t other = (i < count) ? partner(labels[i]) : 0;
+        int swapped = other && bench_rand(&seed) % 100 < confuse;
+        for (uint32_t f = 0; f < blanks + frames && t < TIMESTEPS; f++, t++) {
+            int8_t *row = out + t * classes;
+            float jitter = (float)(bench_rand(&seed) % 100) * 0.001f - 0.05f;
+            if (f < blanks) {
+                row[OCR_CTC_BLANK] = quantize(0.92f);
+                row[1 + bench_rand(&seed) % (classes - 2)] = quantize(0.04f);
+            } else if (!other) {
+                row[labels[i]] = quantize(0.85f + jitter);
+                row[OCR_CTC_BLANK] = quantize(0.1f);
+            } else {
+                row[labels[i]] = quantize((swapped ? 0.36f : 0.58f) + jitter);
+                row[other] = quantize((swapped ? 0.52f : 0.32f) - jitter);
+                row[OCR_CTC_BLANK] = quantize(0.08f);
+            }
+        }
+    }
+    for (; t < TIMESTEPS; t++) out[t * classes + OCR_CTC_BLANK] = 127;
+}
+
+static void test_lexicon(const ocr_charset_t *cs, ocr_lexicon_t *lex) {
+    char msg[160];
+    uint16_t cls[8];
+
+    printf("\n=== Lexicon Trie ===\n");
+    int size = ocr_lexicon_build(cs, (const uint8_t*)words, sizeof(words) - 1,
+                                 scratch, ocr_lexicon_build_scratch_size(sizeof(words) - 1),
+                                 image, ocr_lexicon_build_image_size(sizeof(words) - 1));
+    CHECK(size > 0 && (uint32_t)size <= ocr_lexicon_build_image_size(sizeof(words) - 1) &&
+          ocr_lexicon_map(lex, image, (uint32_t)size) == 0, "23 words built and mapped in place");
+    snprintf(msg, sizeof(msg), "%u nodes, %u edges, %d-byte image for a %u-byte word list",
+             lex->node_count, lex->edge_count, size, (unsigned)(sizeof(words) - 1));
+    CHECK(lex->edge_count + 1 == lex->node_count, msg);
+
+    // 東京 / 東京駅: 共通の接頭辞、両方とも単語
+    to_classes(cs, "東京駅", cls);
+    uint32_t n1 = ocr_lexicon_child(lex, OCR_LEXICON_ROOT, cls[0]);
+    uint32_t n2 = ocr_lexicon_child(lex, n1, cls[1]);
+    uint32_t n3 = ocr_lexicon_child(lex, n2, cls[2]);
+    CHECK(n1 != OCR_LEXICON_NONE && !ocr_lexicon_is_word(lex, n1) && ocr_lexicon_is_word(lex, n2) &&
+          ocr_lexicon_is_word(lex, n3), "東 -> 東京 (word) -> 東京駅 (word)");
+
+    to_classes(cs, "東カ", cls);
+    CHECK(ocr_lexicon_child(lex, n1, cls[1]) == OCR_LEXICON_NONE &&
+          ocr_lexicon_child(lex, OCR_LEXICON_NONE, cls[0]) == OCR_LEXICON_NONE, "missing edge: OCR_LEXICON_NONE");
+
+    // 語彙はすべて辿れる
+    int all = 1;
+    for (const char *w = words; *w;) {
+        const char *end = strchr(w, '\n');
+        char word[32];
+        memcpy(word, w, end - w);
+        word[end - w] = '\0';
+        uint32_t n = to_classes(cs, word, cls), node = OCR_LEXICON_ROOT;
+        for (uint32_t i = 0; i < n; i++) node = ocr_lexicon_child(lex, node, cls[i]);
+        all &= ocr_lexicon_is_word(lex, node);
+        w = end + 1;
+    }
+    CHECK(all, "every listed word ends on a word node");
+
+    uint32_t bad[4] = {0x12345678u, 1, 0, 0};
+    CHECK(ocr_lexicon_map(lex, bad, sizeof(bad)) != 0 && ocr_lexicon_map(lex, image, 12) != 0,
+          "wrong magic and short image rejected");
+    static const char unknown[] = "東京\n横浜\n";
+    CHECK(ocr_lexicon_build(cs, (const uint8_t*)unknown, sizeof(unknown) - 1, scratch, sizeof(scratch),
+                            image + 1024, 1024) < 0, "word with a character outside the dictionary rejected");
+}
+
+static void test_arena(const ocr_ctc_t *ctc) {
+    ocr_beam_t beam;
+    char msg[160];
+
+    printf("\n=== Beam Arena ===\n");
+    CHECK(ocr_beam_size(0) == 0 && ocr_beam_size(OCR_BEAM_MAX_WIDTH + 1) == 0, "width 0 and above 16 rejected");
+    CHECK(ocr_beam_init(&beam, ctc, NULL, 8, arena, ocr_beam_size(8) - 4) != 0, "short arena rejected");
+    snprintf(msg, sizeof(msg), "fixed arena: %u bytes at width 4, %u at 8, %u at 16",
+             ocr_beam_size(4), ocr_beam_size(8), ocr_beam_size(16));
+    CHECK(ocr_beam_size(16) <= sizeof(arena) && ocr_beam_size(4) < ocr_beam_size(8), msg);
+}
+
+static void test_greedy_match(void) {
+    ocr_charset_t cs;
+    ocr_ctc_t ctc;
+    ocr_beam_t beam;
+    ocr_ctc_result_t gr, br;
+    char gt[REGION_TEXT], bt[REGION_TEXT];
+    uint16_t labels[20];
+    int same = 1;
+
+    printf("\n=== Width 1 vs Greedy ===\n");
+    ocr_charset_init(&cs, big_dict, big_dict_size, big_storage, sizeof(big_storage));
+    ocr_ctc_init(&ctc, &cs, BIG_CLASSES, OCR_CTC_OUTPUT_LOGITS, 0.05f, 0);
+    ocr_beam_init(&beam, &ctc, NULL, 1, arena, sizeof(arena));
+    for (int trial = 0; trial < 20; trial++) {
+        // 明瞭な行（ロジット出力）: 1文字2〜3フレーム、間にブランク
+        memset(scores, -100, TIMESTEPS * BIG_CLASSES);
+        uint32_t t = 0;
+        for (int i = 0; i < 15; i++) {
+            labels[i] = (uint16_t)(1 + bench_rand(&seed) % BIG_ENTRIES);
+            scores[t++ * BIG_CLASSES + OCR_CTC_BLANK] = 60;
+            for (uint32_t f = 0; f < 2 + bench_rand(&seed) % 2; f++) scores[t++ * BIG_CLASSES + labels[i]] = 60;
+        }
+        for (; t < TIMESTEPS; t++) scores[t * BIG_CLASSES + OCR_CTC_BLANK] = 60;
+        ocr_ctc_greedy(&ctc, scores, TIMESTEPS, gt, sizeof(gt), &gr);
+        ocr_beam_decode(&beam, scores, TIMESTEPS, bt, sizeof(bt), &br);
+        same &= strcmp(gt, bt) == 0 && gr.chars == br.chars;
+    }
+    CHECK(same, "width 1 without lexicon decodes clear lines like greedy (20 lines, logits)");
+}
+
+// 正解率: 正解の単語と完全一致した行の割合（beamがNULLならグリーディ）
+static double accuracy(const ocr_charset_t *cs, const ocr_ctc_t *ctc, ocr_beam_t *beam,
+                       int8_t (*lines)[TIMESTEPS * SMALL_CLASSES_MAX], uint16_t (*labels)[16], const uint32_t *counts) {
+    ocr_ctc_result_t res;
+    char text[REGION_TEXT];
+    uint16_t got[64];
+    int ok = 0;
+    for (int i = 0; i < CONFUSION_LINES; i++) {
+        if (beam) ocr_beam_decode(beam, lines[i], TIMESTEPS, text, sizeof(text), &res);
+        else ocr_ctc_greedy(ctc, lines[i], TIMESTEPS, text, sizeof(text), &res);
+        ok += to_classes(cs, text, got) == counts[i] && memcmp(got, labels[i], counts[i] * sizeof(uint16_t)) == 0;
+    }
+    return 100.0 * ok / CONFUSION_LINES;
+}
+
+static void test_confusion(const ocr_charset_t *cs, const ocr_ctc_t *ctc, const ocr_lexicon_t *lex) {
+    static const char *list[32];
+    static uint16_t labels[CONFUSION_LINES][16];
+    static uint32_t counts[CONFUSION_LINES];
+    static int8_t lines[CONFUSION_LINES][TIMESTEPS * SMALL_CLASSES_MAX];
+    ocr_beam_t beam;
+    char msg[200];
+    uint32_t word_count = 0;
+    static char word_store[512];
+    char *wp = word_store;
+
+    printf("\n=== Look-alike Confusion Set (%d lines, %u classes) ===\n", CONFUSION_LINES, ctc->classes);
+    for (const char *w = words; *w;) {
+        const char *end = strchr(w, '\n');
+        memcpy(wp, w, end - w);
+        wp[end - w] = '\0';
+        list[word_count++] = wp;
+        wp += end - w + 1;
+        w = end + 1;
+    }
+    for (int i = 0; i < CONFUSION_LINES; i++) {
+        const char *word = list[bench_rand(&seed) % word_count];
+        counts[i] = to_classes(cs, word, labels[i]);
+        synth_confusion(labels[i], counts[i], ctc->classes, 40, lines[i]);
+    }
+
+    double greedy = accuracy(cs, ctc, NULL, lines, labels, counts);
+    printf("  %-22s %5.1f%%\n", "greedy", greedy);
+    ocr_beam_init(&beam, ctc, NULL, 8, arena, sizeof(arena));
+    double plain = accuracy(cs, ctc, &beam, lines, labels, counts);
+    printf("  %-22s %5.1f%%\n", "beam 8, no lexicon", plain);
+    double lexicon[5];
+    const uint16_t widths[5] = {1, 2, 4, 8, 16};
+    for (int w = 0; w < 5; w++) {
+        ocr_beam_init(&beam, ctc, lex, widths[w], arena, sizeof(arena));
+        lexicon[w] = accuracy(cs, ctc, &beam, lines, labels, counts);
+        printf("  beam %-2u + lexicon      %5.1f%%\n", widths[w], lexicon[w]);
+    }
+
+    snprintf(msg, sizeof(msg), "lexicon beam (width 8) %.1f%% vs greedy %.1f%%", lexicon[3], greedy);
+    CHECK(lexicon[3] >= 95.0 && lexicon[3] > greedy + 30.0, msg);
+    CHECK(plain <= greedy + 10.0, "without a lexicon the beam cannot tell look-alikes apart either");
+}
+
+static void test_lexicon_rules(const ocr_charset_t *cs, const ocr_ctc_t *ctc, const ocr_lexicon_t *lex) {
+    ocr_beam_t beam;
+    ocr_ctc_result_t res;
+    char text[REGION_TEXT];
+    char msg[200];
+    uint16_t labels[16];
+    uint32_t n;
+
+    printf("\n=== Lexicon Rules ===\n");
+    ocr_beam_init(&beam, ctc, lex, OCR_BEAM_WIDTH, arena, sizeof(arena));
+
+    // 明瞭な語彙外の単語（改札）はペナルティ付きでも読める
+    n = to_classes(cs, "改札", labels);
+    synth_confusion(labels, n, ctc->classes, 0, scores);
+    ocr_beam_decode(&beam, scores, TIMESTEPS, text, sizeof(text), &res);
+    snprintf(msg, sizeof(msg), "clear out-of-lexicon word reads: \"%s\" (confidence %.2f)", text, res.confidence);
+    CHECK(strcmp(text, "改札") == 0 && !beam.fallback && res.confidence > 0.8f, msg);
+
+    // 空白で単語が区切られ、各単語が語彙で補正される
+    n = to_classes(cs, "ロビー 力士", labels);
+    int ok = 1;
+    for (int trial = 0; trial < 20; trial++) {
+        synth_confusion(labels, n, ctc->classes, 60, scores);
+        ocr_beam_decode(&beam, scores, TIMESTEPS, text, sizeof(text), &res);
+        ok &= strcmp(text, "ロビー 力士") == 0;
+    }
+    CHECK(ok, "\"ロビー 力士\": each word after a space is matched from the root (20 noisy lines)");
+
+    // 単語の途中で終わる行（東京駅の「東」だけ）は語彙の単語に引き寄せられない
+    n = to_classes(cs, "東", labels);
+    synth_confusion(labels, n, ctc->classes, 0, scores);
+    ocr_beam_decode(&beam, scores, TIMESTEPS, text, sizeof(text), &res);
+    CHECK(strcmp(text, "東") == 0, "clear partial word kept (penalized, not replaced)");
+
+    // ペナルティ0（厳密な語彙制約）: 合う単語がなければグリーディ結果
+    beam.oov_penalty = 0.0f;
+    n = to_classes(cs, "改札", labels);
+    synth_confusion(labels, n, ctc->classes, 0, scores);
+    ocr_beam_decode(&beam, scores, TIMESTEPS, text, sizeof(text), &res);
+    CHECK(strcmp(text, "改札") == 0 && beam.fallback, "hard constraint without a matching word falls back to greedy");
+}
+
+static void bench_widths(void) {
+    ocr_charset_t cs;
+    ocr_ctc_t ctc;
+    ocr_beam_t beam;
+    ocr_ctc_result_t res;
+    char text[REGION_TEXT];
+    uint16_t labels[20];
+    const int iterations = 50;
+
+    printf("\n=== Decode Benchmark (%d timesteps x %d classes, softmax output) ===\n", TIMESTEPS, BIG_CLASSES);
+    ocr_charset_init(&cs, big_dict, big_dict_size, big_storage, sizeof(big_storage));
+    ocr_ctc_init(&ctc, &cs, BIG_CLASSES, OCR_CTC_OUTPUT_PROBS, 1.0f / 255.0f, -128);
+    for (int i = 0; i < 20; i++) labels[i] = (uint16_t)(1 + bench_rand(&seed) % BIG_ENTRIES);
+    synth_confusion(labels, 20, BIG_CLASSES, 0, scores);
+    // 背景の小さな確率（上位k探索が全ブロックを見ずに済むか）
+    for (uint32_t i = 0; i < TIMESTEPS * BIG_CLASSES; i += 97) {
+        if (scores[i] == -128) scores[i] = -127;
+    }
+
+    double t0 = bench_now_us();
+    for (int i = 0; i < iterations; i++) ocr_ctc_greedy(&ctc, scores, TIMESTEPS, text, sizeof(text), &res);
+    printf("  %-10s %8.1f us/line, %u chars\n", "greedy", (bench_now_us() - t0) / iterations, res.chars);
+
+    const uint16_t widths[5] = {1, 2, 4, 8, 16};
+    for (int w = 0; w < 5; w++) {
+        ocr_beam_init(&beam, &ctc, NULL, widths[w], arena, sizeof(arena));
+        t0 = bench_now_us();
+        for (int i = 0; i < iterations; i++) ocr_beam_decode(&beam, scores, TIMESTEPS, text, sizeof(text), &res);
+        printf("  beam %-5u %8.1f us/line, %u chars, %6u-byte arena\n", widths[w],
+               (bench_now_us() - t0) / iterations, res.chars, ocr_beam_size(widths[w]));
+    }
+}
+
+int main(void) {
+    ocr_charset_t cs;
+    ocr_ctc_t ctc;
+    ocr_lexicon_t lex;
+
+    printf("\n=== OCR Lexicon Beam Search Test ===\n");
+
+    build_dict();
+    build_big_dict();
+    ocr_charset_init(&cs, dict, dict_size, charset_storage, sizeof(charset_storage));
+    ocr_ctc_init(&ctc, &cs, (uint16_t)(cs.count + 2), OCR_CTC_OUTPUT_PROBS, 1.0f / 255.0f, -128);
+
+    test_lexicon(&cs, &lex);
+    test_arena(&ctc);
+    test_greedy_match();
+    test_confusion(&cs, &ctc, &lex);
+    test_lexicon_rules(&cs, &ctc, &lex);
+    bench_widths();
+
+    printf("\n");
+    if (failures > 0) {
+        printf("❌ %d test(s) failed\n", failures);
+        return 1;
+    }
+    printf("✅ All beam search tests passed!\n");
+    return 0;
+}
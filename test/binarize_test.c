@@ -0,0 +1,275 @@
+/**
+ * @file binarize_test.c
+ * @brief 積分画像による適応二値化・コントラスト正規化のテストとベンチマーク
+ *
+ * 目的: SIMD積分画像がナイーブ実装と一致し、低コントラスト文字が分離できることを確認
+ * 計測: 320x240 / 640x480 での処理時間
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "bench_timer.h"
+#include "ocr_binarize.h"
+
+#define MAX_WIDTH  640
+#define MAX_HEIGHT 480
+
+static int failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("❌ FAIL: %s\n", msg); failures++; } \
+    else { printf("✅ %s\n", msg); } \
+} while (0)
+
+static uint8_t storage[1 << 22] __attribute__((aligned(8)));
+
+/**
+ * @brief 低コントラストの看板を模した画像: 横方向グラデーション背景＋やや暗い文字
+ * @return 文字ピクセルなら1を書いたマスク
+ */
+static void render_sign(uint8_t *img, uint8_t *mask, int w, int h) {
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            // 背景: 左90 → 右200（光沢・照明ムラ）
+            int bg = 90 + 110 * x / w;
+            int text = ((y % 32) >= 10 && (y % 32) < 22) && ((x / 4) % 3 == 0);
+            img[y * w + x] = (uint8_t)(text ? bg - 25 : bg);
+            mask[y * w + x] = (uint8_t)text;
+        }
+    }
+}
+
+static void test_integral_image(void) {
+    static uint8_t img[MAX_WIDTH * MAX_HEIGHT];
+    static uint32_t integral[(MAX_WIDTH + 1) * (MAX_HEIGHT + 1)];
+    static uint32_t integral_sq[(MAX_WIDTH + 1) * (MAX_HEIGHT + 1)];
+    uint32_t seed = 0x1234567u;
+    const int w = 637, h = 479;   // SIMD幅で割り切れないサイズ
+
+    printf("\n=== Integral Image ===\n");
+
+    for (int i = 0; i < w * h; i++) {
+        img[i] = (uint8_t)bench_rand(&seed);
+    }
+    ocr_integral_image(img, w, w, h, integral, integral_sq);
+
+    // 64ビットで行プレフィックス和を縦に累積したもの
+    int ok = 1;
+    uint64_t col[MAX_WIDTH + 1] = {0}, col_sq[MAX_WIDTH + 1] = {0};
+    for (int y = 0; y < h && ok; y++) {
+        uint64_t run = 0, run_sq = 0;
+        for (int x = 0; x < w; x++) {
+            run += img[y * w + x];
+            run_sq += (uint64_t)img[y * w + x] * img[y * w + x];
+            col[x + 1] += run;
+            col_sq[x + 1] += run_sq;
+        }
+        for (int x = 0; x <= w; x++) {
+            if (integral[(y + 1) * (w + 1) + x] != (uint32_t)col[x] ||
+                integral_sq[(y + 1) * (w + 1) + x] != (uint32_t)col_sq[x]) {
+                ok = 0;
+                break;
+            }
+        }
+    }
+    CHECK(ok, "integral and squared integral match 64-bit reference (mod 2^32)");
+
+    // 二乗和は2^32を超えるが、窓内の差分は正確
+    int x0 = 600, y0 = 440, x1 = 631, y1 = 471;
+    uint64_t ref = 0;
+    for (int y = y0; y < y1; y++) for (int x = x0; x < x1; x++) ref += (uint64_t)img[y * w + x] * img[y * w + x];
+    uint32_t got = integral_sq[y1 * (w + 1) + x1] - integral_sq[y1 * (w + 1) + x0]
+                 - integral_sq[y0 * (w + 1) + x1] + integral_sq[y0 * (w + 1) + x0];
+    CHECK(got == ref, "window squared sum exact despite 32-bit wraparound");
+}
+
+static float text_accuracy(const uint8_t *bin, const uint8_t *mask, int w, int h) {
+    int correct = 0;
+    for (int i = 0; i < w * h; i++) {
+        correct += (mask[i] ? bin[i] == 0 : bin[i] == 255);
+    }
+    return (float)correct / (float)(w * h);
+}
+
+static void test_binarization(void) {
+    static uint8_t img[320 * 240], mask[320 * 240], out[320 * 240];
+    ocr_adaptive_t a;
+    const int w = 320, h = 240;
+    char msg[96];
+
+    printf("\n=== Adaptive Binarization ===\n");
+
+    render_sign(img, mask, w, h);
+
+    // 全体しきい値（平均値）では照明ムラに負ける
+    uint32_t total = 0;
+    for (int i = 0; i < w * h; i++) total += img[i];
+    for (int i = 0; i < w * h; i++) out[i] = (img[i] * (uint32_t)(w * h) < total) ? 0 : 255;
+    float global = text_accuracy(out, mask, w, h);
+
+    CHECK(ocr_adaptive_init(&a, w, h, OCR_ADAPTIVE_SAUVOLA, OCR_ADAPTIVE_RADIUS, storage, sizeof(storage)) == 0,
+          "Sauvola stage init");
+    ocr_adaptive_gray(&a, img, w, out, w);
+    float sauvola = text_accuracy(out, mask, w, h);
+
+    ocr_adaptive_init(&a, w, h, OCR_ADAPTIVE_BRADLEY, OCR_ADAPTIVE_RADIUS, storage, sizeof(storage));
+    ocr_adaptive_gray(&a, img, w, out, w);
+    float bradley = text_accuracy(out, mask, w, h);
+
+    printf("  pixel accuracy: global %.1f%%, Sauvola %.1f%%, Bradley %.1f%%\n",
+           100.0f * global, 100.0f * sauvola, 100.0f * bradley);
+    snprintf(msg, sizeof(msg), "Sauvola separates low-contrast text (%.1f%%)", 100.0f * sauvola);
+    CHECK(sauvola > 0.9f && sauvola > global + 0.3f, msg);
+    snprintf(msg, sizeof(msg), "Bradley separates low-contrast text (%.1f%%)", 100.0f * bradley);
+    CHECK(bradley > 0.9f && bradley > global + 0.3f, msg);
+
+    CHECK(ocr_adaptive_init(&a, w, h, OCR_ADAPTIVE_SAUVOLA, 0, storage, sizeof(storage)) != 0,
+          "zero radius rejected");
+    CHECK(ocr_adaptive_init(&a, w, h, OCR_ADAPTIVE_SAUVOLA, 7, storage, 1024) != 0,
+          "undersized storage rejected");
+}
+
+/**
+ * @brief 行リングの結果が全画面積分画像による Bradley 判定と一致することを確認
+ */
+static void test_ring_matches_full(void) {
+    static uint8_t img[MAX_WIDTH * MAX_HEIGHT], out[MAX_WIDTH * MAX_HEIGHT];
+    static uint32_t integral[(MAX_WIDTH + 1) * (MAX_HEIGHT + 1)];
+    static uint32_t integral_sq[(MAX_WIDTH + 1) * (MAX_HEIGHT + 1)];
+    const int w = 637, h = 479;
+    const uint8_t radii[] = { 1, OCR_ADAPTIVE_RADIUS, 40 };
+    ocr_adaptive_t a;
+    uint32_t seed = 7;
+    char msg[96];
+
+    printf("\n=== Integral Row Ring ===\n");
+
+    for (int i = 0; i < w * h; i++) img[i] = (uint8_t)bench_rand(&seed);
+    ocr_integral_image(img, w, w, h, integral, integral_sq);
+
+    for (size_t n = 0; n < sizeof(radii); n++) {
+        const int r = radii[n];
+        uint32_t size = ocr_adaptive_size(w, r);
+        int mismatches = 0;
+
+        ocr_adaptive_init(&a, w, h, OCR_ADAPTIVE_BRADLEY, r, storage, size);
+        ocr_adaptive_gray(&a, img, w, out, w);
+
+        // 同じ浮動小数点演算順で参照判定
+        for (int y = 0; y < h; y++) {
+            int y0 = (y > r) ? y - r : 0, y1 = (y + r + 1 < h) ? y + r + 1 : h;
+            for (int x = 0; x < w; x++) {
+                int x0 = (x > r) ? x - r : 0, x1 = (x + r + 1 < w) ? x + r + 1 : w;
+                uint32_t sum = integral[y1 * (w + 1) + x1] - integral[y1 * (w + 1) + x0]
+                             - integral[y0 * (w + 1) + x1] + integral[y0 * (w + 1) + x0];
+                float mean = (float)sum * (1.0f / (float)((x1 - x0) * (y1 - y0)));
+                uint8_t ref = ((float)img[y * w + x] < mean * (1.0f - OCR_ADAPTIVE_BRADLEY_T)) ? 0 : 255;
+                if (out[y * w + x] != ref) mismatches++;
+            }
+        }
+        snprintf(msg, sizeof(msg), "radius %2d: ring matches full integral (%d mismatches, %u KB)",
+                 r, mismatches, size / 1024);
+        CHECK(mismatches == 0, msg);
+    }
+
+    snprintf(msg, sizeof(msg), "320-wide stage fits in 48 KB (%u bytes)",
+             ocr_adaptive_size(320, OCR_ADAPTIVE_RADIUS));
+    CHECK(ocr_adaptive_size(320, OCR_ADAPTIVE_RADIUS) <= 48 * 1024, msg);
+}
+
+static void test_contrast_tensor(void) {
+    static uint16_t rgb[320 * 240];
+    static uint8_t img[320 * 240], mask[320 * 240];
+    static int8_t tensor[320 * 240 * 3];
+    ocr_adaptive_t a;
+    ocr_tensor_quantizer_t q;
+    const int w = 320, h = 240;
+    const float mean[3] = {0.0f, 0.0f, 0.0f};
+    const float std[3] = {1.0f, 1.0f, 1.0f};
+
+    printf("\n=== Contrast Normalization to Tensor ===\n");
+
+    render_sign(img, mask, w, h);
+    for (int i = 0; i < w * h; i++) {
+        rgb[i] = (uint16_t)(((img[i] >> 3) << 11) | ((img[i] >> 2) << 5) | (img[i] >> 3));
+    }
+
+    // q = v - 128 の恒等量子化
+    ocr_quantizer_init(&q, w, h, 3, OCR_TENSOR_LAYOUT_NHWC, 1.0f / 255.0f, -128, mean, std);
+    ocr_adaptive_init(&a, w, h, OCR_ADAPTIVE_CONTRAST, OCR_ADAPTIVE_RADIUS, storage, sizeof(storage));
+    ocr_adaptive_rgb565_to_tensor(&a, &q, rgb, w, tensor);
+
+    // 文字と背景の平均差（入力は25）
+    double text_sum = 0, bg_sum = 0;
+    int text_n = 0, bg_n = 0;
+    for (int i = 0; i < w * h; i++) {
+        if (mask[i]) { text_sum += tensor[i * 3 + 1]; text_n++; }
+        else { bg_sum += tensor[i * 3 + 1]; bg_n++; }
+    }
+    double separation = bg_sum / bg_n - text_sum / text_n;
+    printf("  text/background separation: input 25, output %.1f\n", separation);
+    CHECK(separation > 50.0, "local contrast stretched");
+
+    // 平坦領域はゲイン上限でノイズを増幅しない
+    for (int i = 0; i < w * h; i++) rgb[i] = 0x8410;
+    ocr_adaptive_rgb565_to_tensor(&a, &q, rgb, w, tensor);
+    int flat_ok = 1;
+    for (int i = 0; i < w * h * 3; i++) if (tensor[i] < -2 || tensor[i] > 2) flat_ok = 0;
+    CHECK(flat_ok, "flat region maps to mid-gray");
+}
+
+static void bench_size(int w, int h) {
+    static uint8_t img[MAX_WIDTH * MAX_HEIGHT], out[MAX_WIDTH * MAX_HEIGHT];
+    static uint32_t integral[(MAX_WIDTH + 1) * (MAX_HEIGHT + 1)];
+    static uint32_t integral_sq[(MAX_WIDTH + 1) * (MAX_HEIGHT + 1)];
+    ocr_adaptive_t a;
+    uint32_t seed = 99;
+    const int iterations = 20;
+
+    for (int i = 0; i < w * h; i++) img[i] = (uint8_t)bench_rand(&seed);
+    ocr_adaptive_init(&a, w, h, OCR_ADAPTIVE_SAUVOLA, OCR_ADAPTIVE_RADIUS, storage, sizeof(storage));
+
+    double t0 = bench_now_us();
+    uint64_t c0 = bench_cycles();
+    for (int i = 0; i < iterations; i++) {
+        ocr_integral_image(img, w, w, h, integral, integral_sq);
+    }
+    uint64_t c1 = bench_cycles();
+    double t1 = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        ocr_adaptive_gray(&a, img, w, out, w);
+    }
+    double t2 = bench_now_us();
+
+    printf("%3dx%-3d integral: %7.1f us (%.2f cycles/px)   Sauvola total: %7.1f us, pool %u KB\n",
+           w, h, (t1 - t0) / iterations, (double)(c1 - c0) / iterations / (w * h),
+           (t2 - t1) / iterations, ocr_adaptive_size(w, OCR_ADAPTIVE_RADIUS) / 1024);
+}
+
+static void bench_adaptive(void) {
+    printf("\n=== Adaptive Stage Benchmark ===\n");
+    bench_size(320, 240);
+    bench_size(640, 480);
+}
+
+int main(void) {
+    printf("\n=== OCR Adaptive Binarization Test ===\n");
+
+    test_integral_image();
+    test_binarization();
+    test_ring_matches_full();
+    test_contrast_tensor();
+    bench_adaptive();
+
+    printf("\n");
+    if (failures > 0) {
+        printf("❌ %d test(s) failed\n", failures);
+        return 1;
+    }
+    printf("✅ All binarize tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,299 @@
+/**
+ * @file ctc_test.c
+ * @brief CTCグリーディデコーダとUTF-8文字セットのテスト＋ベンチマーク
+ *
+ * 目的: PP-OCR形式の辞書（1行1文字、UTF-8）をフラッシュ上のまま引けること、
+ *       int8出力のargmax・ブランク/繰り返しの縮約が正しく文字列を復元すること、
+ *       LUTによる信頼度が浮動小数点のsoftmaxと一致すること、
+ *       64バイトの領域テキストを超えず、マルチバイト文字を途中で切らないことを確認
+ * 計測: 80タイムステップ x 6,625クラス（日本語辞書規模）の1行デコード時間
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "bench_timer.h"
+#include "ocr_ctc.h"
+
+#define BIG_ENTRIES 6623            // PP-OCR辞書規模（+ブランク +空白 = 6,625クラス）
+#define BIG_CLASSES (BIG_ENTRIES + 2)
+#define TIMESTEPS 80
+#define REGION_TEXT 64              // ai_taskの領域テキスト
+
+static int failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("❌ FAIL: %s\n", msg); failures++; } \
+    else { printf("✅ %s\n", msg); } \
+} while (0)
+
+static uint8_t big_dict[BIG_ENTRIES * 4];
+static uint32_t big_dict_size = 0;
+static uint8_t index_storage[4096] __attribute__((aligned(4)));
+static int8_t scores[TIMESTEPS * BIG_CLASSES];
+static uint32_t seed = 4242;
+
+static const char small_dict[] = "あ\nい\nう\nか\nき\n東\n京\n駅\nA\nB\n1\n";
+
+static uint32_t utf8_encode(uint32_t cp, uint8_t *out) {
+    if (cp < 0x80) { out[0] = (uint8_t)cp; return 1; }
+    if (cp < 0x800) { out[0] = 0xC0 | (cp >> 6); out[1] = 0x80 | (cp & 0x3F); return 2; }
+    out[0] = 0xE0 | (cp >> 12); out[1] = 0x80 | ((cp >> 6) & 0x3F); out[2] = 0x80 | (cp & 0x3F);
+    return 3;
+}
+
+// 辞書のi番目の文字: 記号・英数字（1バイト）、ラテン拡張（2バイト）、かな・漢字（3バイト）
+static uint32_t big_codepoint(uint32_t i) {
+    if (i < 94) return 0x21 + i;
+    if (i < 94 + 64) return 0xC0 + (i - 94);
+    return 0x3041 + (i - 94 - 64);
+}
+
+static void build_big_dict(void) {
+    big_dict_size = 0;
+    for (uint32_t i = 0; i < BIG_ENTRIES; i++) {
+        big_dict_size += utf8_encode(big_codepoint(i), big_dict + big_dict_size);
+        big_dict[big_dict_size++] = '\n';
+    }
+}
+
+/**
+ * @brief 正解ラベル列からint8出力を合成（1文字2〜4フレーム、間にブランク1〜2）
+ * @param dense 1文字2フレーム・ブランク1（長い行用）
+ */
+static void synth_scores(const uint16_t *labels, uint32_t count, uint32_t classes, int dense, int8_t *out) {
+    uint32_t t = 0;
+    for (uint32_t i = 0; i <= count && t < TIMESTEPS; i++) {
+        uint32_t blanks = dense ? 1 : 1 + bench_rand(&seed) % 2;
+        uint32_t frames = dense ? 2 : 2 + bench_rand(&seed) % 3;
+        for (uint32_t f = 0; f < blanks + (i < count ? frames : 0) && t < TIMESTEPS; f++, t++) {
+            int8_t *row = out + t * classes;
+            for (uint32_t c = 0; c < classes; c++) row[c] = (int8_t)(-90 + (int)(bench_rand(&seed) % 80));
+            uint32_t win = (f < blanks) ? OCR_CTC_BLANK : labels[i];
+            row[win] = (int8_t)(20 + bench_rand(&seed) % 60);
+        }
+    }
+    // 残りはブランク
+    for (; t < TIMESTEPS; t++) {
+        int8_t *row = out + t * classes;
+        for (uint32_t c = 0; c < classes; c++) row[c] = -100;
+        row[OCR_CTC_BLANK] = 90;
+    }
+}
+
+static uint32_t argmax_ref(const int8_t *s, uint32_t n) {
+    uint32_t best = 0;
+    for (uint32_t i = 1; i < n; i++) if (s[i] > s[best]) best = i;
+    return best;
+}
+
+static void test_charset(void) {
+    ocr_charset_t cs;
+    const uint8_t *utf8;
+    char msg[160];
+
+    printf("\n=== UTF-8 Charset ===\n");
+    CHECK(ocr_charset_init(&cs, (const uint8_t*)small_dict, sizeof(small_dict) - 1,
+                           index_storage, sizeof(index_storage)) == 0 && cs.count == 11,
+          "small dictionary: 11 entries");
+    uint32_t n = ocr_charset_lookup(&cs, 6, &utf8);
+    CHECK(n == 3 && memcmp(utf8, "京", 3) == 0, "entry 6 is 京 (3 bytes, in place)");
+    CHECK(ocr_charset_lookup(&cs, 11, &utf8) == 0, "out of range lookup returns 0");
+
+    static const char crlf[] = "東\r\n京\r\n駅";
+    CHECK(ocr_charset_init(&cs, (const uint8_t*)crlf, sizeof(crlf) - 1, index_storage, sizeof(index_storage)) == 0 &&
+          cs.count == 3 && ocr_charset_lookup(&cs, 1, &utf8) == 3 && ocr_charset_lookup(&cs, 2, &utf8) == 3,
+          "CRLF lines and a last line without line feed");
+    static const char empty_line[] = "東\n\n駅\n";
+    CHECK(ocr_charset_init(&cs, (const uint8_t*)empty_line, sizeof(empty_line) - 1,
+                           index_storage, sizeof(index_storage)) != 0, "empty entry rejected");
+
+    build_big_dict();
+    uint32_t size = ocr_charset_size(big_dict, big_dict_size);
+    CHECK(ocr_charset_init(&cs, big_dict, big_dict_size, index_storage, size) == 0 && cs.count == BIG_ENTRIES,
+          "6,623-entry dictionary indexed");
+    int all = 1;
+    for (uint32_t i = 0; i < BIG_ENTRIES; i++) {
+        uint8_t expect[4];
+        uint32_t len = utf8_encode(big_codepoint(i), expect);
+        all &= ocr_charset_lookup(&cs, i, &utf8) == len && memcmp(utf8, expect, len) == 0;
+    }
+    snprintf(msg, sizeof(msg), "every entry found (%u bytes of flash, %u bytes of index)", big_dict_size, size);
+    CHECK(all, msg);
+}
+
+static void test_argmax(void) {
+    static int8_t v[BIG_CLASSES];
+    int ok = 1;
+
+    printf("\n=== Int8 Argmax ===\n");
+    for (uint32_t trial = 0; trial < 2000; trial++) {
+        uint32_t n = (trial < 200) ? 1 + trial % 70 : BIG_CLASSES;
+        // 狭い値域で同値を多く含める（最初の最大値を返すこと）
+        int range = (trial % 3 == 0) ? 4 : 256;
+        for (uint32_t i = 0; i < n; i++) v[i] = (int8_t)((int)(bench_rand(&seed) % range) - 128);
+        ok &= ocr_ctc_argmax(v, n) == argmax_ref(v, n);
+    }
+    CHECK(ok, "block argmax matches the scalar first maximum (1..70 and 6,625 classes, ties)");
+}
+
+static void test_greedy(void) {
+    ocr_charset_t cs;
+    ocr_ctc_t ctc;
+    ocr_ctc_result_t res;
+    char text[REGION_TEXT];
+    char msg[200];
+
+    printf("\n=== Greedy CTC Decoding ===\n");
+    ocr_charset_init(&cs, (const uint8_t*)small_dict, sizeof(small_dict) - 1, index_storage, sizeof(index_storage));
+    CHECK(ocr_ctc_init(&ctc, &cs, 11, OCR_CTC_OUTPUT_LOGITS, 0.05f, 0) != 0 &&
+          ocr_ctc_init(&ctc, &cs, 14, OCR_CTC_OUTPUT_LOGITS, 0.05f, 0) != 0,
+          "class count must be entries + 1 (or + 2 with space)");
+    ocr_ctc_init(&ctc, &cs, 13, OCR_CTC_OUTPUT_LOGITS, 0.05f, 0);
+
+    // 東京駅 A1 の 「きき」: 繰り返しはブランクを挟んだときだけ2文字
+    static const uint16_t labels[] = {6, 7, 8, 12, 9, 11, 5, 5};
+    synth_scores(labels, 8, 13, 0, scores);
+    int n = ocr_ctc_greedy(&ctc, scores, TIMESTEPS, text, sizeof(text), &res);
+    snprintf(msg, sizeof(msg), "decodes \"%s\" (%d bytes, %u chars)", text, n, res.chars);
+    CHECK(strcmp(text, "東京駅 A1きき") == 0 && res.chars == 8 && !res.truncated, msg);
+
+    // 同じクラスが連続するフレームは1文字
+    memset(scores, -100, 6 * 13);
+    for (int t = 0; t < 6; t++) scores[t * 13 + (t < 5 ? 1 : 0)] = 100;
+    ocr_ctc_greedy(&ctc, scores, 6, text, sizeof(text), &res);
+    CHECK(strcmp(text, "あ") == 0, "repeated frames collapse to one character");
+
+    // 信頼度: 浮動小数点softmaxの平均と比較
+    const float scale = 0.05f;
+    synth_scores(labels, 8, 13, 0, scores);
+    ocr_ctc_greedy(&ctc, scores, TIMESTEPS, text, sizeof(text), &res);
+    double ref = 0.0;
+    int emitted = 0;
+    uint32_t prev = 0;
+    for (int t = 0; t < TIMESTEPS; t++) {
+        const int8_t *row = scores + t * 13;
+        uint32_t c = argmax_ref(row, 13);
+        if (c != 0 && c != prev) {
+            double sum = 0.0;
+            for (int k = 0; k < 13; k++) sum += exp((row[k] - row[c]) * scale);
+            ref += 1.0 / sum;
+            emitted++;
+        }
+        prev = c;
+    }
+    ref /= emitted;
+    snprintf(msg, sizeof(msg), "LUT confidence %.4f vs float softmax %.4f", res.confidence, ref);
+    CHECK(fabs(res.confidence - ref) < 0.002, msg);
+
+    // softmax済み出力（PP-OCRのエクスポート）: 最大値がそのまま確率
+    ocr_ctc_init(&ctc, &cs, 13, OCR_CTC_OUTPUT_PROBS, 1.0f / 255.0f, -128);
+    memset(scores, -128, 4 * 13);
+    scores[0 * 13 + 6] = 127;        // 1.0
+    scores[1 * 13 + 0] = 100;
+    scores[2 * 13 + 7] = -1;         // 0.5
+    scores[3 * 13 + 0] = 100;
+    ocr_ctc_greedy(&ctc, scores, 4, text, sizeof(text), &res);
+    snprintf(msg, sizeof(msg), "softmax output: \"%s\", confidence %.3f (mean of 1.0 and 0.5)", text, res.confidence);
+    CHECK(strcmp(text, "東京") == 0 && fabs(res.confidence - 0.75f) < 0.003f, msg);
+
+    // 空行
+    memset(scores, -128, 4 * 13);
+    for (int t = 0; t < 4; t++) scores[t * 13] = 127;
+    n = ocr_ctc_greedy(&ctc, scores, 4, text, sizeof(text), &res);
+    CHECK(n == 0 && text[0] == '\0' && res.chars == 0 && res.confidence == 0.0f, "all blank: empty string, confidence 0");
+}
+
+static int valid_utf8(const char *s) {
+    const uint8_t *p = (const uint8_t*)s;
+    while (*p) {
+        uint32_t len = (*p < 0x80) ? 1 : ((*p & 0xE0) == 0xC0) ? 2 : ((*p & 0xF0) == 0xE0) ? 3 : 0;
+        if (!len) return 0;
+        for (uint32_t i = 1; i < len; i++) if ((p[i] & 0xC0) != 0x80) return 0;
+        p += len;
+    }
+    return 1;
+}
+
+static void test_truncation(void) {
+    ocr_charset_t cs;
+    ocr_ctc_t ctc;
+    ocr_ctc_result_t res;
+    char text[REGION_TEXT + 8];
+    char msg[160];
+    uint16_t labels[26];
+
+    printf("\n=== Region Text Bound ===\n");
+    ocr_charset_init(&cs, big_dict, big_dict_size, index_storage, sizeof(index_storage));
+    ocr_ctc_init(&ctc, &cs, BIG_CLASSES, OCR_CTC_OUTPUT_LOGITS, 0.05f, 0);
+
+    // 1バイト文字1つの後に3バイト文字が続く行（64バイトの境界が文字の途中に来る）
+    labels[0] = 1;
+    for (int i = 1; i < 26; i++) labels[i] = (uint16_t)(1 + 94 + 64 + (bench_rand(&seed) % 5000));
+    memset(text + REGION_TEXT, 0x5A, 8);
+    synth_scores(labels, 26, BIG_CLASSES, 1, scores);
+    int n = ocr_ctc_greedy(&ctc, scores, TIMESTEPS, text, REGION_TEXT, &res);
+    snprintf(msg, sizeof(msg), "64-byte region: %d bytes, %u whole characters, truncated", n, res.chars);
+    CHECK(n == 1 + 3 * 20 && res.chars == 21 && res.truncated && text[n] == '\0' &&
+          text[REGION_TEXT] == 0x5A && valid_utf8(text), msg);
+}
+
+static void bench_decode(void) {
+    ocr_charset_t cs;
+    ocr_ctc_t ctc;
+    ocr_ctc_result_t res;
+    char text[REGION_TEXT];
+    uint16_t labels[20];
+    const int iterations = 200;
+
+    printf("\n=== Decode Benchmark (%d timesteps x %d classes) ===\n", TIMESTEPS, BIG_CLASSES);
+    ocr_charset_init(&cs, big_dict, big_dict_size, index_storage, sizeof(index_storage));
+    for (int i = 0; i < 20; i++) labels[i] = (uint16_t)(1 + bench_rand(&seed) % BIG_ENTRIES);
+    synth_scores(labels, 20, BIG_CLASSES, 0, scores);
+
+    // 比較用: 素朴なスカラーargmax
+    volatile uint32_t sink = 0;
+    double t0 = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        for (int t = 0; t < TIMESTEPS; t++) sink += argmax_ref(scores + t * BIG_CLASSES, BIG_CLASSES);
+    }
+    double naive_us = (bench_now_us() - t0) / iterations;
+    (void)sink;
+
+    const char *names[2] = {"softmax output", "logits + exp LUT"};
+    const uint8_t kinds[2] = {OCR_CTC_OUTPUT_PROBS, OCR_CTC_OUTPUT_LOGITS};
+    for (int k = 0; k < 2; k++) {
+        ocr_ctc_init(&ctc, &cs, BIG_CLASSES, kinds[k], k ? 0.05f : 1.0f / 255.0f, -128);
+        t0 = bench_now_us();
+        uint64_t c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            ocr_ctc_greedy(&ctc, scores, TIMESTEPS, text, sizeof(text), &res);
+        }
+        uint64_t c1 = bench_cycles();
+        double us = (bench_now_us() - t0) / iterations;
+        printf("  %-18s %8.1f us/line, %.2f cycles/class, %u chars\n", names[k], us,
+               (double)(c1 - c0) / iterations / (TIMESTEPS * BIG_CLASSES), res.chars);
+    }
+    printf("  %-18s %8.1f us/line (argmax only)\n", "naive scalar", naive_us);
+}
+
+int main(void) {
+    printf("\n=== OCR CTC Decoder Test ===\n");
+
+    test_charset();
+    test_argmax();
+    test_greedy();
+    test_truncation();
+    bench_decode();
+
+    printf("\n");
+    if (failures > 0) {
+        printf("❌ %d test(s) failed\n", failures);
+        return 1;
+    }
+    printf("✅ All CTC decoder tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,770 @@
+/**
+ * @file geometry_test.c
+ * @brief 傾き推定・回転切り出しのテストとベンチマーク
+ *
+ * 目的: 手持ち撮影の傾き（±15°）を0.5°以内で推定し、固定小数点の回転切り出しで
+ *       水平な文字行に戻せることを確認。四辺形→認識帯の射影変換を浮動小数点版と比較
+ *       小さい文字はフル解像度から1パスで切り出す方が検出解像度からより正確なことを確認
+ *       縦書きの90度回転切り出しを素朴な転置・縦書き四辺形の射影変換と比較
+ *       切り出し→認識入力（int8）の融合カーネルが2段（RGB565帯＋量子化）とビット一致すること
+ *       3〜4倍縮小でも1画素幅の線が融合カーネルの出力から消えないこと
+ * 計測: 320x240（検出解像度）での推定時間（上限0.5 ms）
+ *       認識入力1個あたりの融合カーネルと2段（中間バッファ確保＋コピー）の比較
+ *       縦書き90度回転の融合カーネル: 列ブロック処理と行ごとの格子走査の比較
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "bench_timer.h"
+#include "ocr_geometry.h"
+
+#define MAX_WIDTH  640
+#define MAX_HEIGHT 480
+
+static int failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("❌ FAIL: %s\n", msg); failures++; } \
+    else { printf("✅ %s\n", msg); } \
+} while (0)
+
+static uint32_t scratch[OCR_SKEW_SCRATCH_SIZE / sizeof(uint32_t)];
+
+static uint16_t gray565(int v) {
+    if (v < 0) v = 0;
+    if (v > 255) v = 255;
+    return (uint16_t)(((v >> 3) << 11) | ((v >> 2) << 5) | (v >> 3));
+}
+
+/**
+ * @brief 紙面座標(u, v)の文字パターン: 24px間隔の行、高さ12px、字間・単語間あり
+ */
+static int page_ink(float u, float v) {
+    int iu = (int)floorf(u), iv = (int)floorf(v);
+    int row = ((iv % 24) + 24) % 24;
+    int col = ((iu % 60) + 60) % 60;
+    if (row < 6 || row >= 18) return 0;
+    if (col >= 48) return 0;                 // 単語間
+    return (col % 8) < 5;                    // 字間
+}
+
+/**
+ * @brief 中心まわりに angle_deg 傾けた紙面を描画（+ = 右下がり）
+ */
+static void render_page(uint16_t *img, int w, int h, float angle_deg, uint32_t seed) {
+    float rad = angle_deg * 3.14159265f / 180.0f;
+    float c = cosf(rad), s = sinf(rad);
+    float cx = 0.5f * (w - 1), cy = 0.5f * (h - 1);
+
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            float dx = x - cx, dy = y - cy;
+            float u = c * dx + s * dy;
+            float v = -s * dx + c * dy;
+            int noise = (int)(bench_rand(&seed) % 17) - 8;
+            img[y * w + x] = gray565((page_ink(u, v) ? 50 : 210) + noise);
+        }
+    }
+}
+
+static void test_skew_estimate(void) {
+    static uint16_t img[320 * 240];
+    const float angles[] = {0.0f, 3.0f, -5.5f, 7.3f, -10.0f, 12.0f, -14.0f};
+    const int w = 320, h = 240;
+    ocr_skew_t skew;
+    char msg[128];
+
+    printf("\n=== Skew Estimation (320x240) ===\n");
+
+    for (unsigned i = 0; i < sizeof(angles) / sizeof(angles[0]); i++) {
+        render_page(img, w, h, angles[i], 1234 + i);
+        int ret = ocr_skew_estimate(img, w, w, h, 1, scratch, &skew);
+        float est = skew.angle_cdeg / 100.0f;
+        snprintf(msg, sizeof(msg), "skew %+6.2f deg -> %+6.2f deg (conf %u, %u points)",
+                 angles[i], est, skew.confidence, skew.edge_points);
+        CHECK(ret == 0 && fabsf(est - angles[i]) <= 0.5f, msg);
+    }
+
+    // 平坦な画面ではエッジ不足で推定しない
+    for (int i = 0; i < w * h; i++) img[i] = gray565(128);
+    CHECK(ocr_skew_estimate(img, w, w, h, 1, scratch, &skew) != 0 && skew.angle_cdeg == 0,
+          "flat frame reports no estimate");
+}
+
+static void test_skew_vga_step(void) {
+    static uint16_t img[MAX_WIDTH * MAX_HEIGHT];
+    ocr_skew_t skew;
+    char msg[128];
+
+    printf("\n=== Skew Estimation (640x480, step 2) ===\n");
+
+    render_page(img, MAX_WIDTH, MAX_HEIGHT, -8.0f, 77);
+    int ret = ocr_skew_estimate(img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, 2, scratch, &skew);
+    snprintf(msg, sizeof(msg), "VGA frame on a 2x grid: -8.00 deg -> %+.2f deg", skew.angle_cdeg / 100.0f);
+    CHECK(ret == 0 && abs(skew.angle_cdeg + 800) <= 50, msg);
+    CHECK(skew.edge_points <= OCR_SKEW_MAX_POINTS, "edge points decimated to the work bound");
+}
+
+static void test_affine_identity(void) {
+    static uint16_t img[320 * 240], out[320 * 240];
+    ocr_affine_q16_t a;
+    uint32_t seed = 5;
+
+    printf("\n=== Affine Warp ===\n");
+
+    for (int i = 0; i < 320 * 240; i++) img[i] = (uint16_t)bench_rand(&seed);
+
+    // 角度0・等倍: (40, 30)から100x50の切り出しと完全一致
+    ocr_affine_rotate_crop(&a, 40.0f + 49.5f, 30.0f + 24.5f, 0, 1.0f, 100, 50);
+    ocr_warp_affine_rgb565(img, 320, 320, 240, &a, out, 100, 100, 50);
+    int exact = 1;
+    for (int y = 0; y < 50; y++)
+        for (int x = 0; x < 100; x++)
+            if (out[y * 100 + x] != img[(y + 30) * 320 + x + 40]) exact = 0;
+    CHECK(exact, "zero angle, unit scale reproduces the crop bit-exactly");
+
+    // 画像外は端画素を繰り返す
+    ocr_affine_rotate_crop(&a, -10.0f, 250.0f, 0, 1.0f, 8, 8);
+    ocr_warp_affine_rgb565(img, 320, 320, 240, &a, out, 8, 8, 8);
+    CHECK(out[0] == img[239 * 320] && out[7 * 8 + 7] == img[239 * 320], "samples outside the frame clamp to the edge");
+}
+
+static void test_deskew_crop(void) {
+    static uint16_t img[320 * 240], out[200 * 72];
+    const int w = 320, h = 240, cw = 200, ch = 72;
+    const float angle = 9.0f;
+    ocr_skew_t skew;
+    ocr_affine_q16_t a;
+    char msg[128];
+
+    printf("\n=== Deskew Crop ===\n");
+
+    render_page(img, w, h, angle, 42);
+    ocr_skew_estimate(img, w, w, h, 1, scratch, &skew);
+    ocr_affine_rotate_crop(&a, 0.5f * (w - 1), 0.5f * (h - 1), skew.angle_cdeg, 1.0f, cw, ch);
+    ocr_warp_affine_rgb565(img, w, w, h, &a, out, cw, cw, ch);
+
+    // 切り出し結果を傾きなしの紙面と比較
+    int match = 0, axis_match = 0;
+    for (int y = 0; y < ch; y++) {
+        for (int x = 0; x < cw; x++) {
+            float u = x - 0.5f * (cw - 1), v = y - 0.5f * (ch - 1);
+            int ref = page_ink(u, v);
+            int ink = (out[y * cw + x] >> 11) < 16;
+            int axis_ink = (img[(y + (h - ch) / 2) * w + x + (w - cw) / 2] >> 11) < 16;
+            match += (ink == ref);
+            axis_match += (axis_ink == ref);
+        }
+    }
+    float rate = (float)match / (cw * ch);
+    float axis_rate = (float)axis_match / (cw * ch);
+    snprintf(msg, sizeof(msg), "deskewed crop matches upright text (%.1f%%, axis-aligned crop %.1f%%)",
+             100.0f * rate, 100.0f * axis_rate);
+    CHECK(rate > 0.95f && rate > axis_rate + 0.2f, msg);
+
+    // 外接矩形から行の長さ・太さを復元
+    uint16_t lw, lh;
+    float r = 10.0f * 3.14159265f / 180.0f;
+    uint16_t bw = (uint16_t)lrintf(300 * cosf(r) + 20 * sinf(r));
+    uint16_t bh = (uint16_t)lrintf(300 * sinf(r) + 20 * cosf(r));
+    ocr_deskew_extent(bw, bh, 1000, &lw, &lh);
+    snprintf(msg, sizeof(msg), "box %ux%u at 10 deg -> line %ux%u (expected 300x20)", bw, bh, lw, lh);
+    CHECK(abs(lw - 300) <= 2 && abs(lh - 20) <= 2, msg);
+    ocr_deskew_extent(100, 10, 1500, &lw, &lh);
+    CHECK(lw == 100 && lh == 10, "box too flat for the angle keeps its size");
+}
+
+/**
+ * @brief 小さい文字: 1px幅の縦画（3px周期）、高さ8pxの行が16px間隔
+ */
+static int small_ink(int x, int y) {
+    int row = y % 16;
+    return row >= 4 && row < 12 && (x % 3) == 0;
+}
+
+static void test_crop_resize(void) {
+    static uint16_t img[MAX_WIDTH * MAX_HEIGHT], half[320 * 240];
+    static uint16_t full_strip[OCR_STRIP_MAX_WIDTH * OCR_STRIP_HEIGHT], det_strip[OCR_STRIP_MAX_WIDTH * OCR_STRIP_HEIGHT];
+    uint16_t out[50 * 25];
+    uint32_t seed = 11;
+    char msg[160];
+
+    printf("\n=== Crop-Resize ===\n");
+
+    // 2倍縮小: 各出力が2x2画素の平均（フィールドごとに四捨五入）
+    for (int i = 0; i < 320 * 240; i++) half[i] = (uint16_t)bench_rand(&seed);
+    ocr_crop_resize_rgb565(half, 320, 320, 240, 40, 30, 100, 50, out, 50, 50, 25);
+    int exact = 1;
+    for (int y = 0; y < 25; y++) {
+        for (int x = 0; x < 50; x++) {
+            uint32_t r = 0, g = 0, b = 0;
+            for (int k = 0; k < 4; k++) {
+                uint16_t p = half[(30 + 2 * y + k / 2) * 320 + 40 + 2 * x + k % 2];
+                r += p >> 11; g += (p >> 5) & 63; b += p & 31;
+            }
+            uint16_t ref = (uint16_t)((((r + 2) / 4) << 11) | (((g + 2) / 4) << 5) | ((b + 2) / 4));
+            exact &= (out[y * 50 + x] == ref);
+        }
+    }
+    CHECK(exact, "2x reduction averages each 2x2 block");
+
+    // 等倍: 切り出しそのもの
+    ocr_crop_resize_rgb565(half, 320, 320, 240, 7, 9, 50, 25, out, 50, 50, 25);
+    exact = 1;
+    for (int y = 0; y < 25; y++)
+        for (int x = 0; x < 50; x++)
+            exact &= (out[y * 50 + x] == half[(9 + y) * 320 + 7 + x]);
+    CHECK(exact, "unit scale reproduces the crop");
+
+    // 小さい文字: 640x480から直接切り出す場合と、320x240（2x2平均）から切り出す場合
+    for (int y = 0; y < MAX_HEIGHT; y++)
+        for (int x = 0; x < MAX_WIDTH; x++)
+            img[y * MAX_WIDTH + x] = gray565(small_ink(x, y) ? 20 : 235);
+    for (int y = 0; y < 240; y++) {
+        for (int x = 0; x < 320; x++) {
+            int sum = 0;
+            for (int k = 0; k < 4; k++) sum += (img[(2 * y + k / 2) * MAX_WIDTH + 2 * x + k % 2] >> 11);
+            half[y * 320 + x] = gray565(((sum * 8) + 2) / 4);
+        }
+    }
+
+    // 行（y=164..172）を上下4pxの余白付きで、高さ48の認識帯へ
+    const int bx = 60, by = 160, bw = 96, bh = 16;
+    const int sw = bw * OCR_STRIP_HEIGHT / bh;
+    ocr_crop_resize_rgb565(img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, bx, by, bw, bh,
+                           full_strip, sw, sw, OCR_STRIP_HEIGHT);
+    ocr_crop_resize_rgb565(half, 320, 320, 240, bx / 2, by / 2, bw / 2, bh / 2,
+                           det_strip, sw, sw, OCR_STRIP_HEIGHT);
+
+    int full_match = 0, det_match = 0;
+    for (int y = 0; y < OCR_STRIP_HEIGHT; y++) {
+        for (int x = 0; x < sw; x++) {
+            int ref = small_ink(bx + x * bw / sw, by + y * bh / OCR_STRIP_HEIGHT);
+            full_match += (((full_strip[y * sw + x] >> 11) < 16) == ref);
+            det_match += (((det_strip[y * sw + x] >> 11) < 16) == ref);
+        }
+    }
+    float full_rate = (float)full_match / (sw * OCR_STRIP_HEIGHT);
+    float det_rate = (float)det_match / (sw * OCR_STRIP_HEIGHT);
+    snprintf(msg, sizeof(msg), "1 px strokes: full-resolution crop %.1f%%, detection-resolution crop %.1f%%",
+             100.0f * full_rate, 100.0f * det_rate);
+    CHECK(full_rate > 0.9f && full_rate > det_rate + 0.1f, msg);
+}
+
+/**
+ * @brief 素朴な90度回転切り出し（等倍）: 出力1行ごとにフレームの列を縦に走査
+ */
+static void rotate90_naive(const uint16_t *src, int stride, int cx, int cy, int cw, int ch,
+                           uint16_t *dst, int dst_stride) {
+    for (int v = 0; v < cw; v++)
+        for (int u = 0; u < ch; u++)
+            dst[v * dst_stride + u] = src[(cy + u) * stride + cx + cw - 1 - v];
+}
+
+static void test_rotate90(void) {
+    static uint16_t img[MAX_WIDTH * MAX_HEIGHT], out[480 * 240], ref[480 * 240];
+    uint32_t seed = 21;
+    char msg[160];
+
+    printf("\n=== Rotate-90 Crop (vertical text) ===\n");
+
+    for (int i = 0; i < MAX_WIDTH * MAX_HEIGHT; i++) img[i] = (uint16_t)bench_rand(&seed);
+
+    // 等倍: 列の上→下が出力の左→右、列の右端が出力の上端
+    ocr_crop_rotate90_rgb565(img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, 50, 20, 30, 100, out, 100, 100, 30);
+    rotate90_naive(img, MAX_WIDTH, 50, 20, 30, 100, ref, 100);
+    CHECK(memcmp(out, ref, 100 * 30 * sizeof(uint16_t)) == 0, "unit scale equals the naive transpose");
+
+    // 2倍縮小: 回転した2x2平均
+    ocr_crop_rotate90_rgb565(img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, 50, 20, 40, 100, out, 50, 50, 20);
+    int exact = 1;
+    for (int v = 0; v < 20; v++) {
+        for (int u = 0; u < 50; u++) {
+            uint32_t r = 0, g = 0, b = 0;
+            for (int k = 0; k < 4; k++) {
+                uint16_t p = img[(20 + 2 * u + k / 2) * MAX_WIDTH + 50 + 40 - 2 - 2 * v + k % 2];
+                r += p >> 11; g += (p >> 5) & 63; b += p & 31;
+            }
+            exact &= (out[v * 50 + u] == (uint16_t)((((r + 2) / 4) << 11) | (((g + 2) / 4) << 5) | ((b + 2) / 4)));
+        }
+    }
+    CHECK(exact, "2x reduction averages rotated 2x2 blocks");
+
+    // 拡大: 縦書き四辺形（右上→右下→左下→左上）の射影変換と同じ向き・同じ標本点
+    for (int y = 0; y < MAX_HEIGHT; y++)
+        for (int x = 0; x < MAX_WIDTH; x++)
+            img[y * MAX_WIDTH + x] = gray565((x * 7 + y * 3) & 255);
+    const float qx[4] = {112.0f, 112.0f, 100.0f, 100.0f}, qy[4] = {40.0f, 160.0f, 160.0f, 40.0f};
+    ocr_perspective_t p;
+    ocr_perspective_from_quad(&p, qx, qy, 480, OCR_STRIP_HEIGHT);
+    ocr_warp_perspective_rgb565(img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, &p, ref, 480, 480, OCR_STRIP_HEIGHT);
+    ocr_crop_rotate90_rgb565(img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, 100, 40, 12, 120,
+                             out, 480, 480, OCR_STRIP_HEIGHT);
+    int max_diff = 0;
+    for (int i = 0; i < 480 * OCR_STRIP_HEIGHT; i++) {
+        int d = abs((out[i] >> 5 & 63) - (ref[i] >> 5 & 63));
+        max_diff = d > max_diff ? d : max_diff;
+    }
+    snprintf(msg, sizeof(msg), "enlarged strip matches the vertical quad warp (max green diff %d)", max_diff);
+    CHECK(max_diff <= 1, msg);
+
+    // ベンチマーク: 240x480の縦書き領域を480x240へ（ブロック処理 vs 素朴な転置）
+    const int iterations = 50;
+    uint64_t c0 = bench_cycles();
+    for (int i = 0; i < iterations; i++) {
+        rotate90_naive(img, MAX_WIDTH, 200, 0, 240, 480, ref, 480);
+    }
+    uint64_t c1 = bench_cycles();
+    for (int i = 0; i < iterations; i++) {
+        ocr_crop_rotate90_rgb565(img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, 200, 0, 240, 480, out, 480, 480, 240);
+    }
+    uint64_t c2 = bench_cycles();
+    CHECK(memcmp(out, ref, sizeof(out)) == 0, "blocked kernel output equals the naive transpose (240x480)");
+    printf("  rotate-crop 240x480: naive %.2f, blocked %.2f cycles/px\n",
+           (double)(c1 - c0) / iterations / (480 * 240), (double)(c2 - c1) / iterations / (480 * 240));
+
+    // 融合カーネル（認識入力480x240x3へ）: 出力行ごとに格子でフレームの列を走査 vs 列ブロック
+    // 交互に計測して各方式の最速ラウンドを採用
+    static int8_t row_tensor[480 * 240 * 3], block_tensor[480 * 240 * 3];
+    const float mean[3] = {0.5f, 0.5f, 0.5f}, std[3] = {0.5f, 0.5f, 0.5f};
+    ocr_tensor_quantizer_t q;
+    ocr_affine_q16_t a;
+    const int rounds = 5;
+    uint64_t best_row = UINT64_MAX, best_block = UINT64_MAX;
+
+    ocr_quantizer_init(&q, 480, 240, 3, OCR_TENSOR_LAYOUT_NHWC, 0.0078431f, 0, mean, std);
+    ocr_affine_crop_rotate90(&a, 200, 0, 240, 480, 480, 240);
+    for (int r = 0; r < rounds; r++) {
+        c0 = bench_cycles();
+        for (int i = 0; i < iterations / 5; i++) {
+            ocr_warp_affine_to_tensor(&q, img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, &a, 480, 240, row_tensor);
+        }
+        c1 = bench_cycles();
+        for (int i = 0; i < iterations / 5; i++) {
+            ocr_crop_rotate90_to_tensor(&q, img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, 200, 0, 240, 480,
+                                        480, 240, block_tensor);
+        }
+        c2 = bench_cycles();
+        best_row = (c1 - c0 < best_row) ? c1 - c0 : best_row;
+        best_block = (c2 - c1 < best_block) ? c2 - c1 : best_block;
+    }
+    CHECK(memcmp(row_tensor, block_tensor, sizeof(block_tensor)) == 0,
+          "blocked fused kernel equals the per-row grid (240x480 -> 480x240x3)");
+    printf("  fused rotate-crop 240x480: per-row grid %.2f, blocked %.2f cycles/px\n",
+           (double)best_row / (iterations / 5) / (480 * 240), (double)best_block / (iterations / 5) / (480 * 240));
+}
+
+/**
+ * @brief 2段の認識入力作成（中間バッファ確保→RGB565帯→量子化→解放）
+ */
+static void affine_two_pass(const ocr_tensor_quantizer_t *q, const uint16_t *img, const ocr_affine_q16_t *a,
+                            int sw, int sh, int8_t *tensor) {
+    uint16_t *region = malloc((size_t)sw * sh * 2);
+    memset(region, 0, (size_t)sw * sh * 2);
+    ocr_warp_affine_rgb565(img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, a, region, sw, sw, sh);
+    ocr_strip_to_tensor(q, region, sw, sw, sh, tensor);
+    free(region);
+}
+
+static void test_fused_tensor(void) {
+    static uint16_t img[MAX_WIDTH * MAX_HEIGHT], strip[MAX_WIDTH * OCR_STRIP_HEIGHT];
+    static int8_t fused[320 * OCR_STRIP_HEIGHT * 3], ref[320 * OCR_STRIP_HEIGHT * 3];
+    const float mean[3] = {0.5f, 0.5f, 0.5f}, std[3] = {0.5f, 0.5f, 0.5f};
+    ocr_tensor_quantizer_t rgb, gray;
+    ocr_affine_q16_t a;
+    uint32_t seed = 31;
+    char msg[160];
+
+    printf("\n=== Fused Crop-Resize-Quantize (recognition input) ===\n");
+
+    for (int i = 0; i < MAX_WIDTH * MAX_HEIGHT; i++) img[i] = (uint16_t)bench_rand(&seed);
+    ocr_quantizer_init(&rgb, 320, OCR_STRIP_HEIGHT, 3, OCR_TENSOR_LAYOUT_NHWC, 0.0078431f, 0, mean, std);
+    ocr_quantizer_init(&gray, 320, OCR_STRIP_HEIGHT, 1, OCR_TENSOR_LAYOUT_NCHW, 0.0078431f, 0, mean, std);
+
+    // 拡大・縮小・画像端（負の原点、下端の行）・回転（右端にかかる）・90度回転・入力幅を超える帯
+    int exact = 1;
+    for (int c = 0; c < 6; c++) {
+        int sw = 200, sh = OCR_STRIP_HEIGHT;
+        switch (c) {
+        case 0: ocr_affine_crop_resize(&a, 100, 200, 100, 24, sw, sh); break;
+        case 1: ocr_affine_crop_resize(&a, 20, 100, 600, 144, sw, sh); break;
+        case 2: sw = 160; ocr_affine_crop_resize(&a, 0, MAX_HEIGHT - 20, 80, 20, sw, sh); break;
+        case 3: ocr_affine_rotate_crop(&a, 600.0f, 240.0f, 900, 1.5f, sw, sh); break;
+        case 4: sw = 300; ocr_affine_crop_rotate90(&a, 400, 100, 30, 180, sw, sh); break;
+        default: sw = 480; ocr_affine_crop_resize(&a, 40, 300, 480, 48, sw, sh); break;
+        }
+        for (int q = 0; q < 2; q++) {
+            const ocr_tensor_quantizer_t *quantizer = q ? &gray : &rgb;
+            memset(fused, 0x55, sizeof(fused));
+            ocr_warp_affine_to_tensor(quantizer, img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, &a, sw, sh, fused);
+            affine_two_pass(quantizer, img, &a, sw, sh, ref);
+            exact &= memcmp(fused, ref, 320 * OCR_STRIP_HEIGHT * quantizer->channels) == 0;
+        }
+    }
+    CHECK(exact, "affine grids (enlarge, reduce, edges, deskew, rotate-90, clipped), RGB NHWC and gray NCHW: "
+                 "bit-exact with two passes");
+
+    // 90度回転の格子: 拡大時はocr_crop_rotate90_rgb565()と同じ標本点
+    ocr_crop_rotate90_rgb565(img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, 400, 100, 30, 180, strip, 300, 300, 48);
+    ocr_strip_to_tensor(&rgb, strip, 300, 300, 48, ref);
+    ocr_affine_crop_rotate90(&a, 400, 100, 30, 180, 300, 48);
+    ocr_warp_affine_to_tensor(&rgb, img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, &a, 300, 48, fused);
+    CHECK(memcmp(fused, ref, sizeof(fused)) == 0, "rotate-90 grid equals the rotate-crop kernel when enlarging");
+
+    // 箱の切り出し: 2倍までは格子（2段の格子版と一致）、それ以上は面積平均（参照カーネルと一致）
+    const uint16_t boxes[5][6] = {
+        // x, y, w, h, 帯の幅, 高さ
+        {100, 200, 100, 24, 200, 48},   // 拡大
+        {20, 100, 400, 96, 200, 48},    // 2倍縮小（格子）
+        {20, 100, 600, 144, 200, 48},   // 3倍縮小（面積平均）
+        {0, 292, 640, 188, 160, 48},    // 4倍縮小、画像の右下端まで
+        {30, 10, 600, 168, 480, 48},    // 入力幅を超える帯
+    };
+    exact = 1;
+    for (int c = 0; c < 5; c++) {
+        const uint16_t *b = boxes[c];
+        for (int q = 0; q < 2; q++) {
+            const ocr_tensor_quantizer_t *quantizer = q ? &gray : &rgb;
+            memset(fused, 0x55, sizeof(fused));
+            ocr_crop_resize_to_tensor(quantizer, img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT,
+                                      b[0], b[1], b[2], b[3], b[4], b[5], fused);
+            if (b[3] > 2 * b[5]) {
+                ocr_crop_resize_rgb565(img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, b[0], b[1], b[2], b[3],
+                                       strip, b[4], b[4], b[5]);
+                ocr_strip_to_tensor(quantizer, strip, b[4], b[4], b[5], ref);
+            } else {
+                ocr_affine_crop_resize(&a, b[0], b[1], b[2], b[3], b[4], b[5]);
+                affine_two_pass(quantizer, img, &a, b[4], b[5], ref);
+            }
+            exact &= memcmp(fused, ref, 320 * OCR_STRIP_HEIGHT * quantizer->channels) == 0;
+        }
+    }
+    CHECK(exact, "crop-resize boxes (enlarge, 2x grid, 3-4x area average, edges, clipped): bit-exact with two passes");
+
+    // 縦書き: 同様に2倍までは90度回転の格子、それ以上は回転切り出しカーネルの面積平均
+    const uint16_t columns[4][6] = {
+        {400, 100, 30, 180, 300, 48},   // 拡大
+        {300, 40, 96, 400, 200, 48},    // 2倍縮小（格子）
+        {500, 0, 140, 480, 160, 48},    // 約3倍縮小（面積平均）、画像の上下端
+        {600, 20, 40, 400, 400, 12},    // 入力幅を超える帯、右端
+    };
+    exact = 1;
+    for (int c = 0; c < 4; c++) {
+        const uint16_t *b = columns[c];
+        for (int q = 0; q < 2; q++) {
+            const ocr_tensor_quantizer_t *quantizer = q ? &gray : &rgb;
+            memset(fused, 0x55, sizeof(fused));
+            ocr_crop_rotate90_to_tensor(quantizer, img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT,
+                                        b[0], b[1], b[2], b[3], b[4], b[5], fused);
+            if (b[2] > 2 * b[5]) {
+                ocr_crop_rotate90_rgb565(img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, b[0], b[1], b[2], b[3],
+                                         strip, b[4], b[4], b[5]);
+                ocr_strip_to_tensor(quantizer, strip, b[4], b[4], b[5], ref);
+            } else {
+                ocr_affine_crop_rotate90(&a, b[0], b[1], b[2], b[3], b[4], b[5]);
+                affine_two_pass(quantizer, img, &a, b[4], b[5], ref);
+            }
+            exact &= memcmp(fused, ref, 320 * OCR_STRIP_HEIGHT * quantizer->channels) == 0;
+        }
+    }
+    CHECK(exact, "rotate-90 columns (enlarge, 2x grid, 3x area average, edges, clipped): bit-exact with two passes");
+
+    // 射影変換: 一部がフレーム外にはみ出す四辺形も含めて
+    const float quads[2][8] = {
+        {100.0f, 540.0f, 560.0f, 90.0f, 200.0f, 180.0f, 290.0f, 300.0f},
+        {-20.0f, 300.0f, 310.0f, -30.0f, 440.0f, 430.0f, 500.0f, 490.0f},
+    };
+    exact = 1;
+    for (int k = 0; k < 2; k++) {
+        ocr_perspective_t p;
+        uint16_t sw = ocr_quad_strip_width(quads[k], quads[k] + 4, OCR_STRIP_HEIGHT, MAX_WIDTH);
+        ocr_perspective_from_quad(&p, quads[k], quads[k] + 4, sw, OCR_STRIP_HEIGHT);
+        ocr_warp_perspective_rgb565(img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, &p, strip, sw, sw, OCR_STRIP_HEIGHT);
+        ocr_strip_to_tensor(&rgb, strip, sw, sw, OCR_STRIP_HEIGHT, ref);
+        ocr_warp_perspective_to_tensor(&rgb, img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, &p, sw, OCR_STRIP_HEIGHT, fused);
+        exact &= memcmp(fused, ref, sizeof(fused)) == 0;
+    }
+    CHECK(exact, "perspective quads (inside and past the frame edge): bit-exact with two passes");
+
+    // ベンチマーク: 640x480から200x48の帯（小さい文字の拡大、認識入力320x48x3）
+    // 交互に計測して各方式の最速ラウンドを採用（ホストの揺らぎ対策）
+    const int rounds = 7, iterations = 400;
+    uint64_t best_two = UINT64_MAX, best_one = UINT64_MAX;
+    ocr_affine_crop_resize(&a, 100, 200, 100, 24, 200, OCR_STRIP_HEIGHT);
+    for (int r = 0; r < rounds; r++) {
+        uint64_t c0 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            affine_two_pass(&rgb, img, &a, 200, OCR_STRIP_HEIGHT, ref);
+        }
+        uint64_t c1 = bench_cycles();
+        for (int i = 0; i < iterations; i++) {
+            ocr_warp_affine_to_tensor(&rgb, img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, &a, 200, OCR_STRIP_HEIGHT, fused);
+        }
+        uint64_t c2 = bench_cycles();
+        best_two = (c1 - c0 < best_two) ? c1 - c0 : best_two;
+        best_one = (c2 - c1 < best_one) ? c2 - c1 : best_one;
+    }
+    double two = (double)best_two / iterations / (200 * OCR_STRIP_HEIGHT);
+    double one = (double)best_one / iterations / (200 * OCR_STRIP_HEIGHT);
+    printf("  200x48 strip -> 320x48x3 input: two passes %.2f, fused %.2f cycles/px (%u-byte buffer avoided)\n",
+           two, one, 200 * OCR_STRIP_HEIGHT * 2);
+    snprintf(msg, sizeof(msg), "fused kernel faster than crop buffer + quantize (%.2fx)", two / one);
+    CHECK(one < two, msg);
+}
+
+/**
+ * @brief 帯の中央行で暗い列を数える（白背景上の線1本が暗い列1つ）
+ */
+static int dark_columns(const int8_t *tensor, int width, int8_t threshold) {
+    int n = 0;
+    for (int u = 0; u < width; u++) n += (tensor[(OCR_STRIP_HEIGHT / 2) * 320 + u] <= threshold);
+    return n;
+}
+
+static void test_thin_strokes(void) {
+    static uint16_t img[MAX_WIDTH * MAX_HEIGHT];
+    static int8_t tensor[320 * OCR_STRIP_HEIGHT];
+    const float mean[3] = {0.5f, 0.5f, 0.5f}, std[3] = {0.5f, 0.5f, 0.5f};
+    ocr_tensor_quantizer_t gray;
+    ocr_affine_q16_t a;
+    char msg[160];
+
+    printf("\n=== Thin Strokes at 3.5x Reduction ===\n");
+
+    ocr_quantizer_init(&gray, 320, OCR_STRIP_HEIGHT, 1, OCR_TENSOR_LAYOUT_NCHW, 0.0078431f, 0, mean, std);
+    const int8_t threshold = gray.lut[0][200];  // 3〜4画素に線1本なら輝度181以下
+
+    // 横書き: 7画素周期の1画素幅の縦線、630x168の箱を180x48へ（3.5倍縮小）
+    for (int y = 0; y < MAX_HEIGHT; y++)
+        for (int x = 0; x < MAX_WIDTH; x++)
+            img[y * MAX_WIDTH + x] = gray565((x % 7) == 3 ? 20 : 235);
+    const int strokes = (630 + 6) / 7;
+    ocr_crop_resize_to_tensor(&gray, img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, 0, 100, 630, 168, 180, 48, tensor);
+    int area = dark_columns(tensor, 180, threshold);
+    ocr_affine_crop_resize(&a, 0, 100, 630, 168, 180, 48);
+    ocr_warp_affine_to_tensor(&gray, img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, &a, 180, 48, tensor);
+    int grid = dark_columns(tensor, 180, threshold);
+    snprintf(msg, sizeof(msg), "crop-resize keeps every 1 px stroke (%d/%d, single bilinear sample %d)",
+             area, strokes, grid);
+    CHECK(area == strokes && grid < strokes, msg);
+
+    // 縦書き: 同じ線を横線にして168x420の列を120x48の帯へ（3.5倍縮小）
+    for (int y = 0; y < MAX_HEIGHT; y++)
+        for (int x = 0; x < MAX_WIDTH; x++)
+            img[y * MAX_WIDTH + x] = gray565((y % 7) == 3 ? 20 : 235);
+    const int rows = 420 / 7;
+    ocr_crop_rotate90_to_tensor(&gray, img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, 200, 0, 168, 420, 120, 48, tensor);
+    area = dark_columns(tensor, 120, threshold);
+    ocr_affine_crop_rotate90(&a, 200, 0, 168, 420, 120, 48);
+    ocr_warp_affine_to_tensor(&gray, img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, &a, 120, 48, tensor);
+    grid = dark_columns(tensor, 120, threshold);
+    snprintf(msg, sizeof(msg), "rotate-90 keeps every 1 px stroke (%d/%d, single bilinear sample %d)",
+             area, rows, grid);
+    CHECK(area == rows && grid < rows, msg);
+}
+
+/**
+ * @brief 浮動小数点リファレンス: 画素ごとに射影変換とバイリニア補間（565の各フィールド）
+ */
+static void warp_perspective_ref(const uint16_t *src, int sw, int sh, const float qx[4], const float qy[4],
+                                 float *ref, int dw, int dh) {
+    for (int v = 0; v < dh; v++) {
+        for (int u = 0; u < dw; u++) {
+            // 単位正方形 -> 四辺形の射影変換を倍精度で画素ごとに評価
+            double s = (u + 0.5) / dw, t = (v + 0.5) / dh;
+            double x0 = qx[0], y0 = qy[0], x1 = qx[1], y1 = qy[1];
+            double x2 = qx[2], y2 = qy[2], x3 = qx[3], y3 = qy[3];
+            double sx = x0 - x1 + x2 - x3, sy = y0 - y1 + y2 - y3;
+            double dx1 = x1 - x2, dx2 = x3 - x2, dy1 = y1 - y2, dy2 = y3 - y2;
+            double den = dx1 * dy2 - dx2 * dy1;
+            double g = (sx * dy2 - dx2 * sy) / den, h = (dx1 * sy - sx * dy1) / den;
+            double w = g * s + h * t + 1.0;
+            double x = ((x1 - x0 + g * x1) * s + (x3 - x0 + h * x3) * t + x0) / w - 0.5;
+            double y = ((y1 - y0 + g * y1) * s + (y3 - y0 + h * y3) * t + y0) / w - 0.5;
+            if (x < 0) x = 0;
+            if (y < 0) y = 0;
+            if (x > sw - 1) x = sw - 1;
+            if (y > sh - 1) y = sh - 1;
+            int ix = (int)x, iy = (int)y;
+            int ix1 = ix + 1 < sw ? ix + 1 : ix, iy1 = iy + 1 < sh ? iy + 1 : iy;
+            double fx = x - ix, fy = y - iy;
+            for (int c = 0; c < 3; c++) {
+                int shift = c == 0 ? 11 : (c == 1 ? 5 : 0), mask = c == 1 ? 63 : 31;
+                double p00 = (src[iy * sw + ix] >> shift) & mask, p01 = (src[iy * sw + ix1] >> shift) & mask;
+                double p10 = (src[iy1 * sw + ix] >> shift) & mask, p11 = (src[iy1 * sw + ix1] >> shift) & mask;
+                ref[(v * dw + u) * 3 + c] = (float)((p00 * (1 - fx) + p01 * fx) * (1 - fy) +
+                                                    (p10 * (1 - fx) + p11 * fx) * fy);
+            }
+        }
+    }
+}
+
+static void test_perspective_reference(void) {
+    static uint16_t img[320 * 240], out[OCR_STRIP_MAX_WIDTH * OCR_STRIP_HEIGHT];
+    static float ref[OCR_STRIP_MAX_WIDTH * OCR_STRIP_HEIGHT * 3];
+    const int w = 320, h = 240;
+    // 台形（遠近）と回転＋せん断の四辺形
+    const float quads[3][2][4] = {
+        {{40.0f, 280.0f, 300.0f, 20.0f}, {60.0f, 80.0f, 150.0f, 130.0f}},
+        {{70.0f, 250.0f, 235.0f, 55.0f}, {40.0f, 80.0f, 150.0f, 106.0f}},
+        {{-10.0f, 200.0f, 210.0f, 5.0f}, {200.0f, 190.0f, 250.0f, 245.0f}},  // 画像外にはみ出す
+    };
+    ocr_perspective_t p;
+    char msg[128];
+
+    printf("\n=== Perspective Warp vs Float Reference ===\n");
+
+    // なめらかな模様（位置誤差がそのまま画素差に出る）
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int r = (int)(15.5f + 15.5f * sinf(x * 0.11f + y * 0.03f));
+            int g = (int)(31.5f + 31.5f * cosf(y * 0.13f - x * 0.05f));
+            int b = (x * 31 + y * 13) / (w + h) & 31;
+            img[y * w + x] = (uint16_t)((r << 11) | (g << 5) | b);
+        }
+    }
+
+    for (int q = 0; q < 3; q++) {
+        const float *qx = quads[q][0], *qy = quads[q][1];
+        uint16_t sw = ocr_quad_strip_width(qx, qy, OCR_STRIP_HEIGHT, OCR_STRIP_MAX_WIDTH);
+        int ok = ocr_perspective_from_quad(&p, qx, qy, sw, OCR_STRIP_HEIGHT) == 0;
+        ocr_warp_perspective_rgb565(img, w, w, h, &p, out, sw, sw, OCR_STRIP_HEIGHT);
+        warp_perspective_ref(img, w, h, qx, qy, ref, sw, OCR_STRIP_HEIGHT);
+
+        float max_err = 0.0f;
+        double sum_err = 0.0;
+        for (int i = 0; i < sw * OCR_STRIP_HEIGHT; i++) {
+            float got[3] = {(float)(out[i] >> 11), (float)((out[i] >> 5) & 63), (float)(out[i] & 31)};
+            for (int c = 0; c < 3; c++) {
+                float e = fabsf(got[c] - ref[i * 3 + c]);
+                if (e > max_err) max_err = e;
+                sum_err += e;
+            }
+        }
+        snprintf(msg, sizeof(msg), "quad %d -> %ux%d strip: max error %.2f LSB, mean %.3f LSB",
+                 q, sw, OCR_STRIP_HEIGHT, max_err, sum_err / (sw * OCR_STRIP_HEIGHT * 3));
+        CHECK(ok && max_err <= 1.5f && sum_err / (sw * OCR_STRIP_HEIGHT * 3) < 0.3, msg);
+    }
+
+    const float flat_x[4] = {10.0f, 10.0f, 10.0f, 10.0f}, flat_y[4] = {5.0f, 6.0f, 7.0f, 8.0f};
+    CHECK(ocr_perspective_from_quad(&p, flat_x, flat_y, 48, 48) != 0, "degenerate quad rejected");
+}
+
+static void test_quad_strip(void) {
+    static uint16_t img[320 * 240], out[OCR_STRIP_MAX_WIDTH * OCR_STRIP_HEIGHT];
+    const int w = 320, h = 240;
+    const float angle = -12.0f;
+    ocr_perspective_t p;
+    char msg[128];
+
+    printf("\n=== Rotated Quad -> Recognition Strip ===\n");
+
+    // 中心まわりに傾けた紙面から、1行（高さ12px + 上下6px）を四辺形で切り出す
+    render_page(img, w, h, angle, 3);
+    float rad = angle * 3.14159265f / 180.0f, c = cosf(rad), s = sinf(rad);
+    const float pu[4] = {-96.0f, 96.0f, 96.0f, -96.0f}, pv[4] = {-12.0f, -12.0f, 12.0f, 12.0f};
+    float qx[4], qy[4];
+    for (int i = 0; i < 4; i++) {
+        // 紙面(u, v) -> 画像: 描画の逆変換。画素中心 = 端 + 0.5
+        qx[i] = 0.5f * (w - 1) + c * pu[i] - s * pv[i] + 0.5f;
+        qy[i] = 0.5f * (h - 1) + s * pu[i] + c * pv[i] + 0.5f;
+    }
+    uint16_t sw = ocr_quad_strip_width(qx, qy, OCR_STRIP_HEIGHT, OCR_STRIP_MAX_WIDTH);
+    CHECK(sw == 384, "strip width keeps the 8:1 quad aspect at height 48");
+    ocr_perspective_from_quad(&p, qx, qy, sw, OCR_STRIP_HEIGHT);
+    ocr_warp_perspective_rgb565(img, w, w, h, &p, out, sw, sw, OCR_STRIP_HEIGHT);
+
+    // 帯の画素(u, v)は紙面の(-96 + u/2, -12 + v/2)
+    int match = 0;
+    for (int y = 0; y < OCR_STRIP_HEIGHT; y++) {
+        for (int x = 0; x < sw; x++) {
+            int ref = page_ink(-96.0f + (x + 0.5f) * 0.5f, -12.0f + (y + 0.5f) * 0.5f);
+            match += (((out[y * sw + x] >> 11) < 16) == ref);
+        }
+    }
+    float rate = (float)match / (sw * OCR_STRIP_HEIGHT);
+    snprintf(msg, sizeof(msg), "rotated line rectified into the strip (%.1f%% match)", 100.0f * rate);
+    CHECK(rate > 0.95f, msg);
+}
+
+static void bench_skew(void) {
+    static uint16_t img[MAX_WIDTH * MAX_HEIGHT], out[320 * 48];
+    ocr_skew_t skew;
+    ocr_affine_q16_t a;
+    const int iterations = 50;
+    char msg[96];
+
+    printf("\n=== Geometry Benchmark ===\n");
+
+    render_page(img, 320, 240, 6.0f, 9);
+    double t0 = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        ocr_skew_estimate(img, 320, 320, 240, 1, scratch, &skew);
+    }
+    double t1 = bench_now_us();
+    double per = (t1 - t0) / iterations;
+    printf("  skew estimate 320x240: %7.1f us\n", per);
+    snprintf(msg, sizeof(msg), "skew estimate under 0.5 ms at 320x240 (%.1f us)", per);
+    CHECK(per < 500.0, msg);
+
+    render_page(img, MAX_WIDTH, MAX_HEIGHT, 6.0f, 9);
+    t0 = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        ocr_skew_estimate(img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, 2, scratch, &skew);
+    }
+    t1 = bench_now_us();
+    printf("  skew estimate 640x480 (step 2): %7.1f us\n", (t1 - t0) / iterations);
+
+    ocr_affine_rotate_crop(&a, 320.0f, 240.0f, 600, 2.0f, 320, 48);
+    uint64_t c0 = bench_cycles();
+    for (int i = 0; i < iterations; i++) {
+        ocr_warp_affine_rgb565(img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, &a, out, 320, 320, 48);
+    }
+    uint64_t c1 = bench_cycles();
+    printf("  rotate-crop 320x48: %.2f cycles/px\n", (double)(c1 - c0) / iterations / (320 * 48));
+
+    const float qx[4] = {100.0f, 540.0f, 560.0f, 90.0f}, qy[4] = {200.0f, 180.0f, 290.0f, 300.0f};
+    ocr_perspective_t p;
+    ocr_perspective_from_quad(&p, qx, qy, 320, OCR_STRIP_HEIGHT);
+    c0 = bench_cycles();
+    for (int i = 0; i < iterations; i++) {
+        ocr_warp_perspective_rgb565(img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, &p, out, 320, 320, OCR_STRIP_HEIGHT);
+    }
+    c1 = bench_cycles();
+    printf("  perspective strip 320x48: %.2f cycles/px\n", (double)(c1 - c0) / iterations / (320 * 48));
+
+    c0 = bench_cycles();
+    for (int i = 0; i < iterations; i++) {
+        ocr_crop_resize_rgb565(img, MAX_WIDTH, MAX_WIDTH, MAX_HEIGHT, 100, 200, 400, 96, out, 200, 200, OCR_STRIP_HEIGHT);
+    }
+    c1 = bench_cycles();
+    printf("  crop-resize 400x96 -> 200x48: %.2f cycles/px\n", (double)(c1 - c0) / iterations / (200 * 48));
+}
+
+int main(void) {
+    printf("\n=== OCR Geometry Test ===\n");
+
+    test_skew_estimate();
+    test_skew_vga_step();
+    test_affine_identity();
+    test_deskew_crop();
+    test_perspective_reference();
+    test_quad_strip();
+    test_crop_resize();
+    test_rotate90();
+    test_fused_tensor();
+    test_thin_strokes();
+    bench_skew();
+
+    printf("\n");
+    if (failures > 0) {
+        printf("❌ %d test(s) failed\n", failures);
+        return 1;
+    }
+    printf("✅ All geometry tests passed!\n");
+    return 0;
+}
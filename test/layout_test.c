@@ -0,0 +1,269 @@
+/**
+ * @file layout_test.c
+ * @brief 読み順復元（行・ブロック・段組）のテストとベンチマーク
+ *
+ * 目的: 検出順がばらばらのボックスから、横書きは左→右・上→下、
+ *       縦書きは上→下・右→左の順で行とブロックが復元されることを確認
+ *       2段組＋全幅タイトル、わずかな傾きのある行を確認
+ * 計測: 200ボックス（2段×25行×4語）の読み順復元時間
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "bench_timer.h"
+#include "ocr_layout.h"
+
+#define MAX_BOXES 256
+
+static int failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("❌ FAIL: %s\n", msg); failures++; } \
+    else { printf("✅ %s\n", msg); } \
+} while (0)
+
+static uint8_t box_storage[32768] __attribute__((aligned(8)));
+static uint8_t layout_storage[65536] __attribute__((aligned(8)));
+static ocr_det_boxes_t boxes;
+static ocr_layout_t layout;
+static uint16_t label[MAX_BOXES];    // ボックスの正解読み順
+static uint32_t seed = 12345;
+
+static void reset_boxes(void) {
+    ocr_det_boxes_init(&boxes, MAX_BOXES, box_storage, sizeof(box_storage));
+}
+
+static void add_box(int x, int y, int w, int h, int direction, uint16_t order) {
+    uint32_t i = boxes.count++;
+    boxes.x[i] = (uint16_t)x;
+    boxes.y[i] = (uint16_t)y;
+    boxes.width[i] = (uint16_t)w;
+    boxes.height[i] = (uint16_t)h;
+    boxes.score[i] = 200;
+    boxes.direction[i] = (uint8_t)direction;
+    label[i] = order;
+}
+
+// 検出順をシャッフル（ラベルも一緒に入れ替え）
+static void shuffle_boxes(void) {
+    for (uint32_t i = boxes.count; i > 1; i--) {
+        uint32_t j = bench_rand(&seed) % i;
+        uint32_t a = i - 1;
+#define SWAP(arr) do { __typeof__(arr[0]) t = arr[a]; arr[a] = arr[j]; arr[j] = t; } while (0)
+        SWAP(boxes.x); SWAP(boxes.y); SWAP(boxes.width); SWAP(boxes.height);
+        SWAP(boxes.score); SWAP(boxes.direction); SWAP(label);
+#undef SWAP
+    }
+}
+
+// box_orderのラベルが0,1,2,...と並ぶか
+static int order_is_sequential(void) {
+    if (layout.box_count != boxes.count) {
+        return 0;
+    }
+    for (uint32_t k = 0; k < layout.box_count; k++) {
+        if (label[layout.box_order[k]] != k) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int build(void) {
+    ocr_layout_init(&layout, MAX_BOXES, layout_storage, sizeof(layout_storage));
+    return ocr_layout_build(&layout, &boxes);
+}
+
+static void test_single_column(void) {
+    char msg[160];
+    printf("\n--- Single column, shuffled ---\n");
+
+    // 5行×4語、行間20px
+    reset_boxes();
+    for (int l = 0; l < 5; l++) {
+        for (int w = 0; w < 4; w++) {
+            add_box(10 + w * 60, 20 + l * 20, 50, 14, 0, (uint16_t)(l * 4 + w));
+        }
+    }
+    shuffle_boxes();
+
+    int lines = build();
+    snprintf(msg, sizeof(msg), "5 lines, 1 block (got %d lines, %u blocks, %u columns)",
+             lines, layout.block_count, layout.column_count);
+    CHECK(lines == 5 && layout.block_count == 1 && layout.column_count == 1, msg);
+    CHECK(order_is_sequential(), "Words left to right, lines top to bottom");
+    CHECK(layout.lines[0].box_count == 4 && layout.lines[0].x == 10 && layout.lines[0].width == 230,
+          "Line bounds cover its words");
+    CHECK(layout.blocks[0].first_line == 0 && layout.blocks[0].line_count == 5 &&
+          layout.blocks[0].height == 94, "Block holds all lines");
+}
+
+static void test_two_columns(void) {
+    char msg[160];
+    printf("\n--- Full-width title over two columns ---\n");
+
+    // タイトル（大きい文字）→ 左段の段落2つ → 右段
+    reset_boxes();
+    uint16_t n = 0;
+    add_box(40, 5, 110, 30, 0, n++);
+    add_box(170, 5, 110, 30, 0, n++);
+    for (int l = 0; l < 6; l++) {
+        int y = 50 + l * 20 + (l >= 3 ? 20 : 0);   // 左段は3行目の後に段落間隔
+        add_box(10, y, 60, 14, 0, n++);
+        add_box(80, y, 60, 14, 0, n++);
+    }
+    for (int l = 0; l < 7; l++) {
+        add_box(190, 50 + l * 20, 60, 14, 0, n++);
+        add_box(260, 50 + l * 20, 50, 14, 0, n++);
+    }
+    shuffle_boxes();
+
+    int lines = build();
+    snprintf(msg, sizeof(msg), "14 lines, 4 blocks, 2 columns (got %d, %u, %u)",
+             lines, layout.block_count, layout.column_count);
+    CHECK(lines == 14 && layout.block_count == 4 && layout.column_count == 2, msg);
+    CHECK(order_is_sequential(), "Title, left column paragraphs, then right column");
+    CHECK(layout.blocks[0].line_count == 1 && layout.blocks[1].line_count == 3 &&
+          layout.blocks[2].line_count == 3 && layout.blocks[3].line_count == 7,
+          "Paragraph break splits the left column");
+    CHECK(layout.blocks[0].column == 0 && layout.blocks[1].column == 0 &&
+          layout.blocks[2].column == 0 && layout.blocks[3].column == 1, "Column indices");
+    CHECK(layout.lines[1].block == 1 && layout.lines[13].block == 3, "Lines point at their blocks");
+}
+
+static void test_vertical(void) {
+    char msg[160];
+    printf("\n--- Vertical Japanese ---\n");
+
+    // 縦書き4行×3語（右の行から読む）、下に2つ目のブロック
+    reset_boxes();
+    uint16_t n = 0;
+    for (int k = 0; k < 4; k++) {
+        for (int j = 0; j < 3; j++) {
+            add_box(280 - k * 30, 20 + j * 40, 20, 36, 1, n++);
+        }
+    }
+    for (int k = 0; k < 2; k++) {
+        for (int j = 0; j < 2; j++) {
+            add_box(280 - k * 30, 200 + j * 40, 20, 36, 1, n++);
+        }
+    }
+    shuffle_boxes();
+
+    int lines = build();
+    snprintf(msg, sizeof(msg), "6 vertical lines, 2 blocks (got %d, %u)", lines, layout.block_count);
+    CHECK(lines == 6 && layout.block_count == 2 && layout.direction == 1, msg);
+    CHECK(order_is_sequential(), "Top to bottom within a line, lines right to left");
+    CHECK(layout.lines[0].direction == 1 && layout.lines[0].x == 280 && layout.lines[0].height == 116,
+          "Vertical line bounds");
+
+    // 縦書きの2段（左右に並ぶブロック）は右から読む
+    reset_boxes();
+    n = 0;
+    for (int k = 0; k < 3; k++) {
+        add_box(280 - k * 30, 20, 20, 100, 1, n++);
+    }
+    for (int k = 0; k < 3; k++) {
+        add_box(150 - k * 30, 20, 20, 100, 1, n++);
+    }
+    shuffle_boxes();
+    lines = build();
+    snprintf(msg, sizeof(msg), "Vertical columns right to left (got %d lines, %u blocks)",
+             lines, layout.block_count);
+    CHECK(lines == 6 && layout.block_count == 2 && order_is_sequential() &&
+          layout.blocks[0].column == 0 && layout.blocks[1].column == 1, msg);
+}
+
+static void test_skew(void) {
+    char msg[160];
+    printf("\n--- Slight skew ---\n");
+
+    // 1語ごとに2px下がる（約1.9度）3行×6語
+    reset_boxes();
+    for (int l = 0; l < 3; l++) {
+        for (int w = 0; w < 6; w++) {
+            add_box(10 + w * 50, 20 + l * 22 + w * 2, 44, 14, 0, (uint16_t)(l * 6 + w));
+        }
+    }
+    shuffle_boxes();
+
+    int lines = build();
+    snprintf(msg, sizeof(msg), "3 skewed lines, 1 block (got %d, %u)", lines, layout.block_count);
+    CHECK(lines == 3 && layout.block_count == 1, msg);
+    CHECK(order_is_sequential(), "Skewed words stay on their lines");
+}
+
+static void test_edge_cases(void) {
+    printf("\n--- Edge cases ---\n");
+
+    reset_boxes();
+    CHECK(build() == 0 && layout.line_count == 0 && layout.block_count == 0, "No boxes");
+
+    add_box(5, 5, 30, 10, 0, 0);
+    CHECK(build() == 1 && layout.box_order[0] == 0, "Single box");
+
+    // 幅の広い区切り（単語間隔の2.5倍超）は別の行
+    reset_boxes();
+    add_box(10, 10, 40, 14, 0, 0);
+    add_box(100, 10, 40, 14, 0, 1);
+    CHECK(build() == 2 && order_is_sequential(), "Wide gap splits a line");
+
+    ocr_layout_t small;
+    CHECK(ocr_layout_init(&small, 1, layout_storage, sizeof(layout_storage)) == 0 &&
+          ocr_layout_build(&small, &boxes) < 0, "Too many boxes is rejected");
+    CHECK(ocr_layout_init(&small, MAX_BOXES, layout_storage, 16) < 0, "Short storage is rejected");
+}
+
+static void bench_layout(void) {
+    char msg[160];
+    const int iterations = 1000;
+    printf("\n--- Benchmark: 200 boxes (2 columns x 25 lines x 4 words) ---\n");
+
+    reset_boxes();
+    uint16_t n = 0;
+    for (int c = 0; c < 2; c++) {
+        for (int l = 0; l < 25; l++) {
+            for (int w = 0; w < 4; w++) {
+                add_box(10 + c * 320 + w * 70, 20 + l * 18, 60, 12, 0, n++);
+            }
+        }
+    }
+    shuffle_boxes();
+
+    int lines = 0;
+    double t0 = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        ocr_layout_init(&layout, MAX_BOXES, layout_storage, sizeof(layout_storage));
+        lines = ocr_layout_build(&layout, &boxes);
+    }
+    double t = (bench_now_us() - t0) / iterations;
+
+    snprintf(msg, sizeof(msg), "50 lines, 2 blocks, 2 columns (got %d, %u, %u)",
+             lines, layout.block_count, layout.column_count);
+    CHECK(lines == 50 && layout.block_count == 2 && layout.column_count == 2, msg);
+    CHECK(order_is_sequential(), "Left column read before right column");
+    printf("  layout: %.1f us per frame, scratch %u bytes for %d boxes\n",
+           t, ocr_layout_size(MAX_BOXES), MAX_BOXES);
+}
+
+int main(void) {
+    printf("\n=== OCR Reading Order Test ===\n");
+
+    test_single_column();
+    test_two_columns();
+    test_vertical();
+    test_skew();
+    test_edge_cases();
+    bench_layout();
+
+    printf("\n");
+    if (failures > 0) {
+        printf("❌ %d test(s) failed\n", failures);
+        return 1;
+    }
+    printf("✅ All reading order tests passed!\n");
+    return 0;
+}
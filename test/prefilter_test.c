@@ -0,0 +1,305 @@
+/**
+ * @file prefilter_test.c
+ * @brief CPUテキスト有無プレフィルタのテストとベンチマーク
+ *
+ * 目的: 縮小済み検出入力（320x240）の合成シーンで、文字のあるフレームは
+ *       検出へ進み、壁・グラデーション・大きな形状・1本の線だけのフレームは
+ *       検出をスキップすることを確認（既定閾値の較正表を出力）
+ *       タイルスコアマップで検出マップを文字のありそうなタイルに限定できることを確認
+ * 計測: 1フレームの処理時間（検出推論8msの5%以内が目標）
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "bench_timer.h"
+#include "ocr_prefilter.h"
+
+#define FULL_W 640
+#define FULL_H 480
+#define IN_W 320
+#define IN_H 240
+
+static int failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("❌ FAIL: %s\n", msg); failures++; } \
+    else { printf("✅ %s\n", msg); } \
+} while (0)
+
+static uint8_t full[FULL_W * FULL_H];   // カメラ解像度の輝度
+static int8_t plane[IN_W * IN_H];       // 検出入力（2x2平均、int8）
+static uint8_t storage[4096] __attribute__((aligned(4)));
+static uint32_t seed = 77;
+
+static void fill(uint8_t v) {
+    memset(full, v, sizeof(full));
+}
+
+static void rect(int x0, int y0, int w, int h, uint8_t v) {
+    for (int y = y0 < 0 ? 0 : y0; y < y0 + h && y < FULL_H; y++) {
+        for (int x = x0 < 0 ? 0 : x0; x < x0 + w && x < FULL_W; x++) {
+            full[y * FULL_W + x] = v;
+        }
+    }
+}
+
+/**
+ * @brief 擬似文字列: 縦画2〜3本＋横画のランダムな組み合わせ（高さh、カメラ画素）
+ */
+static void text(int x, int y, int h, int chars, uint8_t ink) {
+    int w = h * 6 / 10, sw = h / 8 > 1 ? h / 8 : 1;
+    for (int c = 0; c < chars; c++, x += w + h / 4) {
+        uint32_t bits = bench_rand(&seed);
+        rect(x, y, sw, h, ink);
+        if (bits & 1) rect(x + (w - sw) / 2, y, sw, h, ink);
+        if (bits & 2) rect(x + w - sw, y, sw, h, ink);
+        if (bits & 4) rect(x, y, w, sw, ink);
+        if (bits & 8) rect(x, y + (h - sw) / 2, w, sw, ink);
+        if (bits & 16) rect(x, y + h - sw, w, sw, ink);
+    }
+}
+
+// 2x2平均で検出入力へ縮小し、センサノイズ（±noise）を加える
+static void downsample(int noise) {
+    for (int y = 0; y < IN_H; y++) {
+        for (int x = 0; x < IN_W; x++) {
+            const uint8_t *p = &full[(2 * y) * FULL_W + 2 * x];
+            int v = (p[0] + p[1] + p[FULL_W] + p[FULL_W + 1] + 2) / 4 - 128;
+            if (noise) v += (int)(bench_rand(&seed) % (2 * noise + 1)) - noise;
+            plane[y * IN_W + x] = (int8_t)(v < -128 ? -128 : (v > 127 ? 127 : v));
+        }
+    }
+}
+
+static void gradient(int from, int to) {
+    for (int y = 0; y < FULL_H; y++) {
+        for (int x = 0; x < FULL_W; x++) {
+            float r = hypotf(x - FULL_W / 2.0f, y - FULL_H / 2.0f) / 400.0f;
+            full[y * FULL_W + x] = (uint8_t)(from + (to - from) * r * (0.7f + 0.3f * x / FULL_W));
+        }
+    }
+}
+
+typedef struct {
+    const char *name;
+    int has_text;       // 正解
+    int asserted;       // 判定を検査する（テクスチャは較正表のみ）
+} scene_t;
+
+static const scene_t scenes[] = {
+    {"document page (8-16 px)", 1, 1},
+    {"label, low contrast 10 px", 1, 1},
+    {"sign, 3 large glyphs", 1, 1},
+    {"light text on dark", 1, 1},
+    {"one small word on gradient", 1, 1},
+    {"blank wall", 0, 1},
+    {"vignetted gradient", 0, 1},
+    {"door and window frames", 0, 1},
+    {"cable / single thin lines", 0, 1},
+    {"soft shadow", 0, 1},
+    {"fine blinds (period 8)", 0, 0},
+};
+
+static void render_scene(int s) {
+    switch (s) {
+    case 0:
+        fill(225);
+        for (int row = 0; row < 18; row++) {
+            int h = 8 + (row % 5) * 2;
+            text(30, 20 + row * 25, h, 30 - h, 40);
+        }
+        break;
+    case 1:
+        fill(160);
+        rect(200, 200, 220, 60, 175);
+        text(215, 212, 10, 20, 125);
+        text(215, 234, 10, 14, 125);
+        break;
+    case 2:
+        gradient(120, 90);
+        text(180, 170, 90, 3, 240);
+        break;
+    case 3:
+        fill(30);
+        for (int row = 0; row < 6; row++) text(60, 60 + row * 40, 14, 18, 220);
+        break;
+    case 4:
+        gradient(200, 150);
+        text(400, 300, 10, 5, 60);
+        break;
+    case 5:
+        fill(180);
+        break;
+    case 6:
+        gradient(210, 90);
+        break;
+    case 7:
+        fill(170);
+        rect(100, 40, 200, 420, 120);
+        rect(116, 56, 168, 388, 150);
+        rect(400, 80, 180, 140, 230);
+        rect(488, 80, 6, 140, 90);
+        break;
+    case 8:
+        fill(200);
+        rect(320, 0, 3, FULL_H, 60);
+        rect(0, 150, FULL_W, 3, 60);
+        rect(500, 0, 2, FULL_H, 90);
+        break;
+    case 9:
+        gradient(190, 170);
+        for (int y = 0; y < FULL_H; y++) {
+            for (int x = 0; x < FULL_W; x++) {
+                float d = hypotf(x - 400.0f, y - 260.0f);
+                if (d < 160.0f) full[y * FULL_W + x] = (uint8_t)(full[y * FULL_W + x] * (0.6f + 0.4f * d / 160.0f));
+            }
+        }
+        break;
+    default:
+        fill(150);
+        for (int x = 0; x < FULL_W; x += 16) rect(x, 0, 6, FULL_H, 90);
+        break;
+    }
+    downsample(3);
+}
+
+static void init(ocr_prefilter_t *pf) {
+    if (ocr_prefilter_init(pf, IN_W, IN_H, OCR_PREFILTER_TILE, storage, sizeof(storage)) != 0) {
+        printf("prefilter init failed\n");
+        exit(1);
+    }
+}
+
+static void test_calibration(void) {
+    ocr_prefilter_t pf;
+    char msg[160];
+    int text_kept = 0, text_total = 0, blank_skipped = 0, blank_total = 0;
+
+    printf("\n=== Text Prefilter Calibration (320x240, tile %d, threshold %d, min %d tiles) ===\n",
+           OCR_PREFILTER_TILE, OCR_PREFILTER_TILE_THRESH, OCR_PREFILTER_MIN_TILES);
+    init(&pf);
+    printf("  %-30s %6s %6s %8s\n", "scene", "likely", "max", "decision");
+
+    for (int s = 0; s < (int)(sizeof(scenes) / sizeof(scenes[0])); s++) {
+        render_scene(s);
+        ocr_prefilter_run(&pf, plane, 1, IN_W);
+        int detect = ocr_prefilter_has_text(&pf);
+        printf("  %-30s %6u %6u %8s%s\n", scenes[s].name, pf.likely_tiles, pf.max_score,
+               detect ? "detect" : "skip", scenes[s].asserted ? "" : "  (texture: left to detection)");
+        if (!scenes[s].asserted) continue;
+        if (scenes[s].has_text) {
+            text_total++;
+            text_kept += detect;
+        } else {
+            blank_total++;
+            blank_skipped += !detect;
+        }
+    }
+
+    snprintf(msg, sizeof(msg), "every text scene goes to detection (%d/%d)", text_kept, text_total);
+    CHECK(text_kept == text_total, msg);
+    snprintf(msg, sizeof(msg), "plain scenes skip detection (%d/%d)", blank_skipped, blank_total);
+    CHECK(blank_skipped == blank_total, msg);
+}
+
+static void test_score_map(void) {
+    static int8_t map[IN_W * IN_H];
+    static int8_t quarter[(IN_W / 4) * (IN_H / 4)];
+    ocr_prefilter_t pf;
+    char msg[160];
+
+    printf("\n=== Score Map and Restricted Detection ===\n");
+    init(&pf);
+    CHECK(pf.tiles_x == 20 && pf.tiles_y == 15, "320x240 -> 20x15 tiles");
+    CHECK(ocr_prefilter_init(&pf, IN_W, IN_H, OCR_PREFILTER_TILE, storage, 64) != 0,
+          "undersized storage rejected");
+    init(&pf);
+
+    // 右下の小さなラベル（入力座標 x 107..188, y 106..122 付近、タイル行6と7）
+    render_scene(1);
+    ocr_prefilter_run(&pf, plane, 1, IN_W);
+    int row_hot[2] = {0, 0}, outside = 0;
+    for (uint32_t ty = 0; ty < pf.tiles_y; ty++) {
+        for (uint32_t tx = 0; tx < pf.tiles_x; tx++) {
+            int text_tile = tx * 16 + 16 > 107 && tx * 16 < 188 && (ty == 6 || ty == 7);
+            int hot = pf.scores[ty * pf.tiles_x + tx] >= pf.tile_thresh;
+            outside += hot && !text_tile;
+            if (hot && text_tile) row_hot[ty - 6]++;
+        }
+    }
+    snprintf(msg, sizeof(msg), "likely tiles sit on both label lines (%d + %d likely, %d elsewhere)",
+             row_hot[0], row_hot[1], outside);
+    CHECK(row_hot[0] >= 2 && row_hot[1] >= 2 && outside == 0, msg);
+
+    CHECK(ocr_prefilter_region_likely(&pf, 100, 100, 40, 40) && !ocr_prefilter_region_likely(&pf, 0, 0, 64, 64) &&
+          !ocr_prefilter_region_likely(&pf, 400, 0, 10, 10), "region check: label region likely, corner not");
+
+    // 同解像度マップ: ラベル周辺だけ残る
+    memset(map, 100, sizeof(map));
+    uint32_t cleared = ocr_prefilter_mask(&pf, map, IN_W, IN_W, IN_H, -128);
+    snprintf(msg, sizeof(msg), "mask keeps the label tiles (+1 tile), clears %u of %u pixels",
+             cleared, IN_W * IN_H);
+    CHECK(map[118 * IN_W + 150] == 100 && map[10 * IN_W + 10] == -128 && cleared > IN_W * IN_H * 8 / 10, msg);
+
+    // 1/4マップ（EAST解像度）: 各画素は対応するタイルの判定に従う
+    memset(quarter, 100, sizeof(quarter));
+    ocr_prefilter_mask(&pf, quarter, IN_W / 4, IN_W / 4, IN_H / 4, -128);
+    int consistent = 1;
+    for (int y = 0; y < IN_H / 4; y++) {
+        for (int x = 0; x < IN_W / 4; x++) {
+            int kept = ocr_prefilter_region_likely(&pf, 4 * x, 4 * y, 1, 1);
+            consistent &= quarter[y * (IN_W / 4) + x] == (kept ? 100 : -128);
+        }
+    }
+    CHECK(consistent, "mask scales tiles to a 1/4 map");
+}
+
+static void bench_prefilter(void) {
+    ocr_prefilter_t pf;
+    const int iterations = 500;
+    char msg[160];
+
+    printf("\n=== Prefilter Benchmark (320x240) ===\n");
+    init(&pf);
+    render_scene(0);
+
+    double t0 = bench_now_us();
+    uint64_t c0 = bench_cycles();
+    for (int i = 0; i < iterations; i++) {
+        ocr_prefilter_run(&pf, plane, 1, IN_W);
+    }
+    uint64_t c1 = bench_cycles();
+    double us = (bench_now_us() - t0) / iterations;
+    printf("  document page: %.1f us/frame, %.2f cycles/px (every %d rows scanned)\n", us,
+           (double)(c1 - c0) / iterations / (IN_W * IN_H), OCR_PREFILTER_ROW_STEP);
+
+    // NHWC RGBテンソルの第1チャンネル（ストライド3）
+    static int8_t rgb[IN_W * IN_H * 3];
+    for (int i = 0; i < IN_W * IN_H; i++) rgb[3 * i] = rgb[3 * i + 1] = rgb[3 * i + 2] = plane[i];
+    uint32_t likely_gray = ocr_prefilter_run(&pf, plane, 1, IN_W);
+    uint32_t likely_rgb = ocr_prefilter_run(&pf, rgb, 3, IN_W * 3);
+    CHECK(likely_gray == likely_rgb, "NHWC first channel gives the same scores");
+
+    snprintf(msg, sizeof(msg), "prefilter %.1f us < 5%% of an 8 ms detection inference (400 us)", us);
+    CHECK(us < 400.0, msg);
+}
+
+int main(void) {
+    printf("\n=== OCR Text Prefilter Test ===\n");
+
+    test_calibration();
+    test_score_map();
+    bench_prefilter();
+
+    printf("\n");
+    if (failures > 0) {
+        printf("❌ %d test(s) failed\n", failures);
+        return 1;
+    }
+    printf("✅ All prefilter tests passed!\n");
+    return 0;
+}
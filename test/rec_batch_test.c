@@ -0,0 +1,206 @@
+/**
+ * @file rec_batch_test.c
+ * @brief 認識バッチ（複数の切り出しを1回の推論に詰める）のテスト＋ベンチマーク
+ *
+ * 目的: 活性化メモリ予算からバッチサイズが決まること、スロットが連続した
+ *       バッチテンソルに並び、出力が正しいボックスに戻ること、
+ *       失敗した切り出しはバッチに入らないことを確認
+ * 計測: 320x48x3入力 / 80x6,625出力（PP-OCR日本語）でのバッチサイズと予算の関係、
+ *       バッチサイズごとの1ボックスあたりCPU時間（切り出しの量子化＋CTCデコード）
+ *       ※ NPU呼び出しの償却はホストでは測れない（実機はAI_TASKのREC BATCH行）
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "bench_timer.h"
+#include "ocr_preprocess.h"
+#include "ocr_ctc.h"
+#include "ocr_rec_batch.h"
+
+#define REC_WIDTH    320
+#define REC_HEIGHT   48
+#define REC_INPUT    (REC_WIDTH * REC_HEIGHT * 3)
+#define TIMESTEPS    80
+#define REC_CLASSES  6625
+#define REC_OUTPUT   (TIMESTEPS * REC_CLASSES)
+#define REC_ENTRIES  (REC_CLASSES - 2)
+#define BOXES        24
+
+static int failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("❌ FAIL: %s\n", msg); failures++; } \
+    else { printf("✅ %s\n", msg); } \
+} while (0)
+
+static uint8_t arena[8 * 1024 * 1024] __attribute__((aligned(8)));
+static uint16_t strip[640 * REC_HEIGHT];
+static uint8_t dict[REC_ENTRIES * 4];
+static uint8_t index_storage[4096] __attribute__((aligned(4)));
+static uint32_t seed = 7070;
+
+// NPUの代わり: スロットの先頭値をそのスロット出力の全タイムステップのクラスにする
+static void fake_inference(const ocr_rec_batch_t *batch) {
+    for (uint32_t s = 0; s < batch->count; s++) {
+        const int8_t *in = batch->input + s * batch->input_size;
+        int8_t *out = batch->output + s * batch->output_size;
+        memset(out, -128, batch->output_size);
+        for (uint32_t t = 0; t < TIMESTEPS; t++) {
+            uint32_t cls = (t % 4 == 3) ? 0 : 1 + (uint8_t)in[0];
+            out[t * REC_CLASSES + cls] = 127;
+        }
+    }
+}
+
+static void test_plan(void) {
+    char msg[160];
+
+    printf("\n=== Batch Planning ===\n");
+    uint32_t one = ocr_rec_batch_size(REC_INPUT, REC_OUTPUT, 1);
+    CHECK(ocr_rec_batch_plan(REC_INPUT, REC_OUTPUT, 8, one - 1) == 0 &&
+          ocr_rec_batch_plan(REC_INPUT, REC_OUTPUT, 8, one) == 1, "budget below one slot: no batch");
+    CHECK(ocr_rec_batch_plan(REC_INPUT, REC_OUTPUT, 8, 64u * 1024 * 1024) == 8 &&
+          ocr_rec_batch_plan(REC_INPUT, REC_OUTPUT, 64, 64u * 1024 * 1024) == OCR_REC_MAX_BATCH,
+          "large budget: model batch, at most OCR_REC_MAX_BATCH");
+    CHECK(ocr_rec_batch_size(REC_INPUT, REC_OUTPUT, 0) == 0 &&
+          ocr_rec_batch_size(REC_INPUT, REC_OUTPUT, OCR_REC_MAX_BATCH + 1) == 0, "invalid capacity rejected");
+
+    // NPU活性化メモリ2.5MBのうち、検出テンソル等を除いた残り
+    printf("  budget      slots  (one slot: %u KB in + %u KB out)\n", REC_INPUT / 1024, REC_OUTPUT / 1024);
+    const uint32_t budgets[5] = {600, 1200, 1800, 2200, 4800};
+    uint32_t last = 0;
+    int monotonic = 1;
+    for (int i = 0; i < 5; i++) {
+        uint32_t slots = ocr_rec_batch_plan(REC_INPUT, REC_OUTPUT, 8, budgets[i] * 1024);
+        printf("  %5u KB  %5u\n", budgets[i], slots);
+        monotonic &= slots >= last;
+        last = slots;
+    }
+    snprintf(msg, sizeof(msg), "batch grows with the budget (%u slots in 2.2 MB)",
+             ocr_rec_batch_plan(REC_INPUT, REC_OUTPUT, 8, 2200 * 1024));
+    CHECK(monotonic && ocr_rec_batch_plan(REC_INPUT, REC_OUTPUT, 8, 2200 * 1024) == 3, msg);
+}
+
+static void test_scatter(void) {
+    ocr_rec_batch_t batch;
+    const uint32_t in_size = 100, out_size = TIMESTEPS * REC_CLASSES;
+    uint32_t size = ocr_rec_batch_size(in_size, out_size, 4);
+    uint16_t result_of[BOXES];
+    int ok = 1;
+
+    printf("\n=== Stage, Infer, Scatter ===\n");
+    CHECK(ocr_rec_batch_init(&batch, in_size, out_size, 4, arena, size - 1) != 0, "short storage rejected");
+    ocr_rec_batch_init(&batch, in_size, out_size, 4, arena, size);
+    CHECK(((uintptr_t)batch.output & 7) == 0 && batch.output >= batch.input + 4 * in_size,
+          "output slots after the inputs, 8-byte aligned");
+
+    // ボックス3個おきに切り出し失敗（バッチに入れずにスロットを再利用）
+    memset(result_of, 0xFF, sizeof(result_of));
+    uint32_t inferences = 0, staged = 0;
+    for (uint32_t box = 0; box < BOXES; box++) {
+        int8_t *slot = ocr_rec_batch_next(&batch);
+        ok &= slot == batch.input + batch.count * in_size;
+        memset(slot, (int8_t)box, in_size);
+        if (box % 3 == 2) {
+            continue;
+        }
+        ocr_rec_batch_push(&batch, (uint16_t)box);
+        staged++;
+        if (batch.count == batch.capacity || box == BOXES - 1) {
+            fake_inference(&batch);
+            for (uint32_t s = 0; s < batch.count; s++) {
+                const int8_t *out = ocr_rec_batch_output(&batch, s);
+                uint32_t cls = 0;
+                while (out[cls] != 127) cls++;
+                result_of[batch.tag[s]] = (uint16_t)(cls - 1);
+            }
+            ok &= ocr_rec_batch_output(&batch, batch.count) == NULL;
+            ocr_rec_batch_clear(&batch);
+            inferences++;
+        }
+    }
+    for (uint32_t box = 0; box < BOXES; box++) {
+        ok &= (box % 3 == 2) ? result_of[box] == 0xFFFF : result_of[box] == box;
+    }
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%u boxes in %u inferences, every output back at its box, failed crops skipped",
+             staged, inferences);
+    CHECK(ok && inferences == 4, msg);
+
+    ocr_rec_batch_init(&batch, in_size, out_size, 2, arena, size);
+    ocr_rec_batch_push(&batch, 0);
+    ocr_rec_batch_push(&batch, 1);
+    CHECK(ocr_rec_batch_next(&batch) == NULL && ocr_rec_batch_push(&batch, 2) != 0, "full batch takes no slot");
+}
+
+static void bench_cpu_per_box(void) {
+    ocr_rec_batch_t batch;
+    ocr_tensor_quantizer_t quantizer;
+    ocr_charset_t cs;
+    ocr_ctc_t ctc;
+    ocr_ctc_result_t res;
+    char text[64];
+    const float mean[3] = {0.5f, 0.5f, 0.5f};
+    const float std[3] = {0.5f, 0.5f, 0.5f};
+    const uint32_t sizes[4] = {1, 2, 4, 8};
+
+    printf("\n=== CPU per Box (strip quantization + CTC greedy, %d boxes) ===\n", BOXES);
+    uint32_t dict_size = 0;
+    for (uint32_t i = 0; i < REC_ENTRIES; i++) {
+        uint32_t cp = 0x3041 + i;
+        dict[dict_size++] = (uint8_t)(0xE0 | (cp >> 12));
+        dict[dict_size++] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+        dict[dict_size++] = (uint8_t)(0x80 | (cp & 0x3F));
+        dict[dict_size++] = '\n';
+    }
+    ocr_charset_init(&cs, dict, dict_size, index_storage, sizeof(index_storage));
+    ocr_ctc_init(&ctc, &cs, REC_CLASSES, OCR_CTC_OUTPUT_PROBS, 1.0f / 255.0f, -128);
+    ocr_quantizer_init(&quantizer, REC_WIDTH, REC_HEIGHT, 3, 0, 0.0078431f, 0, mean, std);
+    for (uint32_t i = 0; i < sizeof(strip) / 2; i++) strip[i] = (uint16_t)bench_rand(&seed);
+
+    for (int k = 0; k < 4; k++) {
+        uint32_t size = ocr_rec_batch_size(REC_INPUT, REC_OUTPUT, sizes[k]);
+        ocr_rec_batch_init(&batch, REC_INPUT, REC_OUTPUT, sizes[k], arena, size);
+        // 出力は事前に用意（NPUの書き込み時間は計測に含めない）
+        for (uint32_t s = 0; s < sizes[k]; s++) {
+            memset(ocr_rec_batch_next(&batch), (int8_t)(s * 7), 1);
+            ocr_rec_batch_push(&batch, (uint16_t)s);
+        }
+        fake_inference(&batch);
+        ocr_rec_batch_clear(&batch);
+        double t0 = bench_now_us();
+        for (uint32_t box = 0; box < BOXES; box++) {
+            ocr_strip_to_tensor(&quantizer, strip, 640, 80 + (box * 37) % 560, REC_HEIGHT,
+                                ocr_rec_batch_next(&batch));
+            ocr_rec_batch_push(&batch, (uint16_t)box);
+            if (batch.count == batch.capacity || box == BOXES - 1) {
+                for (uint32_t s = 0; s < batch.count; s++) {
+                    ocr_ctc_greedy(&ctc, ocr_rec_batch_output(&batch, s), TIMESTEPS, text, sizeof(text), &res);
+                }
+                ocr_rec_batch_clear(&batch);
+            }
+        }
+        double us = (bench_now_us() - t0) / BOXES;
+        printf("  batch %u: %7.1f us/box (%u inferences, %6u KB)\n", sizes[k], us,
+               (BOXES + sizes[k] - 1) / sizes[k], size / 1024);
+    }
+}
+
+int main(void) {
+    printf("\n=== OCR Recognition Batch Test ===\n");
+
+    test_plan();
+    test_scatter();
+    bench_cpu_per_box();
+
+    printf("\n");
+    if (failures > 0) {
+        printf("❌ %d test(s) failed\n", failures);
+        return 1;
+    }
+    printf("✅ All recognition batch tests passed!\n");
+    return 0;
+}
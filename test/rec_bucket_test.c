@@ -0,0 +1,216 @@
+/**
+ * @file rec_bucket_test.c
+ * @brief 認識モデルの幅バケット（80/160/320/640）選択のテスト＋ベンチマーク
+ *
+ * 目的: バケット表が幅順に並ぶこと、ストリップが歪まずに入る最小のバケットに
+ *       振り分けられること（最大幅を超えるものは最大のバケット）を確認
+ * 計測: 看板・メニュー・ラベル相当の箱幅分布（高さ48に正規化したストリップ）で
+ *       固定320幅と幅バケットの認識時間を比較
+ *       CPU側（ストリップの量子化＋CTCデコード）は実測、
+ *       NPU側は入力列数に比例するとした見積もり（320列で5ms: ai_memory.cの模擬値）
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "bench_timer.h"
+#include "ocr_preprocess.h"
+#include "ocr_ctc.h"
+#include "ocr_rec_bucket.h"
+
+#define STRIP_HEIGHT  48
+#define MAX_WIDTH     640
+#define REC_CLASSES   6625
+#define REC_ENTRIES   (REC_CLASSES - 2)
+#define BOXES         400
+#define NPU_US_PER_COLUMN (5000.0 / 320.0)
+
+static int failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("❌ FAIL: %s\n", msg); failures++; } \
+    else { printf("✅ %s\n", msg); } \
+} while (0)
+
+static uint16_t strip[MAX_WIDTH * STRIP_HEIGHT];
+static int8_t tensor[MAX_WIDTH * STRIP_HEIGHT * 3];
+static int8_t output[(MAX_WIDTH / 4) * REC_CLASSES];
+static uint8_t dict[REC_ENTRIES * 4];
+static uint8_t index_storage[4096] __attribute__((aligned(4)));
+static uint16_t box_width[BOXES];
+static uint32_t seed = 4848;
+
+static void test_table(void) {
+    ocr_rec_buckets_t buckets;
+
+    printf("\n=== Bucket Table ===\n");
+    ocr_rec_buckets_init(&buckets);
+    CHECK(ocr_rec_buckets_select(&buckets, 100) < 0 && ocr_rec_buckets_max_width(&buckets) == 0,
+          "empty table: no bucket");
+
+    // モデル番号順（幅順ではない）に登録
+    ocr_rec_buckets_add(&buckets, 320, 1);
+    ocr_rec_buckets_add(&buckets, 80, 4);
+    ocr_rec_buckets_add(&buckets, 640, 6);
+    ocr_rec_buckets_add(&buckets, 160, 5);
+    CHECK(buckets.count == 4 && buckets.bucket[0].width == 80 && buckets.bucket[1].width == 160 &&
+          buckets.bucket[2].width == 320 && buckets.bucket[3].width == 640 &&
+          buckets.bucket[0].model == 4 && buckets.bucket[3].model == 6, "sorted by width, models kept");
+    CHECK(ocr_rec_buckets_add(&buckets, 480, 7) < 0, "full table rejects a fifth variant");
+
+    ocr_rec_buckets_t two;
+    ocr_rec_buckets_init(&two);
+    ocr_rec_buckets_add(&two, 320, 1);
+    CHECK(ocr_rec_buckets_add(&two, 320, 2) < 0 && ocr_rec_buckets_add(&two, 0, 3) < 0 && two.count == 1,
+          "duplicate and zero widths rejected");
+
+    CHECK(ocr_rec_buckets_select(&buckets, 1) == 0 && ocr_rec_buckets_select(&buckets, 80) == 0 &&
+          ocr_rec_buckets_select(&buckets, 81) == 1 && ocr_rec_buckets_select(&buckets, 320) == 2 &&
+          ocr_rec_buckets_select(&buckets, 321) == 3 && ocr_rec_buckets_select(&buckets, 640) == 3,
+          "narrowest bucket the strip fits");
+    CHECK(ocr_rec_buckets_select(&buckets, 900) == 3 && ocr_rec_buckets_select(&two, 500) == 0 &&
+          ocr_rec_buckets_max_width(&two) == 320, "wider than all: widest bucket");
+}
+
+// 高さ48での文字幅はほぼ正方（和文）＋余白。短い語が多く、長い行は少ない
+static void make_box_widths(void) {
+    for (uint32_t i = 0; i < BOXES; i++) {
+        uint32_t r = bench_rand(&seed) % 100;
+        uint32_t chars;
+        if (r < 40) {
+            chars = 1 + bench_rand(&seed) % 2;      // 値段・記号・1〜2文字の語
+        } else if (r < 70) {
+            chars = 3 + bench_rand(&seed) % 3;      // 品名・駅名
+        } else if (r < 90) {
+            chars = 6 + bench_rand(&seed) % 4;      // 短い文
+        } else {
+            chars = 10 + bench_rand(&seed) % 11;    // 行全体
+        }
+        uint32_t w = chars * 44 + 8;
+        box_width[i] = (uint16_t)(w > MAX_WIDTH ? MAX_WIDTH : w);
+    }
+}
+
+typedef struct {
+    double cpu_us;
+    double npu_us;
+    uint32_t columns;               // モデル入力の列数
+    uint32_t content;               // そのうちストリップの列数（残りは詰め物）
+    uint32_t squashed;
+    uint32_t per_bucket[OCR_REC_MAX_BUCKETS];
+} run_stats_t;
+
+static void run(const ocr_rec_buckets_t *buckets, const ocr_tensor_quantizer_t *quantizers,
+                const ocr_ctc_t *ctc, run_stats_t *stats) {
+    ocr_ctc_result_t res;
+    char text[64];
+
+    memset(stats, 0, sizeof(*stats));
+    double t0 = bench_now_us();
+    for (uint32_t i = 0; i < BOXES; i++) {
+        int b = ocr_rec_buckets_select(buckets, box_width[i]);
+        uint16_t width = buckets->bucket[b].width;
+        uint16_t strip_w = box_width[i];
+        uint16_t strip_h = STRIP_HEIGHT;
+        // 最大幅を超える行は縦横比を保って縮小（文字が潰れる）
+        if (strip_w > width) {
+            strip_h = (uint16_t)(STRIP_HEIGHT * width / strip_w);
+            strip_w = width;
+            stats->squashed++;
+        }
+        ocr_strip_to_tensor(&quantizers[b], strip, MAX_WIDTH, strip_w, strip_h, tensor);
+        ocr_ctc_greedy(ctc, output, width / 4, text, sizeof(text), &res);
+        stats->columns += width;
+        stats->content += strip_w;
+        stats->per_bucket[b]++;
+    }
+    stats->cpu_us = bench_now_us() - t0;
+    stats->npu_us = stats->columns * NPU_US_PER_COLUMN;
+}
+
+static void bench_distribution(void) {
+    const float mean[3] = {0.5f, 0.5f, 0.5f};
+    const float std[3] = {0.5f, 0.5f, 0.5f};
+    const uint16_t widths[4] = {80, 160, 320, 640};
+    ocr_tensor_quantizer_t quantizers[OCR_REC_MAX_BUCKETS];
+    ocr_rec_buckets_t fixed, narrow, bucketed;
+    ocr_charset_t cs;
+    ocr_ctc_t ctc;
+    run_stats_t base, half, buck;
+    char msg[200];
+
+    printf("\n=== Recognition Time on a Box-Width Distribution (%d boxes) ===\n", BOXES);
+    uint32_t dict_size = 0;
+    for (uint32_t i = 0; i < REC_ENTRIES; i++) {
+        uint32_t cp = 0x3041 + i;
+        dict[dict_size++] = (uint8_t)(0xE0 | (cp >> 12));
+        dict[dict_size++] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+        dict[dict_size++] = (uint8_t)(0x80 | (cp & 0x3F));
+        dict[dict_size++] = '\n';
+    }
+    ocr_charset_init(&cs, dict, dict_size, index_storage, sizeof(index_storage));
+    ocr_ctc_init(&ctc, &cs, REC_CLASSES, OCR_CTC_OUTPUT_PROBS, 1.0f / 255.0f, -128);
+    for (uint32_t i = 0; i < sizeof(strip) / 2; i++) strip[i] = (uint16_t)bench_rand(&seed);
+    // 出力: 4タイムステップごとに1文字、他はブランク
+    memset(output, -128, sizeof(output));
+    for (uint32_t t = 0; t < MAX_WIDTH / 4; t++) {
+        output[t * REC_CLASSES + ((t % 4 == 3) ? 1 + t % 200 : 0)] = 127;
+    }
+
+    // 固定320幅、80/160/320、80/160/320/640
+    ocr_rec_buckets_init(&fixed);
+    ocr_rec_buckets_add(&fixed, 320, 0);
+    ocr_rec_buckets_init(&narrow);
+    ocr_rec_buckets_init(&bucketed);
+    for (int b = 0; b < 4; b++) {
+        if (widths[b] <= 320) {
+            ocr_rec_buckets_add(&narrow, widths[b], (uint8_t)b);
+        }
+        ocr_rec_buckets_add(&bucketed, widths[b], (uint8_t)b);
+        ocr_quantizer_init(&quantizers[b], widths[b], STRIP_HEIGHT, 3, 0, 0.0078431f, 0, mean, std);
+    }
+    make_box_widths();
+
+    run(&fixed, &quantizers[2], &ctc, &base);
+    run(&narrow, quantizers, &ctc, &half);
+    run(&bucketed, quantizers, &ctc, &buck);
+
+    printf("  boxes per bucket:  80: %u  160: %u  320: %u  640: %u\n",
+           buck.per_bucket[0], buck.per_bucket[1], buck.per_bucket[2], buck.per_bucket[3]);
+    printf("  %-16s %9s %8s %9s %9s %9s %9s\n", "inputs", "columns", "padding", "CPU ms", "NPU ms*",
+           "total ms", "squashed");
+    const run_stats_t *rows[3] = {&base, &half, &buck};
+    const char *names[3] = {"fixed 320", "80/160/320", "80/160/320/640"};
+    for (int i = 0; i < 3; i++) {
+        printf("  %-16s %9u %7.1f%% %9.2f %9.1f %9.1f %9u\n", names[i], rows[i]->columns,
+               100.0 * (rows[i]->columns - rows[i]->content) / rows[i]->columns,
+               rows[i]->cpu_us / 1000.0, rows[i]->npu_us / 1000.0,
+               (rows[i]->cpu_us + rows[i]->npu_us) / 1000.0, rows[i]->squashed);
+    }
+    printf("  * NPU estimated at %.1f us per input column\n", NPU_US_PER_COLUMN);
+
+    snprintf(msg, sizeof(msg), "80/160/320: %.0f%% of the fixed-width recognition time, same lines squashed",
+             100.0 * (half.cpu_us + half.npu_us) / (base.cpu_us + base.npu_us));
+    CHECK(half.squashed == base.squashed && half.npu_us < base.npu_us &&
+          half.cpu_us + half.npu_us < base.cpu_us + base.npu_us, msg);
+    snprintf(msg, sizeof(msg), "80/160/320/640: %.0f%% of the fixed-width time, no line squashed (fixed: %u)",
+             100.0 * (buck.cpu_us + buck.npu_us) / (base.cpu_us + base.npu_us), base.squashed);
+    CHECK(buck.squashed == 0 && buck.content > base.content, msg);
+}
+
+int main(void) {
+    printf("\n=== OCR Recognition Width Bucket Test ===\n");
+
+    test_table();
+    bench_distribution();
+
+    printf("\n");
+    if (failures > 0) {
+        printf("❌ %d test(s) failed\n", failures);
+        return 1;
+    }
+    printf("✅ All width bucket tests passed!\n");
+    return 0;
+}
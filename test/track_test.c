@@ -0,0 +1,293 @@
+/**
+ * @file track_test.c
+ * @brief テキストボックス追跡と認識キャッシュのテスト（ホストリプレイ）
+ *
+ * 目的: 動く合成テキスト行をフレームごとに検出ボックスとして与え、
+ *       トラックIDが維持されること、認識結果がキャッシュから正しく再利用されること、
+ *       内容が変わった行（1語だけの変更を含む）・新しい行だけが再認識されることを確認
+ *       等速度予測により速い移動（IoUゲート外）でもIDが維持されることを確認
+ * 計測: 認識呼び出しの削減率、64ボックスの追跡更新時間
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "bench_timer.h"
+#include "ocr_track.h"
+
+#define PLANE_W 320
+#define PLANE_H 240
+#define MAX_LINES 64
+
+static int failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { printf("❌ FAIL: %s\n", msg); failures++; } \
+    else { printf("✅ %s\n", msg); } \
+} while (0)
+
+// 合成テキスト行（正解）
+typedef struct {
+    float x, y, vx, vy;
+    int w, h;
+    int content;        // 文字列の内容（変わると再認識が必要）
+    int old_content;    // 1語だけ書き換えた場合の元の内容（-1: なし）
+    int alive;
+} line_t;
+
+static uint8_t tracker_storage[64 * 1024] __attribute__((aligned(8)));
+static int8_t plane[PLANE_W * PLANE_H];
+static line_t lines[MAX_LINES];
+static int line_count = 0;
+static uint32_t seed = 2025;
+static uint32_t recognizer_calls = 0;
+
+static int jitter(void) {
+    return (int)(bench_rand(&seed) % 3) - 1;
+}
+
+// 行の内容に応じた模様（ボックス相対座標で決まるので移動しても同じ）
+static void render(void) {
+    memset(plane, -100, sizeof(plane));
+    for (int i = 0; i < line_count; i++) {
+        const line_t *l = &lines[i];
+        if (!l->alive) continue;
+        int x0 = (int)lrintf(l->x), y0 = (int)lrintf(l->y);
+        for (int y = 0; y < l->h; y++) {
+            for (int x = 0; x < l->w; x++) {
+                int px = x0 + x, py = y0 + y;
+                if (px < 0 || py < 0 || px >= PLANE_W || py >= PLANE_H) continue;
+                int glyph = x * 8 / l->w;
+                int c = (l->old_content >= 0 && glyph != 3) ? l->old_content : l->content;
+                plane[py * PLANE_W + px] = (int8_t)(((c * 53 + glyph * 29) % 160) - 60 + (y * 20 / l->h));
+            }
+        }
+    }
+}
+
+// 認識のモック: ボックスと最も重なる正解行の内容を返す
+static void recognize(const ocr_track_box_t *b, char *text, size_t size) {
+    int best = -1;
+    float best_iou = 0.0f;
+    recognizer_calls++;
+    for (int i = 0; i < line_count; i++) {
+        const line_t *l = &lines[i];
+        if (!l->alive) continue;
+        float ix = fminf(l->x + l->w, (float)b->x + b->width) - fmaxf(l->x, b->x);
+        float iy = fminf(l->y + l->h, (float)b->y + b->height) - fmaxf(l->y, b->y);
+        if (ix <= 0 || iy <= 0) continue;
+        float iou = ix * iy / (l->w * l->h + (float)b->width * b->height - ix * iy);
+        if (iou > best_iou) { best_iou = iou; best = i; }
+    }
+    snprintf(text, size, "LINE-%d", best >= 0 ? lines[best].content : -1);
+}
+
+/**
+ * @brief 1フレーム分: 観測 → 追跡 → キャッシュ参照/認識
+ * @return 認識結果が正解と異なったボックス数
+ */
+static int step(ocr_tracker_t *tr, int move, uint32_t *ids) {
+    ocr_track_box_t obs[MAX_LINES];
+    uint16_t track_of[MAX_LINES];
+    int owner[MAX_LINES];
+    uint32_t n = 0;
+    int errors = 0;
+
+    for (int i = 0; i < line_count; i++) {
+        line_t *l = &lines[i];
+        if (move) { l->x += l->vx; l->y += l->vy; }
+        if (!l->alive) continue;
+        obs[n].x = (uint16_t)(lrintf(l->x) + jitter());
+        obs[n].y = (uint16_t)(lrintf(l->y) + jitter());
+        obs[n].width = (uint16_t)(l->w + jitter());
+        obs[n].height = (uint16_t)(l->h + jitter());
+        owner[n++] = i;
+    }
+    render();
+    ocr_tracker_update(tr, obs, n, track_of);
+
+    for (uint32_t k = 0; k < n; k++) {
+        int8_t sig[OCR_TRACK_SIG_LENGTH];
+        char text[OCR_TRACK_TEXT_LENGTH], expect[OCR_TRACK_TEXT_LENGTH];
+        ocr_track_signature(plane, 1, PLANE_W, &obs[k], sig);
+        const ocr_track_t *t = ocr_tracker_lookup(tr, track_of[k], &obs[k], sig);
+        if (t) {
+            strcpy(text, t->text);
+        } else {
+            recognize(&obs[k], text, sizeof(text));
+            ocr_tracker_store(tr, track_of[k], &obs[k], sig, text, 0.9f);
+        }
+        snprintf(expect, sizeof(expect), "LINE-%d", lines[owner[k]].content);
+        errors += strcmp(text, expect) != 0;
+        if (ids) {
+            ids[owner[k]] = (track_of[k] != OCR_TRACK_NONE) ? tr->tracks[track_of[k]].id : 0;
+        }
+    }
+    return errors;
+}
+
+static void add_line(float x, float y, float vx, float vy, int w, int h, int content) {
+    lines[line_count++] = (line_t){ x, y, vx, vy, w, h, content, -1, 1 };
+}
+
+static void test_hover_replay(void) {
+    ocr_tracker_t tr;
+    char msg[200];
+    uint32_t ids[MAX_LINES] = {0}, first_ids[MAX_LINES] = {0};
+    int errors = 0, id_changes = 0;
+    const int frames = 150;
+
+    printf("\n--- Hover replay: 6 lines, drift + jitter, 150 frames ---\n");
+
+    CHECK(ocr_tracker_init(&tr, OCR_TRACK_MAX, MAX_LINES, tracker_storage, sizeof(tracker_storage)) == 0,
+          "tracker init");
+    line_count = 0;
+    recognizer_calls = 0;
+    for (int i = 0; i < 6; i++) {
+        add_line(10.0f + (i % 2) * 150.0f, 20.0f + (i / 2) * 60.0f, 0.2f, 0.2f, 110 - i * 8, 16, i);
+    }
+
+    uint32_t calls_at_change = 0, calls_at_new = 0, calls_at_word = 0, new_id = 0;
+    for (int f = 0; f < frames; f++) {
+        if (f == 60) {
+            lines[2].content = 12;              // ページをめくった: 同じ位置で内容が変わる
+            calls_at_change = recognizer_calls;
+        }
+        if (f == 90) {
+            lines[4].alive = 0;                 // 1行が画面外へ
+            add_line(200.0f, 200.0f, -0.5f, 0.0f, 90, 16, 7);   // 新しい行
+            calls_at_new = recognizer_calls;
+        }
+        if (f == 120) {
+            lines[1].old_content = lines[1].content;   // 8語中1語だけ書き換え
+            lines[1].content = 21;
+            calls_at_word = recognizer_calls;
+        }
+        errors += step(&tr, f > 0, ids);
+        if (f == 0) {
+            memcpy(first_ids, ids, sizeof(ids));
+        }
+        if (f == 60) calls_at_change = recognizer_calls - calls_at_change;
+        if (f == 90) { calls_at_new = recognizer_calls - calls_at_new; new_id = ids[6]; }
+        if (f == 120) calls_at_word = recognizer_calls - calls_at_word;
+        for (int i = 0; i < 4; i++) {
+            if (i != 2) id_changes += (ids[i] != first_ids[i]);
+        }
+    }
+
+    const uint32_t crops = tr.recognitions + tr.reused;
+    snprintf(msg, sizeof(msg), "all %u crops read correctly (%d wrong)", crops, errors);
+    CHECK(errors == 0, msg);
+    CHECK(id_changes == 0, "track ids persist while lines drift");
+    snprintf(msg, sizeof(msg), "content change re-recognized at once (%u call)", calls_at_change);
+    CHECK(calls_at_change == 1, msg);
+    snprintf(msg, sizeof(msg), "new line gets a new track id %u and one recognition", new_id);
+    CHECK(calls_at_new == 1 && new_id > 6, msg);
+    snprintf(msg, sizeof(msg), "one changed word re-recognizes its line (%u call)", calls_at_word);
+    CHECK(calls_at_word == 1, msg);
+    snprintf(msg, sizeof(msg), "recognition calls saved: %u of %u (%.1f%%)",
+             tr.reused, crops, 100.0 * tr.reused / crops);
+    CHECK(tr.recognitions == recognizer_calls && tr.reused * 10 > crops * 9, msg);
+    CHECK(tr.count == 6, "line that left the frame was dropped after its misses");
+}
+
+static void test_fast_motion(void) {
+    ocr_tracker_t tr;
+    char msg[160];
+    uint32_t ids[MAX_LINES] = {0};
+
+    printf("\n--- Accelerating pan: up to 12 px/frame across a 16 px line ---\n");
+
+    for (int variant = 0; variant < 2; variant++) {
+        uint32_t first = 0;
+        int changes = 0;
+        ocr_tracker_init(&tr, OCR_TRACK_MAX, MAX_LINES, tracker_storage, sizeof(tracker_storage));
+        if (variant == 1) {
+            tr.velocity_gain = 0.0f;            // 予測なし（比較用）
+        }
+        line_count = 0;
+        add_line(100.0f, 10.0f, 1.0f, 0.0f, 120, 16, 3);
+        for (int f = 0; f < 20; f++) {
+            lines[0].vy = (f < 6) ? 2.0f * f : 12.0f;  // 2 px/frame ずつ加速
+            step(&tr, f > 0, ids);
+            if (f == 0) first = ids[0];
+            changes += (ids[0] != first);
+        }
+        if (variant == 0) {
+            snprintf(msg, sizeof(msg), "constant-velocity prediction keeps one id (%d changes)", changes);
+            CHECK(changes == 0, msg);
+        } else {
+            snprintf(msg, sizeof(msg), "without prediction the id is lost (%d changes)", changes);
+            CHECK(changes > 0, msg);
+        }
+    }
+}
+
+static void test_capacity(void) {
+    ocr_tracker_t tr;
+    ocr_track_box_t obs[4] = {{0, 0, 20, 10}, {40, 0, 20, 10}, {80, 0, 20, 10}, {120, 0, 20, 10}};
+    uint16_t track_of[4];
+
+    printf("\n--- Capacity ---\n");
+    ocr_tracker_init(&tr, 2, 4, tracker_storage, sizeof(tracker_storage));
+    CHECK(ocr_tracker_update(&tr, obs, 4, track_of) == 2 && track_of[2] == OCR_TRACK_NONE &&
+          track_of[3] == OCR_TRACK_NONE, "boxes beyond the track capacity get no track");
+    int8_t sig[OCR_TRACK_SIG_LENGTH] = {0};
+    CHECK(ocr_tracker_lookup(&tr, OCR_TRACK_NONE, &obs[2], sig) == NULL && tr.recognitions == 1,
+          "untracked box is always recognized");
+    CHECK(ocr_tracker_update(&tr, obs, 5, track_of) < 0, "too many boxes rejected");
+    CHECK(ocr_tracker_init(&tr, 64, 64, tracker_storage, 16) < 0, "short storage rejected");
+}
+
+static void bench_update(void) {
+    ocr_tracker_t tr;
+    ocr_track_box_t obs[64];
+    uint16_t track_of[64];
+    const int iterations = 2000;
+
+    printf("\n--- Benchmark: 64 boxes ---\n");
+    ocr_tracker_init(&tr, OCR_TRACK_MAX, 64, tracker_storage, sizeof(tracker_storage));
+    for (int i = 0; i < 64; i++) {
+        obs[i] = (ocr_track_box_t){ (uint16_t)((i % 4) * 80), (uint16_t)((i / 4) * 15), 70, 12 };
+    }
+    ocr_tracker_update(&tr, obs, 64, track_of);
+
+    double t0 = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        obs[i % 64].x ^= 1;
+        ocr_tracker_update(&tr, obs, 64, track_of);
+    }
+    double t = (bench_now_us() - t0) / iterations;
+
+    render();
+    int8_t sig[OCR_TRACK_SIG_LENGTH];
+    t0 = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        ocr_track_signature(plane, 1, PLANE_W, &obs[i % 64], sig);
+    }
+    double ts = (bench_now_us() - t0) / iterations;
+
+    CHECK(tr.count == 64 && tr.matched == 64, "64 static boxes stay matched");
+    printf("  update: %.1f us per frame, signature %.2f us per box, storage %u bytes\n",
+           t, ts, ocr_tracker_size(OCR_TRACK_MAX, 64));
+}
+
+int main(void) {
+    printf("\n=== OCR Text Box Tracker Test ===\n");
+
+    test_hover_replay();
+    test_fast_motion();
+    test_capacity();
+    bench_update();
+
+    printf("\n");
+    if (failures > 0) {
+        printf("❌ %d test(s) failed\n", failures);
+        return 1;
+    }
+    printf("✅ All tracker tests passed!\n");
+    return 0;
+}